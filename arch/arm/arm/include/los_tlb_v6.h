@@ -76,6 +76,15 @@ STATIC INLINE VOID OsArmInvalidateTlbMvaRangeNoBarrier(VADDR_T start, UINT32 cou
     }
 }
 
+STATIC INLINE VOID OsArmInvalidateTlbAsidNoBarrier(UINT32 asid)
+{
+#ifdef LOSCFG_KERNEL_SMP
+    OsArmWriteTlbiasidis(asid);
+#else
+    OsArmWriteTlbiasid(asid);
+#endif
+}
+
 STATIC INLINE VOID OsCleanTLB(VOID)
 {
     UINT32 val = 0;
@@ -922,6 +922,216 @@ STATUS_T LOS_ArchMmuMove(LosArchMmu *archMmu, VADDR_T oldVaddr, VADDR_T newVaddr
     return LOS_OK;
 }
 
+#ifdef LOSCFG_KERNEL_VM
+#define MMU_COW_ASID_FLUSH_PAGES 64 /* above this, one asid flush is cheaper than flushing by mva */
+
+STATIC INLINE PTE_T OsCvtPte2ToReadOnly(PTE_T pte2)
+{
+    switch (pte2 & MMU_DESCRIPTOR_L2_AP_MASK) {
+        case MMU_DESCRIPTOR_L2_AP_P_RW_U_RW:
+            return (pte2 & ~MMU_DESCRIPTOR_L2_AP_MASK) | MMU_DESCRIPTOR_L2_AP_P_RO_U_RO;
+        case MMU_DESCRIPTOR_L2_AP_P_RW_U_NA:
+            return (pte2 & ~MMU_DESCRIPTOR_L2_AP_MASK) | MMU_DESCRIPTOR_L2_AP_P_RO_U_NA;
+        default:
+            return pte2;
+    }
+}
+
+STATIC INLINE PTE_T OsCvtPte1ToReadOnly(PTE_T pte1)
+{
+    switch (pte1 & MMU_DESCRIPTOR_L1_AP_MASK) {
+        case MMU_DESCRIPTOR_L1_AP_P_RW_U_RW:
+            return (pte1 & ~MMU_DESCRIPTOR_L1_AP_MASK) | MMU_DESCRIPTOR_L1_AP_P_RO_U_RO;
+        case MMU_DESCRIPTOR_L1_AP_P_RW_U_NA:
+            return (pte1 & ~MMU_DESCRIPTOR_L1_AP_MASK) | MMU_DESCRIPTOR_L1_AP_P_RO_U_NA;
+        default:
+            return pte1;
+    }
+}
+
+STATIC INLINE VOID OsCowPageRefInc(PADDR_T paddr, UINT8 *segID)
+{
+    /* pages of a region mostly live in one segment, avoid the segment scan for each of them */
+    LosVmPage *page = OsVmPhysToPage(paddr, *segID);
+    if (page == NULL) {
+        page = OsVmPaddrToPage(paddr);
+        if (page == NULL) {
+            return;
+        }
+        *segID = page->segID;
+    }
+    LOS_AtomicInc(&page->refCounts);
+}
+
+STATIC PTE_T *OsCowDstPte2BaseGet(LosArchMmu *dstMmu, VADDR_T vaddr, PTE_T srcPte1)
+{
+    PADDR_T pte2Base = 0;
+    PADDR_T pte1Paddr;
+    PTE_T *l1Entry = NULL;
+    SPIN_LOCK_S *lock = NULL;
+    UINT32 intSave;
+
+    pte1Paddr = OsGetPte1Paddr(dstMmu->physTtb, vaddr);
+    lock = OsGetPte1Lock(dstMmu, pte1Paddr, &intSave);
+    l1Entry = OsGetPte1Ptr(dstMmu->virtTtb, vaddr);
+    if (OsIsPte1PageTable(*l1Entry)) {
+        OsUnlockPte1(lock, intSave);
+        return OsGetPte2BasePtr(*l1Entry);
+    }
+    if (!OsIsPte1Invalid(*l1Entry) || (OsGetL2Table(dstMmu, OsGetPte1Index(vaddr), &pte2Base) != LOS_OK)) {
+        OsUnlockPte1(lock, intSave);
+        return NULL;
+    }
+
+    pte2Base |= MMU_DESCRIPTOR_L1_TYPE_PAGE_TABLE | (srcPte1 & MMU_DESCRIPTOR_L1_PAGETABLE_NON_SECURE);
+    pte2Base &= MMU_DESCRIPTOR_L1_SMALL_DOMAIN_MASK;
+    pte2Base |= MMU_DESCRIPTOR_L1_SMALL_DOMAIN_CLIENT; // use client AP
+    OsSavePte1(l1Entry, pte2Base);
+    OsUnlockPte1(lock, intSave);
+    return OsGetPte2BasePtr(pte2Base);
+}
+
+STATIC UINT32 OsCowCloneL2(LosArchMmu *srcMmu, LosArchMmu *dstMmu, PTE_T *srcPte1, VADDR_T vaddr, UINT32 count,
+                           BOOL *protect)
+{
+    UINT32 index = OsGetPte2Index(vaddr);
+    UINT32 cloneCount = MIN2(MMU_DESCRIPTOR_L2_NUMBERS_PER_L1 - index, count);
+    UINT32 end = index + cloneCount;
+    PTE_T *srcPte2BasePtr = NULL;
+    PTE_T *dstPte2BasePtr = NULL;
+    SPIN_LOCK_S *srcLock = NULL;
+    SPIN_LOCK_S *dstLock = NULL;
+    UINT32 srcIntSave, dstIntSave;
+    PTE_T pte2, roPte2;
+    UINT8 segID = 0;
+
+    dstPte2BasePtr = OsCowDstPte2BaseGet(dstMmu, vaddr, *srcPte1);
+    if (dstPte2BasePtr == NULL) {
+        return 0;
+    }
+
+    srcLock = OsGetPte2Lock(srcMmu, *srcPte1, &srcIntSave);
+    if (srcLock == NULL) {
+        return 0;
+    }
+    srcPte2BasePtr = OsGetPte2BasePtr(*srcPte1);
+    dstLock = OsGetPte2Lock(dstMmu, OsGetPte1(dstMmu->virtTtb, vaddr), &dstIntSave);
+    if (dstLock == NULL) {
+        OsUnlockPte2(srcLock, srcIntSave);
+        return 0;
+    }
+
+    DMB;
+    for (; index < end; index++) {
+        pte2 = srcPte2BasePtr[index];
+        if (!OsIsPte2SmallPage(pte2) && !OsIsPte2SmallPageXN(pte2)) {
+            continue;
+        }
+        roPte2 = OsCvtPte2ToReadOnly(pte2);
+        if (roPte2 != pte2) {
+            srcPte2BasePtr[index] = roPte2;
+            *protect = TRUE;
+        }
+        dstPte2BasePtr[index] = roPte2;
+        OsCowPageRefInc(MMU_DESCRIPTOR_L2_SMALL_PAGE_ADDR(pte2), &segID);
+    }
+    DSB;
+
+    OsUnlockPte2(dstLock, dstIntSave);
+    OsUnlockPte2(srcLock, srcIntSave);
+    return cloneCount;
+}
+
+STATIC UINT32 OsCowCloneSection(LosArchMmu *srcMmu, LosArchMmu *dstMmu, PTE_T *srcPte1, VADDR_T vaddr,
+                                BOOL *protect)
+{
+    SPIN_LOCK_S *srcLock = NULL;
+    SPIN_LOCK_S *dstLock = NULL;
+    UINT32 srcIntSave, dstIntSave;
+    PTE_T *dstPte1 = NULL;
+    PTE_T roPte1;
+    PADDR_T paddr;
+    UINT32 index;
+    UINT8 segID = 0;
+
+    srcLock = OsGetPte1Lock(srcMmu, OsGetPte1Paddr(srcMmu->physTtb, vaddr), &srcIntSave);
+    dstLock = OsGetPte1Lock(dstMmu, OsGetPte1Paddr(dstMmu->physTtb, vaddr), &dstIntSave);
+    dstPte1 = OsGetPte1Ptr(dstMmu->virtTtb, vaddr);
+    if (!OsIsPte1Section(*srcPte1) || !OsIsPte1Invalid(*dstPte1)) {
+        OsUnlockPte1(dstLock, dstIntSave);
+        OsUnlockPte1(srcLock, srcIntSave);
+        return 0;
+    }
+
+    roPte1 = OsCvtPte1ToReadOnly(*srcPte1);
+    if (roPte1 != *srcPte1) {
+        OsSavePte1(srcPte1, roPte1);
+        *protect = TRUE;
+    }
+    OsSavePte1(dstPte1, roPte1);
+    OsUnlockPte1(dstLock, dstIntSave);
+    OsUnlockPte1(srcLock, srcIntSave);
+
+    paddr = MMU_DESCRIPTOR_L1_SECTION_ADDR(roPte1);
+    for (index = 0; index < MMU_DESCRIPTOR_L2_NUMBERS_PER_L1; index++) {
+        OsCowPageRefInc(paddr + (index << MMU_DESCRIPTOR_L2_SMALL_SHIFT), &segID);
+    }
+    return MMU_DESCRIPTOR_L2_NUMBERS_PER_L1;
+}
+
+/*
+ * Share every page mapped in [vaddr, vaddr + count pages) of srcMmu with dstMmu copy-on-write:
+ * the PTEs are copied read-only into dstMmu, write-protected in srcMmu, the page refcounts are
+ * raised, and the stale writable TLB entries of srcMmu are dropped with a single flush.
+ */
+STATUS_T LOS_ArchMmuCowClone(LosArchMmu *srcMmu, LosArchMmu *dstMmu, VADDR_T vaddr, size_t count)
+{
+    PTE_T *l1Entry = NULL;
+    VADDR_T start = vaddr;
+    UINT32 remain = (UINT32)count;
+    UINT32 cloneCount;
+    BOOL protect = FALSE;
+    STATUS_T ret = LOS_OK;
+
+    if ((srcMmu == NULL) || (dstMmu == NULL) || (count == 0)) {
+        VM_ERR("invalid args: srcMmu %p, dstMmu %p, count %d", srcMmu, dstMmu, count);
+        return LOS_ERRNO_VM_INVALID_ARGS;
+    }
+
+    while (remain > 0) {
+        l1Entry = OsGetPte1Ptr(srcMmu->virtTtb, vaddr);
+        if (OsIsPte1Invalid(*l1Entry)) {
+            (VOID)OsUnmapL1Invalid(&vaddr, &remain);
+            continue;
+        } else if (OsIsPte1PageTable(*l1Entry)) {
+            cloneCount = OsCowCloneL2(srcMmu, dstMmu, l1Entry, vaddr, remain, &protect);
+        } else if (OsIsPte1Section(*l1Entry) && MMU_DESCRIPTOR_IS_L1_SIZE_ALIGNED(vaddr) &&
+                   (remain >= MMU_DESCRIPTOR_L2_NUMBERS_PER_L1)) {
+            cloneCount = OsCowCloneSection(srcMmu, dstMmu, l1Entry, vaddr, &protect);
+        } else {
+            cloneCount = 0;
+        }
+        if (cloneCount == 0) {
+            VM_ERR("clone failed: vaddr %#x, l1Entry %#x", vaddr, *l1Entry);
+            ret = LOS_ERRNO_VM_NO_MEMORY;
+            break;
+        }
+        vaddr += cloneCount << MMU_DESCRIPTOR_L2_SMALL_SHIFT;
+        remain -= cloneCount;
+    }
+
+    if (protect) {
+        if (count > MMU_COW_ASID_FLUSH_PAGES) {
+            OsArmInvalidateTlbAsidNoBarrier(srcMmu->asid);
+        } else {
+            OsArmInvalidateTlbMvaRangeNoBarrier(start, count);
+        }
+        OsArmInvalidateTlbBarrier();
+    }
+    return ret;
+}
+#endif
+
 VOID LOS_ArchMmuContextSwitch(LosArchMmu *archMmu)
 {
     UINT32 ttbr;
@@ -58,12 +58,16 @@ LITE_OS_SEC_TEXT_MINOR VOID LOS_GetCpuCycle(UINT32 *highCnt, UINT32 *lowCnt)
     *lowCnt = cycle & 0xFFFFFFFFU;
 }
 
-LITE_OS_SEC_TEXT_MINOR UINT64 LOS_CurrNanosec(VOID)
+LITE_OS_SEC_TEXT_MINOR UINT64 OsCycle2Nanosec(UINT64 cycle)
 {
-    UINT64 cycle = HalClockGetCycles();
     return (cycle / g_sysClock) * OS_SYS_NS_PER_SECOND + (cycle % g_sysClock) * OS_SYS_NS_PER_SECOND / g_sysClock;
 }
 
+LITE_OS_SEC_TEXT_MINOR UINT64 LOS_CurrNanosec(VOID)
+{
+    return OsCycle2Nanosec(HalClockGetCycles());
+}
+
 LITE_OS_SEC_TEXT_MINOR VOID LOS_Udelay(UINT32 usecs)
 {
     HalDelayUs(usecs);
@@ -32,6 +32,7 @@
 #include "user_copy.h"
 #include "arm_user_copy.h"
 #include "arm_user_clear.h"
+#include "arm_user_atomic.h"
 #include "securec.h"
 #include "los_memory.h"
 #include "los_vm_map.h"
@@ -104,4 +105,13 @@ INT32 LOS_UserMemClear(unsigned char *buf, UINT32 len)
     return ret;
 }
 
+INT32 LOS_ArchUserCmpXchg32(UINT32 *uaddr, UINT32 oldVal, UINT32 newVal, UINT32 *curVal)
+{
+    if (((UINTPTR)uaddr % sizeof(UINT32)) || !LOS_IsUserAddressRange((VADDR_T)(UINTPTR)uaddr, sizeof(UINT32))) {
+        return -EFAULT;
+    }
+
+    return _arm_user_cmpxchg(uaddr, oldVal, newVal, curVal);
+}
+
 
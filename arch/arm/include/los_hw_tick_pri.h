@@ -42,6 +42,7 @@ extern "C" {
 
 extern UINT32 OsTickInit(UINT32 systemClock, UINT32 tickPerSecond);
 extern VOID OsTickStart(VOID);
+extern UINT64 OsCycle2Nanosec(UINT64 cycle);
 
 #ifdef __cplusplus
 #if __cplusplus
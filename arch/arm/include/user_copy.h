@@ -101,3 +101,18 @@ INT32 LOS_CopyToKernel(VOID *dest, UINT32 max, const VOID *src, UINT32 count);
  * @return zero on success; non-zero on failure.
  */
 INT32 LOS_UserMemClear(unsigned char *buf, UINT32 len);
+
+/*
+ * @brief Compare and exchange a word in userspace
+ *
+ * The word at uaddr is replaced with newVal if it holds oldVal. The value found at uaddr is
+ * returned in curVal either way, the exchange happened if it equals oldVal.
+ *
+ * @param uaddr The word aligned user address.
+ * @param oldVal The expected value.
+ * @param newVal The value to store.
+ * @param curVal The value found at uaddr.
+ *
+ * @return zero on success; -EFAULT if uaddr is not accessible.
+ */
+INT32 LOS_ArchUserCmpXchg32(UINT32 *uaddr, UINT32 oldVal, UINT32 newVal, UINT32 *curVal);
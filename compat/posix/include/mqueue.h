@@ -47,7 +47,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
-#include "los_queue_pri.h"
+#include "los_list.h"
+#include "los_atomic.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -71,8 +72,12 @@ extern "C" {
 /* CONSTANTS */
 
 #define MQ_USE_MAGIC  0x89abcdef
-/* not support prio */
-#define MQ_PRIO_MAX 1
+
+/**
+ * @ingroup mqueue
+ * Number of message priorities, messages of each priority are kept in their own fifo
+ */
+#define MQ_PRIO_MAX 32
 
 typedef union send_receive_t {
     unsigned oth : 3;
@@ -87,6 +92,24 @@ struct mqnotify {
 };
 
 /* TYPE DEFINITIONS */
+typedef struct MqueueMsg {
+    LOS_DL_LIST node;       /* entry of the priority fifo or the free list */
+    UINT32 msgLen;
+    UINT32 msgPrio;
+    CHAR data[0];
+} MqueueMsg;
+
+typedef struct {
+    LOS_DL_LIST prioList[MQ_PRIO_MAX]; /* message fifo of each priority */
+    UINT32 prioBitmap;                 /* bit n is set when prioList[n] is not empty */
+    LOS_DL_LIST freeList;              /* free message nodes */
+    LOS_DL_LIST waitList[2];           /* tasks blocked in receive and send */
+    UINT16 maxMsg;
+    UINT16 msgSize;
+    UINT16 curMsgs;
+    Atomic busy;                       /* senders and receivers working on the queue */
+} MqueueCB;
+
 struct mqarray {
     UINT32 mq_id : 31;
     UINT32 unlinkflag : 1;
@@ -96,7 +119,7 @@ struct mqarray {
     uid_t euid; /* euid of mqueue */
     gid_t egid; /* egid of mqueue */
     struct mqnotify mq_notify;
-    LosQueueCB *mqcb;
+    MqueueCB *mqcb;
     struct mqpersonal *mq_personal;
 };
 
@@ -237,16 +260,14 @@ extern int mq_unlink(const char *mqName);
  * a message queue that has a specified descriptor.
  * @attention
  * <ul>
- * <li> Priority-based message processing is not supported.</li>
+ * <li> Messages of higher priority are received first, messages of the same priority in fifo order.</li>
  * <li> The msg_len should be same to the length of string which msg_ptr point to.</li>
  * </ul>
  *
  * @param personal   [IN] Message queue descriptor.
  * @param msg        [IN] Pointer to the message content to be sent.
  * @param msgLen     [IN] Length of the message to be sent.
- * @param msgPrio    [IN] Priority of the message to be sent (the value of this parameter must
- *                        be 0 because priority-based message sending is not supported. If the
- *                        value is not 0, this API will cease to work.)
+ * @param msgPrio    [IN] Priority of the message to be sent, less than MQ_PRIO_MAX.
  *
  * @retval  0    The message is successfully sent.
  * @retval -1    The message fails to be sent, with any of the following error codes in errno.
@@ -273,19 +294,17 @@ extern int mq_send(mqd_t personal, const char *msg, size_t msgLen, unsigned int
  * @ingroup mqueue
  *
  * @par Description:
- * This API is used to remove the oldest message from the message queue that has a specified descriptor,
- * and puts it in the buffer pointed to by msg_ptr.
+ * This API is used to remove the oldest message of the highest priority from the message queue that has
+ * a specified descriptor, and puts it in the buffer pointed to by msg_ptr.
  * @attention
  * <ul>
- * <li> Priority-based message processing is not supported.</li>
  * <li> The msg_len should be same to the length of string which msg_ptr point to.</li>
  * </ul>
  *
  * @param personal   [IN] Message queue descriptor.
  * @param msg        [IN] Pointer to the message content to be received.
  * @param msgLen     [IN] Length of the message to be received.
- * @param msgPrio    [OUT] Priority of the message to be received
- *                         because priority-based message processing is not supported, this parameter is useless).
+ * @param msgPrio    [OUT] Priority of the message to be received.
  *
  * @retval  0    The message is successfully received.
  * @retval -1    The message fails to be received, with any of the following error codes in the errno.
@@ -345,7 +364,6 @@ extern int mq_getsetattr(mqd_t personal, const struct mq_attr *mqSetAttr, struct
  * a message queue that has a descriptor at a scheduled time.
  * @attention
  * <ul>
- * <li> Priority-based message processing is not supported.</li>
  * <li> The expiry time must be later than the current time.</li>
  * <li> The wait time is a relative time.</li>
  * <li> The msg_len should be same to the length of string which msg_ptr point to.</li>
@@ -354,8 +372,7 @@ extern int mq_getsetattr(mqd_t personal, const struct mq_attr *mqSetAttr, struct
  * @param mqdes           [IN] Message queue descriptor.
  * @param msg             [IN] Pointer to the message content to be sent.
  * @param msgLen          [IN] Length of the message to be sent.
- * @param msgPrio         [IN] Priority of the message to be sent (the value of this parameter must be 0
- *                             because priority-based message processing is not supported).
+ * @param msgPrio         [IN] Priority of the message to be sent, less than MQ_PRIO_MAX.
  * @param absTimeout      [IN] Scheduled time at which the message will be sent. If the value is 0,
  *                             the message is an instant message.
  *
@@ -388,7 +405,6 @@ extern int mq_timedsend(mqd_t personal, const char *msg, size_t msgLen,
  * a message queue message that has a specified descriptor.
  * @attention
  * <ul>
- * <li> Priority-based message processing is not supported.</li>
  * <li> The expiry time must be later than the current time.</li>
  * <li> The wait time is a relative time.</li>
  * <li> The msg_len should be same to the length of string which msg_ptr point to.</li>
@@ -397,8 +413,7 @@ extern int mq_timedsend(mqd_t personal, const char *msg, size_t msgLen,
  * @param personal        [IN] Message queue descriptor.
  * @param msg             [IN] Pointer to the message content to be received.
  * @param msgLen          [IN] Length of the message to be received.
- * @param msgPrio         [OUT] Priority of the message to be received (because priority-based message
- *                              processing is not supported, this parameter is useless ).
+ * @param msgPrio         [OUT] Priority of the message to be received.
  * @param absTimeout      [IN] Scheduled time at which the messagewill be received. If the value is 0,
  *                             the message is an instant message.
  *
@@ -422,6 +437,69 @@ extern int mq_timedsend(mqd_t personal, const char *msg, size_t msgLen,
 extern ssize_t mq_timedreceive(mqd_t personal, char *msg, size_t msgLen,
                                unsigned int *msgPrio, const struct timespec *absTimeout);
 
+/**
+ * @ingroup mqueue
+ * Message vector of the batch send and receive APIs
+ */
+struct mq_msgvec {
+    char *msg;              /**< Message buffer */
+    size_t msgLen;          /**< Message length to send, or buffer size on receive which is updated
+                                 to the received length */
+    unsigned int msgPrio;   /**< Message priority */
+};
+
+/**
+ * @ingroup mqueue
+ *
+ * @par Description:
+ * This API is used to put several messages into a message queue with one lookup of the descriptor.
+ * @attention
+ * <ul>
+ * <li> Only the first message waits for free space, the rest are sent while the queue is not full.</li>
+ * <li> The wait time is a relative time.</li>
+ * </ul>
+ *
+ * @param personal        [IN] Message queue descriptor.
+ * @param msgVec          [IN] Messages to be sent.
+ * @param count           [IN] Number of messages in msgVec.
+ * @param absTimeout      [IN] Wait time of the first message.
+ *
+ * @retval  #int  The number of messages sent.
+ * @retval -1     No message is sent, with the same error codes in errno as mq_timedsend.
+ *
+ * @par Dependency:
+ * <ul><li>mqueue.h</li></ul>
+ * @see mq_timedreceive_batch
+ */
+extern int mq_timedsend_batch(mqd_t personal, const struct mq_msgvec *msgVec, unsigned int count,
+                              const struct timespec *absTimeout);
+
+/**
+ * @ingroup mqueue
+ *
+ * @par Description:
+ * This API is used to get several messages from a message queue with one lookup of the descriptor.
+ * @attention
+ * <ul>
+ * <li> Only the first message waits for the queue to be filled, the rest are received while it is not empty.</li>
+ * <li> The wait time is a relative time.</li>
+ * </ul>
+ *
+ * @param personal        [IN] Message queue descriptor.
+ * @param msgVec          [IN/OUT] Receive buffers, msgLen and msgPrio are updated for each message received.
+ * @param count           [IN] Number of buffers in msgVec.
+ * @param absTimeout      [IN] Wait time of the first message.
+ *
+ * @retval  #int  The number of messages received.
+ * @retval -1     No message is received, with the same error codes in errno as mq_timedreceive.
+ *
+ * @par Dependency:
+ * <ul><li>mqueue.h</li></ul>
+ * @see mq_timedsend_batch
+ */
+extern int mq_timedreceive_batch(mqd_t personal, struct mq_msgvec *msgVec, unsigned int count,
+                                 const struct timespec *absTimeout);
+
 extern void MqueueRefer(int sysFd);
 extern int OsMqNotify(mqd_t personal, const struct sigevent *sigev);
 
@@ -48,6 +48,12 @@
 #define MAX_MQ_FD CONFIG_NQUEUE_DESCRIPTORS
 #endif
 
+#define MQ_READ         0
+#define MQ_WRITE        1
+/* messages handled by one call of the batch APIs */
+#define MQ_BATCH_MAX    16
+#define MQ_PRIO_TOP(bitmap) (31 - CLZ(bitmap))
+
 /* GLOBALS */
 STATIC fd_set g_queueFdSet;
 STATIC struct mqarray g_queueTable[LOSCFG_BASE_IPC_QUEUE_LIMIT];
@@ -74,69 +80,78 @@ STATIC INLINE INT32 MqNameCheck(const CHAR *mqName)
     return 0;
 }
 
-STATIC INLINE UINT32 GetMqueueCBByID(UINT32 queueID, LosQueueCB **queueCB)
+STATIC struct mqarray *MqueueSlotGet(VOID)
 {
-    LosQueueCB *tmpQueueCB = NULL;
-    if (queueCB == NULL) {
-        errno = EINVAL;
-        return LOS_ERRNO_QUEUE_READ_PTR_NULL;
-    }
-    tmpQueueCB = GET_QUEUE_HANDLE(queueID);
-    if ((GET_QUEUE_INDEX(queueID) >= LOSCFG_BASE_IPC_QUEUE_LIMIT) || (tmpQueueCB->queueID != queueID)) {
-        return LOS_ERRNO_QUEUE_INVALID;
-    }
-    *queueCB = tmpQueueCB;
+    UINT32 index;
 
-    return LOS_OK;
+    for (index = 0; index < LOSCFG_BASE_IPC_QUEUE_LIMIT; index++) {
+        if ((g_queueTable[index].mqcb == NULL) && (g_queueTable[index].mq_name == NULL)) {
+            g_queueTable[index].mq_id = index;
+            return &(g_queueTable[index]);
+        }
+    }
+    return NULL;
 }
 
-STATIC INLINE struct mqarray *GetMqueueCBByName(const CHAR *name)
+STATIC MqueueCB *MqueueCBCreate(UINT16 maxMsg, UINT16 msgSize)
 {
+    UINT32 nodeSize = sizeof(MqueueMsg) + ALIGN(msgSize, sizeof(UINTPTR));
+    UINT64 poolSize = sizeof(MqueueCB) + (UINT64)nodeSize * maxMsg;
+    MqueueCB *mqcb = NULL;
+    UINT8 *pool = NULL;
     UINT32 index;
-    UINT32 mylen = strlen(name);
 
-    for (index = 0; index < LOSCFG_BASE_IPC_QUEUE_LIMIT; index++) {
-        if ((g_queueTable[index].mq_name == NULL) || (strlen(g_queueTable[index].mq_name) != mylen)) {
-            continue;
-        }
+    if (poolSize > OS_NULL_INT) {
+        return NULL;
+    }
 
-        if (strncmp(name, (const CHAR *)(g_queueTable[index].mq_name), mylen) == 0) {
-            return &(g_queueTable[index]);
-        }
+    mqcb = (MqueueCB *)LOS_MemAlloc(OS_SYS_MEM_ADDR, (UINT32)poolSize);
+    if (mqcb == NULL) {
+        return NULL;
     }
-    return NULL;
+
+    (VOID)memset_s(mqcb, sizeof(MqueueCB), 0, sizeof(MqueueCB));
+    for (index = 0; index < MQ_PRIO_MAX; index++) {
+        LOS_ListInit(&mqcb->prioList[index]);
+    }
+    LOS_ListInit(&mqcb->freeList);
+    LOS_ListInit(&mqcb->waitList[MQ_READ]);
+    LOS_ListInit(&mqcb->waitList[MQ_WRITE]);
+    mqcb->maxMsg = maxMsg;
+    mqcb->msgSize = msgSize;
+
+    /* the message nodes follow the control block */
+    pool = (UINT8 *)(mqcb + 1);
+    for (index = 0; index < maxMsg; index++) {
+        MqueueMsg *msg = (MqueueMsg *)(pool + index * nodeSize);
+        LOS_ListTailInsert(&mqcb->freeList, &msg->node);
+    }
+    return mqcb;
 }
 
 STATIC INT32 DoMqueueDelete(struct mqarray *mqueueCB)
 {
-    UINT32 ret;
+    /* the senders and receivers get the queue under g_mqueueMutex */
+    if ((mqueueCB->mqcb != NULL) && (LOS_AtomicRead(&mqueueCB->mqcb->busy) != 0)) {
+        errno = EAGAIN;
+        return -1;
+    }
 
     if (mqueueCB->mq_name != NULL) {
         LOS_MemFree(OS_SYS_MEM_ADDR, mqueueCB->mq_name);
         mqueueCB->mq_name = NULL;
     }
 
-    mqueueCB->mqcb = NULL;
+    if (mqueueCB->mqcb != NULL) {
+        (VOID)LOS_MemFree(OS_SYS_MEM_ADDR, mqueueCB->mqcb);
+        mqueueCB->mqcb = NULL;
+    }
     /* When mqueue-list head node needed free ,reset the mode_data */
     mqueueCB->mode_data.data = 0;
     mqueueCB->euid = -1;
     mqueueCB->egid = -1;
     mqueueCB->mq_notify.pid = 0;
-
-    ret = LOS_QueueDelete(mqueueCB->mq_id);
-    switch (ret) {
-        case LOS_OK:
-            return 0;
-        case LOS_ERRNO_QUEUE_NOT_FOUND:
-        case LOS_ERRNO_QUEUE_NOT_CREATE:
-        case LOS_ERRNO_QUEUE_IN_TSKUSE:
-        case LOS_ERRNO_QUEUE_IN_TSKWRITE:
-            errno = EAGAIN;
-            return -1;
-        default:
-            errno = EINVAL;
-            return -1;
-    }
+    return 0;
 }
 
 STATIC int SaveMqueueName(const CHAR *mqName, struct mqarray *mqueueCB)
@@ -163,37 +178,30 @@ STATIC int SaveMqueueName(const CHAR *mqName, struct mqarray *mqueueCB)
 STATIC struct mqpersonal *DoMqueueCreate(const struct mq_attr *attr, const CHAR *mqName, INT32 openFlag, UINT32 mode)
 {
     struct mqarray *mqueueCB = NULL;
-    UINT32 mqueueID;
 
-    UINT32 err = LOS_QueueCreate(NULL, attr->mq_maxmsg, &mqueueID, 0, attr->mq_msgsize);
-    if (map_errno(err) != ENOERR) {
+    if ((attr->mq_maxmsg == 0) || (attr->mq_msgsize == 0)) {
+        errno = EINVAL;
         goto ERROUT;
     }
 
-    if (g_queueTable[GET_QUEUE_INDEX(mqueueID)].mqcb == NULL) {
-        mqueueCB = &(g_queueTable[GET_QUEUE_INDEX(mqueueID)]);
-        mqueueCB->mq_id = mqueueID;
-    }
-
+    mqueueCB = MqueueSlotGet();
     if (mqueueCB == NULL) {
-        errno = EINVAL;
+        errno = ENFILE;
         goto ERROUT;
     }
 
-    if (SaveMqueueName(mqName, mqueueCB) != LOS_OK) {
+    mqueueCB->mqcb = MqueueCBCreate((UINT16)attr->mq_maxmsg, (UINT16)attr->mq_msgsize);
+    if (mqueueCB->mqcb == NULL) {
+        errno = ENOSPC;
         goto ERROUT;
     }
 
-    if (GetMqueueCBByID(mqueueCB->mq_id, &(mqueueCB->mqcb)) != LOS_OK) {
-        errno = ENOSPC;
+    if (SaveMqueueName(mqName, mqueueCB) != LOS_OK) {
         goto ERROUT;
     }
 
     mqueueCB->mq_personal = (struct mqpersonal *)LOS_MemAlloc(OS_SYS_MEM_ADDR, sizeof(struct mqpersonal));
     if (mqueueCB->mq_personal == NULL) {
-        (VOID)LOS_QueueDelete(mqueueCB->mq_id);
-        mqueueCB->mqcb->queueHandle = NULL;
-        mqueueCB->mqcb = NULL;
         errno = ENOSPC;
         goto ERROUT;
     }
@@ -211,9 +219,8 @@ STATIC struct mqpersonal *DoMqueueCreate(const struct mq_attr *attr, const CHAR
     return mqueueCB->mq_personal;
 ERROUT:
 
-    if ((mqueueCB != NULL) && (mqueueCB->mq_name != NULL)) {
-        LOS_MemFree(OS_SYS_MEM_ADDR, mqueueCB->mq_name);
-        mqueueCB->mq_name = NULL;
+    if (mqueueCB != NULL) {
+        (VOID)DoMqueueDelete(mqueueCB);
     }
     return (struct mqpersonal *)-1;
 }
@@ -604,9 +611,9 @@ int OsMqGetAttr(mqd_t personal, struct mq_attr *mqAttr)
     }
 
     mqueueCB = privateMqPersonal->mq_posixdes;
-    mqAttr->mq_maxmsg = mqueueCB->mqcb->queueLen;
-    mqAttr->mq_msgsize = mqueueCB->mqcb->queueSize - sizeof(UINT32);
-    mqAttr->mq_curmsgs = mqueueCB->mqcb->readWriteableCnt[OS_QUEUE_READ];
+    mqAttr->mq_maxmsg = mqueueCB->mqcb->maxMsg;
+    mqAttr->mq_msgsize = mqueueCB->mqcb->msgSize;
+    mqAttr->mq_curmsgs = mqueueCB->mqcb->curMsgs;
     mqAttr->mq_flags = privateMqPersonal->mq_flags;
     (VOID)pthread_mutex_unlock(&g_mqueueMutex);
     return 0;
@@ -725,7 +732,7 @@ static void MqSendNotify(struct mqarray *mqueueCB)
 {
     struct mqnotify *mqnotify = &mqueueCB->mq_notify;
 
-    if ((mqnotify->pid) && (mqueueCB->mqcb->readWriteableCnt[OS_QUEUE_READ] == 0)) {
+    if ((mqnotify->pid) && (mqueueCB->mqcb->curMsgs == 0)) {
         siginfo_t info;
 
         switch (mqnotify->notify.sigev_notify) {
@@ -756,105 +763,336 @@ static void MqSendNotify(struct mqarray *mqueueCB)
         errno = errcode;                 \
         goto ERROUT;                     \
     }
-int mq_timedsend(mqd_t personal, const char *msg, size_t msgLen, unsigned int msgPrio,
-                 const struct timespec *absTimeout)
+
+STATIC VOID MqueueMsgEnqueue(MqueueCB *mqcb, MqueueMsg *msg, BOOL head)
+{
+    if (head) {
+        LOS_ListAdd(&mqcb->prioList[msg->msgPrio], &msg->node);
+    } else {
+        LOS_ListTailInsert(&mqcb->prioList[msg->msgPrio], &msg->node);
+    }
+    mqcb->prioBitmap |= 1U << msg->msgPrio;
+    mqcb->curMsgs++;
+}
+
+STATIC MqueueMsg *MqueueMsgDequeue(MqueueCB *mqcb)
+{
+    UINT32 prio = MQ_PRIO_TOP(mqcb->prioBitmap);
+    MqueueMsg *msg = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&mqcb->prioList[prio]), MqueueMsg, node);
+
+    LOS_ListDelete(&msg->node);
+    if (LOS_ListEmpty(&mqcb->prioList[prio])) {
+        mqcb->prioBitmap &= ~(1U << prio);
+    }
+    mqcb->curMsgs--;
+    return msg;
+}
+
+/*
+ * Pend on the queue until a peer hands a message node over: a receiver
+ * passes a free node to a waiting sender, a sender passes a filled node
+ * to a waiting receiver.
+ */
+STATIC INT32 MqueueWait(MqueueCB *mqcb, UINT32 readWrite, UINT32 timeout, MqueueMsg **msg)
+{
+    LosTaskCB *runTask = OsCurrTaskGet();
+    UINT32 ret;
+
+    if (timeout == LOS_NO_WAIT) {
+        return EAGAIN;
+    }
+
+    if (OS_INT_ACTIVE) {
+        return EINTR;
+    }
+
+    if (!OsPreemptableInSched()) {
+        return EINVAL;
+    }
+
+    *msg = NULL;
+    OsTaskWaitSetPendMask(OS_TASK_WAIT_MQUEUE, (UINTPTR)msg, timeout);
+    ret = runTask->ops->wait(runTask, &mqcb->waitList[readWrite], timeout);
+    if (ret == LOS_ERRNO_TSK_TIMEOUT) {
+        return ETIMEDOUT;
+    }
+
+    /* woken up without a node, e.g. by a signal */
+    return (*msg == NULL) ? EINTR : ENOERR;
+}
+
+STATIC BOOL MqueueWakeWaiter(MqueueCB *mqcb, UINT32 readWrite, MqueueMsg *msg)
+{
+    LosTaskCB *resumedTask = NULL;
+
+    if (LOS_ListEmpty(&mqcb->waitList[readWrite])) {
+        return FALSE;
+    }
+
+    resumedTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&mqcb->waitList[readWrite]));
+    *(MqueueMsg **)resumedTask->waitID = msg;
+    OsTaskWakeClearPendMask(resumedTask);
+    resumedTask->ops->wake(resumedTask);
+    return TRUE;
+}
+
+/* Take up to *count free nodes, only waits when there is none. */
+STATIC INT32 MqueueMsgAlloc(MqueueCB *mqcb, MqueueMsg **msgs, UINT32 *count, UINT32 timeout)
+{
+    UINT32 num = 0;
+    UINT32 intSave;
+    INT32 err = ENOERR;
+
+    SCHEDULER_LOCK(intSave);
+    while ((num < *count) && !LOS_ListEmpty(&mqcb->freeList)) {
+        msgs[num] = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&mqcb->freeList), MqueueMsg, node);
+        LOS_ListDelete(&msgs[num]->node);
+        num++;
+    }
+
+    if (num == 0) {
+        err = MqueueWait(mqcb, MQ_WRITE, timeout, &msgs[0]);
+        num = (err == ENOERR) ? 1 : 0;
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    *count = num;
+    return err;
+}
+
+/* Take up to *count messages by priority, only waits when there is none. */
+STATIC INT32 MqueueMsgFetch(MqueueCB *mqcb, MqueueMsg **msgs, UINT32 *count, UINT32 timeout)
+{
+    UINT32 num = 0;
+    UINT32 intSave;
+    INT32 err = ENOERR;
+
+    SCHEDULER_LOCK(intSave);
+    while ((num < *count) && (mqcb->prioBitmap != 0)) {
+        msgs[num] = MqueueMsgDequeue(mqcb);
+        num++;
+    }
+
+    if (num == 0) {
+        err = MqueueWait(mqcb, MQ_READ, timeout, &msgs[0]);
+        num = (err == ENOERR) ? 1 : 0;
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    *count = num;
+    return err;
+}
+
+STATIC VOID MqueueMsgPost(MqueueCB *mqcb, MqueueMsg **msgs, UINT32 count, BOOL head)
+{
+    BOOL needSched = FALSE;
+    UINT32 intSave;
+    UINT32 index;
+
+    if (count == 0) {
+        return;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    for (index = 0; index < count; index++) {
+        /* put back at the head in reverse order to keep the fifo order */
+        MqueueMsg *msg = head ? msgs[count - index - 1] : msgs[index];
+        if (MqueueWakeWaiter(mqcb, MQ_READ, msg)) {
+            needSched = TRUE;
+        } else {
+            MqueueMsgEnqueue(mqcb, msg, head);
+        }
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    if (needSched) {
+        OsSchedPreemptTargetNotify();
+        LOS_Schedule();
+    }
+}
+
+STATIC VOID MqueueMsgFree(MqueueCB *mqcb, MqueueMsg **msgs, UINT32 count)
+{
+    BOOL needSched = FALSE;
+    UINT32 intSave;
+    UINT32 index;
+
+    if (count == 0) {
+        return;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    for (index = 0; index < count; index++) {
+        if (MqueueWakeWaiter(mqcb, MQ_WRITE, msgs[index])) {
+            needSched = TRUE;
+        } else {
+            LOS_ListTailInsert(&mqcb->freeList, &msgs[index]->node);
+        }
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    if (needSched) {
+        OsSchedPreemptTargetNotify();
+        LOS_Schedule();
+    }
+}
+
+/*
+ * Look up the queue and pin it against mq_unlink/mq_close, the caller
+ * drops the busy count once the transfer is done.
+ */
+STATIC struct mqarray *MqueueGet(mqd_t personal, UINT32 readWrite, size_t msgLen,
+                                 const struct timespec *absTimeout, UINT64 *ticks)
 {
-    UINT32 mqueueID, err;
-    UINT64 absTicks;
     struct mqarray *mqueueCB = NULL;
     struct mqpersonal *privateMqPersonal = NULL;
-
-    OS_MQ_GOTO_ERROUT_IF(!MqParamCheck(personal, msg, msgLen), errno);
-    OS_MQ_GOTO_ERROUT_IF(msgPrio > (MQ_PRIO_MAX - 1), EINVAL);
+    UINT32 flags;
 
     (VOID)pthread_mutex_lock(&g_mqueueMutex);
     privateMqPersonal = MqGetPrivDataBuff(personal);
-
     OS_MQ_GOTO_ERROUT_UNLOCK_IF(privateMqPersonal == NULL || privateMqPersonal->mq_status != MQ_USE_MAGIC, EBADF);
 
     mqueueCB = privateMqPersonal->mq_posixdes;
-    OS_MQ_GOTO_ERROUT_UNLOCK_IF(msgLen > (size_t)(mqueueCB->mqcb->queueSize - sizeof(UINT32)), EMSGSIZE);
+    flags = (UINT32)privateMqPersonal->mq_flags;
+    if (readWrite == MQ_WRITE) {
+        OS_MQ_GOTO_ERROUT_UNLOCK_IF(msgLen > mqueueCB->mqcb->msgSize, EMSGSIZE);
+        OS_MQ_GOTO_ERROUT_UNLOCK_IF(((flags & (UINT32)O_WRONLY) != (UINT32)O_WRONLY) &&
+                                    ((flags & (UINT32)O_RDWR) != (UINT32)O_RDWR), EBADF);
+    } else {
+        OS_MQ_GOTO_ERROUT_UNLOCK_IF(msgLen < mqueueCB->mqcb->msgSize, EMSGSIZE);
+        OS_MQ_GOTO_ERROUT_UNLOCK_IF((flags & (UINT32)O_WRONLY) == (UINT32)O_WRONLY, EBADF);
+    }
 
-    OS_MQ_GOTO_ERROUT_UNLOCK_IF((((UINT32)privateMqPersonal->mq_flags & (UINT32)O_WRONLY) != (UINT32)O_WRONLY) &&
-                                (((UINT32)privateMqPersonal->mq_flags & (UINT32)O_RDWR) != (UINT32)O_RDWR),
-                                EBADF);
+    OS_MQ_GOTO_ERROUT_UNLOCK_IF(ConvertTimeout(privateMqPersonal->mq_flags, absTimeout, ticks) == -1, errno);
+    LOS_AtomicInc(&mqueueCB->mqcb->busy);
+    (VOID)pthread_mutex_unlock(&g_mqueueMutex);
+    return mqueueCB;
 
-    OS_MQ_GOTO_ERROUT_UNLOCK_IF(ConvertTimeout(privateMqPersonal->mq_flags, absTimeout, &absTicks) == -1, errno);
-    mqueueID = mqueueCB->mq_id;
+ERROUT_UNLOCK:
     (VOID)pthread_mutex_unlock(&g_mqueueMutex);
+    return NULL;
+}
 
-    if (LOS_ListEmpty(&mqueueCB->mqcb->readWriteList[OS_QUEUE_READ])) {
-        MqSendNotify(mqueueCB);
+int mq_timedsend_batch(mqd_t personal, const struct mq_msgvec *msgVec, unsigned int count,
+                       const struct timespec *absTimeout)
+{
+    MqueueMsg *msgs[MQ_BATCH_MAX];
+    struct mqarray *mqueueCB = NULL;
+    MqueueCB *mqcb = NULL;
+    size_t maxLen = 0;
+    UINT64 absTicks;
+    UINT32 num, index;
+    INT32 err;
+
+    OS_MQ_GOTO_ERROUT_IF((msgVec == NULL) || (count == 0), EINVAL);
+    num = (count > MQ_BATCH_MAX) ? MQ_BATCH_MAX : count;
+    for (index = 0; index < num; index++) {
+        OS_MQ_GOTO_ERROUT_IF(!MqParamCheck(personal, msgVec[index].msg, msgVec[index].msgLen), errno);
+        OS_MQ_GOTO_ERROUT_IF(msgVec[index].msgPrio > (MQ_PRIO_MAX - 1), EINVAL);
+        maxLen = (msgVec[index].msgLen > maxLen) ? msgVec[index].msgLen : maxLen;
     }
 
-    err = LOS_QueueWriteCopy(mqueueID, (VOID *)msg, (UINT32)msgLen, (UINT32)absTicks);
-    if (map_errno(err) != ENOERR) {
+    mqueueCB = MqueueGet(personal, MQ_WRITE, maxLen, absTimeout, &absTicks);
+    if (mqueueCB == NULL) {
         goto ERROUT;
     }
-    return 0;
-ERROUT_UNLOCK:
-    (VOID)pthread_mutex_unlock(&g_mqueueMutex);
+    mqcb = mqueueCB->mqcb;
+
+    if (LOS_ListEmpty(&mqcb->waitList[MQ_READ])) {
+        MqSendNotify(mqueueCB);
+    }
+
+    err = MqueueMsgAlloc(mqcb, msgs, &num, (UINT32)absTicks);
+    /* copy in outside of the scheduler lock, the user buffer may fault */
+    for (index = 0; index < num; index++) {
+        if (LOS_CopyToKernel(msgs[index]->data, mqcb->msgSize, msgVec[index].msg, msgVec[index].msgLen) != 0) {
+            err = EFAULT;
+            break;
+        }
+        msgs[index]->msgLen = (UINT32)msgVec[index].msgLen;
+        msgs[index]->msgPrio = msgVec[index].msgPrio;
+    }
+    MqueueMsgFree(mqcb, &msgs[index], num - index);
+    MqueueMsgPost(mqcb, msgs, index, FALSE);
+    LOS_AtomicDec(&mqcb->busy);
+
+    OS_MQ_GOTO_ERROUT_IF(index == 0, err);
+    return (int)index;
 ERROUT:
     return -1;
 }
 
-ssize_t mq_timedreceive(mqd_t personal, char *msg, size_t msgLen, unsigned int *msgPrio,
-                        const struct timespec *absTimeout)
+int mq_timedreceive_batch(mqd_t personal, struct mq_msgvec *msgVec, unsigned int count,
+                          const struct timespec *absTimeout)
 {
-    UINT32 mqueueID, err;
-    UINT32 receiveLen;
-    UINT64 absTicks;
+    MqueueMsg *msgs[MQ_BATCH_MAX];
     struct mqarray *mqueueCB = NULL;
-    struct mqpersonal *privateMqPersonal = NULL;
+    MqueueCB *mqcb = NULL;
+    size_t minLen = (size_t)-1;
+    UINT64 absTicks;
+    UINT32 num, index;
+    INT32 err;
 
-    if (!MqParamCheck(personal, msg, msgLen)) {
-        goto ERROUT;
+    OS_MQ_GOTO_ERROUT_IF((msgVec == NULL) || (count == 0), EINVAL);
+    num = (count > MQ_BATCH_MAX) ? MQ_BATCH_MAX : count;
+    for (index = 0; index < num; index++) {
+        OS_MQ_GOTO_ERROUT_IF(!MqParamCheck(personal, msgVec[index].msg, msgVec[index].msgLen), errno);
+        minLen = (msgVec[index].msgLen < minLen) ? msgVec[index].msgLen : minLen;
     }
 
-    if (msgPrio != NULL) {
-        *msgPrio = 0;
+    mqueueCB = MqueueGet(personal, MQ_READ, minLen, absTimeout, &absTicks);
+    if (mqueueCB == NULL) {
+        goto ERROUT;
     }
+    mqcb = mqueueCB->mqcb;
 
-    (VOID)pthread_mutex_lock(&g_mqueueMutex);
-    privateMqPersonal = MqGetPrivDataBuff(personal);
-    if (privateMqPersonal == NULL || privateMqPersonal->mq_status != MQ_USE_MAGIC) {
-        errno = EBADF;
-        goto ERROUT_UNLOCK;
+    err = MqueueMsgFetch(mqcb, msgs, &num, (UINT32)absTicks);
+    for (index = 0; index < num; index++) {
+        if (LOS_CopyFromKernel(msgVec[index].msg, msgVec[index].msgLen, msgs[index]->data, msgs[index]->msgLen) != 0) {
+            err = EFAULT;
+            break;
+        }
+        msgVec[index].msgLen = msgs[index]->msgLen;
+        msgVec[index].msgPrio = msgs[index]->msgPrio;
     }
+    /* the messages not delivered go back to the front of the queue */
+    MqueueMsgPost(mqcb, &msgs[index], num - index, TRUE);
+    MqueueMsgFree(mqcb, msgs, index);
+    LOS_AtomicDec(&mqcb->busy);
 
-    mqueueCB = privateMqPersonal->mq_posixdes;
-    if (msgLen < (size_t)(mqueueCB->mqcb->queueSize - sizeof(UINT32))) {
-        errno = EMSGSIZE;
-        goto ERROUT_UNLOCK;
-    }
+    OS_MQ_GOTO_ERROUT_IF(index == 0, err);
+    return (int)index;
+ERROUT:
+    return -1;
+}
 
-    if (((UINT32)privateMqPersonal->mq_flags & (UINT32)O_WRONLY) == (UINT32)O_WRONLY) {
-        errno = EBADF;
-        goto ERROUT_UNLOCK;
-    }
+int mq_timedsend(mqd_t personal, const char *msg, size_t msgLen, unsigned int msgPrio,
+                 const struct timespec *absTimeout)
+{
+    struct mq_msgvec msgVec = { (char *)msg, msgLen, msgPrio };
 
-    if (ConvertTimeout(privateMqPersonal->mq_flags, absTimeout, &absTicks) == -1) {
-        goto ERROUT_UNLOCK;
-    }
+    return (mq_timedsend_batch(personal, &msgVec, 1, absTimeout) == 1) ? 0 : -1;
+}
 
-    receiveLen = msgLen;
-    mqueueID = mqueueCB->mq_id;
-    (VOID)pthread_mutex_unlock(&g_mqueueMutex);
+ssize_t mq_timedreceive(mqd_t personal, char *msg, size_t msgLen, unsigned int *msgPrio,
+                        const struct timespec *absTimeout)
+{
+    struct mq_msgvec msgVec = { msg, msgLen, 0 };
 
-    err = LOS_QueueReadCopy(mqueueID, (VOID *)msg, &receiveLen, (UINT32)absTicks);
-    if (map_errno(err) == ENOERR) {
-        return (ssize_t)receiveLen;
-    } else {
-        goto ERROUT;
+    if (msgPrio != NULL) {
+        *msgPrio = 0;
     }
 
-ERROUT_UNLOCK:
-    (VOID)pthread_mutex_unlock(&g_mqueueMutex);
-ERROUT:
-    return -1;
+    if (mq_timedreceive_batch(personal, &msgVec, 1, absTimeout) != 1) {
+        return -1;
+    }
+
+    if (msgPrio != NULL) {
+        *msgPrio = msgVec.msgPrio;
+    }
+    return (ssize_t)msgVec.msgLen;
 }
 
-/* not support the prio */
 int mq_send(mqd_t personal, const char *msg_ptr, size_t msg_len, unsigned int msg_prio)
 {
     return mq_timedsend(personal, msg_ptr, msg_len, msg_prio, NULL);
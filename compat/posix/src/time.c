@@ -41,6 +41,7 @@
 #include "los_signal.h"
 #ifdef LOSCFG_KERNEL_VDSO
 #include "los_vdso.h"
+#include "los_hw_tick_pri.h"
 #endif
 #ifdef LOSCFG_SECURITY_VID
 #include "vid_api.h"
@@ -1118,6 +1119,8 @@ int getitimer(int which, struct itimerval *value)
 VOID OsVdsoTimeGet(VdsoDataPage *vdsoDataPage)
 {
     UINT32 intSave;
+    UINT64 cycle;
+    UINT64 nowNsec;
     struct timespec64 tmp = {0};
     struct timespec64 hwTime = {0};
 
@@ -1125,7 +1128,12 @@ VOID OsVdsoTimeGet(VdsoDataPage *vdsoDataPage)
         return;
     }
 
-    OsGetHwTime(&hwTime);
+    /* user mode extrapolates from this counter value, so the timeval must be derived from the same read */
+    cycle = HalClockGetCycles();
+    nowNsec = OsCycle2Nanosec(cycle);
+    hwTime.tv_sec = nowNsec / OS_SYS_NS_PER_SECOND;
+    hwTime.tv_nsec = nowNsec - hwTime.tv_sec * OS_SYS_NS_PER_SECOND;
+    vdsoDataPage->cycleLast = cycle;
 
     LOS_SpinLockSave(&g_timeSpin, &intSave);
     tmp = OsTimeSpecAdd(hwTime, g_accDeltaFromAdj);
@@ -879,6 +879,9 @@ int fatfs_fsync(struct file *filep)
     FRESULT result;
     int ret;
 
+#ifdef LOSCFG_FS_FAT_PAGE_CACHE
+    OsFileCacheFlush(&filep->f_vnode->mapping);
+#endif
     ret = lock_fs(fs);
     if (ret == FALSE) {
         return -EBUSY;
@@ -991,7 +994,7 @@ int fatfs_fallocate(struct file *filep, int mode, off_t offset, off_t len)
     return fatfs_fallocate64(filep, mode, offset, len);
 }
 
-int fatfs_truncate64(struct Vnode *vp, off64_t len)
+static int fatfs_truncate_locked(struct Vnode *vp, off64_t len)
 {
     FATFS *fs = (FATFS *)vp->originMount->data;
     DIR_FILE *dfp = (DIR_FILE *)vp->data;
@@ -1001,10 +1004,6 @@ int fatfs_truncate64(struct Vnode *vp, off64_t len)
     FRESULT result = FR_OK;
     int ret;
 
-    if (len < 0 || len >= FAT32_MAXSIZE) {
-        return -EINVAL;
-    }
-
     ret = lock_fs(fs);
     if (ret == FALSE) {
         result = FR_TIMEOUT;
@@ -1014,6 +1013,12 @@ int fatfs_truncate64(struct Vnode *vp, off64_t len)
         unlock_fs(fs, FR_OK);
         return 0;
     }
+#ifdef LOSCFG_FS_FAT_PAGE_CACHE
+    if (len < finfo->fsize) {
+        /* cached data past the new end must not come back when the file grows again */
+        OsFileCacheTruncate(&vp->mapping, (off_t)len);
+    }
+#endif
 
     object.fs = fs;
     result = realloc_cluster(finfo, &object, (FSIZE_t)len);
@@ -1034,6 +1039,25 @@ ERROR_OUT:
     return -fatfs_2_vfs(result);
 }
 
+int fatfs_truncate64(struct Vnode *vp, off64_t len)
+{
+    int ret;
+
+    if (len < 0 || len >= FAT32_MAXSIZE) {
+        return -EINVAL;
+    }
+
+#ifdef LOSCFG_FS_FAT_PAGE_CACHE
+    /* same order as a buffered write, which may grow the file from under the mapping lock */
+    (void)LOS_MuxAcquire(&vp->mapping.mux_lock);
+    ret = fatfs_truncate_locked(vp, len);
+    (void)LOS_MuxRelease(&vp->mapping.mux_lock);
+#else
+    ret = fatfs_truncate_locked(vp, len);
+#endif
+    return ret;
+}
+
 int fatfs_truncate(struct Vnode *vp, off_t len)
 {
     return fatfs_truncate64(vp, len);
@@ -1997,6 +2021,10 @@ int fatfs_unlink(struct Vnode *parent, struct Vnode *vp, const char *name)
         result = FR_IS_DIR;
         goto ERROR_OUT;
     }
+#ifdef LOSCFG_FS_FAT_PAGE_CACHE
+    /* the clusters are released below, nothing may be written back to them */
+    OsFileCacheDropDirty(&vp->mapping);
+#endif
     ret = lock_fs(fs);
     if (ret == FALSE) {
         result = FR_TIMEOUT;
@@ -2318,6 +2346,7 @@ ssize_t fatfs_writepage(struct Vnode *vnode, char *buff, off_t pos, size_t bufle
     QWORD sect;
     QWORD step;
     QWORD n;
+    QWORD nsect;
     size_t position; /* byte offset */
     BYTE *buf = (BYTE *)buff;
     FRESULT result;
@@ -2361,22 +2390,23 @@ ssize_t fatfs_writepage(struct Vnode *vnode, char *buff, off_t pos, size_t bufle
     sect = clst2sect(fs, clust);
     sect += (pos / SS(fs)) & (fs->csize - 1);
 
-    /* How many sectors do we need to read once */
-    if (fs->csize < buflen / SS(fs)) {
+    /* a partial last sector is written whole, the page buffer covers it */
+    nsect = (buflen + SS(fs) - 1) / SS(fs);
+    if (fs->csize < nsect) {
         step = fs->csize;
     } else {
-        step = buflen / SS(fs);
+        step = nsect;
     }
 
     n = 0;
     sclst = clust;
-    while (n < buflen / SS(fs)) {
+    while (n < nsect) {
         if (disk_write(fs->pdrv, buf, sect, step) != RES_OK) {
             result = FR_DISK_ERR;
             goto ERROR_UNLOCK;
         }
         n += step;
-        if (n >= buflen / SS(fs)) {
+        if (n >= nsect) {
             break;
         }
 
@@ -2444,8 +2474,13 @@ struct MountOps fatfs_mops = {
 
 struct file_operations_vfs fatfs_fops = {
     .open = fatfs_open,
+#ifdef LOSCFG_FS_FAT_PAGE_CACHE
+    .read = VfsGenericFileRead,
+    .write = VfsGenericFileWrite,
+#else
     .read = fatfs_read,
     .write = fatfs_write,
+#endif
     .seek = fatfs_lseek,
     .close = fatfs_close,
     .mmap = OsVfsFileMmap,
@@ -70,6 +70,11 @@ void ClearCloexecFlag(int procFd);
 
 void clear_fd(int fd);
 
+struct iovec;
+/* regular files take readv/writev iovec by iovec, without a bounce buffer of the whole request */
+bool vfs_iov_direct_able(int fd);
+ssize_t vfs_iov_direct(int fd, const struct iovec *iov, int iovcnt, off_t *offset, bool toUser);
+
 /**
  * @ingroup  fs
  * @brief    locate character in string.
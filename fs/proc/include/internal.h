@@ -67,6 +67,8 @@ extern void ProcFsCacheInit(void);
 
 extern void ProcFdInit(void);
 
+extern void ProcSlabInfoInit(void);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -99,20 +99,37 @@ static int PathCacheListProcess(struct SeqBuf *buf)
     return count;
 }
 
-static int PageCacheEntryProcess(struct SeqBuf *buf, struct page_mapping *mapping)
+static int PageCacheEntryProcess(struct SeqBuf *buf, struct Vnode *vnode)
 {
     int total = 0;
-    LosFilePage *fpage = NULL;
+    VM_OFFSET_T pgoff = 0;
+    VM_OFFSET_T offsets[PAGE_CACHE_GANG_SIZE];
+    LosFilePage *pages[PAGE_CACHE_GANG_SIZE];
+    struct page_mapping *mapping = &vnode->mapping;
+    unsigned int num, i;
+    uint32_t intSave;
 
     if (mapping->nrpages == 0) {
         LosBufPrintf(buf, "null]\n");
         return total;
     }
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        LosBufPrintf(buf, "%d,", fpage->pgoff);
-        total++;
-    }
+    do {
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        num = LOS_RadixTreeGangLookup(&vnode->pageTree, (void **)pages, pgoff, PAGE_CACHE_GANG_SIZE);
+        for (i = 0; i < num; i++) {
+            offsets[i] = pages[i]->pgoff;
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+        for (i = 0; i < num; i++) {
+            LosBufPrintf(buf, "%d,", offsets[i]);
+            total++;
+        }
+        if (num > 0) {
+            pgoff = offsets[num - 1] + 1;
+        }
+    } while (num == PAGE_CACHE_GANG_SIZE);
     LosBufPrintf(buf, "]\n");
     return total;
 }
@@ -120,15 +137,13 @@ static int PageCacheEntryProcess(struct SeqBuf *buf, struct page_mapping *mappin
 static int PageCacheMapProcess(struct SeqBuf *buf)
 {
     LIST_HEAD *vnodeList = GetVnodeActiveList();
-    struct page_mapping *mapping = NULL;
     struct Vnode *vnode = NULL;
     int total = 0;
 
     VnodeHold();
     LOS_DL_LIST_FOR_EACH_ENTRY(vnode, vnodeList, struct Vnode, actFreeEntry) {
-        mapping = &vnode->mapping;
         LosBufPrintf(buf, "%p, %s:[", vnode, vnode->filePath);
-        total += PageCacheEntryProcess(buf, mapping);
+        total += PageCacheEntryProcess(buf, vnode);
     }
     VnodeDrop();
     return total;
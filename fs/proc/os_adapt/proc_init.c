@@ -65,6 +65,7 @@ void ProcFsInit(void)
     ProcUptimeInit();
     ProcFsCacheInit();
     ProcFdInit();
+    ProcSlabInfoInit();
 #ifdef LOSCFG_KERNEL_PM
     ProcPmInit();
 #endif
@@ -34,19 +34,53 @@
 #include <errno.h>
 #include <string.h>
 #include "pthread.h"
+#include "los_event.h"
+#include "los_mux.h"
+#include "los_rbtree.h"
+#include "los_spinlock.h"
+#include "los_sys.h"
+#include "vfs_config.h"
+#ifdef LOSCFG_NET_LWIP_SACK
+#include "lwip/sockets.h"
+#endif
+
+#define EPOLL_EVENT_READY 0x1
+#define EPOLL_EVENT_CLOSED 0x2
 
-/* 100, the number of fd one epollfd can control */
-#define EPOLL_DEFAULT_SIZE 100
+/* ticks a waiter sleeps before it polls again the fds that have no readiness source */
+#define EPOLL_POLL_SLICE 10
+
+/* flags that are not events, a oneshot item keeps only these once it fired */
+#define EPOLL_PRIVATE_BITS (EPOLLET | EPOLLONESHOT | EPOLLEXCLUSIVE)
 
 /* Internal data, used to manage each epoll fd */
 struct epoll_head {
-    int size;
-    int nodeCount;
-    struct epoll_event *evs;
+    LosRbTree tree;             /* interest set, keyed by fd */
+    LOS_DL_LIST readyList;      /* items with pending events, protected by g_epollSpin */
+    LOS_DL_LIST pollList;       /* items without a readiness source */
+    EVENT_CB_S event;
+    LosMux lock;                /* protects the tree and the items of this instance */
+    UINT32 refCount;            /* the fd and every call inside the instance, protected by g_epollMutex */
+    BOOL closed;                /* the fd is closed, set with lock held */
+};
+
+struct epoll_item {
+    LosRbNode node;             /* must be the first member */
+    int fd;
+    UINT32 events;
+    epoll_data_t data;
+    UINT32 revents;             /* events noticed by the source, protected by g_epollSpin */
+    LOS_DL_LIST readyEntry;
+    LOS_DL_LIST sourceEntry;    /* on source->items, or on pollList of the head */
+    struct epoll_source *source;
+    struct epoll_head *head;
 };
 
 STATIC pthread_mutex_t g_epollMutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 
+/* protects readiness sources, ready lists and item->source */
+LITE_OS_SEC_BSS STATIC SPIN_LOCK_INIT(g_epollSpin);
+
 #ifndef MAX_EPOLL_FD
 #define MAX_EPOLL_FD CONFIG_EPOLL_DESCRIPTORS
 #endif
@@ -125,38 +159,248 @@ static struct epoll_head *EpollGetDataBuff(int fd)
     return g_epPrivBuf[id];
 }
 
+/* the instance of fd with a reference taken, NULL with EBADF set if fd is not an epoll fd */
+static struct epoll_head *EpollHeadGet(int fd)
+{
+    struct epoll_head *epHead = NULL;
+
+    (VOID)pthread_mutex_lock(&g_epollMutex);
+    epHead = EpollGetDataBuff(fd);
+    if (epHead != NULL) {
+        epHead->refCount++;
+    } else {
+        set_errno(EBADF);
+    }
+    (VOID)pthread_mutex_unlock(&g_epollMutex);
+    return epHead;
+}
+
+static VOID DoEpollClose(struct epoll_head *epHead);
+
+static VOID EpollHeadPut(struct epoll_head *epHead)
+{
+    (VOID)pthread_mutex_lock(&g_epollMutex);
+    if (--epHead->refCount == 0) {
+        DoEpollClose(epHead);
+    }
+    (VOID)pthread_mutex_unlock(&g_epollMutex);
+}
+
+static ULONG_T EpollItemCmpKey(const VOID *keyA, const VOID *keyB)
+{
+    int fdA = *(const int *)keyA;
+    int fdB = *(const int *)keyB;
+
+    if (fdA > fdB) {
+        return RB_BIGGER;
+    } else if (fdA < fdB) {
+        return RB_SMALLER;
+    }
+    return RB_EQUAL;
+}
+
+static VOID *EpollItemGetKey(LosRbNode *node)
+{
+    return &((struct epoll_item *)node)->fd;
+}
+
+static struct epoll_item *EpollItemFind(struct epoll_head *epHead, int fd)
+{
+    LosRbNode *node = NULL;
+
+    if (LOS_RbGetNode(&epHead->tree, &fd, &node)) {
+        return (struct epoll_item *)node;
+    }
+    return NULL;
+}
+
 /**
- * when do EPOLL_CTL_ADD, need check if fd exist
- *
- * @param epHead: epoll control head, find by epoll id .
- * @param fd: ctl add fd.
- * @return 0 or -1
+ * readiness source of fd, sockets feed epoll from the network stack,
+ * other fds return NULL and are polled on each wait
  */
-static int CheckFdExist(struct epoll_head *epHead, int fd)
+static struct epoll_source *EpollGetSource(int fd)
 {
-    int i;
-    for (i = 0; i < epHead->nodeCount; i++) {
-        if (epHead->evs[i].data.fd == fd) {
-            return -1;
+#ifdef LOSCFG_NET_LWIP_SACK
+    if ((fd >= CONFIG_NFILE_DESCRIPTORS) && (fd < (CONFIG_NFILE_DESCRIPTORS + CONFIG_NSOCKET_DESCRIPTORS))) {
+        return socks_epoll_source(fd);
+    }
+#endif
+    (void)fd;
+    return NULL;
+}
+
+static UINT32 EpollItemPoll(const struct epoll_item *item)
+{
+    struct pollfd pfd;
+
+    if (item->source != NULL) {
+        return item->source->poll(item->fd);
+    }
+
+    pfd.fd = item->fd;
+    pfd.events = (short)(item->events & ~EPOLL_PRIVATE_BITS);
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 0) <= 0) {
+        return 0;
+    }
+    return (UINT32)(unsigned short)pfd.revents;
+}
+
+/* called with g_epollSpin held */
+static VOID EpollItemReady(struct epoll_item *item, UINT32 events)
+{
+    item->revents |= events;
+    if (LOS_ListEmpty(&item->readyEntry)) {
+        LOS_ListTailInsert(&item->head->readyList, &item->readyEntry);
+    }
+    (VOID)LOS_EventWrite(&item->head->event, EPOLL_EVENT_READY);
+}
+
+VOID epoll_source_init(struct epoll_source *src, UINT32 (*pollFn)(int fd))
+{
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&g_epollSpin, &intSave);
+    LOS_ListInit(&src->items);
+    src->poll = pollFn;
+    LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+}
+
+/**
+ * Feed events of an object to the epoll items watching it. Of the items registered with
+ * EPOLLEXCLUSIVE only one is woken, and the next notification goes to the next one.
+ */
+VOID epoll_source_notify(struct epoll_source *src, UINT32 events)
+{
+    struct epoll_item *item = NULL;
+    struct epoll_item *exclusive = NULL;
+    UINT32 ready;
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&g_epollSpin, &intSave);
+    if (src->items.pstNext == NULL) {
+        LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+        return;
+    }
+
+    LOS_DL_LIST_FOR_EACH_ENTRY(item, &src->items, struct epoll_item, sourceEntry) {
+        ready = events & item->events & ~EPOLL_PRIVATE_BITS;
+        if (ready == 0) {
+            continue;
+        }
+        if (item->events & EPOLLEXCLUSIVE) {
+            if (exclusive != NULL) {
+                continue;
+            }
+            exclusive = item;
         }
+        EpollItemReady(item, ready);
     }
 
-    return 0;
+    if (exclusive != NULL) {
+        LOS_ListDelete(&exclusive->sourceEntry);
+        LOS_ListTailInsert(&src->items, &exclusive->sourceEntry);
+    }
+    LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+}
+
+/* called with g_epollSpin held */
+static struct epoll_item *EpollSourceItemFind(struct epoll_source *src, const struct epoll_head *epHead)
+{
+    struct epoll_item *item = NULL;
+
+    if (src->items.pstNext == NULL) {
+        return NULL;
+    }
+    LOS_DL_LIST_FOR_EACH_ENTRY(item, &src->items, struct epoll_item, sourceEntry) {
+        if (item->head == epHead) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * The object goes away, drop every epoll item watching it like close() does on Linux.
+ * Must not be called with the network stack protection held.
+ */
+VOID epoll_source_release(struct epoll_source *src)
+{
+    struct epoll_item *item = NULL;
+    struct epoll_head *epHead = NULL;
+    UINT32 intSave;
+
+    (VOID)pthread_mutex_lock(&g_epollMutex);
+    for (;;) {
+        LOS_SpinLockSave(&g_epollSpin, &intSave);
+        if ((src->items.pstNext == NULL) || LOS_ListEmpty(&src->items)) {
+            LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+            break;
+        }
+        item = LOS_DL_LIST_ENTRY(src->items.pstNext, struct epoll_item, sourceEntry);
+        epHead = item->head;
+        LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+
+        /*
+         * the instance stays alive, closing it also takes g_epollMutex. The item may have been
+         * deleted before its lock was taken, so look again for one of this instance.
+         */
+        (VOID)LOS_MuxLock(&epHead->lock, LOS_WAIT_FOREVER);
+        LOS_SpinLockSave(&g_epollSpin, &intSave);
+        item = EpollSourceItemFind(src, epHead);
+        if (item != NULL) {
+            LOS_ListDelInit(&item->sourceEntry);
+            LOS_ListDelInit(&item->readyEntry);
+            item->source = NULL;
+            LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+            LOS_RbDelNode(&epHead->tree, &item->node);
+            free(item);
+        } else {
+            LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+        }
+        (VOID)LOS_MuxUnlock(&epHead->lock);
+    }
+    (VOID)pthread_mutex_unlock(&g_epollMutex);
+}
+
+/* called with the instance lock held */
+static VOID EpollItemDetach(struct epoll_item *item)
+{
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&g_epollSpin, &intSave);
+    LOS_ListDelete(&item->sourceEntry);
+    LOS_ListDelInit(&item->readyEntry);
+    item->source = NULL;
+    LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+}
+
+static VOID EpollItemFree(struct epoll_head *epHead, struct epoll_item *item)
+{
+    EpollItemDetach(item);
+    LOS_RbDelNode(&epHead->tree, &item->node);
+    free(item);
 }
 
 /**
- * close epoll
+ * close epoll, once nobody is left inside the instance
  *
  * @param epHead: epoll control head.
  * @return void
  */
 static VOID DoEpollClose(struct epoll_head *epHead)
 {
+    struct epoll_item *item = NULL;
+
     if (epHead != NULL) {
-        if (epHead->evs != NULL) {
-            free(epHead->evs);
+        (VOID)LOS_MuxLock(&epHead->lock, LOS_WAIT_FOREVER);
+        while ((item = (struct epoll_item *)LOS_RbFirstNode(&epHead->tree)) != NULL) {
+            EpollItemFree(epHead, item);
         }
+        (VOID)LOS_MuxUnlock(&epHead->lock);
 
+        (VOID)LOS_MuxDestroy(&epHead->lock);
+        (VOID)LOS_EventDestroy(&epHead->event);
         free(epHead);
     }
 
@@ -169,9 +413,7 @@ static VOID DoEpollClose(struct epoll_head *epHead)
  * epoll_create is implemented by calling epoll_create1, it's parameter 'size' is useless.
  *
  * epoll_create1,
- * The simple version of epoll does not use red-black trees,
- * so when fd is normal value (greater than 0),
- * actually allocated epoll can manage num of EPOLL_DEFAULT_SIZE
+ * registered fds are kept in a red-black tree, so there is no limit besides memory.
  *
  * @param flags: not actually used
  * @return epoll fd
@@ -187,11 +429,18 @@ int epoll_create1(int flags)
         return fd;
     }
 
-    /* actually allocated epoll can manage num is EPOLL_DEFAULT_SIZE */
-    epHead->size = EPOLL_DEFAULT_SIZE;
-    epHead->nodeCount = 0;
-    epHead->evs = malloc(sizeof(struct epoll_event) * EPOLL_DEFAULT_SIZE);
-    if (epHead->evs == NULL) {
+    LOS_RbInitTree(&epHead->tree, EpollItemCmpKey, NULL, EpollItemGetKey);
+    LOS_ListInit(&epHead->readyList);
+    LOS_ListInit(&epHead->pollList);
+    epHead->refCount = 1;
+    epHead->closed = FALSE;
+    if (LOS_EventInit(&epHead->event) != LOS_OK) {
+        free(epHead);
+        set_errno(ENOMEM);
+        return fd;
+    }
+    if (LOS_MuxInit(&epHead->lock, NULL) != LOS_OK) {
+        (VOID)LOS_EventDestroy(&epHead->event);
         free(epHead);
         set_errno(ENOMEM);
         return fd;
@@ -219,134 +468,286 @@ int epoll_create1(int flags)
 int epoll_close(int epfd)
 {
     struct epoll_head *epHead = NULL;
+    int ret;
 
+    (VOID)pthread_mutex_lock(&g_epollMutex);
     epHead = EpollGetDataBuff(epfd);
     if (epHead == NULL) {
+        (VOID)pthread_mutex_unlock(&g_epollMutex);
         set_errno(EBADF);
         return -1;
     }
 
-    DoEpollClose(epHead);
-    return EpollFreeSysFd(epfd);
+    ret = EpollFreeSysFd(epfd);
+
+    /* wake the waiters, the last of them frees the instance */
+    (VOID)LOS_MuxLock(&epHead->lock, LOS_WAIT_FOREVER);
+    epHead->closed = TRUE;
+    (VOID)LOS_MuxUnlock(&epHead->lock);
+    (VOID)LOS_EventWrite(&epHead->event, EPOLL_EVENT_CLOSED);
+    EpollHeadPut(epHead);
+    (VOID)pthread_mutex_unlock(&g_epollMutex);
+    return ret;
+}
+
+static int EpollCtlAdd(struct epoll_head *epHead, int fd, const struct epoll_event *ev)
+{
+    struct epoll_item *item = NULL;
+    struct epoll_source *src = NULL;
+    UINT32 ready;
+    UINT32 intSave;
+
+    if (EpollItemFind(epHead, fd) != NULL) {
+        set_errno(EEXIST);
+        return -1;
+    }
+
+    item = (struct epoll_item *)malloc(sizeof(struct epoll_item));
+    if (item == NULL) {
+        set_errno(ENOMEM);
+        return -1;
+    }
+    (VOID)memset_s(item, sizeof(struct epoll_item), 0, sizeof(struct epoll_item));
+    item->fd = fd;
+    item->events = ev->events | EPOLLERR | EPOLLHUP;
+    item->data = ev->data;
+    item->head = epHead;
+    LOS_ListInit(&item->readyEntry);
+    (VOID)LOS_RbAddNode(&epHead->tree, &item->node);
+
+    src = EpollGetSource(fd);
+    LOS_SpinLockSave(&g_epollSpin, &intSave);
+    item->source = src;
+    if (src != NULL) {
+        LOS_ListTailInsert(&src->items, &item->sourceEntry);
+    } else {
+        LOS_ListTailInsert(&epHead->pollList, &item->sourceEntry);
+    }
+    LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+
+    /* events already pending are reported without waiting for the next change */
+    if (src != NULL) {
+        ready = EpollItemPoll(item) & item->events & ~EPOLL_PRIVATE_BITS;
+        if (ready != 0) {
+            LOS_SpinLockSave(&g_epollSpin, &intSave);
+            EpollItemReady(item, ready);
+            LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+        }
+    }
+    return 0;
+}
+
+static int EpollCtlMod(struct epoll_head *epHead, int fd, const struct epoll_event *ev)
+{
+    struct epoll_item *item = EpollItemFind(epHead, fd);
+    UINT32 ready;
+    UINT32 intSave;
+
+    if (item == NULL) {
+        set_errno(ENOENT);
+        return -1;
+    }
+
+    LOS_SpinLockSave(&g_epollSpin, &intSave);
+    item->events = ev->events | EPOLLERR | EPOLLHUP;
+    item->data = ev->data;
+    LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+
+    /* a rearmed oneshot item or a wider mask may already be satisfied */
+    if (item->source != NULL) {
+        ready = EpollItemPoll(item) & item->events & ~EPOLL_PRIVATE_BITS;
+        if (ready != 0) {
+            LOS_SpinLockSave(&g_epollSpin, &intSave);
+            EpollItemReady(item, ready);
+            LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+        }
+    }
+    return 0;
 }
 
 int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
 {
     struct epoll_head *epHead = NULL;
-    int i;
+    struct epoll_item *item = NULL;
     int ret = -1;
 
-    epHead = EpollGetDataBuff(epfd);
-    if (epHead == NULL) {
-        set_errno(EBADF);
-        return ret;
+    if ((ev == NULL) && (op != EPOLL_CTL_DEL)) {
+        set_errno(EINVAL);
+        return -1;
     }
 
-    if (ev == NULL) {
+    if ((ev != NULL) && (ev->events & EPOLLEXCLUSIVE) && (op == EPOLL_CTL_MOD)) {
         set_errno(EINVAL);
         return -1;
     }
 
+    epHead = EpollHeadGet(epfd);
+    if (epHead == NULL) {
+        return ret;
+    }
+
+    (VOID)LOS_MuxLock(&epHead->lock, LOS_WAIT_FOREVER);
     switch (op) {
         case EPOLL_CTL_ADD:
-            ret = CheckFdExist(epHead, fd);
-            if (ret == -1) {
-                set_errno(EEXIST);
-                return -1;
-            }
-
-            if (epHead->nodeCount == EPOLL_DEFAULT_SIZE) {
-                set_errno(ENOMEM);
-                return -1;
-            }
-
-            epHead->evs[epHead->nodeCount].events = ev->events | POLLERR | POLLHUP;
-            epHead->evs[epHead->nodeCount].data.fd = fd;
-            epHead->nodeCount++;
-            return 0;
+            ret = EpollCtlAdd(epHead, fd, ev);
+            break;
         case EPOLL_CTL_DEL:
-            for (i = 0; i < epHead->nodeCount; i++) {
-                if (epHead->evs[i].data.fd != fd) {
-                    continue;
-                }
-
-                if (i != epHead->nodeCount - 1) {
-                    memmove_s(&epHead->evs[i], epHead->nodeCount - i, &epHead->evs[i + 1],
-                              epHead->nodeCount - i);
-                }
-                epHead->nodeCount--;
-                return 0;
+            item = EpollItemFind(epHead, fd);
+            if (item == NULL) {
+                set_errno(ENOENT);
+                break;
             }
-            set_errno(ENOENT);
-            return -1;
+            EpollItemFree(epHead, item);
+            ret = 0;
+            break;
         case EPOLL_CTL_MOD:
-            for (i = 0; i < epHead->nodeCount; i++) {
-                if (epHead->evs[i].data.fd == fd) {
-                    epHead->evs[i].events = ev->events | POLLERR | POLLHUP;
-                    return 0;
-                }
-            }
-            set_errno(ENOENT);
-            return -1;
+            ret = EpollCtlMod(epHead, fd, ev);
+            break;
         default:
             set_errno(EINVAL);
-            return -1;
+            break;
     }
+    (VOID)LOS_MuxUnlock(&epHead->lock);
+    EpollHeadPut(epHead);
+    return ret;
 }
 
-int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents, int timeout)
+static int EpollReport(struct epoll_item *item, UINT32 revents, FAR struct epoll_event *ev)
 {
-    struct epoll_head *epHead = NULL;
-    int ret;
-    int counter;
-    int i;
-    struct pollfd *pFd = NULL;
-    int pollSize;
+    revents &= item->events & ~EPOLL_PRIVATE_BITS;
+    if (revents == 0) {
+        return 0;
+    }
 
-    epHead = EpollGetDataBuff(epfd);
-    if (epHead== NULL) {
-        set_errno(EBADF);
-        return -1;
+    ev->events = revents;
+    ev->data = item->data;
+    if (item->events & EPOLLONESHOT) {
+        item->events &= EPOLL_PRIVATE_BITS;
     }
+    return 1;
+}
 
-    if ((maxevents <= 0) || (evs == NULL)) {
-        set_errno(EINVAL);
-        return -1;
+/**
+ * Collect events of the instance, called with its lock held. Only items on the ready list are
+ * looked at, plus the fds without a readiness source. A level triggered item stays on the ready
+ * list after it is reported and is dropped the first time its fd is found idle.
+ */
+static int EpollHarvest(struct epoll_head *epHead, FAR struct epoll_event *evs, int maxevents)
+{
+    LOS_DL_LIST requeue;
+    struct epoll_item *item = NULL;
+    UINT32 revents;
+    UINT32 intSave;
+    int count = 0;
+
+    LOS_ListInit(&requeue);
+    LOS_SpinLockSave(&g_epollSpin, &intSave);
+    while ((count < maxevents) && !LOS_ListEmpty(&epHead->readyList)) {
+        item = LOS_DL_LIST_ENTRY(epHead->readyList.pstNext, struct epoll_item, readyEntry);
+        LOS_ListDelInit(&item->readyEntry);
+        revents = item->revents;
+        item->revents = 0;
+
+        if (!(item->events & EPOLLET)) {
+            LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+            revents = EpollItemPoll(item);
+            LOS_SpinLockSave(&g_epollSpin, &intSave);
+            /* queued again by the source meanwhile, leave that for the next wait */
+            if (!LOS_ListEmpty(&item->readyEntry)) {
+                LOS_ListDelete(&item->readyEntry);
+                LOS_ListTailInsert(&requeue, &item->readyEntry);
+            }
+        }
+
+        if (!EpollReport(item, revents, &evs[count])) {
+            continue;
+        }
+        count++;
+
+        if (!(item->events & EPOLLET) && LOS_ListEmpty(&item->readyEntry)) {
+            LOS_ListTailInsert(&requeue, &item->readyEntry);
+        }
     }
 
-    if (maxevents > epHead->nodeCount) {
-        pollSize = epHead->nodeCount;
-    } else {
-        pollSize = maxevents;
+    while (!LOS_ListEmpty(&requeue)) {
+        item = LOS_DL_LIST_ENTRY(requeue.pstNext, struct epoll_item, readyEntry);
+        LOS_ListDelete(&item->readyEntry);
+        LOS_ListTailInsert(&epHead->readyList, &item->readyEntry);
+    }
+    LOS_SpinUnlockRestore(&g_epollSpin, intSave);
+
+    /* fds without a readiness source are level triggered only */
+    LOS_DL_LIST_FOR_EACH_ENTRY(item, &epHead->pollList, struct epoll_item, sourceEntry) {
+        if (count >= maxevents) {
+            break;
+        }
+        if ((item->events & ~EPOLL_PRIVATE_BITS) == 0) {
+            continue;
+        }
+        count += EpollReport(item, EpollItemPoll(item), &evs[count]);
     }
 
-    pFd = malloc(sizeof(struct pollfd) * pollSize);
-    if (pFd == NULL) {
+    return count;
+}
+
+int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents, int timeout)
+{
+    struct epoll_head *epHead = NULL;
+    UINT64 deadline = 0;
+    UINT64 now;
+    UINT32 ticks;
+    BOOL polled = FALSE;
+    BOOL closed = FALSE;
+    int ret;
+
+    if ((maxevents <= 0) || (evs == NULL)) {
         set_errno(EINVAL);
         return -1;
     }
 
-    for (i = 0; i < epHead->nodeCount; i++) {
-        pFd[i].fd = epHead->evs[i].data.fd;
-        pFd[i].events = (short)epHead->evs[i].events;
+    epHead = EpollHeadGet(epfd);
+    if (epHead == NULL) {
+        return -1;
     }
 
-
-    ret = poll(pFd, pollSize, timeout);
-    if (ret <= 0) {
-        free(pFd);
-        return 0;
+    if (timeout > 0) {
+        deadline = LOS_TickCountGet() + LOS_MS2Tick((UINT32)timeout);
     }
 
-    for (i = 0, counter = 0; i < ret && counter < pollSize; counter++) {
-        if (pFd[counter].revents != 0) {
-            evs[i].data.fd = pFd[counter].fd;
-            evs[i].events  = pFd[counter].revents;
-            i++;
+    for (;;) {
+        (VOID)LOS_MuxLock(&epHead->lock, LOS_WAIT_FOREVER);
+        closed = epHead->closed;
+        ret = closed ? 0 : EpollHarvest(epHead, evs, maxevents);
+        polled = !LOS_ListEmpty(&epHead->pollList);
+        (VOID)LOS_MuxUnlock(&epHead->lock);
+        if (closed) {
+            /* the read that woke us cleared the bit, pass it on to the other waiters */
+            (VOID)LOS_EventWrite(&epHead->event, EPOLL_EVENT_CLOSED);
+            set_errno(EBADF);
+            ret = -1;
+            break;
+        }
+        if ((ret > 0) || (timeout == 0)) {
+            break;
+        }
+
+        ticks = LOS_WAIT_FOREVER;
+        if (timeout > 0) {
+            now = LOS_TickCountGet();
+            if (now >= deadline) {
+                ret = 0;
+                break;
+            }
+            ticks = (UINT32)(deadline - now);
         }
+        if (polled && (ticks > EPOLL_POLL_SLICE)) {
+            ticks = EPOLL_POLL_SLICE;
+        }
+
+        (VOID)LOS_EventRead(&epHead->event, EPOLL_EVENT_READY | EPOLL_EVENT_CLOSED,
+                            LOS_WAITMODE_OR | LOS_WAITMODE_CLR, ticks);
     }
 
-    free(pFd);
-    return i;
+    EpollHeadPut(epHead);
+    return ret;
 }
-
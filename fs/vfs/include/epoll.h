@@ -32,6 +32,7 @@
 #define _FS_EPOLL_H_
 
 #include "los_typedef.h"
+#include "los_list.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,6 +56,10 @@ extern "C" {
 #define EPOLLMSG        0x400
 #define EPOLLERR        0x008
 #define EPOLLHUP        0x010
+#define EPOLLRDHUP      0x2000
+#define EPOLLEXCLUSIVE  (1U << 28)
+#define EPOLLONESHOT    (1U << 30)
+#define EPOLLET         (1U << 31)
 
 #define EPOLL_CTL_ADD 1
 #define EPOLL_CTL_DEL 2
@@ -72,6 +77,19 @@ struct epoll_event {
     epoll_data_t data;
 };
 
+/*
+ * Readiness source of a pollable object. The object embeds one and calls epoll_source_notify
+ * when its state changes, so epoll_wait never rescans it. Objects without a source are polled.
+ */
+struct epoll_source {
+    LOS_DL_LIST items;          /* epoll items watching this object */
+    UINT32 (*poll)(int fd);     /* current events of the object, must not block */
+};
+
+VOID epoll_source_init(struct epoll_source *src, UINT32 (*pollFn)(int fd));
+VOID epoll_source_notify(struct epoll_source *src, UINT32 events);
+VOID epoll_source_release(struct epoll_source *src);
+
 int epoll_create1(int flags);
 int epoll_close(int epfd);
 int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev);
@@ -32,6 +32,7 @@
 #define _PATH_CACHE_H
 
 #include "los_list.h"
+#include "los_rcu.h"
 #include "fs/mount.h"
 #include "vnode.h"
 
@@ -41,6 +42,7 @@ struct PathCache {
     LIST_ENTRY parentEntry;       /* list entry for cache list in the parent vnode */
     LIST_ENTRY childEntry;        /* list entry for cache list in the child vnode */
     LIST_ENTRY hashEntry;         /* list entry for buckets in the hash table */
+    LosRcuHead rcu;               /* deferred free after the lockless lookups */
     uint8_t nameLen;              /* length of path component */
 #ifdef LOSCFG_DEBUG_VERSION
     int hit;                      /* cache hit count */
@@ -52,6 +54,7 @@ int PathCacheInit(void);
 int PathCacheFree(struct PathCache *cache);
 struct PathCache *PathCacheAlloc(struct Vnode *parent, struct Vnode *vnode, const char *name, uint8_t len);
 int PathCacheLookup(struct Vnode *parent, const char *name, int len, struct Vnode **vnode);
+uint32_t PathCacheSeqGet(void);
 void VnodePathCacheFree(struct Vnode *vnode);
 void PathCacheMemoryDump(void);
 void PathCacheDump(void);
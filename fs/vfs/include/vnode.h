@@ -35,6 +35,7 @@
 #include "fs/fs_operation.h"
 #include "fs/file.h"
 #include "los_list.h"
+#include "los_radix_tree.h"
 
 typedef LOS_DL_LIST LIST_HEAD;
 typedef LOS_DL_LIST LIST_ENTRY;
@@ -127,6 +128,9 @@ struct Vnode {
     struct Mount *newMount;             /* fs info about who mount on this vnode */
     char *filePath;                     /* file path of the vnode */
     struct page_mapping mapping;        /* page mapping of the vnode */
+    LosRadixTree pageTree;              /* cached pages of the mapping, indexed by pgoff */
+    LIST_ENTRY dirtyEntry;              /* entry in the list of vnodes holding dirty cached pages */
+    uint32_t rcuSeq;                    /* grace period to wait before the freed vnode is reused */
 };
 
 struct VnodeOps {
@@ -164,6 +168,7 @@ int VnodeAlloc(struct VnodeOps *vop, struct Vnode **vnode);
 int VnodeFree(struct Vnode *vnode);
 int VnodeLookup(const char *path, struct Vnode **vnode, uint32_t flags);
 int VnodeLookupFullpath(const char *fullpath, struct Vnode **vnode, uint32_t flags);
+int VnodeLookupHold(const char *path, struct Vnode **vnode, uint32_t flags);
 int VnodeLookupAt(const char *path, struct Vnode **vnode, uint32_t flags, struct Vnode *orgVnode);
 int VnodeHold(void);
 int VnodeDrop(void);
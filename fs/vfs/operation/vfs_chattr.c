@@ -65,8 +65,7 @@ int chattr(const char *pathname, struct IATTR *attr)
         return VFS_ERROR;
     }
 
-    VnodeHold();
-    ret = VnodeLookup(pathname, &vnode, 0);
+    ret = VnodeLookupHold(pathname, &vnode, 0);
     if (ret != LOS_OK) {
         goto errout_with_lock;
     }
@@ -54,8 +54,7 @@ int fscheck(const char *path)
     struct fs_dirent_s *dir = NULL;
 
     /* Find the node matching the path. */
-    VnodeHold();
-    ret = VnodeLookup(path, &vnode, 0);
+    ret = VnodeLookupHold(path, &vnode, 0);
     if (ret != OK) {
         VnodeDrop();
         goto errout;
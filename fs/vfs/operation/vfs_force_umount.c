@@ -425,7 +425,7 @@ static void VnodeTryFree(struct Vnode *vnode)
     }
 
     VnodePathCacheFree(vnode);
-    LOS_ListDelete(&(vnode->hashEntry));
+    VfsHashRemove(vnode);
     LOS_ListDelete(&vnode->actFreeEntry);
 
     if (vnode->vop->Reclaim) {
@@ -476,9 +476,13 @@ int ForceUmountDev(struct Vnode *dev)
     }
 
     LOS_ListDelete(&mnt->mountList);
-    free(mnt);
-    origin->newMount = NULL;
     origin->flag &= ~(VNODE_FLAG_MOUNT_ORIGIN);
+    /* lockless walks that still see the flag find either the old Mount or NULL */
+    DMB;
+    origin->newMount = NULL;
+    /* lockless path walks may still be crossing the mount point */
+    LOS_RcuSynchronize();
+    free(mnt);
 
     VnodeDrop();
     (void)sem_post(&flist->fl_sem);
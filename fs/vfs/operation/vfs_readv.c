@@ -34,10 +34,99 @@
 #include "unistd.h"
 #include "string.h"
 #include "stdlib.h"
+#include "fcntl.h"
 #include "fs/file.h"
 #include "user_copy.h"
 #include "stdio.h"
 #include "limits.h"
+#ifdef LOSCFG_KERNEL_VM
+#include "fs/fs_operation.h"
+#include "los_vm_pin.h"
+#include "vnode.h"
+
+struct iov_io {
+    int fd;
+    off_t *offset;
+    ssize_t total;  /* bytes moved by the iovecs before the current one */
+};
+
+static ssize_t iov_io_chunk(void *arg, void *kbuf, size_t len, size_t pos, bool toUser)
+{
+    struct iov_io *io = (struct iov_io *)arg;
+    ssize_t ret;
+
+    if (io->offset == NULL) {
+        ret = toUser ? read(io->fd, kbuf, len) : write(io->fd, kbuf, len);
+    } else {
+        off_t off = *io->offset + io->total + (off_t)pos;
+        ret = toUser ? pread(io->fd, kbuf, len, off) : pwrite(io->fd, kbuf, len, off);
+    }
+    return (ret < 0) ? -get_errno() : ret;
+}
+
+static ssize_t iov_read_chunk(void *arg, void *kbuf, size_t len, size_t pos)
+{
+    return iov_io_chunk(arg, kbuf, len, pos, true);
+}
+
+static ssize_t iov_write_chunk(void *arg, void *kbuf, size_t len, size_t pos)
+{
+    return iov_io_chunk(arg, kbuf, len, pos, false);
+}
+
+/*
+ * splitting a request keeps its meaning only for regular files, sockets and pipes need one call.
+ * An O_APPEND file is left out as well, each part would append on its own.
+ */
+bool vfs_iov_direct_able(int fd)
+{
+    struct file *filep = NULL;
+
+    if ((fd < 0) || (fd >= CONFIG_NFILE_DESCRIPTORS) || (fs_getfilep(fd, &filep) < 0)) {
+        return false;
+    }
+    return (filep->f_vnode != NULL) && (filep->f_vnode->type == VNODE_TYPE_REG) &&
+           !((unsigned int)filep->f_oflags & O_APPEND);
+}
+
+ssize_t vfs_iov_direct(int fd, const struct iovec *iov, int iovcnt, off_t *offset, bool toUser)
+{
+    struct iov_io io = { fd, offset, 0 };
+    size_t buflen = 0;
+    ssize_t ret;
+    int i;
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (SSIZE_MAX - buflen < iov[i].iov_len) {
+            set_errno(EINVAL);
+            return VFS_ERROR;
+        }
+        buflen += iov[i].iov_len;
+    }
+
+    for (i = 0; i < iovcnt; ++i) {
+        if (iov[i].iov_len == 0) {
+            continue;
+        }
+
+        ret = LOS_VmUserBufIo(iov[i].iov_base, iov[i].iov_len, toUser,
+                              toUser ? iov_read_chunk : iov_write_chunk, &io);
+        if (ret < 0) {
+            if (io.total > 0) {
+                break;
+            }
+            set_errno(-ret);
+            return VFS_ERROR;
+        }
+        io.total += ret;
+        if ((size_t)ret < iov[i].iov_len) {
+            break;
+        }
+    }
+
+    return io.total;
+}
+#endif
 
 static char *pread_buf_and_check(int fd, const struct iovec *iov, int iovcnt, ssize_t *totalbytesread, off_t *offset)
 {
@@ -98,6 +187,12 @@ ssize_t vfs_readv(int fd, const struct iovec *iov, int iovcnt, off_t *offset)
     ssize_t totalbytesread = 0;
     ssize_t bytesleft;
 
+#ifdef LOSCFG_KERNEL_VM
+    if ((iov != NULL) && (iovcnt <= IOV_MAX) && vfs_iov_direct_able(fd)) {
+        return vfs_iov_direct(fd, iov, iovcnt, offset, true);
+    }
+#endif
+
     buf = pread_buf_and_check(fd, iov, iovcnt, &totalbytesread, offset);
     if (buf == NULL) {
         return totalbytesread;
@@ -74,8 +74,7 @@ int utime(const char *path, const struct utimbuf *ptimes)
     }
 
     /* Get the vnode for this file */
-    VnodeHold();
-    ret = VnodeLookup(fullpath, &vnode, 0);
+    ret = VnodeLookupHold(fullpath, &vnode, 0);
     if (ret != LOS_OK) {
         VnodeDrop();
         goto errout_with_path;
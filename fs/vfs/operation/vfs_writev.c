@@ -37,6 +37,9 @@
 #include "fs/file.h"
 #include "user_copy.h"
 #include "limits.h"
+#ifdef LOSCFG_KERNEL_VM
+#include "fs/fs_operation.h"
+#endif
 
 static int iov_trans_to_buf(char *buf, ssize_t totallen, const struct iovec *iov, int iovcnt)
 {
@@ -90,6 +93,13 @@ ssize_t vfs_writev(int fd, const struct iovec *iov, int iovcnt, off_t *offset)
         return VFS_ERROR;
     }
 
+#ifdef LOSCFG_KERNEL_VM
+    /* a writev at the file position is one write, other writers must not land between its iovecs */
+    if ((offset != NULL) && vfs_iov_direct_able(fd)) {
+        return vfs_iov_direct(fd, iov, iovcnt, offset, false);
+    }
+#endif
+
     for (i = 0; i < iovcnt; ++i) {
         if (SSIZE_MAX - buflen < iov[i].iov_len) {
             set_errno(EINVAL);
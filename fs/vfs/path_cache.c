@@ -34,9 +34,14 @@
 #include "stdlib.h"
 #include "limits.h"
 #include "vnode.h"
+#include "los_slab.h"
 
 #define PATH_CACHE_HASH_MASK (LOSCFG_MAX_PATH_CACHE_SIZE - 1)
+/* path components up to this length are allocated from g_pathCacheSlab, longer ones from the heap */
+#define PATH_CACHE_SHORT_NAME_MAX 23
 LIST_HEAD g_pathCacheHashEntrys[LOSCFG_MAX_PATH_CACHE_SIZE];
+static LosKmemCache *g_pathCacheSlab = NULL;
+static volatile uint32_t g_pathCacheSeq = 0; /* bumped each time a cache entry is removed */
 #ifdef LOSCFG_DEBUG_VERSION
 static int g_totalPathCacheHit = 0;
 static int g_totalPathCacheTry = 0;
@@ -57,6 +62,12 @@ void ResetPathCacheHitInfo(int *hit, int *try)
 
 int PathCacheInit(void)
 {
+    g_pathCacheSlab = LOS_KmemCacheCreate("path_cache", sizeof(struct PathCache) + PATH_CACHE_SHORT_NAME_MAX + 1,
+                                          0, NULL);
+    if (g_pathCacheSlab == NULL) {
+        return -ENOMEM;
+    }
+
     for (int i = 0; i < LOSCFG_MAX_PATH_CACHE_SIZE; i++) {
         LOS_ListInit(&g_pathCacheHashEntrys[i]);
     }
@@ -106,34 +117,63 @@ static uint32_t NameHash(const char *name, int len, struct Vnode *dvp)
 static void PathCacheInsert(struct Vnode *parent, struct PathCache *cache, const char* name, int len)
 {
     int hash = NameHash(name, len, parent) & PATH_CACHE_HASH_MASK;
-    LOS_ListAdd(&g_pathCacheHashEntrys[hash], &cache->hashEntry);
+    LOS_ListRcuAdd(&g_pathCacheHashEntrys[hash], &cache->hashEntry);
+}
+
+static struct PathCache *PathCacheMemAlloc(uint8_t len)
+{
+    size_t pathCacheSize = sizeof(struct PathCache) + len + 1;
+    struct PathCache *pc = NULL;
+
+    if (len > PATH_CACHE_SHORT_NAME_MAX) {
+        return (struct PathCache *)zalloc(pathCacheSize);
+    }
+
+    pc = (struct PathCache *)LOS_KmemCacheAlloc(g_pathCacheSlab);
+    if (pc != NULL) {
+        (void)memset_s(pc, pathCacheSize, 0, pathCacheSize);
+    }
+    return pc;
+}
+
+static void PathCacheMemFree(struct PathCache *pc)
+{
+    if (pc->nameLen > PATH_CACHE_SHORT_NAME_MAX) {
+        free(pc);
+    } else {
+        (void)LOS_KmemCacheFree(g_pathCacheSlab, pc);
+    }
+}
+
+/* runs at the end of an interrupt, both frees are irq safe */
+static void PathCacheRcuFree(LosRcuHead *head)
+{
+    PathCacheMemFree(LOS_DL_LIST_ENTRY(head, struct PathCache, rcu));
 }
 
 struct PathCache *PathCacheAlloc(struct Vnode *parent, struct Vnode *vnode, const char *name, uint8_t len)
 {
     struct PathCache *pc = NULL;
-    size_t pathCacheSize;
     int ret;
 
     if (name == NULL || len > NAME_MAX || parent == NULL || vnode == NULL) {
         return NULL;
     }
-    pathCacheSize = sizeof(struct PathCache) + len + 1;
 
-    pc = (struct PathCache*)zalloc(pathCacheSize);
+    pc = PathCacheMemAlloc(len);
     if (pc == NULL) {
         PRINT_ERR("pathCache alloc failed, no memory!\n");
         return NULL;
     }
 
+    pc->nameLen = len;
     ret = strncpy_s(pc->name, len + 1, name, len);
     if (ret != LOS_OK) {
-        free(pc);
+        PathCacheMemFree(pc);
         return NULL;
     }
 
     pc->parentVnode = parent;
-    pc->nameLen = len;
     pc->childVnode = vnode;
 
     LOS_ListAdd((&(parent->childPathCaches)), (&(pc->childEntry)));
@@ -151,10 +191,13 @@ int PathCacheFree(struct PathCache *pc)
         return -ENOENT;
     }
 
-    LOS_ListDelete(&pc->hashEntry);
+    LOS_ListRcuDelete(&pc->hashEntry);
     LOS_ListDelete(&pc->parentEntry);
     LOS_ListDelete(&pc->childEntry);
-    free(pc);
+    DMB;
+    g_pathCacheSeq++;
+    /* lookups walk the hash buckets locklessly */
+    LOS_RcuCall(&pc->rcu, PathCacheRcuFree);
 
     return LOS_OK;
 }
@@ -166,16 +209,27 @@ int PathCacheLookup(struct Vnode *parent, const char *name, int len, struct Vnod
     LIST_HEAD *dhead = &g_pathCacheHashEntrys[hash];
 
     TRACE_TRY_CACHE();
+    LOS_RcuReadLock();
     LOS_DL_LIST_FOR_EACH_ENTRY(pc, dhead, struct PathCache, hashEntry) {
         if (pc->parentVnode == parent && pc->nameLen == len && !strncmp(pc->name, name, len)) {
             *vnode = pc->childVnode;
             TRACE_HIT_CACHE(pc);
+            LOS_RcuReadUnlock();
             return LOS_OK;
         }
     }
+    LOS_RcuReadUnlock();
     return -ENOENT;
 }
 
+/* A walk that read the same sequence before and after under VnodeHold has seen no removed entry */
+uint32_t PathCacheSeqGet(void)
+{
+    uint32_t seq = g_pathCacheSeq;
+    DMB;
+    return seq;
+}
+
 static void FreeChildPathCache(struct Vnode *vnode)
 {
     struct PathCache *item = NULL;
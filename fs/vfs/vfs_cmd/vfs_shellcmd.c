@@ -254,8 +254,7 @@ int osShellCmdCat(int argc, const char **argv)
   ret = vfs_normalize_path(shell_working_directory, argv[0], &fullpath);
   ERROR_OUT_IF(ret < 0, set_err(-ret, "cat error"), return -1);
 
-  VnodeHold();
-  ret = VnodeLookup(fullpath, &vnode, O_RDONLY);
+  ret = VnodeLookupHold(fullpath, &vnode, O_RDONLY);
     if (ret != LOS_OK)
       {
         set_errno(-ret);
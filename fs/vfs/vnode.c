@@ -32,14 +32,19 @@
 #include "vnode.h"
 #include "fs/dirent_fs.h"
 #include "path_cache.h"
+#include "los_slab.h"
+#include "los_rcu.h"
+#include "los_vm_filemap.h"
 
 LIST_HEAD g_vnodeFreeList;              /* free vnodes list */
 LIST_HEAD g_vnodeVirtualList;           /* dev vnodes list */
 LIST_HEAD g_vnodeActiveList;              /* inuse vnodes list */
+LIST_HEAD g_vnodeRcuList;               /* freed vnodes waiting for a grace period */
 static int g_freeVnodeSize = 0;         /* system free vnodes size */
 static int g_totalVnodeSize = 0;        /* total vnode size */
 
 static LosMux g_vnodeMux;
+static LosKmemCache *g_vnodeCache = NULL;
 static struct Vnode *g_rootVnode = NULL;
 static struct VnodeOps g_devfsOps;
 
@@ -55,9 +60,16 @@ int VnodesInit(void)
         return retval;
     }
 
+    g_vnodeCache = LOS_KmemCacheCreate("vnode", sizeof(struct Vnode), 0, NULL);
+    if (g_vnodeCache == NULL) {
+        PRINT_ERR("Create vnode cache fail\n");
+        return -ENOMEM;
+    }
+
     LOS_ListInit(&g_vnodeFreeList);
     LOS_ListInit(&g_vnodeVirtualList);
     LOS_ListInit(&g_vnodeActiveList);
+    LOS_ListInit(&g_vnodeRcuList);
     retval = VnodeAlloc(NULL, &g_rootVnode);
     if (retval != LOS_OK) {
         PRINT_ERR("VnodeInit failed error %d\n", retval);
@@ -70,8 +82,31 @@ int VnodesInit(void)
     return LOS_OK;
 }
 
+static void VnodeRcuReap(void)
+{
+    struct Vnode *item = NULL;
+    struct Vnode *nextItem = NULL;
+
+    /* vnodes are queued in the order of their grace period */
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(item, nextItem, &g_vnodeRcuList, struct Vnode, actFreeEntry) {
+        if (!LOS_RcuGpDone(item->rcuSeq)) {
+            break;
+        }
+        LOS_ListDelete(&item->actFreeEntry);
+        if (item->vop == &g_devfsOps) {
+            (void)LOS_KmemCacheFree(g_vnodeCache, item);
+            g_totalVnodeSize--;
+            continue;
+        }
+        (void)memset_s(item, sizeof(struct Vnode), 0, sizeof(struct Vnode));
+        LOS_ListAdd(&g_vnodeFreeList, &item->actFreeEntry);
+        g_freeVnodeSize++;
+    }
+}
+
 static struct Vnode *GetFromFreeList(void)
 {
+    VnodeRcuReap();
     if (g_freeVnodeSize <= 0) {
         return NULL;
     }
@@ -96,9 +131,11 @@ struct Vnode *VnodeReclaimLru(void)
     int releaseCount = 0;
 
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(item, nextItem, &g_vnodeActiveList, struct Vnode, actFreeEntry) {
+        /* a vnode with dirty cached pages is left to the flusher */
         if ((item->useCount > 0) ||
             (item->flag & VNODE_FLAG_MOUNT_ORIGIN) ||
-            (item->flag & VNODE_FLAG_MOUNT_NEW)) {
+            (item->flag & VNODE_FLAG_MOUNT_NEW) ||
+            !LOS_ListEmpty(&item->dirtyEntry)) {
             continue;
         }
 
@@ -115,6 +152,10 @@ struct Vnode *VnodeReclaimLru(void)
         return NULL;
     }
 
+    if (g_freeVnodeSize <= 0) {
+        /* the reclaimed vnodes may still be seen by lockless hash lookups */
+        LOS_RcuSynchronize();
+    }
     item = GetFromFreeList();
     if (item == NULL) {
         PRINT_ERR("VnodeAlloc failed, reclaim and get from free list failed!\n");
@@ -129,8 +170,11 @@ int VnodeAlloc(struct VnodeOps *vop, struct Vnode **newVnode)
     VnodeHold();
     vnode = GetFromFreeList();
     if ((vnode == NULL) && g_totalVnodeSize < LOSCFG_MAX_VNODE_SIZE) {
-        vnode = (struct Vnode*)zalloc(sizeof(struct Vnode));
-        g_totalVnodeSize++;
+        vnode = (struct Vnode*)LOS_KmemCacheAlloc(g_vnodeCache);
+        if (vnode != NULL) {
+            (void)memset_s(vnode, sizeof(struct Vnode), 0, sizeof(struct Vnode));
+            g_totalVnodeSize++;
+        }
     }
 
     if (vnode == NULL) {
@@ -157,6 +201,8 @@ int VnodeAlloc(struct VnodeOps *vop, struct Vnode **newVnode)
         vnode->vop = vop;
     }
     LOS_ListInit(&vnode->mapping.page_list);
+    LOS_RadixTreeInit(&vnode->pageTree);
+    LOS_ListInit(&vnode->dirtyEntry);
     LOS_SpinInit(&vnode->mapping.list_lock);
     (VOID)LOS_MuxInit(&vnode->mapping.mux_lock, NULL);
     vnode->mapping.host = vnode;
@@ -180,8 +226,12 @@ int VnodeFree(struct Vnode *vnode)
         return -EBUSY;
     }
 
+    if (!LOS_ListEmpty(&vnode->dirtyEntry)) {
+        OsFileCacheFlush(&vnode->mapping);
+    }
+
     VnodePathCacheFree(vnode);
-    LOS_ListDelete(&(vnode->hashEntry));
+    VfsHashRemove(vnode);
     LOS_ListDelete(&vnode->actFreeEntry);
 
     if (vnode->vop->Reclaim) {
@@ -192,16 +242,15 @@ int VnodeFree(struct Vnode *vnode)
         free(vnode->filePath);
     }
     if (vnode->vop == &g_devfsOps) {
-        /* for dev vnode, just free it */
         free(vnode->data);
-        free(vnode);
-        g_totalVnodeSize--;
-    } else {
-        /* for normal vnode, reclaim it to g_VnodeFreeList */
-        (void)memset_s(vnode, sizeof(struct Vnode), 0, sizeof(struct Vnode));
-        LOS_ListAdd(&g_vnodeFreeList, &vnode->actFreeEntry);
-        g_freeVnodeSize++;
-    }
+        vnode->data = NULL;
+    }
+    /*
+     * dev vnodes go back to g_vnodeCache, normal ones to g_VnodeFreeList, both once the lockless
+     * hash and path cache lookups are done with them
+     */
+    vnode->rcuSeq = LOS_RcuGpStart();
+    LOS_ListTailInsert(&g_vnodeRcuList, &vnode->actFreeEntry);
     VnodeDrop();
 
     return LOS_OK;
@@ -296,6 +345,25 @@ static struct Vnode *ConvertVnodeIfMounted(struct Vnode *vnode)
     return vnode->newMount->vnodeCovered;
 }
 
+/*
+ * For the lockless walk: umount clears the flag and newMount behind the reader's back, so
+ * newMount is loaded once and checked. The Mount itself is only freed after a grace period.
+ */
+static struct Vnode *ConvertVnodeIfMountedRcu(struct Vnode *vnode)
+{
+    struct Mount *mnt = NULL;
+
+    if (!(vnode->flag & VNODE_FLAG_MOUNT_ORIGIN)) {
+        return vnode;
+    }
+    DMB;
+    mnt = *(struct Mount * volatile *)&vnode->newMount;
+    if ((mnt == NULL) || (mnt->vnodeCovered == NULL)) {
+        return vnode;
+    }
+    return mnt->vnodeCovered;
+}
+
 static void RefreshLRU(struct Vnode *vnode)
 {
     if (vnode == NULL || (vnode->type != VNODE_TYPE_REG && vnode->type != VNODE_TYPE_DIR) ||
@@ -452,6 +520,78 @@ int VnodeLookup(const char *path, struct Vnode **vnode, uint32_t flags)
     return VnodeLookupAt(path, vnode, flags, NULL);
 }
 
+/* Walks a path that is fully in the path cache, nothing is changed on the way */
+static int VnodeLookupCached(const char *normalizedPath, struct Vnode **result)
+{
+    uint8_t len = 0;
+    char *currentDir = (char *)normalizedPath;
+    char *nextDir = NULL;
+    struct Vnode *startVnode = g_rootVnode;
+    struct Vnode *currentVnode = startVnode;
+    struct Vnode *nextVnode = NULL;
+
+    while (*currentDir != '\0') {
+        if ((currentVnode != startVnode) && VfsVnodePermissionCheck(currentVnode, EXEC_OP)) {
+            return LOS_NOK;
+        }
+        if (currentVnode->type != VNODE_TYPE_DIR) {
+            return LOS_NOK;
+        }
+        nextDir = NextName(currentDir, &len);
+        if (nextDir == NULL) {
+            break;
+        }
+        if (PathCacheLookup(currentVnode, nextDir, len, &nextVnode) != LOS_OK) {
+            return LOS_NOK;
+        }
+        currentVnode = ConvertVnodeIfMountedRcu(nextVnode);
+        currentDir = nextDir + len;
+    }
+
+    *result = currentVnode;
+    return LOS_OK;
+}
+
+/*
+ * Same as VnodeHold() followed by VnodeLookup(), the lock is held on return whatever the result.
+ * A path already in the path cache is walked before the lock is taken, under VnodeHold the walk
+ * only has to check that no cache entry went away meanwhile.
+ */
+int VnodeLookupHold(const char *path, struct Vnode **vnode, uint32_t flags)
+{
+    int ret;
+    uint32_t seq;
+    char *normalizedPath = NULL;
+    struct Vnode *result = NULL;
+
+    if ((flags & (V_CREATE | V_DUMMY)) || (vfs_normalize_path(NULL, path, &normalizedPath) != LOS_OK)) {
+        VnodeHold();
+        return VnodeLookup(path, vnode, flags);
+    }
+
+    seq = PathCacheSeqGet();
+    LOS_RcuReadLock();
+    ret = VnodeLookupCached(normalizedPath, &result);
+    LOS_RcuReadUnlock();
+
+    VnodeHold();
+    if ((ret != LOS_OK) || (seq != PathCacheSeqGet())) {
+        free(normalizedPath);
+        return VnodeLookup(path, vnode, flags);
+    }
+
+    /* the result may have been mounted on since the walk */
+    result = ConvertVnodeIfMounted(result);
+    RefreshLRU(result);
+    if (result->filePath == NULL) {
+        result->filePath = normalizedPath;
+    } else {
+        free(normalizedPath);
+    }
+    *vnode = result;
+    return LOS_OK;
+}
+
 int VnodeLookupFullpath(const char *fullpath, struct Vnode **vnode, uint32_t flags)
 {
     return VnodeLookupAt(fullpath, vnode, flags, g_rootVnode);
@@ -486,6 +626,8 @@ static void ChangeRootInternal(struct Vnode *rootOld, char *dirname)
         mnt->vnodeBeCovered = nodeInFs;
 
         nodeInFs->newMount = mnt;
+        /* lockless walks test the flag before they read newMount */
+        DMB;
         nodeInFs->flag |= VNODE_FLAG_MOUNT_ORIGIN;
 
         break;
@@ -602,6 +744,7 @@ int VnodeDevInit()
         return -ENOMEM;
     }
     devMount->vnodeCovered = devNode;
+    DMB;
     devMount->vnodeBeCovered->flag |= VNODE_FLAG_MOUNT_ORIGIN;
     return LOS_OK;
 }
@@ -29,6 +29,7 @@
  */
 
 #include "los_mux.h"
+#include "los_rcu.h"
 #include "vnode.h"
 #include "fs/mount.h"
 
@@ -94,7 +95,8 @@ int VfsHashGet(const struct Mount *mount, uint32_t hash, struct Vnode **vnode, V
         return -EINVAL;
     }
 
-    (void)LOS_MuxLock(&g_vnodeHashMux, LOS_WAIT_FOREVER);
+    /* lookups are lockless, removed vnodes are only reused after a grace period */
+    LOS_RcuReadLock();
     LOS_DL_LIST *list = VfsHashBucket(mount, hash);
     LOS_DL_LIST_FOR_EACH_ENTRY(curVnode, list, struct Vnode, hashEntry) {
         if (curVnode->hash != hash) {
@@ -106,11 +108,11 @@ int VfsHashGet(const struct Mount *mount, uint32_t hash, struct Vnode **vnode, V
         if (fn != NULL && fn(curVnode, arg)) {
             continue;
         }
-        (void)LOS_MuxUnlock(&g_vnodeHashMux);
+        LOS_RcuReadUnlock();
         *vnode = curVnode;
         return LOS_OK;
     }
-    (void)LOS_MuxUnlock(&g_vnodeHashMux);
+    LOS_RcuReadUnlock();
     *vnode = NULL;
     return LOS_NOK;
 }
@@ -121,7 +123,10 @@ void VfsHashRemove(struct Vnode *vnode)
         return;
     }
     (void)LOS_MuxLock(&g_vnodeHashMux, LOS_WAIT_FOREVER);
-    LOS_ListDelete(&vnode->hashEntry);
+    /* never hashed or already removed */
+    if ((vnode->hashEntry.pstPrev != NULL) && (vnode->hashEntry.pstNext != &vnode->hashEntry)) {
+        LOS_ListRcuDelete(&vnode->hashEntry);
+    }
     (void)LOS_MuxUnlock(&g_vnodeHashMux);
 }
 
@@ -132,7 +137,7 @@ int VfsHashInsert(struct Vnode *vnode, uint32_t hash)
     }
     (void)LOS_MuxLock(&g_vnodeHashMux, LOS_WAIT_FOREVER);
     vnode->hash = hash;
-    LOS_ListHeadInsert(VfsHashBucket(vnode->originMount, hash), &vnode->hashEntry);
+    LOS_ListRcuAdd(VfsHashBucket(vnode->originMount, hash), &vnode->hashEntry);
     (void)LOS_MuxUnlock(&g_vnodeHashMux);
     return LOS_OK;
 }
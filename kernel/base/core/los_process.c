@@ -286,9 +286,7 @@ VOID OsWaitWakeTask(LosTaskCB *taskCB, UINT32 wakePID)
 {
     taskCB->waitID = wakePID;
     taskCB->ops->wake(taskCB);
-#ifdef LOSCFG_KERNEL_SMP
-    LOS_MpSchedule(OS_MP_CPU_ALL);
-#endif
+    OsSchedPreemptTargetNotify();
 }
 
 STATIC BOOL OsWaitWakeSpecifiedProcess(LOS_DL_LIST *head, const LosProcessCB *processCB, LOS_DL_LIST **anyList)
@@ -1948,7 +1946,7 @@ STATIC INT32 OsCopyProcess(UINT32 flags, const CHAR *name, UINTPTR sp, UINT32 si
         goto ERROR_TASK;
     }
 
-    LOS_MpSchedule(OS_MP_CPU_ALL);
+    OsSchedPreemptTargetNotify();
     if (OS_SCHEDULER_ACTIVE) {
         LOS_Schedule();
     }
@@ -220,7 +220,6 @@ STATIC INLINE VOID ScanSwtmrTimeList(SwtmrRunqueue *srq)
 {
     UINT32 intSave;
     SortLinkAttribute *swtmrSortLink = &srq->swtmrSortLink;
-    LOS_DL_LIST *listObject = &swtmrSortLink->sortLink;
 
     /*
      * it needs to be carefully coped with, since the swtmr is in specific sortlink
@@ -228,15 +227,14 @@ STATIC INLINE VOID ScanSwtmrTimeList(SwtmrRunqueue *srq)
      */
     LOS_SpinLockSave(&swtmrSortLink->spinLock, &intSave);
 
-    if (LOS_ListEmpty(listObject)) {
+    if (OsGetSortLinkNodeNum(swtmrSortLink) == 0) {
         LOS_SpinUnlockRestore(&swtmrSortLink->spinLock, intSave);
         return;
     }
-    SortLinkList *sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
 
     UINT64 currTime = OsGetCurrSchedTimeCycle();
-    while (sortList->responseTime <= currTime) {
-        sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
+    SortLinkList *sortList = OsSortLinkExpiredNodeGet(swtmrSortLink, currTime);
+    while (sortList != NULL) {
         UINT64 startTime = GET_SORTLIST_VALUE(sortList);
         OsDeleteNodeSortLink(swtmrSortLink, sortList);
         LOS_SpinUnlockRestore(&swtmrSortLink->spinLock, intSave);
@@ -244,11 +242,7 @@ STATIC INLINE VOID ScanSwtmrTimeList(SwtmrRunqueue *srq)
         SwtmrWake(srq, startTime, sortList);
 
         LOS_SpinLockSave(&swtmrSortLink->spinLock, &intSave);
-        if (LOS_ListEmpty(listObject)) {
-            break;
-        }
-
-        sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
+        sortList = OsSortLinkExpiredNodeGet(swtmrSortLink, currTime);
     }
 
     LOS_SpinUnlockRestore(&swtmrSortLink->spinLock, intSave);
@@ -544,40 +538,26 @@ VOID OsSwtmrResponseTimeReset(UINT64 startTime)
 {
     UINT16 cpuid = ArchCurrCpuid();
     SortLinkAttribute *swtmrSortLink = &g_swtmrRunqueue[cpuid].swtmrSortLink;
-    LOS_DL_LIST *listHead = &swtmrSortLink->sortLink;
-    LOS_DL_LIST *listNext = listHead->pstNext;
+    LOS_DL_LIST resetList;
 
+    LOS_ListInit(&resetList);
     LOS_SpinLock(&swtmrSortLink->spinLock);
-    while (listNext != listHead) {
-        SortLinkList *sortList = LOS_DL_LIST_ENTRY(listNext, SortLinkList, sortLinkNode);
-        OsDeleteNodeSortLink(swtmrSortLink, sortList);
-        LOS_SpinUnlock(&swtmrSortLink->spinLock);
+    (VOID)OsSortLinkNodesDetach(swtmrSortLink, &resetList);
+    LOS_SpinUnlock(&swtmrSortLink->spinLock);
 
+    while (!LOS_ListEmpty(&resetList)) {
+        SortLinkList *sortList = LOS_DL_LIST_ENTRY(resetList.pstNext, SortLinkList, sortLinkNode);
+        LOS_ListDelete(&sortList->sortLinkNode);
         SwtmrRestart(startTime, sortList, cpuid);
-
-        LOS_SpinLock(&swtmrSortLink->spinLock);
-        listNext = listNext->pstNext;
     }
-    LOS_SpinUnlock(&swtmrSortLink->spinLock);
 }
 
 STATIC INLINE BOOL SwtmrRunqueueFind(SortLinkAttribute *swtmrSortLink, SCHED_TL_FIND_FUNC checkFunc, UINTPTR arg)
 {
-    LOS_DL_LIST *listObject = &swtmrSortLink->sortLink;
-    LOS_DL_LIST *list = listObject->pstNext;
-
     LOS_SpinLock(&swtmrSortLink->spinLock);
-    while (list != listObject) {
-        SortLinkList *listSorted = LOS_DL_LIST_ENTRY(list, SortLinkList, sortLinkNode);
-        if (checkFunc((UINTPTR)listSorted, arg)) {
-            LOS_SpinUnlock(&swtmrSortLink->spinLock);
-            return TRUE;
-        }
-        list = list->pstNext;
-    }
-
+    BOOL find = OsSortLinkFind(swtmrSortLink, checkFunc, arg);
     LOS_SpinUnlock(&swtmrSortLink->spinLock);
-    return FALSE;
+    return find;
 }
 
 STATIC BOOL SwtmrTimeListFind(SCHED_TL_FIND_FUNC checkFunc, UINTPTR arg)
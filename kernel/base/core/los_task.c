@@ -360,6 +360,11 @@ STATIC VOID OsTaskResourcesToFree(LosTaskCB *taskCB)
 #endif
         OsTaskKernelResourcesToFree(syncSignal, topOfStack);
 
+#ifdef LOSCFG_KERNEL_VM
+        /* A task deleted while waiting on a futex leaves its node hashed, it is dropped before the memset */
+        OsFutexNodeDeleteFromFutexHash(&taskCB->futex, TRUE, NULL, NULL);
+#endif
+
         SCHEDULER_LOCK(intSave);
 #ifdef LOSCFG_KERNEL_VM
         OsClearSigInfoTmpList(&(taskCB->sig));
@@ -478,6 +483,7 @@ STATIC VOID TaskCBBaseInit(LosTaskCB *taskCB, const VOID *stackPtr, const VOID *
 
 #ifdef LOSCFG_KERNEL_SMP
     taskCB->currCpu      = OS_TASK_INVALID_CPUID;
+    taskCB->lastCpu      = OS_TASK_INVALID_CPUID;
     taskCB->cpuAffiMask  = (initParam->usCpuAffiMask) ?
                             initParam->usCpuAffiMask : LOSCFG_KERNEL_CPU_MASK;
 #endif
@@ -636,7 +642,7 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_TaskCreate(UINT32 *taskID, TSK_INIT_PARAM_S *in
 
     /* in case created task not running on this core,
        schedule or not depends on other schedulers status. */
-    LOS_MpSchedule(OS_MP_CPU_ALL);
+    OsSchedPreemptTargetNotify();
     if (OS_SCHEDULER_ACTIVE) {
         LOS_Schedule();
     }
@@ -671,7 +677,7 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_TaskResume(UINT32 taskID)
     errRet = taskCB->ops->resume(taskCB, &needSched);
     SCHEDULER_UNLOCK(intSave);
 
-    LOS_MpSchedule(OS_MP_CPU_ALL);
+    OsSchedPreemptTargetNotify();
     if (OS_SCHEDULER_ACTIVE && needSched) {
         LOS_Schedule();
     }
@@ -783,12 +789,6 @@ STATIC VOID OsTaskReleaseHoldLock(LosTaskCB *taskCB)
         }
     }
 
-#ifdef LOSCFG_KERNEL_VM
-    if (taskCB->taskStatus & OS_TASK_FLAG_USER_MODE) {
-        OsFutexNodeDeleteFromFutexHash(&taskCB->futex, TRUE, NULL, NULL);
-    }
-#endif
-
     OsTaskJoinPostUnsafe(taskCB);
 
     OsTaskSyncWake(taskCB);
@@ -805,6 +805,8 @@ LITE_OS_SEC_TEXT VOID OsRunningTaskToExit(LosTaskCB *runTask, UINT32 status)
     OsHookCall(LOS_HOOK_TYPE_TASK_DELETE, runTask);
 
     SCHEDULER_LOCK(intSave);
+    /* Give back what the scheduling class holds for the task, not every path below reaches OsInactiveTaskDelete */
+    runTask->ops->exit(runTask);
     if (OsProcessThreadNumberGet(runTask) == 1) { /* 1: The last task of the process exits */
         SCHEDULER_UNLOCK(intSave);
 
@@ -1098,29 +1100,42 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_TaskInfoGet(UINT32 taskID, TSK_INFO_S *taskInf
     return LOS_OK;
 }
 
-LITE_OS_SEC_TEXT BOOL OsTaskCpuAffiSetUnsafe(UINT32 taskID, UINT16 newCpuAffiMask, UINT16 *oldCpuAffiMask)
+LITE_OS_SEC_TEXT UINT32 OsTaskCpuAffiSetUnsafe(UINT32 taskID, UINT16 newCpuAffiMask, UINT16 *oldCpuAffiMask,
+                                               BOOL *needSched)
 {
+    *needSched = FALSE;
 #ifdef LOSCFG_KERNEL_SMP
     LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
 
+    /* a deadline task takes its bandwidth reservation along, or keeps its affinity */
+    if (EDFTaskCpuAffiChange(taskCB, newCpuAffiMask) != LOS_OK) {
+        return LOS_EBUSY;
+    }
+
     taskCB->cpuAffiMask = newCpuAffiMask;
+    if ((taskCB->taskStatus & OS_TASK_STATUS_READY) && !(CPUID_TO_AFFI_MASK(taskCB->lastCpu) & newCpuAffiMask)) {
+        /* move the ready task to the runqueue of a cpu it may run on */
+        taskCB->ops->dequeue(OsSchedRunqueue(), taskCB);
+        taskCB->ops->enqueue(OsSchedRunqueue(), taskCB);
+    }
     *oldCpuAffiMask = CPUID_TO_AFFI_MASK(taskCB->currCpu);
     if (!((*oldCpuAffiMask) & newCpuAffiMask)) {
         taskCB->signal = SIGNAL_AFFI;
-        return TRUE;
+        *needSched = TRUE;
     }
 #else
     (VOID)taskID;
     (VOID)newCpuAffiMask;
     (VOID)oldCpuAffiMask;
 #endif /* LOSCFG_KERNEL_SMP */
-    return FALSE;
+    return LOS_OK;
 }
 
 LITE_OS_SEC_TEXT_MINOR UINT32 LOS_TaskCpuAffiSet(UINT32 taskID, UINT16 cpuAffiMask)
 {
     BOOL needSched = FALSE;
     UINT32 intSave;
+    UINT32 ret;
     UINT16 currCpuMask;
 
     if (OS_TID_CHECK_INVALID(taskID)) {
@@ -1137,9 +1152,13 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_TaskCpuAffiSet(UINT32 taskID, UINT16 cpuAffiMa
         SCHEDULER_UNLOCK(intSave);
         return LOS_ERRNO_TSK_NOT_CREATED;
     }
-    needSched = OsTaskCpuAffiSetUnsafe(taskID, cpuAffiMask, &currCpuMask);
+    ret = OsTaskCpuAffiSetUnsafe(taskID, cpuAffiMask, &currCpuMask, &needSched);
 
     SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return LOS_ERRNO_TSK_CPU_AFFINITY_MASK_ERR;
+    }
+    OsSchedPreemptTargetNotify();
     if (needSched && OS_SCHEDULER_ACTIVE) {
         LOS_MpSchedule(currCpuMask);
         LOS_Schedule();
@@ -1373,23 +1392,12 @@ LOS_ERREND:
     return policy;
 }
 
-LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16 priority)
+STATIC INT32 OsTaskSchedParamSet(INT32 taskID, const SchedParam *schedParam)
 {
     SchedParam param = { 0 };
+    BOOL needSched = FALSE;
     UINT32 intSave;
 
-    if (OS_TID_CHECK_INVALID(taskID)) {
-        return LOS_ESRCH;
-    }
-
-    if (priority > OS_TASK_PRIORITY_LOWEST) {
-        return LOS_EINVAL;
-    }
-
-    if ((policy != LOS_SCHED_FIFO) && (policy != LOS_SCHED_RR)) {
-        return LOS_EINVAL;
-    }
-
     LosTaskCB *taskCB = OS_TCB_FROM_TID(taskID);
     if (taskCB->taskStatus & OS_TASK_FLAG_SYSTEM_TASK) {
         return LOS_EPERM;
@@ -1402,10 +1410,22 @@ LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16
     }
 
     taskCB->ops->schedParamGet(taskCB, &param);
-    param.policy = policy;
-    param.priority = priority;
-    BOOL needSched = taskCB->ops->schedParamModify(taskCB, &param);
+    param.policy = schedParam->policy;
+    if (schedParam->policy == LOS_SCHED_DEADLINE) {
+        if (schedParam->runTime != 0) {
+            param.runTime = schedParam->runTime;
+            param.deadline = schedParam->deadline;
+            param.period = schedParam->period;
+        }
+    } else {
+        param.priority = schedParam->priority;
+    }
+
+    UINT32 ret = OsSchedParamSet(taskCB, &param, &needSched);
     SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return (INT32)ret;
+    }
 
     LOS_MpSchedule(OS_MP_CPU_ALL);
     if (needSched && OS_SCHEDULER_ACTIVE) {
@@ -1415,6 +1435,47 @@ LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16
     return LOS_OK;
 }
 
+LITE_OS_SEC_TEXT INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16 priority)
+{
+    SchedParam param = { 0 };
+
+    if (OS_TID_CHECK_INVALID(taskID)) {
+        return LOS_ESRCH;
+    }
+
+    if (priority > OS_TASK_PRIORITY_LOWEST) {
+        return LOS_EINVAL;
+    }
+
+    if ((policy != LOS_SCHED_FIFO) && (policy != LOS_SCHED_RR) && (policy != LOS_SCHED_DEADLINE)) {
+        return LOS_EINVAL;
+    }
+
+    /* LOS_SCHED_DEADLINE keeps the reservation given by LOS_SetTaskDeadline */
+    param.policy = policy;
+    param.priority = priority;
+    return OsTaskSchedParamSet(taskID, &param);
+}
+
+LITE_OS_SEC_TEXT INT32 LOS_SetTaskDeadline(INT32 taskID, UINT64 runTime, UINT64 deadline, UINT64 period)
+{
+    SchedParam param = { 0 };
+
+    if (OS_TID_CHECK_INVALID(taskID)) {
+        return LOS_ESRCH;
+    }
+
+    if ((runTime == 0) || (deadline == 0)) {
+        return LOS_EINVAL;
+    }
+
+    param.policy = LOS_SCHED_DEADLINE;
+    param.runTime = OsSchedNsToCycle(runTime);
+    param.deadline = OsSchedNsToCycle(deadline);
+    param.period = OsSchedNsToCycle(period);
+    return OsTaskSchedParamSet(taskID, &param);
+}
+
 STATIC UINT32 OsTaskJoinCheck(UINT32 taskID)
 {
     if (OS_TID_CHECK_INVALID(taskID)) {
@@ -41,14 +41,38 @@
 #define FUTEX_UNLOCK_PI   7
 #define FUTEX_TRYLOCK_PI  8
 #define FUTEX_WAIT_BITSET 9
+#define FUTEX_WAKE_BITSET 10
 
 #define FUTEX_PRIVATE     128
-#define FUTEX_MASK        0x3U
+#define FUTEX_MASK        0x7FU
+
+#define FUTEX_BITSET_MATCH_ANY 0xFFFFFFFFU
+
+/* PI futex word: owner tid plus the waiters bit set by the kernel */
+#define FUTEX_WAITERS     0x80000000U
+#define FUTEX_OWNER_DIED  0x40000000U
+#define FUTEX_TID_MASK    0x3FFFFFFFU
+
+/* FUTEX_WAKE_OP encoding: op:4 cmp:4 oparg:12 cmparg:12 */
+#define FUTEX_OP_SET        0
+#define FUTEX_OP_ADD        1
+#define FUTEX_OP_OR         2
+#define FUTEX_OP_ANDN       3
+#define FUTEX_OP_XOR        4
+#define FUTEX_OP_OPARG_SHIFT 8
+
+#define FUTEX_OP_CMP_EQ     0
+#define FUTEX_OP_CMP_NE     1
+#define FUTEX_OP_CMP_LT     2
+#define FUTEX_OP_CMP_LE     3
+#define FUTEX_OP_CMP_GT     4
+#define FUTEX_OP_CMP_GE     5
 
 typedef struct {
     UINTPTR      key;           /* private:uvaddr   shared:paddr */
     UINT32       index;         /* hash bucket index */
     UINT32       pid;           /* private:process id   shared:OS_INVALID(-1) */
+    UINT32       bitset;        /* FUTEX_WAIT_BITSET mask, FUTEX_BITSET_MATCH_ANY for the others */
     LOS_DL_LIST  pendList;      /* point to pendList in TCB struct */
     LOS_DL_LIST  queueList;     /* thread list blocked by this lock */
     LOS_DL_LIST  futexList;     /* point to the next FutexNode */
@@ -60,4 +84,10 @@ extern INT32 OsFutexWake(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber
 extern INT32 OsFutexWait(const UINT32 *userVaddr, UINT32 flags, UINT32 val, UINT32 absTime);
 extern INT32 OsFutexRequeue(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber,
                             INT32 count, const UINT32 *newUserVaddr);
+extern INT32 OsFutexWaitBitset(const UINT32 *userVaddr, UINT32 flags, UINT32 val, UINT32 absTime, UINT32 bitset);
+extern INT32 OsFutexWakeBitset(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, UINT32 bitset);
+extern INT32 OsFutexWakeOp(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, INT32 wakeNumber2,
+                           const UINT32 *userVaddr2, UINT32 op);
+extern INT32 OsFutexLockPi(const UINT32 *userVaddr, UINT32 flags, UINT32 absTime, BOOL isTry);
+extern INT32 OsFutexUnlockPi(const UINT32 *userVaddr, UINT32 flags);
 #endif
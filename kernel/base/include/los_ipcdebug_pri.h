@@ -33,6 +33,7 @@
 #define _LOS_IPCDEBUG_PRI_H
 
 #include "los_typedef.h"
+#include "los_hw_cpu.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -58,6 +59,27 @@ typedef BOOL (*OsCompareFunc)(const IpcSortParam *sortParam, UINT32 left, UINT32
 extern VOID OsArraySortByTime(UINT32 *sortArray, UINT32 start, UINT32 end, const IpcSortParam *sortParam,
                               OsCompareFunc compareFunc);
 
+typedef enum {
+    OS_IPC_LOCK_MUX,
+    OS_IPC_LOCK_RWLOCK,
+    OS_IPC_LOCK_SEM,
+    OS_IPC_LOCK_TYPE_MAX
+} OsIpcLockType;
+
+typedef struct {
+    UINT32 uncontended; /**< Acquisitions served by the atomic fast path */
+    UINT32 contended;   /**< Acquisitions that went through the scheduler lock */
+    UINT32 spun;        /**< Contended acquisitions won by spinning on a running owner */
+} IpcLockStat;
+
+extern IpcLockStat g_ipcLockStat[OS_IPC_LOCK_TYPE_MAX][LOSCFG_KERNEL_CORE_NUM];
+
+/* Per cpu and unlocked, so the numbers are approximate when a task migrates in between */
+#define OS_IPC_LOCK_STAT_INC(type, member) (g_ipcLockStat[(type)][ArchCurrCpuid()].member++)
+
+extern VOID OsIpcLockStatGet(OsIpcLockType type, IpcLockStat *stat);
+extern VOID OsIpcLockStatReset(VOID);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
@@ -43,6 +43,18 @@ extern "C" {
 
 #define OS_MUX_MAGIC 0xEBCFDEA0
 
+/*
+ * The owner word is claimed and released with atomics while nobody waits. A contender that has to
+ * queue sets this bit under the scheduler lock, from then on the hold is released through the slow
+ * path. Destroy sets the bit alone to keep the fast path off a mutex that is being wiped.
+ */
+#define OS_MUX_OWNER_WAITERS 0x1U
+
+STATIC INLINE LosTaskCB *OsMuxOwnerGet(const LosMux *mutex)
+{
+    return (LosTaskCB *)((UINTPTR)mutex->owner & ~(UINTPTR)OS_MUX_OWNER_WAITERS);
+}
+
 extern VOID OsMuxBitmapRestore(const LosMux *mutex, const LOS_DL_LIST *list, const LosTaskCB *runTask);
 extern UINT32 OsMuxLockUnsafe(LosMux *mutex, UINT32 timeout);
 extern UINT32 OsMuxTrylockUnsafe(LosMux *mutex, UINT32 timeout);
@@ -76,8 +76,16 @@ typedef struct {
     UINT16 readWriteableCnt[OS_QUEUE_N_RW]; /**< Count of readable or writable resources, 0:readable, 1:writable */
     LOS_DL_LIST readWriteList[OS_QUEUE_N_RW]; /**< the linked list to be read or written, 0:readlist, 1:writelist */
     LOS_DL_LIST memList; /**< Pointer to the memory linked list */
+    UINT32 queueFlags; /**< Flags the queue is created with */
+    volatile UINT32 ringHead; /**< Position of the next message to be read from a ring queue */
+    volatile UINT32 ringTail; /**< Position of the next node to be reserved in a ring queue */
+    volatile UINT32 ringWaiters; /**< Whether tasks wait on a ring queue, bit 0:readlist, bit 1:writelist */
+    volatile UINT32 ringUsers; /**< Count of tasks using a ring queue outside the lock, top bit once deleted */
 } LosQueueCB;
 
+#define OS_QUEUE_RING_FLAGS    (LOS_QUEUE_FLAG_MPSC | LOS_QUEUE_FLAG_SPSC)
+#define OS_QUEUE_IS_RING(queueCB) (((queueCB)->queueFlags & OS_QUEUE_RING_FLAGS) != 0)
+
 /* queue state */
 /**
  *  @ingroup los_queue
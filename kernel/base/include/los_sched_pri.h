@@ -75,6 +75,18 @@ STATIC INLINE UINT64 OsGetCurrSchedTimeCycle(VOID)
     return HalClockGetCycles();
 }
 
+STATIC INLINE UINT64 OsSchedNsToCycle(UINT64 ns)
+{
+    return ((ns / OS_SYS_NS_PER_SECOND) * OS_SYS_CLOCK) +
+           (((ns % OS_SYS_NS_PER_SECOND) * OS_SYS_CLOCK) / OS_SYS_NS_PER_SECOND);
+}
+
+STATIC INLINE UINT64 OsSchedCycleToNs(UINT64 cycle)
+{
+    return ((cycle / OS_SYS_CLOCK) * OS_SYS_NS_PER_SECOND) +
+           (((cycle % OS_SYS_CLOCK) * OS_SYS_NS_PER_SECOND) / OS_SYS_CLOCK);
+}
+
 typedef enum {
     INT_NO_RESCH = 0x0,   /* no needs to schedule */
     INT_PEND_RESCH = 0x1, /* pending schedule flag */
@@ -91,16 +103,31 @@ typedef struct {
 typedef struct {
     HPFQueue queueList[OS_PRIORITY_QUEUE_NUM];
     UINT32   queueBitmap;
+    UINT32   taskNum;      /* ready tasks on this queue */
 } HPFRunqueue;
 
+typedef struct {
+    LOS_DL_LIST root;      /* ready deadline tasks sorted by absolute deadline */
+    UINT32      taskNum;
+    UINT32      bandwidth; /* bandwidth reserved by the deadline tasks of this cpu, see SchedEDF */
+} EDFRunqueue;
+
 typedef struct {
     SortLinkAttribute timeoutQueue; /* task timeout queue */
     HPFRunqueue       *hpfRunqueue;
+    EDFRunqueue       *edfRunqueue;
     UINT64            responseTime; /* Response time for current CPU tick interrupts */
     UINT32            responseID;   /* The response ID of the current CPU tick interrupt */
     UINT32            idleTaskID;   /* idle task id */
     UINT32            taskLockCnt;  /* task lock flag */
     UINT32            schedFlag;    /* pending scheduler flag */
+#ifdef LOSCFG_KERNEL_SMP
+    LosTaskCB         *runTask;     /* task running on this cpu, updated with the scheduler lock held */
+    UINT64            balanceTime;  /* next periodic load balance time */
+#endif
+#ifdef LOSCFG_SCHED_DEBUG
+    SchedRunqueueStat stat;
+#endif
 } SchedRunqueue;
 
 extern SchedRunqueue g_schedRunqueue[LOSCFG_KERNEL_CORE_NUM];
@@ -211,12 +238,16 @@ STATIC INLINE VOID OsSchedRunqueuePendingSet(VOID)
 #define LOS_SCHED_FIFO    1U
 #define LOS_SCHED_RR      2U
 #define LOS_SCHED_IDLE    3U
+#define LOS_SCHED_DEADLINE 6U
 
 typedef struct {
     UINT16 policy;
     UINT16 basePrio;
     UINT16 priority;
     UINT32 timeSlice;
+    UINT64 runTime;   /* LOS_SCHED_DEADLINE only, in cycles */
+    UINT64 deadline;
+    UINT64 period;
 } SchedParam;
 
 typedef struct {
@@ -227,9 +258,29 @@ typedef struct {
     UINT32  priBitmap; /**< Bitmap for recording the change of task priority, the priority can not be greater than 31 */
 } SchedHPF;
 
+#define OS_SCHED_EDF_BW_SHIFT       20
+#define OS_SCHED_EDF_FLAG_ADMITTED  0x1U /* the bandwidth is reserved on the runqueue of cpuid */
+#define OS_SCHED_EDF_FLAG_THROTTLED 0x2U /* the budget is exhausted, waiting on the timeout queue for the next period */
+#define OS_SCHED_EDF_FLAG_MISSED    0x4U /* the current job has missed its deadline */
+
+typedef struct {
+    UINT16  policy;     /* The first three fields share the layout of SchedHPF */
+    UINT16  basePrio;
+    UINT16  priority;   /* priority restored when the task goes back to FIFO/RR */
+    UINT16  cpuid;      /* cpu the bandwidth is reserved on, the task only runs there */
+    UINT32  flags;
+    UINT32  bandwidth;  /* runTime / min(deadline, period), OS_SCHED_EDF_BW_SHIFT bits fixed point */
+    UINT64  runTime;    /* budget of each period, in cycles */
+    UINT64  deadline;   /* relative deadline of each job */
+    UINT64  period;
+    UINT64  finishTime; /* absolute deadline of the current job */
+    INT64   budget;     /* budget left to the current job */
+} SchedEDF;
+
 typedef struct {
     union {
         SchedHPF hpf;
+        SchedEDF edf;
     } Policy;
 } SchedPolicy;
 
@@ -388,7 +439,7 @@ typedef struct TagTaskCB {
     sig_cb          sig;
 #ifdef LOSCFG_KERNEL_SMP
     UINT16          currCpu;            /**< CPU core number of this task is running on */
-    UINT16          lastCpu;            /**< CPU core number of this task is running on last time */
+    UINT16          lastCpu;            /**< CPU core number of the runqueue this task is queued on or ran on last time */
     UINT16          cpuAffiMask;        /**< CPU affinity mask, support up to 16 cores */
 #ifdef LOSCFG_KERNEL_SMP_TASK_SYNC
     UINT32          syncSignal;         /**< Synchronization for signal handling */
@@ -638,9 +689,30 @@ STATIC INLINE LosTaskCB *HPFRunqueueTopTaskGet(HPFRunqueue *rq)
 }
 
 VOID HPFSchedPolicyInit(SchedRunqueue *rq);
+#ifdef LOSCFG_KERNEL_SMP
+LosTaskCB *HPFRunqueueTaskPull(SchedRunqueue *rq, LosTaskCB *topTask);
+BOOL HPFRunqueueTaskMigrate(SchedRunqueue *rq, SchedRunqueue *srcRq, UINT64 currTime);
+#endif
 VOID HPFTaskSchedParamInit(LosTaskCB *taskCB, UINT16 policy,
                            const SchedParam *parentParam, const TSK_INIT_PARAM_S *param);
 VOID HPFProcessDefaultSchedParamGet(SchedParam *param);
+BOOL HPFBasePriorityModify(SchedRunqueue *rq, LosTaskCB *taskCB, UINT16 priority);
+VOID HPFTaskHandoff(SchedRunqueue *rq, LosTaskCB *runTask, LosTaskCB *taskCB);
+
+STATIC INLINE LosTaskCB *EDFRunqueueTopTaskGet(EDFRunqueue *rq)
+{
+    if (LOS_ListEmpty(&rq->root)) {
+        return NULL;
+    }
+
+    return LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&rq->root), LosTaskCB, pendList);
+}
+
+VOID EDFSchedPolicyInit(SchedRunqueue *rq);
+UINT32 EDFTaskSchedParamSet(LosTaskCB *taskCB, const SchedParam *param, BOOL *needSched);
+#ifdef LOSCFG_KERNEL_SMP
+UINT32 EDFTaskCpuAffiChange(LosTaskCB *taskCB, UINT16 cpuAffiMask);
+#endif
 
 VOID IdleTaskSchedParamInit(LosTaskCB *taskCB);
 
@@ -650,6 +722,38 @@ UINT32 OsSchedParamInit(LosTaskCB *taskCB, UINT16 policy,
                         const SchedParam *parentParam, const TSK_INIT_PARAM_S *param);
 VOID OsSchedProcessDefaultSchedParamGet(UINT16 policy, SchedParam *param);
 
+/*
+ * Set the scheduling parameters of taskCB, moving it to or from the deadline
+ * class if the policy asks so. The scheduler lock must be held.
+ */
+UINT32 OsSchedParamSet(LosTaskCB *taskCB, const SchedParam *param, BOOL *needSched);
+
+/*
+ * Wake taskCB, pended waiting for the current task, so that it runs on this cpu
+ * as soon as the current task blocks, with the rest of its time slice. Used by
+ * synchronous request/reply ipc, the caller is expected to block next. Falls back
+ * to the ordinary wake when taskCB may not run here or either task is not FIFO/RR.
+ * The scheduler lock must be held.
+ */
+VOID OsSchedHandoffWake(LosTaskCB *taskCB);
+
+#ifdef LOSCFG_KERNEL_SMP
+/*
+ * Choose the runqueue a task that became ready is queued on, the scheduler
+ * lock must be held. If the task preempts the task running on that cpu, the
+ * cpu is recorded and OsSchedPreemptTargetNotify sends the ipi to the
+ * recorded cpus once the lock is released.
+ */
+UINT16 OsSchedRunqueueSelect(const LosTaskCB *taskCB);
+/* Record cpuid for the ipi if taskCB, queued on that cpu, preempts the task running there */
+VOID OsSchedRunqueuePreemptCheck(const LosTaskCB *taskCB, UINT16 cpuid);
+VOID OsSchedPreemptTargetNotify(VOID);
+#else
+STATIC INLINE VOID OsSchedPreemptTargetNotify(VOID)
+{
+}
+#endif
+
 VOID OsSchedResponseTimeReset(UINT64 responseTime);
 VOID OsSchedToUserReleaseLock(VOID);
 VOID OsSchedTick(VOID);
@@ -42,16 +42,34 @@ extern "C" {
 #endif /* __cplusplus */
 #endif /* __cplusplus */
 
+/*
+ * The sort link is a hierarchical timing wheel. Level 0 slots are OS_SORT_LINK_GRANULE cycles wide and keep their
+ * nodes sorted by response time, every higher level slot covers a whole lower level and keeps its nodes unsorted
+ * until the wheel clock reaches the slot, at which point they are cascaded down. Nodes beyond the top level are kept
+ * on the overflow bucket. Insert and delete are O(1), the expiry scan only touches buckets that have come due.
+ */
+#define OS_SORT_LINK_GRANULE_SHIFT      14
+#define OS_SORT_LINK_WHEEL_SLOT_BITS    5
+#define OS_SORT_LINK_WHEEL_SLOTS        (1U << OS_SORT_LINK_WHEEL_SLOT_BITS)
+#define OS_SORT_LINK_WHEEL_SLOT_MASK    (OS_SORT_LINK_WHEEL_SLOTS - 1)
+#define OS_SORT_LINK_WHEEL_LEVELS       5
+#define OS_SORT_LINK_WHEEL_BUCKETS      (OS_SORT_LINK_WHEEL_SLOTS * OS_SORT_LINK_WHEEL_LEVELS)
+#define OS_SORT_LINK_OVERFLOW_BUCKET    OS_SORT_LINK_WHEEL_BUCKETS
+#define OS_SORT_LINK_INVALID_BUCKET     0xFFFFU
+
 typedef struct {
     LOS_DL_LIST sortLinkNode;
     UINT64      responseTime;
+    UINT16      bucket;       /* wheel bucket the node hangs on */
 #ifdef LOSCFG_KERNEL_SMP
     UINT32      cpuid;
 #endif
 } SortLinkList;
 
 typedef struct {
-    LOS_DL_LIST sortLink;
+    LOS_DL_LIST wheel[OS_SORT_LINK_WHEEL_BUCKETS + 1];  /* the last one is the overflow bucket */
+    UINT32      bitmap[OS_SORT_LINK_WHEEL_LEVELS];      /* non-empty slots of each level */
+    UINT64      clock;        /* wheel time in granules, nothing on the wheel expires before it */
     UINT32      nodeNum;
     SPIN_LOCK_S spinLock;     /* swtmr sort link spin lock */
 } SortLinkAttribute;
@@ -62,30 +80,46 @@ typedef struct {
 
 STATIC INLINE VOID OsDeleteNodeSortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
 {
+    UINT16 bucket = sortList->bucket;
+
     LOS_ListDelete(&sortList->sortLinkNode);
+    if ((bucket < OS_SORT_LINK_OVERFLOW_BUCKET) && LOS_ListEmpty(&sortLinkHeader->wheel[bucket])) {
+        sortLinkHeader->bitmap[bucket >> OS_SORT_LINK_WHEEL_SLOT_BITS] &=
+            ~(1U << (bucket & OS_SORT_LINK_WHEEL_SLOT_MASK));
+    }
+    sortList->bucket = OS_SORT_LINK_INVALID_BUCKET;
     SET_SORTLIST_VALUE(sortList, OS_SORT_LINK_INVALID_TIME);
     sortLinkHeader->nodeNum--;
 }
 
+/*
+ * Must be called with the sort link spinlock held.
+ * Returns the earliest response time on the wheel. For nodes that have not yet been cascaded down to level 0 the
+ * start of their bucket is returned instead, which is never later than the real response time.
+ */
+UINT64 OsSortLinkNextResponseTime(SortLinkAttribute *sortLinkHeader, UINT64 currTime);
+
+/*
+ * Must be called with the sort link spinlock held.
+ * Returns a node whose response time is not later than currTime, or NULL if there is none. The node stays on the
+ * wheel, the caller removes it with OsDeleteNodeSortLink.
+ */
+SortLinkList *OsSortLinkExpiredNodeGet(SortLinkAttribute *sortLinkHeader, UINT64 currTime);
+
 STATIC INLINE UINT64 OsGetSortLinkNextExpireTime(SortLinkAttribute *sortHeader, UINT64 startTime, UINT32 tickPrecision)
 {
-    LOS_DL_LIST *head = &sortHeader->sortLink;
-    LOS_DL_LIST *list = head->pstNext;
-
     LOS_SpinLock(&sortHeader->spinLock);
-    if (LOS_ListEmpty(head)) {
-        LOS_SpinUnlock(&sortHeader->spinLock);
+    UINT64 responseTime = OsSortLinkNextResponseTime(sortHeader, startTime);
+    LOS_SpinUnlock(&sortHeader->spinLock);
+    if (responseTime == OS_SORT_LINK_INVALID_TIME) {
         return OS_SORT_LINK_INVALID_TIME - tickPrecision;
     }
 
-    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(list, SortLinkList, sortLinkNode);
-    if (listSorted->responseTime <= (startTime + tickPrecision)) {
-        LOS_SpinUnlock(&sortHeader->spinLock);
+    if (responseTime <= (startTime + tickPrecision)) {
         return startTime + tickPrecision;
     }
 
-    LOS_SpinUnlock(&sortHeader->spinLock);
-    return listSorted->responseTime;
+    return responseTime;
 }
 
 STATIC INLINE UINT32 OsGetSortLinkNodeNum(const SortLinkAttribute *head)
@@ -106,8 +140,10 @@ VOID OsSortLinkInit(SortLinkAttribute *sortLinkHeader);
 VOID OsAdd2SortLink(SortLinkAttribute *head, SortLinkList *node, UINT64 responseTime, UINT16 idleCpu);
 VOID OsDeleteFromSortLink(SortLinkAttribute *head, SortLinkList *node);
 UINT64 OsSortLinkGetTargetExpireTime(UINT64 currTime, const SortLinkList *targetSortList);
-UINT64 OsSortLinkGetNextExpireTime(UINT64 currTime, const SortLinkAttribute *sortLinkHeader);
+UINT64 OsSortLinkGetNextExpireTime(UINT64 currTime, SortLinkAttribute *sortLinkHeader);
 UINT32 OsSortLinkAdjustNodeResponseTime(SortLinkAttribute *head, SortLinkList *node, UINT64 responseTime);
+UINT32 OsSortLinkNodesDetach(SortLinkAttribute *head, LOS_DL_LIST *list);
+BOOL OsSortLinkFind(SortLinkAttribute *head, BOOL (*checkFunc)(UINTPTR, UINTPTR), UINTPTR arg);
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -51,8 +51,15 @@ typedef struct {
     UINT64      pendCount;
     UINT64      waitSchedTime;        /* task status is ready to running times */
     UINT64      waitSchedCount;
+    UINT64      throttleCount;        /* deadline task: budget exhausted before the end of the period */
+    UINT64      deadlineMissCount;    /* deadline task: jobs still running after their absolute deadline */
 } SchedStat;
 
+typedef struct {
+    UINT64      ipiCount;             /* schedule ipi sent after a wakeup */
+    UINT64      ipiSkipCount;         /* wakeups that did not need any ipi */
+} SchedRunqueueStat;
+
 #ifdef LOSCFG_SCHED_DEBUG
 #ifdef LOSCFG_SCHED_TICK_DEBUG
 VOID OsSchedDebugRecordData(VOID);
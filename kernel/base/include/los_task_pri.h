@@ -52,7 +52,13 @@ extern "C" {
 #define SIGNAL_SUSPEND              (1U << 1)
 #define SIGNAL_AFFI                 (1U << 2)
 
-/* scheduler lock */
+/*
+ * scheduler lock
+ *
+ * Still one lock for every cpu. Besides the per-cpu ready queues it guards taskStatus and the
+ * pend lists of all IPC objects, so a per-runqueue split needs those to get their own locks first.
+ * Its contention is reported by the spinlock statistics of g_taskSpin.
+ */
 extern SPIN_LOCK_S g_taskSpin;
 #define SCHEDULER_LOCK(state)       LOS_SpinLockSave(&g_taskSpin, &(state))
 #define SCHEDULER_UNLOCK(state)     LOS_SpinUnlockRestore(&g_taskSpin, state)
@@ -280,6 +286,7 @@ STATIC INLINE BOOL OsTaskIsUserMode(const LosTaskCB *taskCB)
 #define OS_TASK_WAIT_FUTEX      (OS_TASK_WAIT_MUTEX + 1)
 #define OS_TASK_WAIT_EVENT      (OS_TASK_WAIT_FUTEX + 1)
 #define OS_TASK_WAIT_COMPLETE   (OS_TASK_WAIT_EVENT + 1)
+#define OS_TASK_WAIT_MQUEUE     (OS_TASK_WAIT_COMPLETE + 1)
 
 STATIC INLINE VOID OsTaskWaitSetPendMask(UINT16 mask, UINTPTR lockID, UINT32 timeout)
 {
@@ -298,7 +305,8 @@ STATIC INLINE VOID OsTaskWakeClearPendMask(LosTaskCB *resumeTask)
 extern UINT32 OsTaskSetDetachUnsafe(LosTaskCB *taskCB);
 extern VOID OsTaskJoinPostUnsafe(LosTaskCB *taskCB);
 extern UINT32 OsTaskJoinPendUnsafe(LosTaskCB *taskCB);
-extern BOOL OsTaskCpuAffiSetUnsafe(UINT32 taskID, UINT16 newCpuAffiMask, UINT16 *oldCpuAffiMask);
+extern UINT32 OsTaskCpuAffiSetUnsafe(UINT32 taskID, UINT16 newCpuAffiMask, UINT16 *oldCpuAffiMask,
+                                     BOOL *needSched);
 extern VOID OsTaskSchedule(LosTaskCB *, LosTaskCB *);
 extern VOID OsTaskContextLoad(LosTaskCB *newTask);
 extern VOID OsIdleTask(VOID);
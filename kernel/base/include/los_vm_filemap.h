@@ -44,6 +44,8 @@
 #include "los_vm_page.h"
 #include "los_vm_common.h"
 #include "los_vm_phys.h"
+#include "los_slab.h"
+#include "los_radix_tree.h"
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -83,6 +85,15 @@ enum OsPageFlags {
 };
 
 #define PGOFF_MAX                       2000
+#define PAGE_CACHE_TAG_DIRTY            0   /* radix tree tag of the dirty page cache entries */
+#define PAGE_CACHE_GANG_SIZE            16  /* page cache entries fetched per index lookup */
+#define VM_FILE_RA_INIT_PAGES           4   /* first readahead window once a fault stream looks sequential */
+#define VM_FILE_RA_MAX_PAGES            32  /* the window doubles per sequential miss up to this size */
+#define VM_FILE_FAULT_AROUND_PAGES      16  /* aligned window of cached pages mapped by one read fault */
+#define VM_FILE_FLUSH_INTERVAL          5000    /* ms between two write-backs of the dirty cached pages */
+#define VM_FILE_FLUSH_DIRTY_PAGES       256     /* pages dirtied by write() that start a write-back early */
+#define VM_FILE_FLUSH_PRIO              10
+#define VM_FILE_FLUSH_EVENT             0x1
 #define MAX_SHRINK_PAGECACHE_TRY        2
 #define VM_FILEMAP_MAX_SCAN             (SYS_MEM_SIZE_DEFAULT >> PAGE_SHIFT)
 #define VM_FILEMAP_MIN_SCAN             32
@@ -183,12 +194,34 @@ STATIC INLINE BOOL OsIsPageShared(LosVmPage *page)
     return BIT_GET(page->flags, FILE_PAGE_SHARED);
 }
 
+STATIC INLINE VOID OsVmFileRaInit(LosVmFileRa *ra)
+{
+    ra->start = 0;
+    ra->size = 0;
+    ra->asyncSize = 0;
+    /* a first fault on page 0 counts as the start of a sequential stream */
+    ra->prevPgoff = (VM_OFFSET_T)-1;
+}
+
 typedef struct ProcessCB LosProcessCB;
 
+extern LosKmemCache *g_filePageCache;
+extern LosKmemCache *g_mapInfoCache;
+
 #ifdef LOSCFG_FS_VFS
 INT32 OsVfsFileMmap(struct file *filep, LosVmMapRegion *region);
 STATUS_T OsNamedMMap(struct file *filep, LosVmMapRegion *region);
 VOID OsVmmFileRegionFree(struct file *filep, LosProcessCB *processCB);
+
+/*
+ * Buffered file read/write through the page cache of the vnode. A file system opts in by using them
+ * as its read/write file operations, it needs Getattr for the file size, ReadPage/WritePage at byte
+ * positions and a Truncate that can grow the file. Dirty pages are written back by the flusher task.
+ */
+ssize_t VfsGenericFileRead(struct file *filep, char *buf, size_t buflen);
+ssize_t VfsGenericFileWrite(struct file *filep, const char *buf, size_t buflen);
+VOID OsFileCacheDropDirty(struct page_mapping *mapping);
+VOID OsFileCacheTruncate(struct page_mapping *mapping, off_t size);
 #endif
 
 LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff);
@@ -209,6 +242,7 @@ VOID OsPageRefDecNoLock(LosFilePage *page);
 VOID OsPageRefIncLocked(LosFilePage *page);
 int OsTryShrinkMemory(size_t nPage);
 VOID OsMarkPageDirty(LosFilePage *fpage, LosVmMapRegion *region, int off, int len);
+VOID OsVmmFileMapPages(LosVmMapRegion *region, LosVmPgFault *vmf);
 
 #ifdef LOSCFG_DEBUG_VERSION
 VOID ResetPageCacheHitInfo(int *try, int *hit);
@@ -80,8 +80,16 @@ struct VmFileOps {
     void (*close)(struct VmMapRegion *region);
     int  (*fault)(struct VmMapRegion *region, LosVmPgFault *pageFault);
     void (*remove)(struct VmMapRegion *region, LosArchMmu *archMmu, VM_OFFSET_T offset);
+    void (*mapPages)(struct VmMapRegion *region, LosVmPgFault *pageFault); /* map cached pages around a fault */
 };
 
+typedef struct VmFileReadAhead {
+    VM_OFFSET_T         start;          /**< first page of the current readahead window */
+    UINT32              size;           /**< pages in the current window, 0 while access looks random */
+    UINT32              asyncSize;      /**< a hit this many pages before the window end reads the next one */
+    VM_OFFSET_T         prevPgoff;      /**< page offset of the previous fault */
+} LosVmFileRa;
+
 struct VmMapRegion {
     LosRbNode           rbNode;         /**< region red-black tree node */
     LosVmSpace          *space;
@@ -97,6 +105,7 @@ struct VmMapRegion {
             int f_oflags;
             struct Vnode *vnode;
             const LosVmFileOps *vmFOps;
+            LosVmFileRa readAhead;
         } rf;
         struct VmRegionAnon {
             LOS_DL_LIST  node;          /**< region LosVmPage list */
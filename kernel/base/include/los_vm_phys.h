@@ -55,11 +55,43 @@ extern "C" {
 #define VM_ORDER_TO_PHYS(order)  (1 << (PAGE_SHIFT + (order)))
 #define VM_PHYS_TO_ORDER(phys)   (min(LOS_LowBitGet((phys) >> PAGE_SHIFT), VM_LIST_ORDER_MAX - 1))
 
+/* Free pages are grouped by the migrate type of the page block they belong to */
+#define VM_PAGE_BLOCK_ORDER      (VM_LIST_ORDER_MAX - 1)
+#define VM_PAGE_BLOCK_PAGES      VM_ORDER_TO_PAGES(VM_PAGE_BLOCK_ORDER)
+#define VM_PAGE_BLOCK_SHIFT      (PAGE_SHIFT + VM_PAGE_BLOCK_ORDER)
+
+/* LosVmPage.flags bit, set on pages whose contents may be migrated by compaction */
+#define VM_PAGE_FLAG_MOVABLE     31
+
+enum OsVmMigrateType {
+    VM_MIGRATE_UNMOVABLE = 0,
+    VM_MIGRATE_MOVABLE,
+    VM_MIGRATE_PCP_TYPES,
+    VM_MIGRATE_ISOLATE = VM_MIGRATE_PCP_TYPES, /* Page block being emptied by compaction */
+    VM_MIGRATE_TYPE_MAX
+};
+
 struct VmFreeList {
     LOS_DL_LIST node;
     UINT32 listCnt;
 };
 
+#define VM_PCP_HIGH_WATERMARK    64  /* Drain the coldest pages back to buddy above this count */
+#define VM_PCP_LOW_WATERMARK     32  /* Count a drain stops at, so frees near the high mark do not drain each time */
+#define VM_PCP_BATCH             16  /* Pages moved between the buddy and a per-cpu list at once */
+
+/* Per-cpu cache of order-0 pages, hot pages at the head and cold pages at the tail */
+struct VmPcpList {
+    SPIN_LOCK_S lock;
+    LOS_DL_LIST node[VM_MIGRATE_PCP_TYPES];
+    UINT32 count;
+    UINT32 high;
+    UINT32 low;
+    UINT32 batch;
+    UINT32 hitCount;
+    UINT32 fallbackCount;
+};
+
 enum OsLruList {
     VM_LRU_INACTIVE_ANON = 0,
     VM_LRU_ACTIVE_ANON,
@@ -75,7 +107,9 @@ typedef struct VmPhysSeg {
     LosVmPage *pageBase;      /* The first page address of this area */
 
     SPIN_LOCK_S freeListLock; /* The buddy list spinlock */
-    struct VmFreeList freeList[VM_LIST_ORDER_MAX];  /* The free pages in the buddy list */
+    struct VmFreeList freeList[VM_MIGRATE_TYPE_MAX][VM_LIST_ORDER_MAX]; /* The free pages in the buddy list */
+    UINT8 *blockType;         /* The migrate type of each page block */
+    struct VmPcpList pcpList[LOSCFG_KERNEL_CORE_NUM]; /* The order-0 free pages cached per cpu */
 
     SPIN_LOCK_S lruLock;
     size_t lruSize[VM_NR_LRU_LISTS];
@@ -103,8 +137,25 @@ VOID OsPhysSharePageCopy(PADDR_T oldPaddr, PADDR_T *newPaddr, LosVmPage *newPage
 VOID OsVmPhysPagesFreeContiguous(LosVmPage *page, size_t nPages);
 LosVmPage *OsVmPhysToPage(paddr_t pa, UINT8 segID);
 LosVmPage *OsVmPaddrToPage(paddr_t paddr);
+STATIC INLINE BOOL OsVmPageIsMovable(LosVmPage *page)
+{
+    return BIT_GET(page->flags, VM_PAGE_FLAG_MOVABLE);
+}
+
+size_t OsVmPhysBlockTypeAlloc(size_t nPages);
+UINT32 OsVmPhysBlockNumGet(struct VmPhysSeg *seg);
+UINT32 OsVmPhysBlockTypeGet(LosVmPage *page);
+UINT32 OsVmPhysBlockIsolate(struct VmPhysSeg *seg, LosVmPage *block);
+VOID OsVmPhysBlockUnisolate(struct VmPhysSeg *seg, LosVmPage *block, UINT32 type);
+UINT32 OsVmPhysFreeCntGet(struct VmPhysSeg *seg, UINT32 order);
+BOOL OsVmPhysSegAllocable(struct VmPhysSeg *seg, size_t nPages);
+LosVmPage *OsVmPhysMigratePageGet(struct VmPhysSeg *seg);
+size_t OsVmPhysPcpPagesGet(struct VmPhysSeg *seg);
+VOID OsVmPhysPcpStatGet(struct VmPhysSeg *seg, UINT32 *hitCount, UINT32 *fallbackCount);
+size_t OsVmPhysPcpDrainAll(VOID);
 
 LosVmPage *LOS_PhysPageAlloc(VOID);
+LosVmPage *OsVmPhysMovablePageAlloc(VOID);
 VOID LOS_PhysPageFree(LosVmPage *page);
 size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list);
 size_t LOS_PhysPagesFree(LOS_DL_LIST *list);
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __LOS_VM_PIN_H__
+#define __LOS_VM_PIN_H__
+
+#include "los_typedef.h"
+#include "los_vm_page.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#define VM_PIN_BATCH_PAGES      32                  /* pages pinned at once, bounds the stack a pin takes */
+#define VM_PIN_BOUNCE_SIZE      (16 * PAGE_SIZE)    /* bounce buffer for ranges that cannot be pinned */
+
+typedef struct {
+    VADDR_T     uaddr;      /**< user address of the first pinned byte */
+    size_t      len;        /**< bytes covered by the pinned pages */
+    UINT32      count;      /**< number of pinned pages */
+    LosVmPage   *pages[VM_PIN_BATCH_PAGES];
+} LosVmUserPin;
+
+/*
+ * Fault in and pin the user pages under [uaddr, uaddr + len) of the current process, at most
+ * VM_PIN_BATCH_PAGES of them, so pin->len may come back shorter than len. Only anonymous
+ * memory is pinned: file pages need dirty tracking and device memory has no page behind it.
+ */
+STATUS_T LOS_VmUserPin(LosVmUserPin *pin, VADDR_T uaddr, size_t len, BOOL write);
+VOID LOS_VmUserUnpin(LosVmUserPin *pin);
+
+/* kernel alias of byte off of a pinned range, *runLen is how far it stays physically contiguous */
+VOID *LOS_VmUserPinKvaddr(const LosVmUserPin *pin, size_t off, size_t *runLen);
+
+/* moves len bytes between kbuf and the file or device, pos bytes into the request */
+typedef ssize_t (*LosVmUserIoFn)(VOID *arg, VOID *kbuf, size_t len, size_t pos);
+
+/*
+ * Run io over a user buffer without a bounce buffer of the full size. Pinned pages are handed to io
+ * through their kernel alias; ranges that cannot be pinned go through a VM_PIN_BOUNCE_SIZE buffer.
+ * Kernel buffers are passed straight to io. Stops at the first short transfer.
+ * Returns the bytes moved, or a negative errno if nothing was.
+ */
+ssize_t LOS_VmUserBufIo(VOID *buf, size_t len, BOOL toUser, LosVmUserIoFn io, VOID *arg);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* __LOS_VM_PIN_H__ */
@@ -78,27 +78,42 @@ LITE_OS_SEC_TEXT STATIC UINT32 OsEventParamCheck(const VOID *ptr, UINT32 eventMa
     return LOS_OK;
 }
 
-LITE_OS_SEC_TEXT UINT32 OsEventPoll(UINT32 *eventID, UINT32 eventMask, UINT32 mode)
+/*
+ * The event bits are only changed with compare-and-swap, so they can be
+ * polled and consumed without the scheduler lock.
+ */
+STATIC INLINE VOID OsEventBitsUpdate(UINT32 *eventID, UINT32 keepMask, UINT32 events)
 {
-    UINT32 ret = 0;
+    UINT32 oldEvents;
+
+    do {
+        oldEvents = (UINT32)LOS_AtomicRead((Atomic *)eventID);
+    } while (LOS_AtomicCmpXchg32bits((Atomic *)eventID, (INT32)((oldEvents & keepMask) | events), (INT32)oldEvents));
+}
 
-    LOS_ASSERT(OsIntLocked());
-    LOS_ASSERT(LOS_SpinHeld(&g_taskSpin));
+LITE_OS_SEC_TEXT UINT32 OsEventPoll(UINT32 *eventID, UINT32 eventMask, UINT32 mode)
+{
+    UINT32 events;
+    UINT32 ret;
 
-    if (mode & LOS_WAITMODE_OR) {
-        if ((*eventID & eventMask) != 0) {
-            ret = *eventID & eventMask;
+    do {
+        events = (UINT32)LOS_AtomicRead((Atomic *)eventID);
+        ret = 0;
+        if (mode & LOS_WAITMODE_OR) {
+            ret = events & eventMask;
+        } else if ((eventMask != 0) && (eventMask == (events & eventMask))) {
+            ret = eventMask;
         }
-    } else {
-        if ((eventMask != 0) && (eventMask == (*eventID & eventMask))) {
-            ret = *eventID & eventMask;
+
+        if ((ret == 0) || !(mode & LOS_WAITMODE_CLR)) {
+            break;
         }
-    }
+    } while (LOS_AtomicCmpXchg32bits((Atomic *)eventID, (INT32)(events & ~ret), (INT32)events));
 
-    if (ret && (mode & LOS_WAITMODE_CLR)) {
-        *eventID = *eventID & ~ret;
+    if (ret != 0) {
+        /* pairs with the barrier before the bits are set in OsEventWriteUnsafe */
+        DMB;
     }
-
     return ret;
 }
 
@@ -168,19 +183,28 @@ LITE_OS_SEC_TEXT STATIC UINT32 OsEventRead(PEVENT_CB_S eventCB, UINT32 eventMask
         return ret;
     }
 
+    if (once == FALSE) {
+        /* fast path, the events are already there */
+        ret = OsEventPoll(&eventCB->uwEventID, eventMask, mode);
+        if (ret != 0) {
+            OsHookCall(LOS_HOOK_TYPE_EVENT_READ, eventCB, eventMask, mode, timeout);
+            return ret;
+        }
+    }
+
     SCHEDULER_LOCK(intSave);
     ret = OsEventReadImp(eventCB, eventMask, mode, timeout, once);
     SCHEDULER_UNLOCK(intSave);
     return ret;
 }
 
-LITE_OS_SEC_TEXT STATIC UINT8 OsEventResume(LosTaskCB *resumedTask, const PEVENT_CB_S eventCB, UINT32 events)
+LITE_OS_SEC_TEXT STATIC UINT8 OsEventResume(LosTaskCB *resumedTask, UINT32 eventID, UINT32 events)
 {
     UINT8 exitFlag = 0;
 
     if (((resumedTask->eventMode & LOS_WAITMODE_OR) && ((resumedTask->eventMask & events) != 0)) ||
         ((resumedTask->eventMode & LOS_WAITMODE_AND) &&
-        ((resumedTask->eventMask & eventCB->uwEventID) == resumedTask->eventMask))) {
+        ((resumedTask->eventMask & eventID) == resumedTask->eventMask))) {
         exitFlag = 1;
 
         resumedTask->taskEvent = NULL;
@@ -191,18 +215,28 @@ LITE_OS_SEC_TEXT STATIC UINT8 OsEventResume(LosTaskCB *resumedTask, const PEVENT
     return exitFlag;
 }
 
+/*
+ * All the satisfied waiters are made ready in a single pass under the
+ * scheduler lock. Each wake only records the cpu it preempts, the caller
+ * sends one ipi per target cpu with OsSchedPreemptTargetNotify once the
+ * lock is released.
+ */
 LITE_OS_SEC_TEXT VOID OsEventWriteUnsafe(PEVENT_CB_S eventCB, UINT32 events, BOOL once, UINT8 *exitFlag)
 {
     LosTaskCB *resumedTask = NULL;
     LosTaskCB *nextTask = NULL;
     BOOL schedFlag = FALSE;
+    UINT32 eventID;
     OsHookCall(LOS_HOOK_TYPE_EVENT_WRITE, eventCB, events);
-    eventCB->uwEventID |= events;
+    DMB;
+    OsEventBitsUpdate(&eventCB->uwEventID, OS_NULL_INT, events);
     if (!LOS_ListEmpty(&eventCB->stEventList)) {
+        /* AND waiters are checked against one snapshot, a lockless reader may consume bits meanwhile */
+        eventID = (UINT32)LOS_AtomicRead((Atomic *)&eventCB->uwEventID) | events;
         for (resumedTask = LOS_DL_LIST_ENTRY((&eventCB->stEventList)->pstNext, LosTaskCB, pendList);
              &resumedTask->pendList != &eventCB->stEventList;) {
             nextTask = LOS_DL_LIST_ENTRY(resumedTask->pendList.pstNext, LosTaskCB, pendList);
-            if (OsEventResume(resumedTask, eventCB, events)) {
+            if (OsEventResume(resumedTask, eventID, events)) {
                 schedFlag = TRUE;
             }
             if (once == TRUE) {
@@ -235,7 +269,7 @@ LITE_OS_SEC_TEXT STATIC UINT32 OsEventWrite(PEVENT_CB_S eventCB, UINT32 events,
     SCHEDULER_UNLOCK(intSave);
 
     if (exitFlag == 1) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        OsSchedPreemptTargetNotify();
         LOS_Schedule();
     }
     return LOS_OK;
@@ -244,17 +278,13 @@ LITE_OS_SEC_TEXT STATIC UINT32 OsEventWrite(PEVENT_CB_S eventCB, UINT32 events,
 LITE_OS_SEC_TEXT UINT32 LOS_EventPoll(UINT32 *eventID, UINT32 eventMask, UINT32 mode)
 {
     UINT32 ret;
-    UINT32 intSave;
 
     ret = OsEventParamCheck((VOID *)eventID, eventMask, mode);
     if (ret != LOS_OK) {
         return ret;
     }
 
-    SCHEDULER_LOCK(intSave);
-    ret = OsEventPoll(eventID, eventMask, mode);
-    SCHEDULER_UNLOCK(intSave);
-    return ret;
+    return OsEventPoll(eventID, eventMask, mode);
 }
 
 LITE_OS_SEC_TEXT UINT32 LOS_EventRead(PEVENT_CB_S eventCB, UINT32 eventMask, UINT32 mode, UINT32 timeout)
@@ -308,7 +338,7 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_EventClear(PEVENT_CB_S eventCB, UINT32 eventMa
     }
     OsHookCall(LOS_HOOK_TYPE_EVENT_CLEAR, eventCB, eventMask);
     SCHEDULER_LOCK(intSave);
-    eventCB->uwEventID &= eventMask;
+    OsEventBitsUpdate(&eventCB->uwEventID, eventMask, 0);
     SCHEDULER_UNLOCK(intSave);
 
     return LOS_OK;
@@ -329,7 +359,7 @@ LITE_OS_SEC_TEXT UINT32 OsEventReadWithCond(const EventCond *cond, PEVENT_CB_S e
     SCHEDULER_LOCK(intSave);
 
     if (*cond->realValue != cond->value) {
-        eventCB->uwEventID &= cond->clearEvent;
+        OsEventBitsUpdate(&eventCB->uwEventID, cond->clearEvent, 0);
         goto OUT;
     }
 
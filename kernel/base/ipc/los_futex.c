@@ -37,7 +37,6 @@
 #include "los_sched_pri.h"
 #include "los_sys_pri.h"
 #include "los_mp.h"
-#include "los_mux_pri.h"
 #include "user_copy.h"
 
 
@@ -48,56 +47,126 @@
 #define OS_FUTEX_KEY_BASE USER_ASPACE_BASE
 #define OS_FUTEX_KEY_MAX (USER_ASPACE_BASE + USER_ASPACE_SIZE)
 
-/* private: 0~63    hash index_num
- * shared:  64~79   hash index_num */
-#define FUTEX_INDEX_PRIVATE_MAX     64
-#define FUTEX_INDEX_SHARED_MAX      16
-#define FUTEX_INDEX_MAX             (FUTEX_INDEX_PRIVATE_MAX + FUTEX_INDEX_SHARED_MAX)
+/* private: 0 ~ g_futexSharedPos - 1            hash index_num
+ * shared:  g_futexSharedPos ~ g_futexIndexMax - 1  hash index_num
+ * both parts are sized from the task limit when the module is initialized */
+#define FUTEX_INDEX_PRIVATE_MIN     64
+#define FUTEX_INDEX_SHARED_MIN      16
+#define FUTEX_INDEX_SHARED_SHIFT    2
 
-#define FUTEX_INDEX_SHARED_POS      FUTEX_INDEX_PRIVATE_MAX
-#define FUTEX_HASH_PRIVATE_MASK     (FUTEX_INDEX_PRIVATE_MAX - 1)
-#define FUTEX_HASH_SHARED_MASK      (FUTEX_INDEX_SHARED_MAX - 1)
+#define FUTEX_OP_OP(encodedOp)      (((encodedOp) >> 28) & 0x7U)
+#define FUTEX_OP_CMP(encodedOp)     (((encodedOp) >> 24) & 0xFU)
+#define FUTEX_OP_OPARG(encodedOp)   (((INT32)((encodedOp) << 8)) >> 20)
+#define FUTEX_OP_CMPARG(encodedOp)  (((INT32)((encodedOp) << 20)) >> 20)
+#define FUTEX_OP_SHIFT_MAX          31
 
 typedef struct {
-    LosMux      listLock;
+    SPIN_LOCK_S lock;
     LOS_DL_LIST lockList;
+    UINT32      lockCount;      /* number of times the bucket was taken */
+    UINT32      contendCount;   /* number of times it was found held by another cpu */
 } FutexHash;
 
-FutexHash g_futexHash[FUTEX_INDEX_MAX];
+STATIC FutexHash *g_futexHash = NULL;
+STATIC UINT32 g_futexIndexMax;
+STATIC UINT32 g_futexSharedPos;
+STATIC UINT32 g_futexPrivateMask;
+STATIC UINT32 g_futexSharedMask;
 
-STATIC INT32 OsFutexLock(LosMux *lock)
+/*
+ * Bucket critical sections are short and never sleep: user words are only accessed with
+ * the page already mapped, otherwise the caller drops the lock and faults the page in.
+ * Lock order is bucket lock -> g_taskSpin.
+ */
+STATIC INLINE VOID OsFutexBucketLock(FutexHash *hashNode)
 {
-    UINT32 ret = LOS_MuxLock(lock, LOS_WAIT_FOREVER);
-    if (ret != LOS_OK) {
-        PRINT_ERR("Futex lock failed! ERROR: 0x%x!\n", ret);
-        return LOS_EINVAL;
+#ifdef LOSCFG_KERNEL_SMP
+    BOOL contended = LOS_SpinHeld(&hashNode->lock);
+#endif
+
+    LOS_SpinLock(&hashNode->lock);
+    hashNode->lockCount++;
+#ifdef LOSCFG_KERNEL_SMP
+    if (contended) {
+        hashNode->contendCount++;
     }
-    return LOS_OK;
+#endif
 }
 
-STATIC INT32 OsFutexUnlock(LosMux *lock)
+STATIC INLINE VOID OsFutexLock(FutexHash *hashNode, UINT32 *intSave)
 {
-    UINT32 ret = LOS_MuxUnlock(lock);
-    if (ret != LOS_OK) {
-        PRINT_ERR("Futex unlock failed! ERROR: 0x%x!\n", ret);
-        return LOS_EINVAL;
+    *intSave = LOS_IntLock();
+    OsFutexBucketLock(hashNode);
+}
+
+STATIC INLINE VOID OsFutexUnlock(FutexHash *hashNode, UINT32 intSave)
+{
+    LOS_SpinUnlockRestore(&hashNode->lock, intSave);
+}
+
+/* Two buckets are always taken in index order */
+STATIC VOID OsFutexDoubleLock(FutexHash *hashNode1, FutexHash *hashNode2, UINT32 *intSave)
+{
+    if (hashNode1 > hashNode2) {
+        FutexHash *tmpNode = hashNode1;
+        hashNode1 = hashNode2;
+        hashNode2 = tmpNode;
     }
-    return LOS_OK;
+
+    OsFutexLock(hashNode1, intSave);
+    if (hashNode2 != hashNode1) {
+        OsFutexBucketLock(hashNode2);
+    }
+}
+
+STATIC VOID OsFutexDoubleUnlock(FutexHash *hashNode1, FutexHash *hashNode2, UINT32 intSave)
+{
+    if (hashNode1 > hashNode2) {
+        FutexHash *tmpNode = hashNode1;
+        hashNode1 = hashNode2;
+        hashNode2 = tmpNode;
+    }
+
+    if (hashNode2 != hashNode1) {
+        LOS_SpinUnlock(&hashNode2->lock);
+    }
+    OsFutexUnlock(hashNode1, intSave);
+}
+
+STATIC UINT32 OsFutexHashSizeGet(UINT32 minSize, UINT32 shift)
+{
+    UINT32 size = minSize;
+
+    while (size < (g_taskMaxNum >> shift)) {
+        size <<= 1;
+    }
+
+    return size;
 }
 
 UINT32 OsFutexInit(VOID)
 {
-    INT32 count;
-    UINT32 ret;
+    UINT32 count;
+    UINT32 privateNum = OsFutexHashSizeGet(FUTEX_INDEX_PRIVATE_MIN, 0);
+    UINT32 sharedNum = OsFutexHashSizeGet(FUTEX_INDEX_SHARED_MIN, FUTEX_INDEX_SHARED_SHIFT);
 
-    for (count = 0; count < FUTEX_INDEX_MAX; count++) {
+    g_futexHash = (FutexHash *)LOS_MemAlloc(m_aucSysMem0, (privateNum + sharedNum) * sizeof(FutexHash));
+    if (g_futexHash == NULL) {
+        return LOS_ENOMEM;
+    }
+
+    for (count = 0; count < (privateNum + sharedNum); count++) {
+        LOS_SpinInit(&g_futexHash[count].lock);
         LOS_ListInit(&g_futexHash[count].lockList);
-        ret = LOS_MuxInit(&(g_futexHash[count].listLock), NULL);
-        if (ret) {
-            return ret;
-        }
+        g_futexHash[count].lockCount = 0;
+        g_futexHash[count].contendCount = 0;
     }
 
+    g_futexPrivateMask = privateNum - 1;
+    g_futexSharedMask = sharedNum - 1;
+    g_futexSharedPos = privateNum;
+    g_futexIndexMax = privateNum + sharedNum;
+
     return LOS_OK;
 }
 
@@ -134,18 +203,20 @@ STATIC VOID OsFutexShowTaskNodeAttr(const LOS_DL_LIST *futexList)
 VOID OsFutexHashShow(VOID)
 {
     LOS_DL_LIST *futexList = NULL;
-    INT32 count;
-    /* The maximum number of barrels of a hash table */
-    INT32 hashNodeMax = FUTEX_INDEX_MAX;
+    FutexHash *hashNode = NULL;
+    UINT32 count;
+
     PRINTK("#################### los_futex_pri.hash ####################\n");
-    for (count = 0; count < hashNodeMax; count++) {
-        futexList = &(g_futexHash[count].lockList);
-        if (LOS_ListEmpty(futexList)) {
+    PRINTK("private buckets : %u    shared buckets : %u\n", g_futexSharedPos, g_futexIndexMax - g_futexSharedPos);
+    for (count = 0; count < g_futexIndexMax; count++) {
+        hashNode = &g_futexHash[count];
+        if ((hashNode->lockCount == 0) && LOS_ListEmpty(&hashNode->lockList)) {
             continue;
         }
-        PRINTK("hash -> index : %d\n", count);
-        for (futexList = futexList->pstNext;
-             futexList != &(g_futexHash[count].lockList);
+        PRINTK("hash -> index : %u    lock : %u    contended : %u\n", count, hashNode->lockCount,
+               hashNode->contendCount);
+        for (futexList = hashNode->lockList.pstNext;
+             futexList != &(hashNode->lockList);
              futexList = futexList->pstNext) {
                 OsFutexShowTaskNodeAttr(futexList);
         }
@@ -166,18 +237,22 @@ STATIC INLINE UINTPTR OsFutexFlagsToKey(const UINT32 *userVaddr, const UINT32 fl
     return futexKey;
 }
 
-STATIC INLINE UINT32 OsFutexKeyToIndex(const UINTPTR futexKey, const UINT32 flags)
+STATIC INLINE UINT32 OsFutexHashIndexGet(UINTPTR futexKey, UINT32 pid)
 {
     UINT32 index = LOS_HashFNV32aBuf(&futexKey, sizeof(UINTPTR), FNV1_32A_INIT);
 
-    if (flags & FUTEX_PRIVATE) {
-        index &= FUTEX_HASH_PRIVATE_MASK;
-    } else {
-        index &= FUTEX_HASH_SHARED_MASK;
-        index += FUTEX_INDEX_SHARED_POS;
+    if (pid == OS_INVALID) {
+        return (index & g_futexSharedMask) + g_futexSharedPos;
     }
 
-    return index;
+    /* Processes share their user layout, the pid keeps equal uvaddrs from piling up in one bucket */
+    index = LOS_HashFNV32aBuf(&pid, sizeof(UINT32), index);
+    return index & g_futexPrivateMask;
+}
+
+STATIC INLINE UINT32 OsFutexKeyToIndex(const UINTPTR futexKey, const UINT32 flags)
+{
+    return OsFutexHashIndexGet(futexKey, (flags & FUTEX_PRIVATE) ? LOS_GetCurrProcessID() : OS_INVALID);
 }
 
 STATIC INLINE VOID OsFutexSetKey(UINTPTR futexKey, UINT32 flags, FutexNode *node)
@@ -213,7 +288,7 @@ STATIC VOID OsFutexDeleteKeyNodeFromHash(FutexNode *node, BOOL isDeleteHead, Fut
 {
     FutexNode *nextNode = NULL;
 
-    if (node->index >= FUTEX_INDEX_MAX) {
+    if (node->index >= g_futexIndexMax) {
         return;
     }
 
@@ -243,32 +318,31 @@ EXIT:
     return;
 }
 
+/*
+ * Unhashes a node its task left behind on a timeout, a signal or its deletion.
+ * Takes the bucket lock, so it must not be called with the scheduler locked.
+ */
 VOID OsFutexNodeDeleteFromFutexHash(FutexNode *node, BOOL isDeleteHead, FutexNode **headNode, BOOL *queueFlags)
 {
     FutexHash *hashNode = NULL;
+    UINT32 intSave, index;
 
-    UINT32 index = OsFutexKeyToIndex(node->key, (node->pid == OS_INVALID) ? 0 : FUTEX_PRIVATE);
-    if (index >= FUTEX_INDEX_MAX) {
-        return;
-    }
-
-    hashNode = &g_futexHash[index];
-    if (OsMuxLockUnsafe(&hashNode->listLock, LOS_WAIT_FOREVER)) {
-        return;
-    }
-
-    if (node->index != index) {
-        goto EXIT;
-    }
-
-    OsFutexDeleteKeyNodeFromHash(node, isDeleteHead, headNode, queueFlags);
+    for (;;) {
+        /* A requeue may move the node to another bucket until the bucket lock is held */
+        index = *(volatile UINT32 *)&node->index;
+        if (index >= g_futexIndexMax) {
+            return;
+        }
 
-EXIT:
-    if (OsMuxUnlockUnsafe(OsCurrTaskGet(), &hashNode->listLock, NULL)) {
-        return;
+        hashNode = &g_futexHash[index];
+        OsFutexLock(hashNode, &intSave);
+        if (node->index == index) {
+            OsFutexDeleteKeyNodeFromHash(node, isDeleteHead, headNode, queueFlags);
+            OsFutexUnlock(hashNode, intSave);
+            return;
+        }
+        OsFutexUnlock(hashNode, intSave);
     }
-
-    return;
 }
 
 STATIC FutexNode *OsFutexDeleteAlreadyWakeTaskAndGetNext(const FutexNode *node, FutexNode **headNode, BOOL isDeleteHead)
@@ -501,11 +575,13 @@ STATIC INT32 OsFutexWaitParamCheck(const UINT32 *userVaddr, UINT32 flags, UINT32
 {
     VADDR_T vaddr = (VADDR_T)(UINTPTR)userVaddr;
 
+    UINT32 op = flags & (~FUTEX_PRIVATE);
+
     if (OS_INT_ACTIVE) {
         return LOS_EINTR;
     }
 
-    if (flags & (~FUTEX_PRIVATE)) {
+    if ((op != FUTEX_WAIT) && (op != FUTEX_WAIT_BITSET)) {
         PRINT_ERR("Futex wait param check failed! error flags: 0x%x\n", flags);
         return LOS_EINVAL;
     }
@@ -527,35 +603,14 @@ STATIC INT32 OsFutexWaitParamCheck(const UINT32 *userVaddr, UINT32 flags, UINT32
     return LOS_OK;
 }
 
-STATIC INT32 OsFutexDeleteTimeoutTaskNode(FutexHash *hashNode, FutexNode *node)
-{
-    UINT32 intSave;
-    if (OsFutexLock(&hashNode->listLock)) {
-        return LOS_EINVAL;
-    }
-
-    if (node->index < FUTEX_INDEX_MAX) {
-        SCHEDULER_LOCK(intSave);
-        (VOID)OsFutexDeleteAlreadyWakeTaskAndGetNext(node, NULL, TRUE);
-        SCHEDULER_UNLOCK(intSave);
-    }
-
-#ifdef LOS_FUTEX_DEBUG
-    OsFutexHashShow();
-#endif
-
-    if (OsFutexUnlock(&hashNode->listLock)) {
-        return LOS_EINVAL;
-    }
-    return LOS_ETIMEDOUT;
-}
-
-STATIC INT32 OsFutexInsertTaskToHash(LosTaskCB **taskCB, FutexNode **node, const UINTPTR futexKey, const UINT32 flags)
+STATIC INT32 OsFutexInsertTaskToHash(LosTaskCB **taskCB, FutexNode **node, const UINTPTR futexKey, const UINT32 flags,
+                                     const UINT32 bitset)
 {
     INT32 ret;
     *taskCB = OsCurrTaskGet();
     *node = &((*taskCB)->futex);
     OsFutexSetKey(futexKey, flags, *node);
+    (*node)->bitset = bitset;
 
     ret = OsFindAndInsertToHash(*node);
     if (ret) {
@@ -566,51 +621,24 @@ STATIC INT32 OsFutexInsertTaskToHash(LosTaskCB **taskCB, FutexNode **node, const
     return LOS_OK;
 }
 
-STATIC INT32 OsFutexWaitTask(const UINT32 *userVaddr, const UINT32 flags, const UINT32 val, const UINT32 timeout)
+/* Queues the current task on futexKey and sleeps, the bucket lock taken by the caller is released */
+STATIC INT32 OsFutexPendTask(FutexHash *hashNode, UINT32 intSave, const UINTPTR futexKey, const UINT32 flags,
+                             const UINT32 bitset, const UINT32 timeout)
 {
-    INT32 futexRet;
-    UINT32 intSave, lockVal;
+    INT32 futexRet = LOS_OK;
     LosTaskCB *taskCB = NULL;
     FutexNode *node = NULL;
-    UINTPTR futexKey = OsFutexFlagsToKey(userVaddr, flags);
-    UINT32 index = OsFutexKeyToIndex(futexKey, flags);
-    FutexHash *hashNode = &g_futexHash[index];
-
-    if (OsFutexLock(&hashNode->listLock)) {
-        return LOS_EINVAL;
-    }
 
-    if (LOS_ArchCopyFromUser(&lockVal, userVaddr, sizeof(UINT32))) {
-        PRINT_ERR("Futex wait param check failed! copy from user failed!\n");
-        futexRet = LOS_EINVAL;
-        goto EXIT_ERR;
-    }
-
-    if (lockVal != val) {
-        futexRet = LOS_EBADF;
-        goto EXIT_ERR;
-    }
-
-    if (OsFutexInsertTaskToHash(&taskCB, &node, futexKey, flags)) {
-        futexRet = LOS_NOK;
-        goto EXIT_ERR;
+    if (OsFutexInsertTaskToHash(&taskCB, &node, futexKey, flags, bitset)) {
+        OsFutexUnlock(hashNode, intSave);
+        return LOS_NOK;
     }
 
-    SCHEDULER_LOCK(intSave);
-    OsSchedLock();
+    /* The task lock is taken before the bucket is released, so a waker can not miss the task */
+    LOS_SpinLock(&g_taskSpin);
     OsTaskWaitSetPendMask(OS_TASK_WAIT_FUTEX, futexKey, timeout);
     taskCB->ops->wait(taskCB, &(node->pendList), timeout);
-    LOS_SpinUnlock(&g_taskSpin);
-
-    futexRet = OsFutexUnlock(&hashNode->listLock);
-    if (futexRet) {
-        OsSchedUnlock();
-        LOS_IntRestore(intSave);
-        goto EXIT_UNLOCK_ERR;
-    }
-
-    LOS_SpinLock(&g_taskSpin);
-    OsSchedUnlock();
+    LOS_SpinUnlock(&hashNode->lock);
 
     /*
      * it will immediately do the scheduling, so there's no need to release the
@@ -620,40 +648,105 @@ STATIC INT32 OsFutexWaitTask(const UINT32 *userVaddr, const UINT32 flags, const
 
     if (taskCB->taskStatus & OS_TASK_STATUS_TIMEOUT) {
         taskCB->taskStatus &= ~OS_TASK_STATUS_TIMEOUT;
-        SCHEDULER_UNLOCK(intSave);
-        return OsFutexDeleteTimeoutTaskNode(hashNode, node);
+        futexRet = LOS_ETIMEDOUT;
     }
-
     SCHEDULER_UNLOCK(intSave);
-    return LOS_OK;
 
-EXIT_ERR:
-    (VOID)OsFutexUnlock(&hashNode->listLock);
-EXIT_UNLOCK_ERR:
+    /* Wakers unhash the nodes they wake, a timeout or a signal leaves it to the task itself */
+    OsFutexNodeDeleteFromFutexHash(node, TRUE, NULL, NULL);
+
+#ifdef LOS_FUTEX_DEBUG
+    if (futexRet == LOS_ETIMEDOUT) {
+        OsFutexHashShow();
+    }
+#endif
+
     return futexRet;
 }
 
+/* Faults the user word in with no bucket held, so that the access can be retried under the bucket lock */
+STATIC INT32 OsFutexUserWordFault(const UINT32 *userVaddr, BOOL write)
+{
+    UINT32 val;
+
+    if (LOS_ArchCopyFromUser(&val, userVaddr, sizeof(UINT32))) {
+        return LOS_EFAULT;
+    }
+
+    /* Storing the same value breaks copy on write without changing the word */
+    if (write && LOS_ArchUserCmpXchg32((UINT32 *)userVaddr, val, val, &val)) {
+        return LOS_EFAULT;
+    }
+
+    return LOS_OK;
+}
+
+STATIC INT32 OsFutexWaitTask(const UINT32 *userVaddr, const UINT32 flags, const UINT32 val, const UINT32 timeout,
+                             const UINT32 bitset)
+{
+    UINT32 lockVal, intSave;
+    UINTPTR futexKey = OsFutexFlagsToKey(userVaddr, flags);
+    UINT32 index = OsFutexKeyToIndex(futexKey, flags);
+    FutexHash *hashNode = &g_futexHash[index];
+
+    for (;;) {
+        OsFutexLock(hashNode, &intSave);
+        if (LOS_ArchCopyFromUser(&lockVal, userVaddr, sizeof(UINT32)) == 0) {
+            break;
+        }
+        OsFutexUnlock(hashNode, intSave);
+
+        if (OsFutexUserWordFault(userVaddr, FALSE)) {
+            PRINT_ERR("Futex wait param check failed! copy from user failed!\n");
+            return LOS_EINVAL;
+        }
+    }
+
+    if (lockVal != val) {
+        OsFutexUnlock(hashNode, intSave);
+        return LOS_EBADF;
+    }
+
+    return OsFutexPendTask(hashNode, intSave, futexKey, flags, bitset, timeout);
+}
+
+STATIC UINT32 OsFutexTimeToTick(UINT32 absTime)
+{
+    if (absTime == LOS_WAIT_FOREVER) {
+        return LOS_WAIT_FOREVER;
+    }
+
+    return OsNS2Tick((UINT64)absTime * OS_SYS_NS_PER_US);
+}
+
 INT32 OsFutexWait(const UINT32 *userVaddr, UINT32 flags, UINT32 val, UINT32 absTime)
+{
+    return OsFutexWaitBitset(userVaddr, flags, val, absTime, FUTEX_BITSET_MATCH_ANY);
+}
+
+INT32 OsFutexWaitBitset(const UINT32 *userVaddr, UINT32 flags, UINT32 val, UINT32 absTime, UINT32 bitset)
 {
     INT32 ret;
-    UINT32 timeout = LOS_WAIT_FOREVER;
+
+    if (bitset == 0) {
+        return LOS_EINVAL;
+    }
 
     ret = OsFutexWaitParamCheck(userVaddr, flags, absTime);
     if (ret) {
         return ret;
     }
-    if (absTime != LOS_WAIT_FOREVER) {
-        timeout = OsNS2Tick((UINT64)absTime * OS_SYS_NS_PER_US);
-    }
 
-    return OsFutexWaitTask(userVaddr, flags, val, timeout);
+    return OsFutexWaitTask(userVaddr, flags, val, OsFutexTimeToTick(absTime), bitset);
 }
 
 STATIC INT32 OsFutexWakeParamCheck(const UINT32 *userVaddr, UINT32 flags)
 {
     VADDR_T vaddr = (VADDR_T)(UINTPTR)userVaddr;
 
-    if ((flags & (~FUTEX_PRIVATE)) != FUTEX_WAKE) {
+    UINT32 op = flags & (~FUTEX_PRIVATE);
+
+    if ((op != FUTEX_WAKE) && (op != FUTEX_WAKE_BITSET) && (op != FUTEX_WAKE_OP)) {
         PRINT_ERR("Futex wake param check failed! error flags: 0x%x\n", flags);
         return LOS_EINVAL;
     }
@@ -733,7 +826,7 @@ STATIC INT32 OsFutexWakeTask(UINTPTR futexKey, UINT32 flags, INT32 wakeNumber, F
     if ((*newHeadNode) != NULL) {
         OsFutexReplaceQueueListHeadNode(headNode, *newHeadNode);
         OsFutexDeinitFutexNode(headNode);
-    } else if (headNode->index < FUTEX_INDEX_MAX) {
+    } else if (headNode->index < g_futexIndexMax) {
         OsFutexDeleteKeyFromFutexList(headNode);
         OsFutexDeinitFutexNode(headNode);
     }
@@ -742,16 +835,103 @@ STATIC INT32 OsFutexWakeTask(UINTPTR futexKey, UINT32 flags, INT32 wakeNumber, F
     return LOS_OK;
 }
 
+STATIC FutexNode *OsFutexHeadNodeGet(UINTPTR futexKey, UINT32 flags)
+{
+    FutexNode tempNode = {
+        .key = futexKey,
+        .index = OsFutexKeyToIndex(futexKey, flags),
+        .pid = (flags & FUTEX_PRIVATE) ? LOS_GetCurrProcessID() : OS_INVALID,
+    };
+
+    return OsFindFutexNode(&tempNode);
+}
+
+STATIC VOID OsFutexWakeNode(FutexNode *node, BOOL *wakeAny)
+{
+    LosTaskCB *taskCB = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&(node->pendList)));
+    OsTaskWakeClearPendMask(taskCB);
+    taskCB->ops->wake(taskCB);
+    *wakeAny = TRUE;
+}
+
+/* Wakes the task of the head node and hands the head over to the next node, with the scheduler locked */
+STATIC VOID OsFutexWakeHeadNode(FutexNode *headNode, BOOL *wakeAny)
+{
+    OsFutexWakeNode(headNode, wakeAny);
+    if (LOS_ListEmpty(&headNode->queueList)) {
+        OsFutexDeleteKeyFromFutexList(headNode);
+    } else {
+        OsFutexReplaceQueueListHeadNode(headNode,
+            OS_FUTEX_FROM_QUEUELIST(LOS_DL_LIST_FIRST(&headNode->queueList)));
+    }
+    OsFutexDeinitFutexNode(headNode);
+}
+
+/* Wakes up to wakeNumber waiters whose bitset intersects bitset, in queue order */
+STATIC INT32 OsFutexWakeBitsetTask(UINTPTR futexKey, UINT32 flags, INT32 wakeNumber, UINT32 bitset, BOOL *wakeAny)
+{
+    UINT32 intSave;
+    INT32 count;
+    BOOL wakeHead = FALSE;
+    FutexNode *node = NULL;
+    FutexNode *next = NULL;
+    FutexNode *headNode = OsFutexHeadNodeGet(futexKey, flags);
+    if (headNode == NULL) {
+        return LOS_EBADF;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    headNode = OsFutexDeleteAlreadyWakeTaskAndGetNext(headNode, NULL, TRUE);
+    if (headNode == NULL) {
+        SCHEDULER_UNLOCK(intSave);
+        return LOS_OK;
+    }
+
+    wakeHead = ((headNode->bitset & bitset) != 0);
+    count = wakeHead ? 1 : 0;
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(node, next, &headNode->queueList, FutexNode, queueList) {
+        if (count >= wakeNumber) {
+            break;
+        }
+
+        if (LOS_ListEmpty(&node->pendList)) {
+            /* already woken up or timed out */
+            OsFutexDeinitFutexNode(node);
+            continue;
+        }
+
+        if ((node->bitset & bitset) == 0) {
+            continue;
+        }
+
+        OsFutexWakeNode(node, wakeAny);
+        OsFutexDeinitFutexNode(node);
+        count++;
+    }
+
+    if (wakeHead) {
+        OsFutexWakeHeadNode(headNode, wakeAny);
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    return LOS_OK;
+}
+
 INT32 OsFutexWake(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber)
 {
-    INT32 ret, futexRet;
+    return OsFutexWakeBitset(userVaddr, flags, wakeNumber, FUTEX_BITSET_MATCH_ANY);
+}
+
+INT32 OsFutexWakeBitset(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, UINT32 bitset)
+{
+    INT32 ret;
     UINTPTR futexKey;
-    UINT32 index;
+    UINT32 index, intSave;
     FutexHash *hashNode = NULL;
     FutexNode *headNode = NULL;
     BOOL wakeAny = FALSE;
 
-    if (OsFutexWakeParamCheck(userVaddr, flags)) {
+    if ((bitset == 0) || OsFutexWakeParamCheck(userVaddr, flags)) {
         return LOS_EINVAL;
     }
 
@@ -759,38 +939,29 @@ INT32 OsFutexWake(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber)
     index = OsFutexKeyToIndex(futexKey, flags);
 
     hashNode = &g_futexHash[index];
-    if (OsFutexLock(&hashNode->listLock)) {
-        return LOS_EINVAL;
-    }
+    OsFutexLock(hashNode, &intSave);
 
-    ret = OsFutexWakeTask(futexKey, flags, wakeNumber, &headNode, &wakeAny);
+    if (bitset == FUTEX_BITSET_MATCH_ANY) {
+        ret = OsFutexWakeTask(futexKey, flags, wakeNumber, &headNode, &wakeAny);
+    } else {
+        ret = OsFutexWakeBitsetTask(futexKey, flags, wakeNumber, bitset, &wakeAny);
+    }
     if (ret) {
-        goto EXIT_ERR;
+        OsFutexUnlock(hashNode, intSave);
+        return ret;
     }
 
 #ifdef LOS_FUTEX_DEBUG
     OsFutexHashShow();
 #endif
 
-    futexRet = OsFutexUnlock(&hashNode->listLock);
-    if (futexRet) {
-        goto EXIT_UNLOCK_ERR;
-    }
-
+    OsFutexUnlock(hashNode, intSave);
     if (wakeAny == TRUE) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        OsSchedPreemptTargetNotify();
         LOS_Schedule();
     }
 
     return LOS_OK;
-
-EXIT_ERR:
-    futexRet = OsFutexUnlock(&hashNode->listLock);
-EXIT_UNLOCK_ERR:
-    if (futexRet) {
-        return futexRet;
-    }
-    return ret;
 }
 
 STATIC INT32 OsFutexRequeueInsertNewKey(UINTPTR newFutexKey, INT32 newIndex, FutexNode *oldHeadNode)
@@ -803,7 +974,7 @@ STATIC INT32 OsFutexRequeueInsertNewKey(UINTPTR newFutexKey, INT32 newIndex, Fut
     FutexNode newTempNode = {
         .key = newFutexKey,
         .index = newIndex,
-        .pid = (newIndex < FUTEX_INDEX_SHARED_POS) ? LOS_GetCurrProcessID() : OS_INVALID,
+        .pid = ((UINT32)newIndex < g_futexSharedPos) ? LOS_GetCurrProcessID() : OS_INVALID,
     };
     LOS_DL_LIST *queueList = &oldHeadNode->queueList;
     FutexNode *newHeadNode = OsFindFutexNode(&newTempNode);
@@ -952,6 +1123,7 @@ STATIC INT32 OsFutexRequeueParamCheck(const UINT32 *oldUserVaddr, UINT32 flags,
 INT32 OsFutexRequeue(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, INT32 count, const UINT32 *newUserVaddr)
 {
     INT32 ret;
+    UINT32 intSave;
     UINTPTR oldFutexKey;
     UINTPTR newFutexKey;
     INT32 oldIndex;
@@ -970,14 +1142,14 @@ INT32 OsFutexRequeue(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, IN
     oldIndex = OsFutexKeyToIndex(oldFutexKey, flags);
     newIndex = OsFutexKeyToIndex(newFutexKey, flags);
 
+    /* Both buckets are held so that requeued nodes are never between two buckets unlocked */
     oldHashNode = &g_futexHash[oldIndex];
-    if (OsFutexLock(&oldHashNode->listLock)) {
-        return LOS_EINVAL;
-    }
+    newHashNode = &g_futexHash[newIndex];
+    OsFutexDoubleLock(oldHashNode, newHashNode, &intSave);
 
     oldHeadNode = OsFutexRequeueRemoveOldKeyAndGetHead(oldFutexKey, flags, wakeNumber, newFutexKey, count, &wakeAny);
     if (oldHeadNode == NULL) {
-        (VOID)OsFutexUnlock(&oldHashNode->listLock);
+        OsFutexDoubleUnlock(oldHashNode, newHashNode, intSave);
         if (wakeAny == TRUE) {
             ret = LOS_OK;
             goto EXIT;
@@ -985,30 +1157,490 @@ INT32 OsFutexRequeue(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, IN
         return LOS_EBADF;
     }
 
-    newHashNode = &g_futexHash[newIndex];
-    if (oldIndex != newIndex) {
-        if (OsFutexUnlock(&oldHashNode->listLock)) {
-            return LOS_EINVAL;
+    ret = OsFutexRequeueInsertNewKey(newFutexKey, newIndex, oldHeadNode);
+    OsFutexDoubleUnlock(oldHashNode, newHashNode, intSave);
+
+EXIT:
+    if (wakeAny == TRUE) {
+        OsSchedPreemptTargetNotify();
+        LOS_Schedule();
+    }
+
+    return ret;
+}
+
+STATIC INT32 OsFutexUserAddrCheck(const UINT32 *userVaddr, UINT32 flags)
+{
+    VADDR_T vaddr = (VADDR_T)(UINTPTR)userVaddr;
+
+    if ((vaddr % sizeof(INT32)) || (vaddr < OS_FUTEX_KEY_BASE) || (vaddr >= OS_FUTEX_KEY_MAX)) {
+        PRINT_ERR("Futex param check failed! error userVaddr: 0x%x\n", userVaddr);
+        return LOS_EINVAL;
+    }
+
+    if (flags && (OsFutexKeyShmPermCheck(userVaddr, flags) != LOS_OK)) {
+        PRINT_ERR("Futex param check failed! error shared memory perm userVaddr: 0x%x\n", userVaddr);
+        return LOS_EINVAL;
+    }
+
+    return LOS_OK;
+}
+
+STATIC INT32 OsFutexWakeOpCheck(UINT32 encodedOp)
+{
+    UINT32 op = FUTEX_OP_OP(encodedOp);
+    INT32 oparg = FUTEX_OP_OPARG(encodedOp);
+
+    if ((op > FUTEX_OP_XOR) || (FUTEX_OP_CMP(encodedOp) > FUTEX_OP_CMP_GE)) {
+        return LOS_EOPNOTSUPP;
+    }
+
+    if ((encodedOp & ((UINT32)FUTEX_OP_OPARG_SHIFT << 28)) && ((oparg < 0) || (oparg > FUTEX_OP_SHIFT_MAX))) {
+        return LOS_EINVAL;
+    }
+
+    return LOS_OK;
+}
+
+/* Applies the operation of encodedOp to the user word and returns the value it replaced */
+STATIC INT32 OsFutexAtomicOp(UINT32 *userVaddr, UINT32 encodedOp, UINT32 *oldVal)
+{
+    UINT32 curVal, newVal, prevVal;
+    UINT32 oparg = (UINT32)FUTEX_OP_OPARG(encodedOp);
+
+    if (encodedOp & ((UINT32)FUTEX_OP_OPARG_SHIFT << 28)) {
+        oparg = 1U << oparg;
+    }
+
+    if (LOS_ArchCopyFromUser(&curVal, userVaddr, sizeof(UINT32))) {
+        return LOS_EFAULT;
+    }
+
+    for (;;) {
+        switch (FUTEX_OP_OP(encodedOp)) {
+            case FUTEX_OP_SET:
+                newVal = oparg;
+                break;
+            case FUTEX_OP_ADD:
+                newVal = curVal + oparg;
+                break;
+            case FUTEX_OP_OR:
+                newVal = curVal | oparg;
+                break;
+            case FUTEX_OP_ANDN:
+                newVal = curVal & ~oparg;
+                break;
+            default:
+                newVal = curVal ^ oparg;
+                break;
         }
 
-        if (OsFutexLock(&newHashNode->listLock)) {
-            return LOS_EINVAL;
+        if (LOS_ArchUserCmpXchg32(userVaddr, curVal, newVal, &prevVal)) {
+            return LOS_EFAULT;
+        }
+
+        if (prevVal == curVal) {
+            break;
         }
+        curVal = prevVal;
     }
 
-    ret = OsFutexRequeueInsertNewKey(newFutexKey, newIndex, oldHeadNode);
+    *oldVal = curVal;
+    return LOS_OK;
+}
+
+STATIC BOOL OsFutexOpCmp(UINT32 encodedOp, UINT32 oldVal)
+{
+    INT32 val = (INT32)oldVal;
+    INT32 cmparg = FUTEX_OP_CMPARG(encodedOp);
+
+    switch (FUTEX_OP_CMP(encodedOp)) {
+        case FUTEX_OP_CMP_EQ:
+            return (val == cmparg);
+        case FUTEX_OP_CMP_NE:
+            return (val != cmparg);
+        case FUTEX_OP_CMP_LT:
+            return (val < cmparg);
+        case FUTEX_OP_CMP_LE:
+            return (val <= cmparg);
+        case FUTEX_OP_CMP_GT:
+            return (val > cmparg);
+        default:
+            return (val >= cmparg);
+    }
+}
 
-    if (OsFutexUnlock(&newHashNode->listLock)) {
+STATIC VOID OsFutexWakeOpTask(UINTPTR futexKey, UINT32 flags, INT32 wakeNumber, BOOL *wakeAny)
+{
+    FutexNode *headNode = NULL;
+
+    if (wakeNumber <= 0) {
+        return;
+    }
+
+    (VOID)OsFutexWakeTask(futexKey, flags, wakeNumber, &headNode, wakeAny);
+}
+
+INT32 OsFutexWakeOp(const UINT32 *userVaddr, UINT32 flags, INT32 wakeNumber, INT32 wakeNumber2,
+                    const UINT32 *userVaddr2, UINT32 op)
+{
+    INT32 ret;
+    UINT32 oldVal, intSave;
+    UINTPTR futexKey, futexKey2;
+    FutexHash *hashNode = NULL;
+    FutexHash *hashNode2 = NULL;
+    BOOL wakeAny = FALSE;
+
+    if (OsFutexWakeParamCheck(userVaddr, flags) || OsFutexUserAddrCheck(userVaddr2, flags)) {
         return LOS_EINVAL;
     }
 
-EXIT:
+    ret = OsFutexWakeOpCheck(op);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    futexKey = OsFutexFlagsToKey(userVaddr, flags);
+    futexKey2 = OsFutexFlagsToKey(userVaddr2, flags);
+    hashNode = &g_futexHash[OsFutexKeyToIndex(futexKey, flags)];
+    hashNode2 = &g_futexHash[OsFutexKeyToIndex(futexKey2, flags)];
+
+    /* Both buckets are held across the update */
+    for (;;) {
+        OsFutexDoubleLock(hashNode, hashNode2, &intSave);
+        ret = OsFutexAtomicOp((UINT32 *)userVaddr2, op, &oldVal);
+        if (ret == LOS_OK) {
+            break;
+        }
+        OsFutexDoubleUnlock(hashNode, hashNode2, intSave);
+
+        if (OsFutexUserWordFault(userVaddr2, TRUE)) {
+            return LOS_EFAULT;
+        }
+    }
+
+    OsFutexWakeOpTask(futexKey, flags, wakeNumber, &wakeAny);
+    if (OsFutexOpCmp(op, oldVal)) {
+        OsFutexWakeOpTask(futexKey2, flags, wakeNumber2, &wakeAny);
+    }
+
+    OsFutexDoubleUnlock(hashNode, hashNode2, intSave);
     if (wakeAny == TRUE) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        OsSchedPreemptTargetNotify();
         LOS_Schedule();
     }
 
+    return LOS_OK;
+}
+
+STATIC INT32 OsFutexPiParamCheck(const UINT32 *userVaddr, UINT32 flags)
+{
+    UINT32 op = flags & (~FUTEX_PRIVATE);
+
+    if (OS_INT_ACTIVE) {
+        return LOS_EINTR;
+    }
+
+    if ((op != FUTEX_LOCK_PI) && (op != FUTEX_TRYLOCK_PI) && (op != FUTEX_UNLOCK_PI)) {
+        PRINT_ERR("Futex pi param check failed! error flags: 0x%x\n", flags);
+        return LOS_EINVAL;
+    }
+
+    return OsFutexUserAddrCheck(userVaddr, flags);
+}
+
+STATIC INT32 OsFutexPiOwnerGet(UINT32 futexVal, UINT32 flags, LosTaskCB **owner)
+{
+    UINT32 taskID = futexVal & FUTEX_TID_MASK;
+    LosTaskCB *taskCB = NULL;
+
+    if (OS_TID_CHECK_INVALID(taskID)) {
+        return LOS_ESRCH;
+    }
+
+    taskCB = OS_TCB_FROM_TID(taskID);
+    if (OsTaskIsUnused(taskCB)) {
+        return LOS_ESRCH;
+    }
+
+    if ((flags & FUTEX_PRIVATE) && (taskCB->processID != LOS_GetCurrProcessID())) {
+        return LOS_ESRCH;
+    }
+
+    *owner = taskCB;
+    return LOS_OK;
+}
+
+/* Takes the user word if it has no owner, otherwise returns LOS_EBUSY and the current value */
+STATIC INT32 OsFutexPiTryAcquire(UINT32 *userVaddr, UINT32 taskID, UINT32 *curVal)
+{
+    UINT32 val, prevVal;
+
+    if (LOS_ArchCopyFromUser(&val, userVaddr, sizeof(UINT32))) {
+        return LOS_EFAULT;
+    }
+
+    while ((val & FUTEX_TID_MASK) == 0) {
+        if (LOS_ArchUserCmpXchg32(userVaddr, val, taskID | (val & FUTEX_WAITERS), &prevVal)) {
+            return LOS_EFAULT;
+        }
+
+        if (prevVal == val) {
+            return LOS_OK;
+        }
+        val = prevVal;
+    }
+
+    *curVal = val;
+    return LOS_EBUSY;
+}
+
+STATIC VOID OsFutexPiInherit(LosTaskCB *owner, const LosTaskCB *waiter)
+{
+    SchedParam param = { 0 };
+
+    if (OsSchedParamCompare(owner, waiter) > 0) {
+        waiter->ops->schedParamGet(waiter, &param);
+        owner->ops->priorityInheritance(owner, &param);
+    }
+}
+
+STATIC VOID OsFutexPiRestore(LosTaskCB *owner, const LosTaskCB *waiter)
+{
+    SchedParam param = { 0 };
+
+    /* a waiter less important than the owner never lent it anything */
+    if ((waiter == NULL) || (OsSchedParamCompare(owner, waiter) < 0)) {
+        return;
+    }
+
+    waiter->ops->schedParamGet(waiter, &param);
+    owner->ops->priorityRestore(owner, NULL, &param);
+}
+
+/* The highest priority task still queued on futexKey, with the bucket and the scheduler locked */
+STATIC LosTaskCB *OsFutexPiTopWaiterGet(UINTPTR futexKey, UINT32 flags)
+{
+    FutexNode *headNode = OsFutexHeadNodeGet(futexKey, flags);
+    if (headNode != NULL) {
+        headNode = OsFutexDeleteAlreadyWakeTaskAndGetNext(headNode, NULL, TRUE);
+    }
+    if (headNode == NULL) {
+        return NULL;
+    }
+
+    return OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&(headNode->pendList)));
+}
+
+/* A waiter gave up, the owner drops its boost but keeps the one of the waiters left behind */
+STATIC VOID OsFutexPiWaiterLeave(const UINT32 *userVaddr, UINTPTR futexKey, UINT32 flags, FutexHash *hashNode)
+{
+    UINT32 intSave, schedSave, curVal;
+    LosTaskCB *owner = NULL;
+    LosTaskCB *topWaiter = NULL;
+
+    if (LOS_ArchCopyFromUser(&curVal, userVaddr, sizeof(UINT32))) {
+        return;
+    }
+
+    OsFutexLock(hashNode, &intSave);
+    if (OsFutexPiOwnerGet(curVal, flags, &owner) == LOS_OK) {
+        SCHEDULER_LOCK(schedSave);
+        OsFutexPiRestore(owner, OsCurrTaskGet());
+        topWaiter = OsFutexPiTopWaiterGet(futexKey, flags);
+        if (topWaiter != NULL) {
+            OsFutexPiInherit(owner, topWaiter);
+        }
+        SCHEDULER_UNLOCK(schedSave);
+    }
+    OsFutexUnlock(hashNode, intSave);
+}
+
+INT32 OsFutexLockPi(const UINT32 *userVaddr, UINT32 flags, UINT32 absTime, BOOL isTry)
+{
+    INT32 ret;
+    UINT32 intSave, schedSave, curVal, prevVal;
+    UINTPTR futexKey;
+    FutexHash *hashNode = NULL;
+    LosTaskCB *owner = NULL;
+    LosTaskCB *runTask = OsCurrTaskGet();
+    UINT32 timeout = OsFutexTimeToTick(absTime);
+
+    ret = OsFutexPiParamCheck(userVaddr, flags);
+    if (ret) {
+        return ret;
+    }
+
+    futexKey = OsFutexFlagsToKey(userVaddr, flags);
+    hashNode = &g_futexHash[OsFutexKeyToIndex(futexKey, flags)];
+
+    for (;;) {
+        OsFutexLock(hashNode, &intSave);
+
+        ret = OsFutexPiTryAcquire((UINT32 *)userVaddr, runTask->taskID, &curVal);
+        if (ret == LOS_EFAULT) {
+            goto FAULT;
+        } else if (ret != LOS_EBUSY) {
+            goto EXIT;
+        }
+
+        if ((curVal & FUTEX_TID_MASK) == runTask->taskID) {
+            ret = LOS_EDEADLK;
+            goto EXIT;
+        }
+
+        if (isTry || !timeout) {
+            ret = isTry ? LOS_EBUSY : LOS_ETIMEDOUT;
+            goto EXIT;
+        }
+
+        /* From here on the owner can no longer release the lock in user space */
+        if (!(curVal & FUTEX_WAITERS)) {
+            if (LOS_ArchUserCmpXchg32((UINT32 *)userVaddr, curVal, curVal | FUTEX_WAITERS, &prevVal)) {
+                goto FAULT;
+            }
+
+            if (prevVal != curVal) {
+                OsFutexUnlock(hashNode, intSave);
+                continue;
+            }
+        }
+
+        ret = OsFutexPiOwnerGet(curVal, flags, &owner);
+        if (ret != LOS_OK) {
+            goto EXIT;
+        }
+
+        SCHEDULER_LOCK(schedSave);
+        OsFutexPiInherit(owner, runTask);
+        SCHEDULER_UNLOCK(schedSave);
+
+        ret = OsFutexPendTask(hashNode, intSave, futexKey, flags, FUTEX_BITSET_MATCH_ANY, timeout);
+
+        /*
+         * OsFutexUnlockPi wakes the new owner before it writes the word, both under the bucket lock.
+         * Passing through the lock makes the word final, it may name this task even if the wait gave up.
+         */
+        OsFutexLock(hashNode, &intSave);
+        OsFutexUnlock(hashNode, intSave);
+        if (LOS_ArchCopyFromUser(&curVal, userVaddr, sizeof(UINT32))) {
+            return LOS_EFAULT;
+        }
+
+        if ((curVal & FUTEX_TID_MASK) == runTask->taskID) {
+            return LOS_OK;
+        }
+
+        if (ret != LOS_OK) {
+            OsFutexPiWaiterLeave(userVaddr, futexKey, flags, hashNode);
+            return ret;
+        }
+        continue;
+
+FAULT:
+        OsFutexUnlock(hashNode, intSave);
+        if (OsFutexUserWordFault(userVaddr, TRUE)) {
+            return LOS_EFAULT;
+        }
+    }
+
+EXIT:
+    OsFutexUnlock(hashNode, intSave);
+    return ret;
+}
+
+INT32 OsFutexUnlockPi(const UINT32 *userVaddr, UINT32 flags)
+{
+    INT32 ret;
+    UINT32 intSave, schedSave, curVal, newVal, prevVal;
+    UINTPTR futexKey;
+    FutexHash *hashNode = NULL;
+    FutexNode *headNode = NULL;
+    LosTaskCB *newOwner = NULL;
+    LosTaskCB *topWaiter = NULL;
+    LosTaskCB *runTask = OsCurrTaskGet();
+    BOOL wakeAny = FALSE;
+
+    ret = OsFutexPiParamCheck(userVaddr, flags);
+    if (ret) {
+        return ret;
+    }
+
+    futexKey = OsFutexFlagsToKey(userVaddr, flags);
+    hashNode = &g_futexHash[OsFutexKeyToIndex(futexKey, flags)];
+
+RETRY:
+    OsFutexLock(hashNode, &intSave);
+    if (LOS_ArchCopyFromUser(&curVal, userVaddr, sizeof(UINT32))) {
+        goto FAULT;
+    }
+
+    if ((curVal & FUTEX_TID_MASK) != runTask->taskID) {
+        ret = LOS_EPERM;
+        goto EXIT;
+    }
+
+    /*
+     * The highest priority waiter becomes the owner directly. It is woken in the section that picks it,
+     * so it can no longer time out, and it reads the word only once the bucket lock is dropped.
+     */
+    newVal = 0;
+    newOwner = NULL;
+    headNode = OsFutexHeadNodeGet(futexKey, flags);
+    SCHEDULER_LOCK(schedSave);
+    if (headNode != NULL) {
+        headNode = OsFutexDeleteAlreadyWakeTaskAndGetNext(headNode, NULL, TRUE);
+    }
+    if (headNode != NULL) {
+        newOwner = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&(headNode->pendList)));
+        newVal = newOwner->taskID;
+        if (!LOS_ListEmpty(&headNode->queueList)) {
+            newVal |= FUTEX_WAITERS;
+        }
+        OsFutexWakeHeadNode(headNode, &wakeAny);
+    }
+    SCHEDULER_UNLOCK(schedSave);
+
+    if (LOS_ArchUserCmpXchg32((UINT32 *)userVaddr, curVal, newVal, &prevVal)) {
+        goto FAULT;
+    }
+
+    if (prevVal != curVal) {
+        /* the woken waiter finds the word unchanged and queues again */
+        ret = LOS_EAGAIN;
+        goto EXIT;
+    }
+
+    if (newOwner != NULL) {
+        /* The new owner inherits from the waiters left behind */
+        SCHEDULER_LOCK(schedSave);
+        OsFutexPiRestore(runTask, newOwner);
+        topWaiter = OsFutexPiTopWaiterGet(futexKey, flags);
+        if (topWaiter != NULL) {
+            OsFutexPiInherit(newOwner, topWaiter);
+        }
+        SCHEDULER_UNLOCK(schedSave);
+    }
+
+EXIT:
+    OsFutexUnlock(hashNode, intSave);
+    if (wakeAny == TRUE) {
+        OsSchedPreemptTargetNotify();
+        LOS_Schedule();
+    }
     return ret;
+
+FAULT:
+    OsFutexUnlock(hashNode, intSave);
+    if (OsFutexUserWordFault(userVaddr, TRUE)) {
+        if (wakeAny == TRUE) {
+            /* the picked waiter finds the word unchanged and queues again */
+            OsSchedPreemptTargetNotify();
+            LOS_Schedule();
+        }
+        return LOS_EFAULT;
+    }
+    goto RETRY;
 }
 #endif
 
@@ -30,6 +30,58 @@
  */
 
 #include "los_ipcdebug_pri.h"
+#ifdef LOSCFG_SHELL
+#include "shcmd.h"
+#endif /* LOSCFG_SHELL */
+
+IpcLockStat g_ipcLockStat[OS_IPC_LOCK_TYPE_MAX][LOSCFG_KERNEL_CORE_NUM];
+
+VOID OsIpcLockStatGet(OsIpcLockType type, IpcLockStat *stat)
+{
+    UINT32 cpuid;
+
+    (VOID)memset_s(stat, sizeof(IpcLockStat), 0, sizeof(IpcLockStat));
+    if (type >= OS_IPC_LOCK_TYPE_MAX) {
+        return;
+    }
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        stat->uncontended += g_ipcLockStat[type][cpuid].uncontended;
+        stat->contended += g_ipcLockStat[type][cpuid].contended;
+        stat->spun += g_ipcLockStat[type][cpuid].spun;
+    }
+}
+
+VOID OsIpcLockStatReset(VOID)
+{
+    (VOID)memset_s(g_ipcLockStat, sizeof(g_ipcLockStat), 0, sizeof(g_ipcLockStat));
+}
+
+#ifdef LOSCFG_SHELL_CMD_DEBUG
+LITE_OS_SEC_TEXT_MINOR UINT32 OsShellCmdLockStat(UINT32 argc, const CHAR **argv)
+{
+    STATIC const CHAR *lockName[OS_IPC_LOCK_TYPE_MAX] = { "mux", "rwlock", "sem" };
+    IpcLockStat stat;
+    UINT32 type;
+
+    if ((argc == 1) && (strcmp(argv[0], "-r") == 0)) {
+        OsIpcLockStatReset();
+        return LOS_OK;
+    } else if (argc != 0) {
+        PRINTK("\nUsage: lockstat [-r]\n");
+        return OS_ERROR;
+    }
+
+    PRINTK("\n   Type    Uncontended    Contended    Spun\n");
+    for (type = 0; type < OS_IPC_LOCK_TYPE_MAX; type++) {
+        OsIpcLockStatGet(type, &stat);
+        PRINTK("   %-6s  %-11u    %-9u    %u\n", lockName[type], stat.uncontended, stat.contended, stat.spun);
+    }
+    return LOS_OK;
+}
+
+SHELLCMD_ENTRY(lockstat_shellcmd, CMD_TYPE_EX, "lockstat", 1, (CmdCallBackFunc)OsShellCmdLockStat);
+#endif
 
 
 #if defined(LOSCFG_DEBUG_SEMAPHORE) || defined(LOSCFG_DEBUG_QUEUE)
@@ -36,11 +36,14 @@
 #include "los_task_pri.h"
 #include "los_exc.h"
 #include "los_sched_pri.h"
+#include "los_ipcdebug_pri.h"
 
 
 #ifdef LOSCFG_BASE_IPC_MUX
 #define MUTEXATTR_TYPE_MASK 0x0FU
 
+#define OS_MUX_OWNER_WORD(mutex) ((Atomic *)&(mutex)->owner)
+
 LITE_OS_SEC_TEXT UINT32 LOS_MuxAttrInit(LosMuxAttr *attr)
 {
     if (attr == NULL) {
@@ -247,7 +250,8 @@ LITE_OS_SEC_TEXT UINT32 LOS_MuxDestroy(LosMux *mutex)
         return LOS_EBADF;
     }
 
-    if (mutex->muxCount != 0) {
+    /* claim the free owner word so that a fast path locker cannot take the mutex while it is wiped */
+    if (LOS_AtomicCmpXchg32bits(OS_MUX_OWNER_WORD(mutex), (INT32)OS_MUX_OWNER_WAITERS, 0)) {
         SCHEDULER_UNLOCK(intSave);
         return LOS_EBUSY;
     }
@@ -264,7 +268,7 @@ STATIC VOID OsMuxBitmapSet(const LosMux *mutex, const LosTaskCB *runTask)
     }
 
     SchedParam param = { 0 };
-    LosTaskCB *owner = (LosTaskCB *)mutex->owner;
+    LosTaskCB *owner = OsMuxOwnerGet(mutex);
     INT32 ret = OsSchedParamCompare(owner, runTask);
     if (ret > 0) {
         runTask->ops->schedParamGet(runTask, &param);
@@ -279,14 +283,117 @@ VOID OsMuxBitmapRestore(const LosMux *mutex, const LOS_DL_LIST *list, const LosT
     }
 
     SchedParam param = { 0 };
-    LosTaskCB *owner = (LosTaskCB *)mutex->owner;
+    LosTaskCB *owner = OsMuxOwnerGet(mutex);
     runTask->ops->schedParamGet(runTask, &param);
     owner->ops->priorityRestore(owner, list, &param);
 }
 
+STATIC INLINE BOOL OsMuxFastPathAllowed(const LosMux *mutex)
+{
+    /* the ceiling protocol boosts the owner on every acquisition, which needs the scheduler lock */
+    return ((mutex->magic == OS_MUX_MAGIC) && (mutex->muxList.pstNext != NULL) &&
+            (mutex->attr.protocol != LOS_MUX_PRIO_PROTECT) && (OsCheckMutexAttr(&mutex->attr) == LOS_OK));
+}
+
+/*
+ * A held mutex is always in its owner's lockList, so that deleting the owner releases it. Only the
+ * owner changes its own lockList while it runs, with interrupts off nothing else can get in between.
+ */
+STATIC INLINE BOOL OsMuxFastLock(LosMux *mutex, LosTaskCB *runTask)
+{
+    UINT32 intSave = LOS_IntLock();
+
+    if (LOS_AtomicCmpXchg32bits(OS_MUX_OWNER_WORD(mutex), (INT32)(UINTPTR)runTask, 0)) {
+        LOS_IntRestore(intSave);
+        return FALSE;
+    }
+    DMB;
+    mutex->muxCount = 1;
+    LOS_ListTailInsert(&runTask->lockList, &mutex->holdList);
+    LOS_IntRestore(intSave);
+    return TRUE;
+}
+
+STATIC INLINE BOOL OsMuxFastUnlock(LosMux *mutex, LosTaskCB *runTask)
+{
+    UINT32 intSave;
+
+    if ((mutex->magic != OS_MUX_MAGIC) || (mutex->owner != (VOID *)runTask)) {
+        return FALSE;
+    }
+
+    if ((mutex->muxCount > 1) && (mutex->attr.type == LOS_MUX_RECURSIVE)) {
+        mutex->muxCount--;
+        return TRUE;
+    }
+
+    if (mutex->muxCount != 1) {
+        return FALSE;
+    }
+
+    /* unlink before the owner word is cleared, the next owner links the same node */
+    intSave = LOS_IntLock();
+    LOS_ListDelete(&mutex->holdList);
+    mutex->muxCount = 0;
+    DMB;
+    if (LOS_AtomicCmpXchg32bits(OS_MUX_OWNER_WORD(mutex), 0, (INT32)(UINTPTR)runTask)) {
+        /* a waiter showed up in between, it has to be woken by the slow path */
+        mutex->muxCount = 1;
+        LOS_ListTailInsert(&runTask->lockList, &mutex->holdList);
+        LOS_IntRestore(intSave);
+        return FALSE;
+    }
+    LOS_IntRestore(intSave);
+    return TRUE;
+}
+
+#if defined(LOSCFG_KERNEL_SMP) && (LOSCFG_BASE_IPC_MUX_SPIN_COUNT > 0)
+STATIC BOOL OsMuxSpinLock(LosMux *mutex, LosTaskCB *runTask)
+{
+    UINT32 count;
+    LosTaskCB *owner = NULL;
+
+    for (count = 0; count < LOSCFG_BASE_IPC_MUX_SPIN_COUNT; count++) {
+        owner = (LosTaskCB *)mutex->owner;
+        if (owner == NULL) {
+            if (OsMuxFastLock(mutex, runTask)) {
+                return TRUE;
+            }
+            continue;
+        }
+
+        /* don't overtake queued waiters, and only an owner running elsewhere is going to release soon */
+        if (((UINTPTR)owner & OS_MUX_OWNER_WAITERS) || !(owner->taskStatus & OS_TASK_STATUS_RUNNING) ||
+            (owner->currCpu == ArchCurrCpuid())) {
+            return FALSE;
+        }
+    }
+    return FALSE;
+}
+#endif
+
+/* Called with the scheduler lock, makes the current owner release through OsMuxPostOp. */
+STATIC BOOL OsMuxWaitersSet(LosMux *mutex)
+{
+    UINTPTR owner;
+
+    do {
+        owner = (UINTPTR)mutex->owner;
+        if (owner == 0) {
+            return FALSE;
+        }
+        if (owner & OS_MUX_OWNER_WAITERS) {
+            return TRUE;
+        }
+    } while (LOS_AtomicCmpXchg32bits(OS_MUX_OWNER_WORD(mutex), (INT32)(owner | OS_MUX_OWNER_WAITERS), (INT32)owner));
+
+    return TRUE;
+}
+
 STATIC UINT32 OsMuxPendOp(LosTaskCB *runTask, LosMux *mutex, UINT32 timeout)
 {
     UINT32 ret;
+    UINTPTR newOwner;
 
     if ((mutex->muxList.pstPrev == NULL) || (mutex->muxList.pstNext == NULL)) {
         /* This is for mutex macro initialization. */
@@ -295,31 +402,41 @@ STATIC UINT32 OsMuxPendOp(LosTaskCB *runTask, LosMux *mutex, UINT32 timeout)
         LOS_ListInit(&mutex->muxList);
     }
 
-    if (mutex->muxCount == 0) {
-        mutex->muxCount++;
-        mutex->owner = (VOID *)runTask;
-        LOS_ListTailInsert(&runTask->lockList, &mutex->holdList);
-        if (mutex->attr.protocol == LOS_MUX_PRIO_PROTECT) {
-            SchedParam param = { 0 };
-            runTask->ops->schedParamGet(runTask, &param);
-            param.priority = mutex->attr.prioceiling;
-            runTask->ops->priorityInheritance(runTask, &param);
+    do {
+        if (mutex->owner == NULL) {
+            /* only the ceiling protocol has to be undone on unlock, keep it off the fast path */
+            newOwner = (UINTPTR)runTask;
+            if (mutex->attr.protocol == LOS_MUX_PRIO_PROTECT) {
+                newOwner |= OS_MUX_OWNER_WAITERS;
+            }
+            if (LOS_AtomicCmpXchg32bits(OS_MUX_OWNER_WORD(mutex), (INT32)newOwner, 0)) {
+                continue;
+            }
+            DMB;
+            mutex->muxCount = 1;
+            LOS_ListTailInsert(&runTask->lockList, &mutex->holdList);
+            if (mutex->attr.protocol == LOS_MUX_PRIO_PROTECT) {
+                SchedParam param = { 0 };
+                runTask->ops->schedParamGet(runTask, &param);
+                param.priority = mutex->attr.prioceiling;
+                runTask->ops->priorityInheritance(runTask, &param);
+            }
+            return LOS_OK;
         }
-        return LOS_OK;
-    }
 
-    if (((LosTaskCB *)mutex->owner == runTask) && (mutex->attr.type == LOS_MUX_RECURSIVE)) {
-        mutex->muxCount++;
-        return LOS_OK;
-    }
+        if ((OsMuxOwnerGet(mutex) == runTask) && (mutex->attr.type == LOS_MUX_RECURSIVE)) {
+            mutex->muxCount++;
+            return LOS_OK;
+        }
 
-    if (!timeout) {
-        return LOS_EINVAL;
-    }
+        if (!timeout) {
+            return LOS_EINVAL;
+        }
 
-    if (!OsPreemptableInSched()) {
-        return LOS_EDEADLK;
-    }
+        if (!OsPreemptableInSched()) {
+            return LOS_EDEADLK;
+        }
+    } while (!OsMuxWaitersSet(mutex));
 
     OsMuxBitmapSet(mutex, runTask);
 
@@ -353,7 +470,7 @@ UINT32 OsMuxLockUnsafe(LosMux *mutex, UINT32 timeout)
         return LOS_EINVAL;
     }
 
-    if ((mutex->attr.type == LOS_MUX_ERRORCHECK) && (mutex->owner == (VOID *)runTask)) {
+    if ((mutex->attr.type == LOS_MUX_ERRORCHECK) && (OsMuxOwnerGet(mutex) == runTask)) {
         return LOS_EDEADLK;
     }
 
@@ -363,6 +480,7 @@ UINT32 OsMuxLockUnsafe(LosMux *mutex, UINT32 timeout)
 UINT32 OsMuxTrylockUnsafe(LosMux *mutex, UINT32 timeout)
 {
     LosTaskCB *runTask = OsCurrTaskGet();
+    LosTaskCB *owner = NULL;
 
     if (mutex->magic != OS_MUX_MAGIC) {
         return LOS_EBADF;
@@ -372,8 +490,8 @@ UINT32 OsMuxTrylockUnsafe(LosMux *mutex, UINT32 timeout)
         return LOS_EINVAL;
     }
 
-    if ((mutex->owner != NULL) &&
-        (((LosTaskCB *)mutex->owner != runTask) || (mutex->attr.type != LOS_MUX_RECURSIVE))) {
+    owner = OsMuxOwnerGet(mutex);
+    if ((owner != NULL) && ((owner != runTask) || (mutex->attr.type != LOS_MUX_RECURSIVE))) {
         return LOS_EBUSY;
     }
 
@@ -401,6 +519,24 @@ LITE_OS_SEC_TEXT UINT32 LOS_MuxLock(LosMux *mutex, UINT32 timeout)
         OsBackTrace();
     }
 
+    if (OsMuxFastPathAllowed(mutex)) {
+        if (OsMuxFastLock(mutex, runTask)) {
+            OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_MUX, uncontended);
+            return LOS_OK;
+        }
+        if ((mutex->owner == (VOID *)runTask) && (mutex->attr.type == LOS_MUX_RECURSIVE)) {
+            mutex->muxCount++;
+            return LOS_OK;
+        }
+#if defined(LOSCFG_KERNEL_SMP) && (LOSCFG_BASE_IPC_MUX_SPIN_COUNT > 0)
+        if ((timeout != 0) && OsMuxSpinLock(mutex, runTask)) {
+            OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_MUX, spun);
+            return LOS_OK;
+        }
+#endif
+    }
+
+    OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_MUX, contended);
     SCHEDULER_LOCK(intSave);
     ret = OsMuxLockUnsafe(mutex, timeout);
     SCHEDULER_UNLOCK(intSave);
@@ -428,6 +564,11 @@ LITE_OS_SEC_TEXT UINT32 LOS_MuxTrylock(LosMux *mutex)
         OsBackTrace();
     }
 
+    if (OsMuxFastPathAllowed(mutex) && OsMuxFastLock(mutex, runTask)) {
+        OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_MUX, uncontended);
+        return LOS_OK;
+    }
+
     SCHEDULER_LOCK(intSave);
     ret = OsMuxTrylockUnsafe(mutex, 0);
     SCHEDULER_UNLOCK(intSave);
@@ -438,7 +579,8 @@ STATIC UINT32 OsMuxPostOp(LosTaskCB *taskCB, LosMux *mutex, BOOL *needSched)
 {
     if (LOS_ListEmpty(&mutex->muxList)) {
         LOS_ListDelete(&mutex->holdList);
-        mutex->owner = NULL;
+        DMB;
+        LOS_AtomicSet(OS_MUX_OWNER_WORD(mutex), 0);
         return LOS_OK;
     }
 
@@ -446,7 +588,8 @@ STATIC UINT32 OsMuxPostOp(LosTaskCB *taskCB, LosMux *mutex, BOOL *needSched)
     OsMuxBitmapRestore(mutex, &mutex->muxList, resumedTask);
 
     mutex->muxCount = 1;
-    mutex->owner = (VOID *)resumedTask;
+    DMB;
+    LOS_AtomicSet(OS_MUX_OWNER_WORD(mutex), (INT32)((UINTPTR)resumedTask | OS_MUX_OWNER_WAITERS));
     LOS_ListDelete(&mutex->holdList);
     LOS_ListTailInsert(&resumedTask->lockList, &mutex->holdList);
     OsTaskWakeClearPendMask(resumedTask);
@@ -469,7 +612,7 @@ UINT32 OsMuxUnlockUnsafe(LosTaskCB *taskCB, LosMux *mutex, BOOL *needSched)
         return LOS_EINVAL;
     }
 
-    if ((LosTaskCB *)mutex->owner != taskCB) {
+    if (OsMuxOwnerGet(mutex) != taskCB) {
         return LOS_EPERM;
     }
 
@@ -487,6 +630,14 @@ UINT32 OsMuxUnlockUnsafe(LosTaskCB *taskCB, LosMux *mutex, BOOL *needSched)
         taskCB->ops->priorityRestore(taskCB, NULL, &param);
     }
 
+    if (!((UINTPTR)mutex->owner & OS_MUX_OWNER_WAITERS)) {
+        /* nobody queued, and only scheduler lock holders may queue, so this cannot race */
+        LOS_ListDelete(&mutex->holdList);
+        DMB;
+        LOS_AtomicSet(OS_MUX_OWNER_WORD(mutex), 0);
+        return LOS_OK;
+    }
+
     /* Whether a task block the mutex lock. */
     return OsMuxPostOp(taskCB, mutex, needSched);
 }
@@ -513,11 +664,15 @@ LITE_OS_SEC_TEXT UINT32 LOS_MuxUnlock(LosMux *mutex)
         OsBackTrace();
     }
 
+    if (OsMuxFastUnlock(mutex, runTask)) {
+        return LOS_OK;
+    }
+
     SCHEDULER_LOCK(intSave);
     ret = OsMuxUnlockUnsafe(runTask, mutex, &needSched);
     SCHEDULER_UNLOCK(intSave);
     if (needSched == TRUE) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        OsSchedPreemptTargetNotify();
         LOS_Schedule();
     }
     return ret;
@@ -37,6 +37,7 @@
 #include "los_mp.h"
 #include "los_percpu_pri.h"
 #include "los_hook.h"
+#include "los_atomic.h"
 
 #ifdef LOSCFG_BASE_IPC_QUEUE
 #if (LOSCFG_BASE_IPC_QUEUE_LIMIT <= 0)
@@ -46,6 +47,17 @@
 LITE_OS_SEC_BSS LosQueueCB *g_allQueue = NULL;
 LITE_OS_SEC_BSS STATIC LOS_DL_LIST g_freeQueueList;
 
+/* Node header of a ring queue, the message follows it */
+typedef struct {
+    UINT32 seq;  /* position + 1 once the message at that position is published */
+    UINT32 size;
+} QueueRingNode;
+
+#define OS_QUEUE_FLAG_MASK        (OS_QUEUE_RING_FLAGS | LOS_QUEUE_FLAG_POINTER)
+#define OS_QUEUE_RING_MSG_MAX     (OS_NULL_SHORT - sizeof(QueueRingNode) - sizeof(UINTPTR))
+#define OS_QUEUE_RING_WAITER(rw)  (1U << (rw))
+#define OS_QUEUE_RING_DELETED     0x80000000U
+
 /*
  * Description : queue initial
  * Return      : LOS_OK on success or error code on failure
@@ -76,6 +88,29 @@ LITE_OS_SEC_TEXT_INIT UINT32 OsQueueInit(VOID)
     return LOS_OK;
 }
 
+STATIC UINT32 OsQueueRingCheck(UINT32 flags, UINT16 *len, UINT16 *maxMsgSize)
+{
+    UINT32 ringLen = 1;
+
+    if (((flags & ~OS_QUEUE_FLAG_MASK) != 0) || ((flags & OS_QUEUE_RING_FLAGS) == 0) ||
+        ((flags & OS_QUEUE_RING_FLAGS) == OS_QUEUE_RING_FLAGS) || (*len > LOS_QUEUE_RING_LEN_MAX)) {
+        return LOS_ERRNO_QUEUE_FLAGS_INVALID;
+    }
+
+    if (flags & LOS_QUEUE_FLAG_POINTER) {
+        *maxMsgSize = sizeof(UINTPTR);
+    } else if (*maxMsgSize > OS_QUEUE_RING_MSG_MAX) {
+        return LOS_ERRNO_QUEUE_SIZE_TOO_BIG;
+    }
+
+    while (ringLen < *len) {
+        ringLen <<= 1;
+    }
+    *len = (UINT16)ringLen;
+    *maxMsgSize = (UINT16)(sizeof(QueueRingNode) + ALIGN(*maxMsgSize, sizeof(UINTPTR)));
+    return LOS_OK;
+}
+
 LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32 *queueID,
                                              UINT32 flags, UINT16 maxMsgSize)
 {
@@ -84,9 +119,9 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
     LOS_DL_LIST *unusedQueue = NULL;
     UINT8 *queue = NULL;
     UINT16 msgSize;
+    UINT32 ret;
 
     (VOID)queueName;
-    (VOID)flags;
 
     if (queueID == NULL) {
         return LOS_ERRNO_QUEUE_CREAT_PTR_NULL;
@@ -100,7 +135,16 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
         return LOS_ERRNO_QUEUE_PARA_ISZERO;
     }
 
-    msgSize = maxMsgSize + sizeof(UINT32);
+    msgSize = maxMsgSize;
+    if (flags != 0) {
+        ret = OsQueueRingCheck(flags, &len, &msgSize);
+        if (ret != LOS_OK) {
+            return ret;
+        }
+    } else {
+        msgSize = maxMsgSize + sizeof(UINT32);
+    }
+
     /*
      * Memory allocation is time-consuming, to shorten the time of disable interrupt,
      * move the memory allocation to here.
@@ -109,6 +153,9 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
     if (queue == NULL) {
         return LOS_ERRNO_QUEUE_CREATE_NO_MEMORY;
     }
+    if (flags != 0) {
+        (VOID)memset_s(queue, (UINT32)len * msgSize, 0, (UINT32)len * msgSize);
+    }
 
     SCHEDULER_LOCK(intSave);
     if (LOS_ListEmpty(&g_freeQueueList)) {
@@ -129,9 +176,16 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueCreate(CHAR *queueName, UINT16 len, UINT32
     queueCB->readWriteableCnt[OS_QUEUE_WRITE] = len;
     queueCB->queueHead = 0;
     queueCB->queueTail = 0;
+    queueCB->queueFlags = flags;
+    queueCB->ringHead = 0;
+    queueCB->ringTail = 0;
+    queueCB->ringWaiters = 0;
     LOS_ListInit(&queueCB->readWriteList[OS_QUEUE_READ]);
     LOS_ListInit(&queueCB->readWriteList[OS_QUEUE_WRITE]);
     LOS_ListInit(&queueCB->memList);
+    /* ring users may only get in once the queue above is visible */
+    DMB;
+    (VOID)LOS_AtomicCmpXchg32bits((Atomic *)&queueCB->ringUsers, 0, (INT32)OS_QUEUE_RING_DELETED);
 
     OsQueueDbgUpdateHook(queueCB->queueID, OsCurrTaskGet()->taskEntry);
     SCHEDULER_UNLOCK(intSave);
@@ -243,6 +297,14 @@ STATIC VOID OsQueueBufferOperate(LosQueueCB *queueCB, UINT32 operateType, VOID *
     }
 }
 
+STATIC INLINE UINT32 OsQueueMsgSizeMax(const LosQueueCB *queueCB)
+{
+    if (OS_QUEUE_IS_RING(queueCB)) {
+        return queueCB->queueSize - sizeof(QueueRingNode);
+    }
+    return queueCB->queueSize - sizeof(UINT32);
+}
+
 STATIC UINT32 OsQueueOperateParamCheck(const LosQueueCB *queueCB, UINT32 queueID,
                                        UINT32 operateType, const UINT32 *bufferSize)
 {
@@ -250,21 +312,253 @@ STATIC UINT32 OsQueueOperateParamCheck(const LosQueueCB *queueCB, UINT32 queueID
         return LOS_ERRNO_QUEUE_NOT_CREATE;
     }
 
-    if (OS_QUEUE_IS_WRITE(operateType) && (*bufferSize > (queueCB->queueSize - sizeof(UINT32)))) {
+    if (OS_QUEUE_IS_WRITE(operateType) && (*bufferSize > OsQueueMsgSizeMax(queueCB))) {
         return LOS_ERRNO_QUEUE_WRITE_SIZE_TOO_BIG;
     }
     return LOS_OK;
 }
 
+STATIC INLINE QueueRingNode *OsQueueRingNode(const LosQueueCB *queueCB, UINT32 pos)
+{
+    return (QueueRingNode *)&queueCB->queueHandle[(pos & (queueCB->queueLen - 1U)) * queueCB->queueSize];
+}
+
+STATIC UINT32 OsQueueRingPush(LosQueueCB *queueCB, const UINT8 *bufferAddr, UINT32 msgSize, UINT32 count)
+{
+    QueueRingNode *node = NULL;
+    UINT32 head, tail, num, index;
+
+    do {
+        /* head is loaded first, so it never passes the tail loaded after it */
+        head = queueCB->ringHead;
+        DMB;
+        tail = queueCB->ringTail;
+        num = queueCB->queueLen - (tail - head);
+        if (num == 0) {
+            return 0;
+        }
+        num = (count < num) ? count : num;
+        if (queueCB->queueFlags & LOS_QUEUE_FLAG_SPSC) {
+            queueCB->ringTail = tail + num;
+            break;
+        }
+    } while (LOS_AtomicCmpXchg32bits((Atomic *)&queueCB->ringTail, (INT32)(tail + num), (INT32)tail));
+    DMB;
+
+    for (index = 0; index < num; index++) {
+        node = OsQueueRingNode(queueCB, tail + index);
+        if ((queueCB->queueFlags & LOS_QUEUE_FLAG_POINTER) && (msgSize == sizeof(UINTPTR))) {
+            *(UINTPTR *)(node + 1) = *(const UINTPTR *)bufferAddr;
+        } else {
+            (VOID)memcpy_s(node + 1, queueCB->queueSize - sizeof(QueueRingNode), bufferAddr, msgSize);
+        }
+        node->size = msgSize;
+        bufferAddr += msgSize;
+    }
+
+    DMB;
+    for (index = 0; index < num; index++) {
+        OsQueueRingNode(queueCB, tail + index)->seq = tail + index + 1;
+    }
+    return num;
+}
+
+STATIC UINT32 OsQueueRingPop(LosQueueCB *queueCB, UINT8 *bufferAddr, UINT32 *bufferSize, UINT32 count)
+{
+    QueueRingNode *node = NULL;
+    UINT32 head = queueCB->ringHead;
+    UINT32 stride = *bufferSize;
+    UINT32 num;
+
+    for (num = 0; num < count; num++) {
+        node = OsQueueRingNode(queueCB, head + num);
+        if (node->seq != (head + num + 1)) {
+            break;
+        }
+        DMB;
+        *bufferSize = (stride < node->size) ? stride : node->size;
+        if ((queueCB->queueFlags & LOS_QUEUE_FLAG_POINTER) && (*bufferSize == sizeof(UINTPTR))) {
+            *(UINTPTR *)bufferAddr = *(const UINTPTR *)(node + 1);
+        } else {
+            (VOID)memcpy_s(bufferAddr, stride, node + 1, *bufferSize);
+        }
+        bufferAddr += stride;
+    }
+
+    if (num != 0) {
+        /* the messages must be copied out before the writers may reuse the nodes */
+        DMB;
+        queueCB->ringHead = head + num;
+    }
+    return num;
+}
+
+STATIC INLINE UINT32 OsQueueRingTransfer(LosQueueCB *queueCB, UINT32 readWrite, VOID *bufferAddr,
+                                         UINT32 *bufferSize, UINT32 count)
+{
+    if (readWrite == OS_QUEUE_READ) {
+        return OsQueueRingPop(queueCB, (UINT8 *)bufferAddr, bufferSize, count);
+    }
+    return OsQueueRingPush(queueCB, (const UINT8 *)bufferAddr, *bufferSize, count);
+}
+
+STATIC VOID OsQueueRingWake(LosQueueCB *queueCB, UINT32 readWrite, UINT32 count)
+{
+    LOS_DL_LIST *list = &queueCB->readWriteList[readWrite];
+    LosTaskCB *resumedTask = NULL;
+    BOOL needSched = FALSE;
+    UINT32 intSave;
+
+    /* pairs with the barrier a waiter issues between setting its bit and checking the ring */
+    DMB;
+    if (!(queueCB->ringWaiters & OS_QUEUE_RING_WAITER(readWrite))) {
+        return;
+    }
+
+    SCHEDULER_LOCK(intSave);
+    while ((count > 0) && !LOS_ListEmpty(list)) {
+        resumedTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(list));
+        OsTaskWakeClearPendMask(resumedTask);
+        resumedTask->ops->wake(resumedTask);
+        needSched = TRUE;
+        count--;
+    }
+    if (LOS_ListEmpty(list)) {
+        queueCB->ringWaiters &= ~OS_QUEUE_RING_WAITER(readWrite);
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    if (needSched) {
+        OsSchedPreemptTargetNotify();
+        LOS_Schedule();
+    }
+}
+
+STATIC INLINE VOID OsQueueRingPut(LosQueueCB *queueCB)
+{
+    DMB;
+    LOS_AtomicDec((Atomic *)&queueCB->ringUsers);
+}
+
+/* Keeps LOS_QueueDelete from freeing a ring queue while it is used without the scheduler lock */
+STATIC UINT32 OsQueueRingGet(LosQueueCB *queueCB, UINT32 queueID)
+{
+    UINT32 users;
+
+    do {
+        users = queueCB->ringUsers;
+        if (users & OS_QUEUE_RING_DELETED) {
+            return LOS_ERRNO_QUEUE_NOT_CREATE;
+        }
+    } while (LOS_AtomicCmpXchg32bits((Atomic *)&queueCB->ringUsers, (INT32)(users + 1), (INT32)users));
+    DMB;
+
+    /* the queue may have been deleted and created again before the reference was taken */
+    if ((queueCB->queueID != queueID) || (queueCB->queueState == OS_QUEUE_UNUSED) || !OS_QUEUE_IS_RING(queueCB)) {
+        OsQueueRingPut(queueCB);
+        return LOS_ERRNO_QUEUE_NOT_CREATE;
+    }
+    return LOS_OK;
+}
+
+/*
+ * Ring queues only take the scheduler lock to wait when they are empty or full, and to wake
+ * the other side when it has announced a waiter in ringWaiters.
+ */
+STATIC UINT32 OsQueueRingOperate(LosQueueCB *queueCB, UINT32 queueID, UINT32 operateType, VOID *bufferAddr,
+                                 UINT32 *bufferSize, UINT32 *count, UINT32 timeout)
+{
+    UINT32 readWrite = OS_QUEUE_READ_WRITE_GET(operateType);
+    LOS_DL_LIST *list = &queueCB->readWriteList[readWrite];
+    LosTaskCB *runTask = NULL;
+    UINT32 intSave;
+    UINT32 ret;
+    UINT32 num;
+
+    ret = OsQueueRingGet(queueCB, queueID);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    ret = OsQueueOperateParamCheck(queueCB, queueID, operateType, bufferSize);
+    if (ret != LOS_OK) {
+        goto QUEUE_END;
+    }
+
+    if (OS_QUEUE_OPERATE_GET(operateType) == OS_QUEUE_WRITE_HEAD) {
+        ret = LOS_ERRNO_QUEUE_OPERATE_UNSUPPORTED;
+        goto QUEUE_END;
+    }
+
+    if (OS_QUEUE_IS_READ(operateType) && (queueCB->queueFlags & LOS_QUEUE_FLAG_POINTER) &&
+        (*bufferSize < sizeof(UINTPTR))) {
+        ret = LOS_ERRNO_QUEUE_READ_SIZE_TOO_SMALL;
+        goto QUEUE_END;
+    }
+
+    num = OsQueueRingTransfer(queueCB, readWrite, bufferAddr, bufferSize, *count);
+    if (num == 0) {
+        if (timeout == LOS_NO_WAIT) {
+            ret = OS_QUEUE_IS_READ(operateType) ? LOS_ERRNO_QUEUE_ISEMPTY : LOS_ERRNO_QUEUE_ISFULL;
+            goto QUEUE_END;
+        }
+
+        SCHEDULER_LOCK(intSave);
+        if (!OsPreemptableInSched()) {
+            SCHEDULER_UNLOCK(intSave);
+            ret = LOS_ERRNO_QUEUE_PEND_IN_LOCK;
+            goto QUEUE_END;
+        }
+
+        runTask = OsCurrTaskGet();
+        while (TRUE) {
+            queueCB->ringWaiters |= OS_QUEUE_RING_WAITER(readWrite);
+            DMB;
+            num = OsQueueRingTransfer(queueCB, readWrite, bufferAddr, bufferSize, *count);
+            if (num != 0) {
+                break;
+            }
+
+            OsTaskWaitSetPendMask(OS_TASK_WAIT_QUEUE, queueCB->queueID, timeout);
+            ret = runTask->ops->wait(runTask, list, timeout);
+            if (ret == LOS_ERRNO_TSK_TIMEOUT) {
+                ret = LOS_ERRNO_QUEUE_TIMEOUT;
+                break;
+            }
+        }
+
+        if (LOS_ListEmpty(list)) {
+            queueCB->ringWaiters &= ~OS_QUEUE_RING_WAITER(readWrite);
+        }
+        SCHEDULER_UNLOCK(intSave);
+        if (num == 0) {
+            goto QUEUE_END;
+        }
+    }
+
+    *count = num;
+    OsQueueRingWake(queueCB, !readWrite, num);
+    ret = LOS_OK;
+
+QUEUE_END:
+    OsQueueRingPut(queueCB);
+    return ret;
+}
+
 UINT32 OsQueueOperate(UINT32 queueID, UINT32 operateType, VOID *bufferAddr, UINT32 *bufferSize, UINT32 timeout)
 {
     UINT32 ret;
     UINT32 readWrite = OS_QUEUE_READ_WRITE_GET(operateType);
     UINT32 intSave;
-    OsHookCall(LOS_HOOK_TYPE_QUEUE_READ, (LosQueueCB *)GET_QUEUE_HANDLE(queueID), operateType, *bufferSize, timeout);
+    UINT32 count = 1;
+    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
+    OsHookCall(LOS_HOOK_TYPE_QUEUE_READ, queueCB, operateType, *bufferSize, timeout);
+
+    if (OS_QUEUE_IS_RING(queueCB)) {
+        return OsQueueRingOperate(queueCB, queueID, operateType, bufferAddr, bufferSize, &count, timeout);
+    }
 
     SCHEDULER_LOCK(intSave);
-    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
     ret = OsQueueOperateParamCheck(queueCB, queueID, operateType, bufferSize);
     if (ret != LOS_OK) {
         goto QUEUE_END;
@@ -299,7 +593,7 @@ UINT32 OsQueueOperate(UINT32 queueID, UINT32 operateType, VOID *bufferAddr, UINT
         OsTaskWakeClearPendMask(resumedTask);
         resumedTask->ops->wake(resumedTask);
         SCHEDULER_UNLOCK(intSave);
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        OsSchedPreemptTargetNotify();
         LOS_Schedule();
         return LOS_OK;
     } else {
@@ -362,6 +656,79 @@ LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteCopy(UINT32 queueID,
     return OsQueueOperate(queueID, operateType, bufferAddr, &bufferSize, timeout);
 }
 
+STATIC UINT32 OsQueueBatchOperate(UINT32 queueID, UINT32 operateType, UINT8 *bufferAddr, UINT32 msgSize,
+                                  UINT32 *count, UINT32 timeout)
+{
+    LosQueueCB *queueCB = (LosQueueCB *)GET_QUEUE_HANDLE(queueID);
+    UINT32 ret = LOS_OK;
+    UINT32 bufferSize;
+    UINT32 num;
+
+    if (OS_QUEUE_IS_RING(queueCB)) {
+        bufferSize = msgSize;
+        return OsQueueRingOperate(queueCB, queueID, operateType, bufferAddr, &bufferSize, count, timeout);
+    }
+
+    for (num = 0; num < *count; num++) {
+        bufferSize = msgSize;
+        ret = OsQueueOperate(queueID, operateType, bufferAddr + num * msgSize, &bufferSize,
+                             (num == 0) ? timeout : LOS_NO_WAIT);
+        if (ret != LOS_OK) {
+            break;
+        }
+    }
+
+    if (num == 0) {
+        return ret;
+    }
+    *count = num;
+    return LOS_OK;
+}
+
+LITE_OS_SEC_TEXT UINT32 LOS_QueueReadBatch(UINT32 queueID, VOID *bufferAddr, UINT32 msgSize,
+                                           UINT32 *count, UINT32 timeout)
+{
+    UINT32 ret;
+
+    ret = OsQueueReadParameterCheck(queueID, bufferAddr, &msgSize, timeout);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    if (count == NULL) {
+        return LOS_ERRNO_QUEUE_READ_PTR_NULL;
+    }
+
+    if (*count == 0) {
+        return LOS_ERRNO_QUEUE_PARA_ISZERO;
+    }
+
+    return OsQueueBatchOperate(queueID, OS_QUEUE_OPERATE_TYPE(OS_QUEUE_READ, OS_QUEUE_HEAD),
+                               (UINT8 *)bufferAddr, msgSize, count, timeout);
+}
+
+LITE_OS_SEC_TEXT UINT32 LOS_QueueWriteBatch(UINT32 queueID, VOID *bufferAddr, UINT32 msgSize,
+                                            UINT32 *count, UINT32 timeout)
+{
+    UINT32 ret;
+
+    ret = OsQueueWriteParameterCheck(queueID, bufferAddr, &msgSize, timeout);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    if (count == NULL) {
+        return LOS_ERRNO_QUEUE_WRITE_PTR_NULL;
+    }
+
+    if (*count == 0) {
+        return LOS_ERRNO_QUEUE_PARA_ISZERO;
+    }
+
+    return OsQueueBatchOperate(queueID, OS_QUEUE_OPERATE_TYPE(OS_QUEUE_WRITE, OS_QUEUE_TAIL),
+                               (UINT8 *)bufferAddr, msgSize, count, timeout);
+}
+
 LITE_OS_SEC_TEXT UINT32 LOS_QueueRead(UINT32 queueID, VOID *bufferAddr, UINT32 bufferSize, UINT32 timeout)
 {
     return LOS_QueueReadCopy(queueID, bufferAddr, &bufferSize, timeout);
@@ -421,7 +788,13 @@ LITE_OS_SEC_TEXT_INIT UINT32 LOS_QueueDelete(UINT32 queueID)
         goto QUEUE_END;
     }
 
-    if ((queueCB->readWriteableCnt[OS_QUEUE_WRITE] + queueCB->readWriteableCnt[OS_QUEUE_READ]) !=
+    if (OS_QUEUE_IS_RING(queueCB)) {
+        /* no task can take a new reference once the deleted bit is set */
+        if (LOS_AtomicCmpXchg32bits((Atomic *)&queueCB->ringUsers, (INT32)OS_QUEUE_RING_DELETED, 0)) {
+            ret = LOS_ERRNO_QUEUE_IN_TSKUSE;
+            goto QUEUE_END;
+        }
+    } else if ((queueCB->readWriteableCnt[OS_QUEUE_WRITE] + queueCB->readWriteableCnt[OS_QUEUE_READ]) !=
         queueCB->queueLen) {
         ret = LOS_ERRNO_QUEUE_IN_TSKWRITE;
         goto QUEUE_END;
@@ -471,10 +844,19 @@ LITE_OS_SEC_TEXT_MINOR UINT32 LOS_QueueInfoGet(UINT32 queueID, QUEUE_INFO_S *que
     queueInfo->uwQueueID = queueID;
     queueInfo->usQueueLen = queueCB->queueLen;
     queueInfo->usQueueSize = queueCB->queueSize;
-    queueInfo->usQueueHead = queueCB->queueHead;
-    queueInfo->usQueueTail = queueCB->queueTail;
-    queueInfo->usReadableCnt = queueCB->readWriteableCnt[OS_QUEUE_READ];
-    queueInfo->usWritableCnt = queueCB->readWriteableCnt[OS_QUEUE_WRITE];
+    if (OS_QUEUE_IS_RING(queueCB)) {
+        UINT32 head = queueCB->ringHead;
+        UINT32 tail = queueCB->ringTail;
+        queueInfo->usQueueHead = (UINT16)(head & (queueCB->queueLen - 1U));
+        queueInfo->usQueueTail = (UINT16)(tail & (queueCB->queueLen - 1U));
+        queueInfo->usReadableCnt = (UINT16)(tail - head);
+        queueInfo->usWritableCnt = (UINT16)(queueCB->queueLen - (tail - head));
+    } else {
+        queueInfo->usQueueHead = queueCB->queueHead;
+        queueInfo->usQueueTail = queueCB->queueTail;
+        queueInfo->usReadableCnt = queueCB->readWriteableCnt[OS_QUEUE_READ];
+        queueInfo->usWritableCnt = queueCB->readWriteableCnt[OS_QUEUE_WRITE];
+    }
 
     LOS_DL_LIST_FOR_EACH_ENTRY(tskCB, &queueCB->readWriteList[OS_QUEUE_READ], LosTaskCB, pendList) {
         queueInfo->uwWaitReadTask |= 1ULL << tskCB->taskID;
@@ -36,13 +36,29 @@
 #include "los_task_pri.h"
 #include "los_exc.h"
 #include "los_sched_pri.h"
+#include "los_ipcdebug_pri.h"
 
 #ifdef LOSCFG_BASE_IPC_RWLOCK
-#define RWLOCK_COUNT_MASK 0x00FFFFFFU
+#define RWLOCK_MAGIC_MASK 0x007FFFFFU
+/*
+ * Kept in the top bit of the magic field while tasks are pended on the rwlock. The fast paths only
+ * update the magic/rwCount word with a CAS while it is clear, everything else goes under the scheduler lock.
+ */
+#define RWLOCK_WAITERS    0x00800000U
+
+typedef union {
+    INT32 value;
+    struct {
+        INT32 magic:24;
+        INT32 rwCount:8;
+    } bits;
+} OsRwlockWord;
+
+#define OS_RWLOCK_WORD(rwlock) ((Atomic *)(rwlock))
 
 BOOL LOS_RwlockIsValid(const LosRwlock *rwlock)
 {
-    if ((rwlock != NULL) && ((rwlock->magic & RWLOCK_COUNT_MASK) == OS_RWLOCK_MAGIC)) {
+    if ((rwlock != NULL) && ((rwlock->magic & RWLOCK_MAGIC_MASK) == OS_RWLOCK_MAGIC)) {
         return TRUE;
     }
 
@@ -58,7 +74,7 @@ UINT32 LOS_RwlockInit(LosRwlock *rwlock)
     }
 
     SCHEDULER_LOCK(intSave);
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) == OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) == OS_RWLOCK_MAGIC) {
         SCHEDULER_UNLOCK(intSave);
         return LOS_EPERM;
     }
@@ -81,7 +97,7 @@ UINT32 LOS_RwlockDestroy(LosRwlock *rwlock)
     }
 
     SCHEDULER_LOCK(intSave);
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) != OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
         SCHEDULER_UNLOCK(intSave);
         return LOS_EBADF;
     }
@@ -214,7 +230,7 @@ STATIC UINT32 OsRwlockWrPendOp(LosTaskCB *runTask, LosRwlock *rwlock, UINT32 tim
 
 UINT32 OsRwlockRdUnsafe(LosRwlock *rwlock, UINT32 timeout)
 {
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) != OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
         return LOS_EBADF;
     }
 
@@ -223,7 +239,7 @@ UINT32 OsRwlockRdUnsafe(LosRwlock *rwlock, UINT32 timeout)
 
 UINT32 OsRwlockTryRdUnsafe(LosRwlock *rwlock, UINT32 timeout)
 {
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) != OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
         return LOS_EBADF;
     }
 
@@ -252,7 +268,7 @@ UINT32 OsRwlockTryRdUnsafe(LosRwlock *rwlock, UINT32 timeout)
 
 UINT32 OsRwlockWrUnsafe(LosRwlock *rwlock, UINT32 timeout)
 {
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) != OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
         return LOS_EBADF;
     }
 
@@ -261,7 +277,7 @@ UINT32 OsRwlockWrUnsafe(LosRwlock *rwlock, UINT32 timeout)
 
 UINT32 OsRwlockTryWrUnsafe(LosRwlock *rwlock, UINT32 timeout)
 {
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) != OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
         return LOS_EBADF;
     }
 
@@ -279,6 +295,120 @@ UINT32 OsRwlockTryWrUnsafe(LosRwlock *rwlock, UINT32 timeout)
     return OsRwlockWrPendOp(runTask, rwlock, timeout);
 }
 
+STATIC INLINE BOOL OsRwlockWordFast(OsRwlockWord word)
+{
+    return (((word.bits.magic & RWLOCK_MAGIC_MASK) == OS_RWLOCK_MAGIC) && !(word.bits.magic & RWLOCK_WAITERS));
+}
+
+STATIC BOOL OsRwlockFastRdLock(LosRwlock *rwlock)
+{
+    OsRwlockWord old;
+    OsRwlockWord new;
+
+    do {
+        old.value = LOS_AtomicRead(OS_RWLOCK_WORD(rwlock));
+        if (!OsRwlockWordFast(old) || (old.bits.rwCount < 0) || (old.bits.rwCount == INT8_MAX)) {
+            return FALSE;
+        }
+        new = old;
+        new.bits.rwCount++;
+    } while (LOS_AtomicCmpXchg32bits(OS_RWLOCK_WORD(rwlock), new.value, old.value));
+
+    DMB;
+    return TRUE;
+}
+
+STATIC BOOL OsRwlockFastWrLock(LosRwlock *rwlock, LosTaskCB *runTask)
+{
+    OsRwlockWord old;
+    OsRwlockWord new;
+
+    do {
+        old.value = LOS_AtomicRead(OS_RWLOCK_WORD(rwlock));
+        if (!OsRwlockWordFast(old)) {
+            return FALSE;
+        }
+        if ((old.bits.rwCount != 0) &&
+            ((old.bits.rwCount > 0) || (old.bits.rwCount == INT8_MIN) || (rwlock->writeOwner != (VOID *)runTask))) {
+            return FALSE;
+        }
+        new = old;
+        new.bits.rwCount = (old.bits.rwCount == 0) ? -1 : (old.bits.rwCount - 1);
+    } while (LOS_AtomicCmpXchg32bits(OS_RWLOCK_WORD(rwlock), new.value, old.value));
+
+    DMB;
+    rwlock->writeOwner = (VOID *)runTask;
+    return TRUE;
+}
+
+STATIC BOOL OsRwlockFastUnlock(LosRwlock *rwlock, LosTaskCB *runTask)
+{
+    OsRwlockWord old;
+    OsRwlockWord new;
+
+    old.value = LOS_AtomicRead(OS_RWLOCK_WORD(rwlock));
+    if (!OsRwlockWordFast(old) || (old.bits.rwCount == 0)) {
+        return FALSE;
+    }
+
+    if ((old.bits.rwCount < 0) && (rwlock->writeOwner != (VOID *)runTask)) {
+        return FALSE;
+    }
+
+    new = old;
+    if (old.bits.rwCount > 0) {
+        new.bits.rwCount--;
+    } else {
+        new.bits.rwCount++;
+    }
+
+    if (old.bits.rwCount == -1) {
+        /* drop the owner before the word can be claimed by the next writer */
+        rwlock->writeOwner = NULL;
+    }
+    DMB;
+    if (LOS_AtomicCmpXchg32bits(OS_RWLOCK_WORD(rwlock), new.value, old.value)) {
+        if (old.bits.rwCount == -1) {
+            rwlock->writeOwner = (VOID *)runTask;
+        }
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/* Called with the scheduler lock, keeps the fast paths off the rwlock until OsRwlockThaw. */
+STATIC VOID OsRwlockFreeze(LosRwlock *rwlock)
+{
+    OsRwlockWord old;
+    OsRwlockWord new;
+
+    do {
+        old.value = LOS_AtomicRead(OS_RWLOCK_WORD(rwlock));
+        if (((old.bits.magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) || (old.bits.magic & RWLOCK_WAITERS)) {
+            return;
+        }
+        new = old;
+        new.bits.magic |= RWLOCK_WAITERS;
+    } while (LOS_AtomicCmpXchg32bits(OS_RWLOCK_WORD(rwlock), new.value, old.value));
+}
+
+STATIC VOID OsRwlockThaw(LosRwlock *rwlock)
+{
+    OsRwlockWord word;
+
+    if (!LOS_ListEmpty(&rwlock->readList) || !LOS_ListEmpty(&rwlock->writeList)) {
+        return;
+    }
+
+    word.value = LOS_AtomicRead(OS_RWLOCK_WORD(rwlock));
+    if ((word.bits.magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
+        return;
+    }
+    word.bits.magic &= ~RWLOCK_WAITERS;
+    DMB;
+    LOS_AtomicSet(OS_RWLOCK_WORD(rwlock), word.value);
+}
+
 UINT32 LOS_RwlockRdLock(LosRwlock *rwlock, UINT32 timeout)
 {
     UINT32 intSave;
@@ -288,8 +418,16 @@ UINT32 LOS_RwlockRdLock(LosRwlock *rwlock, UINT32 timeout)
         return ret;
     }
 
+    if (OsRwlockFastRdLock(rwlock)) {
+        OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, uncontended);
+        return LOS_OK;
+    }
+
+    OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, contended);
     SCHEDULER_LOCK(intSave);
+    OsRwlockFreeze(rwlock);
     ret = OsRwlockRdUnsafe(rwlock, timeout);
+    OsRwlockThaw(rwlock);
     SCHEDULER_UNLOCK(intSave);
     return ret;
 }
@@ -303,8 +441,16 @@ UINT32 LOS_RwlockTryRdLock(LosRwlock *rwlock)
         return ret;
     }
 
+    if (OsRwlockFastRdLock(rwlock)) {
+        OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, uncontended);
+        return LOS_OK;
+    }
+
+    OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, contended);
     SCHEDULER_LOCK(intSave);
+    OsRwlockFreeze(rwlock);
     ret = OsRwlockTryRdUnsafe(rwlock, 0);
+    OsRwlockThaw(rwlock);
     SCHEDULER_UNLOCK(intSave);
     return ret;
 }
@@ -318,8 +464,16 @@ UINT32 LOS_RwlockWrLock(LosRwlock *rwlock, UINT32 timeout)
         return ret;
     }
 
+    if (OsRwlockFastWrLock(rwlock, OsCurrTaskGet())) {
+        OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, uncontended);
+        return LOS_OK;
+    }
+
+    OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, contended);
     SCHEDULER_LOCK(intSave);
+    OsRwlockFreeze(rwlock);
     ret = OsRwlockWrUnsafe(rwlock, timeout);
+    OsRwlockThaw(rwlock);
     SCHEDULER_UNLOCK(intSave);
     return ret;
 }
@@ -333,8 +487,16 @@ UINT32 LOS_RwlockTryWrLock(LosRwlock *rwlock)
         return ret;
     }
 
+    if (OsRwlockFastWrLock(rwlock, OsCurrTaskGet())) {
+        OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, uncontended);
+        return LOS_OK;
+    }
+
+    OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_RWLOCK, contended);
     SCHEDULER_LOCK(intSave);
+    OsRwlockFreeze(rwlock);
     ret = OsRwlockTryWrUnsafe(rwlock, 0);
+    OsRwlockThaw(rwlock);
     SCHEDULER_UNLOCK(intSave);
     return ret;
 }
@@ -408,7 +570,7 @@ STATIC UINT32 OsRwlockPostOp(LosRwlock *rwlock, BOOL *needSched)
 
 UINT32 OsRwlockUnlockUnsafe(LosRwlock *rwlock, BOOL *needSched)
 {
-    if ((rwlock->magic & RWLOCK_COUNT_MASK) != OS_RWLOCK_MAGIC) {
+    if ((rwlock->magic & RWLOCK_MAGIC_MASK) != OS_RWLOCK_MAGIC) {
         return LOS_EBADF;
     }
 
@@ -448,10 +610,16 @@ UINT32 LOS_RwlockUnLock(LosRwlock *rwlock)
         return ret;
     }
 
+    if (OsRwlockFastUnlock(rwlock, OsCurrTaskGet())) {
+        return LOS_OK;
+    }
+
     SCHEDULER_LOCK(intSave);
+    OsRwlockFreeze(rwlock);
     ret = OsRwlockUnlockUnsafe(rwlock, &needSched);
+    OsRwlockThaw(rwlock);
     SCHEDULER_UNLOCK(intSave);
-    LOS_MpSchedule(OS_MP_CPU_ALL);
+    OsSchedPreemptTargetNotify();
     if (needSched == TRUE) {
         LOS_Schedule();
     }
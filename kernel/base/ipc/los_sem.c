@@ -39,6 +39,7 @@
 #include "los_mp.h"
 #include "los_percpu_pri.h"
 #include "los_hook.h"
+#include "los_ipcdebug_pri.h"
 
 #ifdef LOSCFG_BASE_IPC_SEM
 
@@ -175,6 +176,48 @@ ERR_HANDLER:
     OS_RETURN_ERROR_P2(errLine, errNo);
 }
 
+#define OS_SEM_COUNT_WORD(semCB) ((volatile INT16 *)&(semCB)->semCount)
+
+/*
+ * Tasks only pend on a semaphore whose count is zero, so a non-zero count can be taken and
+ * given back with a CAS without looking at semList. Updates under the scheduler lock go
+ * through the same CAS because they race with these.
+ */
+STATIC INLINE BOOL OsSemCountDec(LosSemCB *semCB)
+{
+    UINT16 count;
+
+    do {
+        count = semCB->semCount;
+        if (count == 0) {
+            return FALSE;
+        }
+    } while (LOS_AtomicCmpXchg16bits(OS_SEM_COUNT_WORD(semCB), (INT32)(count - 1), (INT32)count));
+
+    DMB;
+    return TRUE;
+}
+
+STATIC INLINE BOOL OsSemCountInc(LosSemCB *semCB, UINT16 minCount)
+{
+    UINT16 count;
+
+    DMB;
+    do {
+        count = semCB->semCount;
+        if ((count < minCount) || (count == OS_SEM_COUNT_MAX)) {
+            return FALSE;
+        }
+    } while (LOS_AtomicCmpXchg16bits(OS_SEM_COUNT_WORD(semCB), (INT32)(count + 1), (INT32)count));
+
+    return TRUE;
+}
+
+STATIC INLINE BOOL OsSemFastPathAllowed(const LosSemCB *semCB, UINT32 semHandle)
+{
+    return ((semCB->semStat == OS_SEM_USED) && (semCB->semID == semHandle));
+}
+
 LITE_OS_SEC_TEXT UINT32 LOS_SemPend(UINT32 semHandle, UINT32 timeout)
 {
     UINT32 intSave;
@@ -198,6 +241,14 @@ LITE_OS_SEC_TEXT UINT32 LOS_SemPend(UINT32 semHandle, UINT32 timeout)
         return LOS_ERRNO_SEM_PEND_IN_SYSTEM_TASK;
     }
 
+    if (OsSemFastPathAllowed(semPended, semHandle) && OsSemCountDec(semPended)) {
+        OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_SEM, uncontended);
+        OsSemDbgTimeUpdateHook(semHandle);
+        OsHookCall(LOS_HOOK_TYPE_SEM_PEND, semPended, runTask, timeout);
+        return LOS_OK;
+    }
+
+    OS_IPC_LOCK_STAT_INC(OS_IPC_LOCK_SEM, contended);
     SCHEDULER_LOCK(intSave);
 
     if ((semPended->semStat == OS_SEM_UNUSED) || (semPended->semID != semHandle)) {
@@ -207,8 +258,7 @@ LITE_OS_SEC_TEXT UINT32 LOS_SemPend(UINT32 semHandle, UINT32 timeout)
     /* Update the operate time, no matter the actual Pend success or not */
     OsSemDbgTimeUpdateHook(semHandle);
 
-    if (semPended->semCount > 0) {
-        semPended->semCount--;
+    if (OsSemCountDec(semPended)) {
         OsHookCall(LOS_HOOK_TYPE_SEM_PEND, semPended, runTask, timeout);
         goto OUT;
     } else if (!timeout) {
@@ -246,18 +296,17 @@ LITE_OS_SEC_TEXT UINT32 OsSemPostUnsafe(UINT32 semHandle, BOOL *needSched)
     /* Update the operate time, no matter the actual Post success or not */
     OsSemDbgTimeUpdateHook(semHandle);
 
-    if (semPosted->semCount == OS_SEM_COUNT_MAX) {
-        return LOS_ERRNO_SEM_OVERFLOW;
-    }
-    if (!LOS_ListEmpty(&semPosted->semList)) {
+    if (LOS_ListEmpty(&semPosted->semList)) {
+        if (!OsSemCountInc(semPosted, 0)) {
+            return LOS_ERRNO_SEM_OVERFLOW;
+        }
+    } else {
         resumedTask = OS_TCB_FROM_PENDLIST(LOS_DL_LIST_FIRST(&(semPosted->semList)));
         OsTaskWakeClearPendMask(resumedTask);
         resumedTask->ops->wake(resumedTask);
         if (needSched != NULL) {
             *needSched = TRUE;
         }
-    } else {
-        semPosted->semCount++;
     }
     OsHookCall(LOS_HOOK_TYPE_SEM_POST, semPosted, resumedTask);
     return LOS_OK;
@@ -273,11 +322,18 @@ LITE_OS_SEC_TEXT UINT32 LOS_SemPost(UINT32 semHandle)
         return LOS_ERRNO_SEM_INVALID;
     }
 
+    LosSemCB *semPosted = GET_SEM(semHandle);
+    if (OsSemFastPathAllowed(semPosted, semHandle) && OsSemCountInc(semPosted, 1)) {
+        OsSemDbgTimeUpdateHook(semHandle);
+        OsHookCall(LOS_HOOK_TYPE_SEM_POST, semPosted, NULL);
+        return LOS_OK;
+    }
+
     SCHEDULER_LOCK(intSave);
     ret = OsSemPostUnsafe(semHandle, &needSched);
         SCHEDULER_UNLOCK(intSave);
     if (needSched) {
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        OsSchedPreemptTargetNotify();
         LOS_Schedule();
     }
 
@@ -162,7 +162,6 @@ STATIC UINT32 OsPendingTaskWake(LosTaskCB *taskCB, INT32 signo)
             taskCB->ops->wake(taskCB);
             break;
         case OS_TASK_WAIT_FUTEX:
-            OsFutexNodeDeleteFromFutexHash(&taskCB->futex, TRUE, NULL, NULL);
             OsTaskWakeClearPendMask(taskCB);
             taskCB->ops->wake(taskCB);
             break;
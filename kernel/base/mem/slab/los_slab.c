@@ -0,0 +1,502 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_slab_pri.h"
+#include "los_hwi.h"
+#include "los_memory.h"
+#include "los_spinlock.h"
+#include "los_vm_common.h"
+#include "los_vm_map.h"
+#include "los_vm_phys.h"
+#ifdef LOSCFG_FS_VFS
+#include "los_seq_buf.h"
+#endif
+
+#define OS_KMEM_STASH_SIZE      16
+#define OS_KMEM_STASH_BATCH     (OS_KMEM_STASH_SIZE >> 1)
+#define OS_KMEM_SLAB_OBJ_MIN    8
+#define OS_KMEM_SLAB_PAGES_MAX  8
+#define OS_KMEM_EMPTY_SLAB_MAX  1
+#define OS_KMEM_FREE_END        0xFFFFU
+#define OS_KMEM_OBJ_NUM_MAX     (OS_KMEM_FREE_END - 1)
+
+typedef struct {
+    UINT32 count;
+    UINT32 hitCount;
+    UINT32 missCount;
+    VOID *obj[OS_KMEM_STASH_SIZE];
+} KmemStash;
+
+/* Slabs are naturally aligned to their size, the header sits at the start of the slab */
+typedef struct {
+    LOS_DL_LIST node;           /* Linked to the partial, full or empty list of the cache */
+    LosKmemCache *cache;
+    UINT16 freeIndex;           /* First free object */
+    UINT16 inuse;
+    UINT16 next[0];             /* Free object chain, one slot per object */
+} KmemSlab;
+
+struct KmemCache {
+    LOS_DL_LIST node;
+    const CHAR *name;
+    UINT32 objSize;
+    UINT32 objOffset;           /* Offset of the first object in a slab */
+    UINT32 objNum;              /* Objects per slab */
+    UINT32 slabPages;
+    KmemCacheCtor ctor;
+    SPIN_LOCK_S lock;
+    LOS_DL_LIST partial;
+    LOS_DL_LIST full;
+    LOS_DL_LIST empty;
+    UINT32 slabNum;
+    UINT32 emptyNum;
+    UINT32 objInuse;            /* Objects taken from the slabs, including the ones in the stashes */
+    KmemStash stash[LOSCFG_KERNEL_CORE_NUM];
+};
+
+#define OS_KMEM_SLAB_SIZE(cache)        ((cache)->slabPages << PAGE_SHIFT)
+#define OS_KMEM_SLAB_OF(cache, obj)     ((KmemSlab *)ROUNDDOWN((UINTPTR)(obj), OS_KMEM_SLAB_SIZE(cache)))
+#define OS_KMEM_OBJ(cache, slab, index) \
+    ((VOID *)((UINTPTR)(slab) + (cache)->objOffset + ((UINTPTR)(index) * (cache)->objSize)))
+
+STATIC LOS_DL_LIST_HEAD(g_kmemCacheList);
+LITE_OS_SEC_BSS STATIC SPIN_LOCK_INIT(g_kmemCacheSpin);
+#define KMEM_LIST_LOCK(state)       LOS_SpinLockSave(&g_kmemCacheSpin, &(state))
+#define KMEM_LIST_UNLOCK(state)     LOS_SpinUnlockRestore(&g_kmemCacheSpin, (state))
+
+STATIC BOOL OsKmemCacheLayout(LosKmemCache *cache, UINT32 align)
+{
+    UINT32 slabSize;
+    UINT32 objNum = 0;
+    UINT32 offset = 0;
+
+    for (cache->slabPages = 1; cache->slabPages <= OS_KMEM_SLAB_PAGES_MAX; cache->slabPages <<= 1) {
+        slabSize = OS_KMEM_SLAB_SIZE(cache);
+        objNum = (slabSize - sizeof(KmemSlab)) / (cache->objSize + sizeof(UINT16));
+        objNum = MIN(objNum, OS_KMEM_OBJ_NUM_MAX);
+        offset = ALIGN(sizeof(KmemSlab) + (objNum * sizeof(UINT16)), align);
+        while ((objNum > 0) && ((offset + (objNum * cache->objSize)) > slabSize)) {
+            objNum--;
+            offset = ALIGN(sizeof(KmemSlab) + (objNum * sizeof(UINT16)), align);
+        }
+        if (objNum >= OS_KMEM_SLAB_OBJ_MIN) {
+            break;
+        }
+    }
+
+    if (objNum == 0) {
+        return FALSE;
+    }
+
+    cache->slabPages = MIN(cache->slabPages, OS_KMEM_SLAB_PAGES_MAX);
+    cache->objNum = objNum;
+    cache->objOffset = offset;
+    return TRUE;
+}
+
+LosKmemCache *LOS_KmemCacheCreate(const CHAR *name, UINT32 size, UINT32 align, KmemCacheCtor ctor)
+{
+    LosKmemCache *cache = NULL;
+    UINT32 intSave;
+
+    if ((name == NULL) || (size == 0) || (size > (OS_KMEM_SLAB_PAGES_MAX << PAGE_SHIFT))) {
+        return NULL;
+    }
+
+    align = MAX(align, sizeof(UINTPTR));
+    if ((align & (align - 1)) != 0) {
+        return NULL;
+    }
+
+    cache = (LosKmemCache *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosKmemCache));
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    (VOID)memset_s(cache, sizeof(LosKmemCache), 0, sizeof(LosKmemCache));
+    cache->name = name;
+    cache->objSize = ALIGN(size, align);
+    cache->ctor = ctor;
+    if (!OsKmemCacheLayout(cache, align)) {
+        (VOID)LOS_MemFree(m_aucSysMem0, cache);
+        return NULL;
+    }
+
+    LOS_SpinInit(&cache->lock);
+    LOS_ListInit(&cache->partial);
+    LOS_ListInit(&cache->full);
+    LOS_ListInit(&cache->empty);
+
+    KMEM_LIST_LOCK(intSave);
+    LOS_ListTailInsert(&g_kmemCacheList, &cache->node);
+    KMEM_LIST_UNLOCK(intSave);
+    return cache;
+}
+
+STATIC KmemSlab *OsKmemSlabCreate(LosKmemCache *cache)
+{
+    KmemSlab *slab = (KmemSlab *)LOS_PhysPagesAllocContiguous(cache->slabPages);
+    UINT32 index;
+
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    if (((UINTPTR)slab & (OS_KMEM_SLAB_SIZE(cache) - 1)) != 0) {
+        PRINT_ERR("%s: slab %#x of %s is not aligned to its size\n", __FUNCTION__, slab, cache->name);
+        LOS_PhysPagesFreeContiguous(slab, cache->slabPages);
+        return NULL;
+    }
+
+    slab->cache = cache;
+    slab->inuse = 0;
+    slab->freeIndex = 0;
+    for (index = 0; index < cache->objNum; index++) {
+        slab->next[index] = (UINT16)(index + 1);
+        if (cache->ctor != NULL) {
+            cache->ctor(OS_KMEM_OBJ(cache, slab, index));
+        }
+    }
+    slab->next[cache->objNum - 1] = OS_KMEM_FREE_END;
+    return slab;
+}
+
+/* The cache lock must be held */
+STATIC VOID *OsKmemSlabObjGet(LosKmemCache *cache)
+{
+    KmemSlab *slab = NULL;
+    UINT16 index;
+
+    if (!LOS_ListEmpty(&cache->partial)) {
+        slab = LOS_DL_LIST_ENTRY(cache->partial.pstNext, KmemSlab, node);
+    } else if (!LOS_ListEmpty(&cache->empty)) {
+        slab = LOS_DL_LIST_ENTRY(cache->empty.pstNext, KmemSlab, node);
+        LOS_ListDelete(&slab->node);
+        LOS_ListAdd(&cache->partial, &slab->node);
+        cache->emptyNum--;
+    } else {
+        return NULL;
+    }
+
+    index = slab->freeIndex;
+    slab->freeIndex = slab->next[index];
+    slab->inuse++;
+    if (slab->inuse == cache->objNum) {
+        LOS_ListDelete(&slab->node);
+        LOS_ListAdd(&cache->full, &slab->node);
+    }
+    cache->objInuse++;
+    return OS_KMEM_OBJ(cache, slab, index);
+}
+
+/* The cache lock must be held, slabs that become surplus are moved to the release list */
+STATIC VOID OsKmemSlabObjPut(LosKmemCache *cache, VOID *obj, LOS_DL_LIST *release)
+{
+    KmemSlab *slab = OS_KMEM_SLAB_OF(cache, obj);
+    UINT16 index = (UINT16)(((UINTPTR)obj - (UINTPTR)slab - cache->objOffset) / cache->objSize);
+
+    slab->next[index] = slab->freeIndex;
+    slab->freeIndex = index;
+    if (slab->inuse == cache->objNum) {
+        LOS_ListDelete(&slab->node);
+        LOS_ListAdd(&cache->partial, &slab->node);
+    }
+    slab->inuse--;
+    cache->objInuse--;
+    if (slab->inuse != 0) {
+        return;
+    }
+
+    LOS_ListDelete(&slab->node);
+    if (cache->emptyNum < OS_KMEM_EMPTY_SLAB_MAX) {
+        LOS_ListAdd(&cache->empty, &slab->node);
+        cache->emptyNum++;
+    } else {
+        LOS_ListTailInsert(release, &slab->node);
+        cache->slabNum--;
+    }
+}
+
+STATIC VOID OsKmemSlabRelease(const LosKmemCache *cache, LOS_DL_LIST *release)
+{
+    KmemSlab *slab = NULL;
+    KmemSlab *next = NULL;
+
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(slab, next, release, KmemSlab, node) {
+        LOS_ListDelete(&slab->node);
+        LOS_PhysPagesFreeContiguous(slab, cache->slabPages);
+    }
+}
+
+/* Return the oldest objects of a stash to the slabs, interrupts must be disabled */
+STATIC VOID OsKmemStashDrain(LosKmemCache *cache, KmemStash *stash, UINT32 num)
+{
+    LOS_DL_LIST_HEAD(release);
+    UINT32 index;
+
+    num = MIN(num, stash->count);
+    LOS_SpinLock(&cache->lock);
+    for (index = 0; index < num; index++) {
+        OsKmemSlabObjPut(cache, stash->obj[index], &release);
+    }
+    LOS_SpinUnlock(&cache->lock);
+
+    for (index = num; index < stash->count; index++) {
+        stash->obj[index - num] = stash->obj[index];
+    }
+    stash->count -= num;
+    OsKmemSlabRelease(cache, &release);
+}
+
+/* Take one object for the caller and a batch for the stash, interrupts must be disabled */
+STATIC VOID *OsKmemStashRefill(LosKmemCache *cache, KmemStash *stash)
+{
+    VOID *obj = NULL;
+
+    LOS_SpinLock(&cache->lock);
+    obj = OsKmemSlabObjGet(cache);
+    while ((obj != NULL) && (stash->count < OS_KMEM_STASH_BATCH)) {
+        VOID *extra = OsKmemSlabObjGet(cache);
+        if (extra == NULL) {
+            break;
+        }
+        stash->obj[stash->count++] = extra;
+    }
+    LOS_SpinUnlock(&cache->lock);
+    return obj;
+}
+
+STATIC VOID *OsKmemCacheGrow(LosKmemCache *cache)
+{
+    KmemSlab *slab = OsKmemSlabCreate(cache);
+    VOID *obj = NULL;
+    UINT32 intSave;
+
+    if (slab == NULL) {
+        return NULL;
+    }
+
+    LOS_SpinLockSave(&cache->lock, &intSave);
+    LOS_ListAdd(&cache->empty, &slab->node);
+    cache->emptyNum++;
+    cache->slabNum++;
+    obj = OsKmemSlabObjGet(cache);
+    LOS_SpinUnlockRestore(&cache->lock, intSave);
+    return obj;
+}
+
+VOID *LOS_KmemCacheAlloc(LosKmemCache *cache)
+{
+    KmemStash *stash = NULL;
+    VOID *obj = NULL;
+    UINT32 intSave;
+
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    intSave = LOS_IntLock();
+    stash = &cache->stash[ArchCurrCpuid()];
+    if (stash->count != 0) {
+        stash->hitCount++;
+        obj = stash->obj[--stash->count];
+        LOS_IntRestore(intSave);
+        return obj;
+    }
+
+    stash->missCount++;
+    obj = OsKmemStashRefill(cache, stash);
+    LOS_IntRestore(intSave);
+    if (obj != NULL) {
+        return obj;
+    }
+
+    /* populate a new slab with interrupts enabled, the constructors may take a while */
+    return OsKmemCacheGrow(cache);
+}
+
+STATIC BOOL OsKmemObjValid(const LosKmemCache *cache, const VOID *obj)
+{
+    const KmemSlab *slab = OS_KMEM_SLAB_OF(cache, obj);
+    UINTPTR offset;
+
+    if (!LOS_IsKernelAddressRange((VADDR_T)(UINTPTR)slab, sizeof(KmemSlab)) ||
+        (slab->cache != cache)) {
+        return FALSE;
+    }
+
+    offset = (UINTPTR)obj - (UINTPTR)slab;
+    if ((offset < cache->objOffset) || (((offset - cache->objOffset) % cache->objSize) != 0) ||
+        (((offset - cache->objOffset) / cache->objSize) >= cache->objNum)) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+UINT32 LOS_KmemCacheFree(LosKmemCache *cache, VOID *obj)
+{
+    KmemStash *stash = NULL;
+    UINT32 intSave;
+
+    if ((cache == NULL) || (obj == NULL)) {
+        return LOS_NOK;
+    }
+
+    if (!OsKmemObjValid(cache, obj)) {
+        PRINT_ERR("%s: %#x does not belong to %s\n", __FUNCTION__, obj, cache->name);
+        return LOS_NOK;
+    }
+
+    intSave = LOS_IntLock();
+    stash = &cache->stash[ArchCurrCpuid()];
+    if (stash->count == OS_KMEM_STASH_SIZE) {
+        OsKmemStashDrain(cache, stash, OS_KMEM_STASH_BATCH);
+    }
+    stash->obj[stash->count++] = obj;
+    LOS_IntRestore(intSave);
+    return LOS_OK;
+}
+
+UINT32 LOS_KmemCacheDestroy(LosKmemCache *cache)
+{
+    LOS_DL_LIST_HEAD(release);
+    KmemSlab *slab = NULL;
+    KmemSlab *next = NULL;
+    UINT32 intSave;
+
+    if (cache == NULL) {
+        return LOS_NOK;
+    }
+
+    /*
+     * The caller guarantees the cache is quiescent, so the stashes of the other cores are not touched
+     * by their owners here. Locking them could not make a concurrent user safe anyway, since the cache
+     * itself is freed below.
+     */
+    intSave = LOS_IntLock();
+    for (UINT32 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        OsKmemStashDrain(cache, &cache->stash[cpuid], cache->stash[cpuid].count);
+    }
+    LOS_IntRestore(intSave);
+
+    LOS_SpinLockSave(&cache->lock, &intSave);
+    if (cache->objInuse != 0) {
+        LOS_SpinUnlockRestore(&cache->lock, intSave);
+        PRINT_ERR("%s: %u objects of %s are still in use\n", __FUNCTION__, cache->objInuse, cache->name);
+        return LOS_NOK;
+    }
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(slab, next, &cache->empty, KmemSlab, node) {
+        LOS_ListDelete(&slab->node);
+        LOS_ListTailInsert(&release, &slab->node);
+    }
+    cache->slabNum = 0;
+    cache->emptyNum = 0;
+    LOS_SpinUnlockRestore(&cache->lock, intSave);
+    OsKmemSlabRelease(cache, &release);
+
+    KMEM_LIST_LOCK(intSave);
+    LOS_ListDelete(&cache->node);
+    KMEM_LIST_UNLOCK(intSave);
+    (VOID)LOS_MemFree(m_aucSysMem0, cache);
+    return LOS_OK;
+}
+
+#undef SHOW
+#ifdef LOSCFG_FS_VFS
+#define SHOW(arg...) do {                                    \
+    if (seqBuf != NULL) {                                    \
+        (void)LosBufPrintf((struct SeqBuf *)seqBuf, ##arg);  \
+    } else {                                                 \
+        PRINTK(arg);                                         \
+    }                                                        \
+} while (0)
+#else
+#define SHOW(arg...) PRINTK(arg)
+#endif
+
+typedef struct {
+    const CHAR *name;
+    UINT32 objSize;
+    UINT32 active;
+    UINT32 total;
+    UINT32 objNum;
+    UINT32 slabPages;
+    UINT32 slabNum;
+    UINT32 stashed;
+    UINT32 hit;
+    UINT32 miss;
+} KmemCacheInfo;
+
+/* Copies the counters of the index-th cache, so that nothing is printed with the list lock held */
+STATIC BOOL OsKmemCacheInfoGet(UINT32 index, KmemCacheInfo *info)
+{
+    LosKmemCache *cache = NULL;
+    BOOL found = FALSE;
+    UINT32 pos = 0;
+    UINT32 intSave;
+
+    KMEM_LIST_LOCK(intSave);
+    LOS_DL_LIST_FOR_EACH_ENTRY(cache, &g_kmemCacheList, LosKmemCache, node) {
+        if (pos++ != index) {
+            continue;
+        }
+        (VOID)memset_s(info, sizeof(KmemCacheInfo), 0, sizeof(KmemCacheInfo));
+        for (UINT32 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+            info->stashed += cache->stash[cpuid].count;
+            info->hit += cache->stash[cpuid].hitCount;
+            info->miss += cache->stash[cpuid].missCount;
+        }
+        info->name = cache->name;
+        info->objSize = cache->objSize;
+        info->active = cache->objInuse - info->stashed;
+        info->total = cache->slabNum * cache->objNum;
+        info->objNum = cache->objNum;
+        info->slabPages = cache->slabPages;
+        info->slabNum = cache->slabNum;
+        found = TRUE;
+        break;
+    }
+    KMEM_LIST_UNLOCK(intSave);
+    return found;
+}
+
+VOID OsKmemCacheInfoShow(VOID *seqBuf)
+{
+    KmemCacheInfo info;
+    UINT32 index;
+
+    SHOW("%-20s %8s %8s %10s %12s %8s %8s %8s %10s %10s\n", "name", "objsize", "active", "total",
+         "objperslab", "pages", "slabs", "cpu", "hit", "miss");
+    for (index = 0; OsKmemCacheInfoGet(index, &info); index++) {
+        SHOW("%-20s %8u %8u %10u %12u %8u %8u %8u %10u %10u\n", info.name, info.objSize, info.active,
+             info.total, info.objNum, info.slabPages, info.slabNum, info.stashed, info.hit, info.miss);
+    }
+}
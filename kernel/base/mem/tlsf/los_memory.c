@@ -50,6 +50,11 @@
 #else
 #define OS_MEM_EXPAND_ENABLE    0
 #endif
+#if defined(LOSCFG_KERNEL_SMP) && !defined(LOSCFG_KERNEL_LMS)
+#define OS_MEM_PCPU_CACHE_ENABLE    1
+#else
+#define OS_MEM_PCPU_CACHE_ENABLE    0
+#endif
 
 /* the dump size of current broken node when memcheck error */
 #define OS_MEM_NODE_DUMP_SIZE   64
@@ -161,12 +166,44 @@ struct OsMemPoolHead {
 #ifdef LOSCFG_MEM_MUL_POOL
     VOID *nextPool;
 #endif
+#if OS_MEM_PCPU_CACHE_ENABLE
+    struct OsMemPcpuCache *pcpuCache;
+#endif
 };
 
 /* Spinlock for mem module, only available on SMP mode */
 #define MEM_LOCK(pool, state)       LOS_SpinLockSave(&(pool)->spinlock, &(state))
 #define MEM_UNLOCK(pool, state)     LOS_SpinUnlockRestore(&(pool)->spinlock, (state))
 
+#if OS_MEM_PCPU_CACHE_ENABLE
+/*
+ * Per-cpu magazines of small used nodes in front of the TLSF free lists. A magazine is only
+ * touched by its own cpu with interrupts disabled, the pool lock is taken to refill or drain
+ * it in batches. Cached nodes keep the used flag and are counted as used by the pool.
+ */
+#define OS_MEM_CACHE_CLASS_SHIFT    4
+#define OS_MEM_CACHE_CLASS_COUNT    (OS_MEM_SMALL_BUCKET_MAX_SIZE >> OS_MEM_CACHE_CLASS_SHIFT)
+#define OS_MEM_CACHE_CLASS_SIZE(i)  (((i) + 1) << OS_MEM_CACHE_CLASS_SHIFT)
+#define OS_MEM_CACHE_MAG_SIZE       16
+#define OS_MEM_CACHE_BATCH          (OS_MEM_CACHE_MAG_SIZE >> 1)
+#define OS_MEM_CACHE_LINE_SIZE      64
+#define OS_MEM_NODE_CACHED_MAGIC    0xABCDCACE
+#define OS_MEM_NODE_IS_CACHED(node) ((node)->magic == OS_MEM_NODE_CACHED_MAGIC)
+
+struct OsMemCacheMagazine {
+    UINT32 count;
+    struct OsMemNodeHead *node[OS_MEM_CACHE_MAG_SIZE];
+};
+
+struct OsMemPcpuCache {
+    struct OsMemCacheMagazine mag[OS_MEM_CACHE_CLASS_COUNT];
+    UINT32 hitCount;
+    UINT32 missCount;
+} LOSBLD_ATTRIB_ALIGN(OS_MEM_CACHE_LINE_SIZE);
+
+STATIC struct OsMemPcpuCache g_memSysCache[LOSCFG_KERNEL_CORE_NUM];
+#endif
+
 /* The memory pool support expand. */
 #define OS_MEM_POOL_EXPAND_ENABLE  0x01
 /* The memory pool support no lock. */
@@ -1001,6 +1038,164 @@ UINT32 LOS_MemPoolList(VOID)
 }
 #endif
 
+#if OS_MEM_PCPU_CACHE_ENABLE
+STATIC INLINE struct OsMemNodeHead *OsMemCacheNodeGet(struct OsMemPoolHead *pool, UINT32 allocSize)
+{
+    struct OsMemNodeHead *node = OsMemFreeNodeGet(pool, allocSize);
+    if (node == NULL) {
+        return NULL;
+    }
+
+    if ((allocSize + OS_MEM_NODE_HEAD_SIZE + OS_MEM_MIN_ALLOC_SIZE) <= node->sizeAndFlag) {
+        OsMemSplitNode(pool, node, allocSize);
+    }
+
+    OS_MEM_NODE_SET_USED_FLAG(node->sizeAndFlag);
+    OsMemWaterUsedRecord(pool, OS_MEM_NODE_GET_SIZE(node->sizeAndFlag));
+    node->magic = OS_MEM_NODE_CACHED_MAGIC;
+    return node;
+}
+
+STATIC UINT32 OsMemCacheRefill(struct OsMemPoolHead *pool, struct OsMemCacheMagazine *mag, UINT32 allocSize)
+{
+    struct OsMemNodeHead *node = NULL;
+    UINT32 intSave;
+
+    MEM_LOCK(pool, intSave);
+    while (mag->count < OS_MEM_CACHE_BATCH) {
+        node = OsMemCacheNodeGet(pool, allocSize);
+        if (node == NULL) {
+            break;
+        }
+        mag->node[mag->count++] = node;
+    }
+    MEM_UNLOCK(pool, intSave);
+
+    return mag->count;
+}
+
+/* Release the oldest nodes of the magazine back to the pool, the pool lock must be held */
+STATIC VOID OsMemCacheDrain(struct OsMemPoolHead *pool, struct OsMemCacheMagazine *mag, UINT32 num)
+{
+    UINT32 index;
+
+    num = MIN(num, mag->count);
+    for (index = 0; index < num; index++) {
+        OS_MEM_SET_MAGIC(mag->node[index]);
+        (VOID)OsMemFree(pool, mag->node[index]);
+    }
+
+    for (index = num; index < mag->count; index++) {
+        mag->node[index - num] = mag->node[index];
+    }
+    mag->count -= num;
+}
+
+/* Flush the magazines of the current cpu, the pool lock must be held */
+STATIC BOOL OsMemCacheFlush(struct OsMemPoolHead *pool)
+{
+    struct OsMemPcpuCache *cache = &pool->pcpuCache[ArchCurrCpuid()];
+    BOOL flushed = FALSE;
+
+    for (UINT32 index = 0; index < OS_MEM_CACHE_CLASS_COUNT; index++) {
+        if (cache->mag[index].count != 0) {
+            OsMemCacheDrain(pool, &cache->mag[index], cache->mag[index].count);
+            flushed = TRUE;
+        }
+    }
+    return flushed;
+}
+
+STATIC VOID *OsMemCacheAlloc(struct OsMemPoolHead *pool, UINT32 size)
+{
+    UINT32 allocSize = OS_MEM_ALIGN(size + OS_MEM_NODE_HEAD_SIZE, OS_MEM_ALIGN_SIZE);
+    struct OsMemPcpuCache *cache = NULL;
+    struct OsMemCacheMagazine *mag = NULL;
+    struct OsMemNodeHead *node = NULL;
+    UINT32 index;
+    UINT32 intSave;
+
+    if (allocSize > OS_MEM_SMALL_BUCKET_MAX_SIZE) {
+        return NULL;
+    }
+
+    index = ((allocSize + OS_MEM_CACHE_CLASS_SIZE(0) - 1) >> OS_MEM_CACHE_CLASS_SHIFT) - 1;
+    intSave = LOS_IntLock();
+    cache = &pool->pcpuCache[ArchCurrCpuid()];
+    mag = &cache->mag[index];
+    if (mag->count != 0) {
+        cache->hitCount++;
+    } else {
+        cache->missCount++;
+        if (OsMemCacheRefill(pool, mag, OS_MEM_CACHE_CLASS_SIZE(index)) == 0) {
+            LOS_IntRestore(intSave);
+            return NULL;
+        }
+    }
+    node = mag->node[--mag->count];
+    LOS_IntRestore(intSave);
+
+    OS_MEM_SET_MAGIC(node);
+#ifdef LOSCFG_MEM_LEAKCHECK
+    OsMemLinkRegisterRecord(node);
+#endif
+    return OsMemCreateUsedNode((VOID *)node);
+}
+
+STATIC BOOL OsMemCacheFree(struct OsMemPoolHead *pool, struct OsMemNodeHead *node)
+{
+    UINT32 nodeSize = OS_MEM_NODE_GET_SIZE(node->sizeAndFlag);
+    struct OsMemCacheMagazine *mag = NULL;
+    UINT32 intSave;
+
+    /*
+     * only nodes of exactly a class size are cached, anything suspicious takes the checked path. Aligned
+     * nodes too: the cache hands out the node start, their aligned flag would be read as a gap there.
+     */
+    if ((nodeSize == 0) || (nodeSize > OS_MEM_SMALL_BUCKET_MAX_SIZE) ||
+        ((nodeSize & (OS_MEM_CACHE_CLASS_SIZE(0) - 1)) != 0) ||
+        !OS_MEM_MAGIC_VALID(node) || !OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag) ||
+        OS_MEM_NODE_GET_ALIGNED_FLAG(node->sizeAndFlag)) {
+        return FALSE;
+    }
+
+    struct OsMemNodeHead *nextNode = OS_MEM_NEXT_NODE(node);
+    if (!OS_MEM_NODE_GET_LAST_FLAG(nextNode->sizeAndFlag) && (nextNode->ptr.prev != node)) {
+        return FALSE;
+    }
+
+#ifdef LOSCFG_MEM_LEAKCHECK
+    OsMemLinkRegisterRecord(node);
+#endif
+    intSave = LOS_IntLock();
+    mag = &pool->pcpuCache[ArchCurrCpuid()].mag[(nodeSize >> OS_MEM_CACHE_CLASS_SHIFT) - 1];
+    if (mag->count == OS_MEM_CACHE_MAG_SIZE) {
+        UINT32 lockSave;
+        MEM_LOCK(pool, lockSave);
+        OsMemCacheDrain(pool, mag, OS_MEM_CACHE_BATCH);
+        MEM_UNLOCK(pool, lockSave);
+    }
+    node->magic = OS_MEM_NODE_CACHED_MAGIC;
+    mag->node[mag->count++] = node;
+    LOS_IntRestore(intSave);
+
+    return TRUE;
+}
+
+STATIC VOID OsMemCacheInfoGet(const struct OsMemPoolHead *pool, LOS_MEM_POOL_STATUS *poolStatus)
+{
+    for (UINT32 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        const struct OsMemPcpuCache *cache = &pool->pcpuCache[cpuid];
+        for (UINT32 index = 0; index < OS_MEM_CACHE_CLASS_COUNT; index++) {
+            poolStatus->cachedNodeNum += cache->mag[index].count;
+            poolStatus->cachedSize += cache->mag[index].count * OS_MEM_CACHE_CLASS_SIZE(index);
+        }
+        poolStatus->cacheHitCount += cache->hitCount;
+        poolStatus->cacheMissCount += cache->missCount;
+    }
+}
+#endif
+
 STATIC INLINE VOID *OsMemAlloc(struct OsMemPoolHead *pool, UINT32 size, UINT32 intSave)
 {
     struct OsMemNodeHead *allocNode = NULL;
@@ -1012,11 +1207,16 @@ STATIC INLINE VOID *OsMemAlloc(struct OsMemPoolHead *pool, UINT32 size, UINT32 i
 #endif
 
     UINT32 allocSize = OS_MEM_ALIGN(size + OS_MEM_NODE_HEAD_SIZE, OS_MEM_ALIGN_SIZE);
-#if OS_MEM_EXPAND_ENABLE
+#if OS_MEM_EXPAND_ENABLE || OS_MEM_PCPU_CACHE_ENABLE
 retry:
 #endif
     allocNode = OsMemFreeNodeGet(pool, allocSize);
     if (allocNode == NULL) {
+#if OS_MEM_PCPU_CACHE_ENABLE
+        if ((pool->pcpuCache != NULL) && OsMemCacheFlush(pool)) {
+            goto retry;
+        }
+#endif
 #if OS_MEM_EXPAND_ENABLE
         if (pool->info.attr & OS_MEM_POOL_EXPAND_ENABLE) {
             INT32 ret = OsMemPoolExpand(pool, allocSize, intSave);
@@ -1067,6 +1267,14 @@ VOID *LOS_MemAlloc(VOID *pool, UINT32 size)
         if (OS_MEM_NODE_GET_USED_FLAG(size) || OS_MEM_NODE_GET_ALIGNED_FLAG(size)) {
             break;
         }
+#if OS_MEM_PCPU_CACHE_ENABLE
+        if (poolHead->pcpuCache != NULL) {
+            ptr = OsMemCacheAlloc(poolHead, size);
+            if (ptr != NULL) {
+                break;
+            }
+        }
+#endif
         MEM_LOCK(poolHead, intSave);
         ptr = OsMemAlloc(poolHead, size, intSave);
         MEM_UNLOCK(poolHead, intSave);
@@ -1173,6 +1381,11 @@ STATIC INLINE BOOL OsMemIsNodeValid(const struct OsMemNodeHead *node, const stru
     }
 
     if (OS_MEM_NODE_GET_USED_FLAG(node->sizeAndFlag)) {
+#if OS_MEM_PCPU_CACHE_ENABLE
+        if (OS_MEM_NODE_IS_CACHED(node)) {
+            return TRUE;
+        }
+#endif
         if (!OS_MEM_MAGIC_VALID(node)) {
             return FALSE;
         }
@@ -1189,7 +1402,7 @@ STATIC INLINE BOOL OsMemIsNodeValid(const struct OsMemNodeHead *node, const stru
 STATIC  BOOL MemCheckUsedNode(const struct OsMemPoolHead *pool, const struct OsMemNodeHead *node,
                               const struct OsMemNodeHead *startNode, const struct OsMemNodeHead *endNode)
 {
-    if (!OsMemIsNodeValid(node, startNode, endNode, pool)) {
+    if (!OS_MEM_MAGIC_VALID(node) || !OsMemIsNodeValid(node, startNode, endNode, pool)) {
         return FALSE;
     }
 
@@ -1326,6 +1539,12 @@ UINT32 LOS_MemFree(VOID *pool, VOID *ptr)
             }
             node = (struct OsMemNodeHead *)((UINTPTR)ptr - gapSize - OS_MEM_NODE_HEAD_SIZE);
         }
+#if OS_MEM_PCPU_CACHE_ENABLE
+        if ((poolHead->pcpuCache != NULL) && OsMemCacheFree(poolHead, node)) {
+            ret = LOS_OK;
+            break;
+        }
+#endif
         MEM_LOCK(poolHead, intSave);
         ret = OsMemFree(poolHead, node);
         MEM_UNLOCK(poolHead, intSave);
@@ -1628,6 +1847,11 @@ STATIC UINT32 OsMemAddrValidCheckPrint(const VOID *pool, struct OsMemFreeNodeHea
 STATIC UINT32 OsMemIntegrityCheckSub(struct OsMemNodeHead **tmpNode, const VOID *pool,
                                      const struct OsMemNodeHead *endNode)
 {
+#if OS_MEM_PCPU_CACHE_ENABLE
+    if (OS_MEM_NODE_IS_CACHED(*tmpNode) && OS_MEM_NODE_GET_USED_FLAG((*tmpNode)->sizeAndFlag)) {
+        return LOS_OK;
+    }
+#endif
     if (!OS_MEM_MAGIC_VALID(*tmpNode)) {
         OsMemMagicCheckPrint(tmpNode);
         return LOS_NOK;
@@ -1929,6 +2153,11 @@ UINT32 LOS_MemInfoGet(VOID *pool, LOS_MEM_POOL_STATUS *poolStatus)
 #endif
 #ifdef LOSCFG_MEM_WATERLINE
     poolStatus->usageWaterLine = poolInfo->info.waterLine;
+#endif
+#if OS_MEM_PCPU_CACHE_ENABLE
+    if (poolInfo->pcpuCache != NULL) {
+        OsMemCacheInfoGet(poolInfo, poolStatus);
+    }
 #endif
     MEM_UNLOCK(poolInfo, intSave);
 
@@ -1963,6 +2192,12 @@ STATIC VOID OsMemInfoPrint(VOID *pool)
            status.totalFreeSize, status.maxFreeNodeSize, status.usedNodeNum,
            status.freeNodeNum);
 #endif
+#if OS_MEM_PCPU_CACHE_ENABLE
+    if (poolInfo->pcpuCache != NULL) {
+        PRINTK("pcpu cache: cached size 0x%x, cached node num 0x%x, hit %u, miss %u\n",
+               status.cachedSize, status.cachedNodeNum, status.cacheHitCount, status.cacheMissCount);
+    }
+#endif
 }
 
 UINT32 LOS_MemFreeNodeShow(VOID *pool)
@@ -2037,6 +2272,9 @@ STATUS_T OsKHeapInit(size_t size)
         g_vmBootMemBase -= size;
         return ret;
     }
+#if OS_MEM_PCPU_CACHE_ENABLE
+    ((struct OsMemPoolHead *)m_aucSysMem0)->pcpuCache = g_memSysCache;
+#endif
 #if OS_MEM_EXPAND_ENABLE
     LOS_MemExpandEnable(OS_SYS_MEM_ADDR);
 #endif
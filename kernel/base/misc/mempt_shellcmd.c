@@ -171,6 +171,21 @@ LITE_OS_SEC_TEXT_MINOR STATIC UINT32 OsShellCmdFreeInfo(INT32 argc, const CHAR *
     return 0;
 }
 
+#ifdef LOSCFG_KERNEL_SMP
+LITE_OS_SEC_TEXT_MINOR STATIC VOID OsShellCmdHeapCacheInfo(VOID)
+{
+    LOS_MEM_POOL_STATUS status = {0};
+
+    if ((LOS_MemInfoGet(m_aucSysMem1, &status) != LOS_OK) ||
+        ((status.cacheHitCount == 0) && (status.cacheMissCount == 0))) {
+        return;
+    }
+
+    PRINTK("Cache:  %u bytes in %u nodes held per cpu (counted in heap), hit: %u, miss: %u\n",
+           status.cachedSize, status.cachedNodeNum, status.cacheHitCount, status.cacheMissCount);
+}
+#endif
+
 LITE_OS_SEC_TEXT_MINOR UINT32 OsShellCmdFree(INT32 argc, const CHAR *argv[])
 {
     if (argc > 1) {
@@ -180,6 +195,9 @@ LITE_OS_SEC_TEXT_MINOR UINT32 OsShellCmdFree(INT32 argc, const CHAR *argv[])
     if (OsShellCmdFreeInfo(argc, argv) != 0) {
         return OS_ERROR;
     }
+#ifdef LOSCFG_KERNEL_SMP
+    OsShellCmdHeapCacheInfo();
+#endif
     OsShellCmdSectionInfo(argc, argv);
     return 0;
 }
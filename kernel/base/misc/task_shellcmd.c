@@ -33,6 +33,7 @@
 #include "los_config.h"
 #include "los_exc.h"
 #include "los_memstat_pri.h"
+#include "los_mux_pri.h"
 #include "los_sem_pri.h"
 #include "los_seq_buf.h"
 #include "los_task_pri.h"
@@ -120,6 +121,8 @@ STATIC UINT8 *ConvertSchedPolicyToString(UINT16 policy)
         return (UINT8 *)"FIFO";
     } else if (policy == LOS_SCHED_IDLE) {
         return (UINT8 *)"IDLE";
+    } else if (policy == LOS_SCHED_DEADLINE) {
+        return (UINT8 *)"EDF";
     }
 
     return (UINT8 *)"ERROR";
@@ -388,6 +391,8 @@ STATIC CHAR *CheckTaskWaitFlag(const LosTaskCB *taskCB, UINTPTR *lockID)
             return "Futex";
         case OS_TASK_WAIT_COMPLETE:
             return "Complete";
+        case OS_TASK_WAIT_MQUEUE:
+            return "Mqueue";
         default:
             break;
     }
@@ -411,7 +416,7 @@ STATIC VOID TaskPendingReasonInfoGet(const LosTaskCB *taskCB, CHAR *pendReason,
 
     if (taskCB->taskMux != NULL) {
         *lockID = (UINTPTR)taskCB->taskMux;
-        LosTaskCB *owner = ((LosMux *)taskCB->taskMux)->owner;
+        LosTaskCB *owner = OsMuxOwnerGet((LosMux *)taskCB->taskMux);
         if (owner != NULL) {
             if (snprintf_s(pendReason, maxLen, maxLen - 1, "Mutex-%u", owner->taskID) == EOK) {
                 return;
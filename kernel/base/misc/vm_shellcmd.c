@@ -41,6 +41,7 @@
 #endif
 #include "los_oom.h"
 #include "los_vm_dump.h"
+#include "los_vm_compact.h"
 #include "los_process_pri.h"
 #ifdef LOSCFG_FS_VFS
 #include "path_cache.h"
@@ -54,6 +55,7 @@
 #define VMM_CMD            "vmm"
 #define OOM_CMD            "oom"
 #define VMM_PMM_CMD        "v2p"
+#define COMPACT_CMD        "compact"
 
 LITE_OS_SEC_TEXT_MINOR VOID OsDumpKernelAspace(VOID)
 {
@@ -249,7 +251,65 @@ LITE_OS_SEC_TEXT_MINOR UINT32 OsShellCmdOom(INT32 argc, const CHAR *argv[])
     return OS_ERROR;
 }
 
+LITE_OS_SEC_TEXT_MINOR VOID CompactPrintUsage(VOID)
+{
+    PRINTK("\t-i,               print the fragmentation index of every order only\n"
+           "\t-h | --help,       print compact command usage\n");
+}
+
+LITE_OS_SEC_TEXT_MINOR VOID OsVmFragIndexDump(VOID)
+{
+    LosVmPhysSeg *seg = NULL;
+    UINT32 segIndex;
+    UINT32 order;
+
+    for (segIndex = 0; segIndex < g_vmPhysSegNum; segIndex++) {
+        seg = &g_vmPhysSeg[segIndex];
+        if (seg->size == 0) {
+            continue;
+        }
+        PRINTK(" phys_seg 0x%08x fragmentation index:", seg);
+        for (order = 0; order < VM_LIST_ORDER_MAX; order++) {
+            PRINTK(" %d", OsVmFragIndexGet(seg, order));
+        }
+        PRINTK("\n");
+    }
+}
+
+LITE_OS_SEC_TEXT_MINOR UINT32 OsShellCmdCompact(INT32 argc, const CHAR *argv[])
+{
+    LosVmCompactStat stat;
+    size_t migrated;
+
+    if (argc == ARGC_1) {
+        if (strcmp(argv[0], "-i") == 0) {
+            OsVmFragIndexDump();
+            return LOS_OK;
+        }
+        if (strcmp(argv[0], "-h") != 0 && strcmp(argv[0], "--help") != 0) {
+            PRINTK("%s: invalid option: %s\n", COMPACT_CMD, argv[0]);
+        }
+        CompactPrintUsage();
+        return LOS_OK;
+    } else if (argc != ARGC_0) {
+        PRINTK("%s: invalid option\n", COMPACT_CMD);
+        CompactPrintUsage();
+        return LOS_OK;
+    }
+
+    OsVmFragIndexDump();
+    migrated = OsVmCompact(0);
+    PRINTK(" migrated %u pages\n", (UINT32)migrated);
+    OsVmFragIndexDump();
+
+    OsVmCompactStatGet(&stat);
+    PRINTK(" compact runs %u, migrated %u, failed %u, freed blocks %u\n",
+           stat.compactCount, stat.migrateCount, stat.failCount, stat.freeBlockCount);
+    return LOS_OK;
+}
+
 #ifdef LOSCFG_SHELL_CMD_DEBUG
+SHELLCMD_ENTRY(compact_shellcmd, CMD_TYPE_SHOW, COMPACT_CMD, 1, (CmdCallBackFunc)OsShellCmdCompact);
 SHELLCMD_ENTRY(oom_shellcmd, CMD_TYPE_SHOW, OOM_CMD, 2, (CmdCallBackFunc)OsShellCmdOom);
 SHELLCMD_ENTRY(vm_shellcmd, CMD_TYPE_SHOW, VMM_CMD, 1, (CmdCallBackFunc)OsShellCmdDumpVm);
 SHELLCMD_ENTRY(v2p_shellcmd, CMD_TYPE_SHOW, VMM_PMM_CMD, 1, (CmdCallBackFunc)OsShellCmdV2P);
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_rcu_pri.h"
+#include "los_atomic.h"
+#include "los_mp.h"
+#include "los_sched_pri.h"
+#ifdef LOSCFG_KERNEL_SMP
+#include "hal_hwi.h"
+#endif
+
+/*
+ * Non-preemptible rcu: a reader only disables task preemption, so a cpu that switches tasks, or that
+ * finishes an interrupt taken while preemption is enabled, holds no rcu reference anymore.
+ * A grace period is over once every cpu running the scheduler has passed such a quiescent state.
+ */
+typedef struct {
+    volatile UINT32 gpSeq;      /* sequence of the latest started grace period */
+    volatile UINT32 doneSeq;    /* sequence of the latest finished grace period */
+    Atomic qsPending;           /* cpus which have not passed a quiescent state in the current grace period */
+    LosRcuHead *cbHead;         /* pending callbacks, in the order of their grace period */
+    LosRcuHead **cbTail;
+    UINT32 reqSeq;              /* the furthest grace period someone waits for */
+} RcuState;
+
+STATIC RcuState g_rcu = { 0, 0, 0, NULL, &g_rcu.cbHead, 0 };
+
+#ifdef LOSCFG_KERNEL_SMP
+/*
+ * Raw lock, it is also taken at the end of interrupts where LOS_SpinUnlock must not reschedule.
+ * Callers have interrupts disabled.
+ */
+STATIC size_t g_rcuLock = 0;
+#define RCU_LOCK()      ArchSpinLock(&g_rcuLock)
+#define RCU_UNLOCK()    ArchSpinUnlock(&g_rcuLock)
+#else
+#define RCU_LOCK()
+#define RCU_UNLOCK()
+#endif
+
+#define RCU_SEQ_DONE(seq)       ((INT32)(g_rcu.doneSeq - (seq)) >= 0)
+#define RCU_GP_IN_PROGRESS()    (g_rcu.gpSeq != g_rcu.doneSeq)
+
+STATIC VOID RcuGpStart(VOID)
+{
+    UINT32 cpuMask = g_taskScheduled;
+
+    LOS_AtomicSet(&g_rcu.qsPending, (INT32)cpuMask);
+    DMB;
+    g_rcu.gpSeq++;
+
+#ifdef LOSCFG_KERNEL_SMP
+    /* idle cpus may sleep without ticks, wake them up to report their quiescent state */
+    cpuMask &= ~CPUID_TO_AFFI_MASK(ArchCurrCpuid());
+    if (cpuMask != 0) {
+        HalIrqSendIpi(cpuMask, LOS_MP_IPI_WAKEUP);
+    }
+#endif
+}
+
+STATIC VOID RcuGpAdvance(VOID)
+{
+    if (RCU_GP_IN_PROGRESS()) {
+        if (LOS_AtomicRead(&g_rcu.qsPending) != 0) {
+            return;
+        }
+        DMB;
+        g_rcu.doneSeq = g_rcu.gpSeq;
+    }
+
+    if (!RCU_SEQ_DONE(g_rcu.reqSeq)) {
+        RcuGpStart();
+    }
+}
+
+STATIC UINT32 RcuGpRequest(VOID)
+{
+    /* a grace period already in progress may have started before the caller's update */
+    UINT32 target = g_rcu.gpSeq + 1;
+
+    if ((INT32)(target - g_rcu.reqSeq) > 0) {
+        g_rcu.reqSeq = target;
+    }
+    RcuGpAdvance();
+    return target;
+}
+
+STATIC LosRcuHead *RcuCbReap(VOID)
+{
+    LosRcuHead *head = g_rcu.cbHead;
+    LosRcuHead **tail = &g_rcu.cbHead;
+
+    while ((*tail != NULL) && RCU_SEQ_DONE((*tail)->gpSeq)) {
+        tail = &(*tail)->next;
+    }
+
+    if (tail == &g_rcu.cbHead) {
+        return NULL;
+    }
+
+    g_rcu.cbHead = *tail;
+    if (g_rcu.cbHead == NULL) {
+        g_rcu.cbTail = &g_rcu.cbHead;
+    }
+    *tail = NULL;
+    return head;
+}
+
+/* Called from OsRcuIrqEnd in interrupt context as well, see LOS_RcuCall for what callbacks may do */
+STATIC VOID RcuCbInvoke(LosRcuHead *head)
+{
+    while (head != NULL) {
+        LosRcuHead *next = head->next;
+        head->func(head);
+        head = next;
+    }
+}
+
+VOID OsRcuQuiescentState(VOID)
+{
+    INT32 cpuBit = (INT32)CPUID_TO_AFFI_MASK(ArchCurrCpuid());
+    INT32 pending;
+
+    /* the reads of the finished read-side critical sections must complete before the report */
+    DMB;
+    do {
+        pending = LOS_AtomicRead(&g_rcu.qsPending);
+        if (!(pending & cpuBit)) {
+            return;
+        }
+    } while (LOS_AtomicCmpXchg32bits(&g_rcu.qsPending, pending & ~cpuBit, pending));
+}
+
+VOID OsRcuIrqEnd(VOID)
+{
+    LosRcuHead *head = NULL;
+
+    if (OsSchedLockCountGet() == 0) {
+        OsRcuQuiescentState();
+    }
+
+    if (RCU_GP_IN_PROGRESS()) {
+        if (LOS_AtomicRead(&g_rcu.qsPending) != 0) {
+            return;
+        }
+    } else if (RCU_SEQ_DONE(g_rcu.reqSeq) && (g_rcu.cbHead == NULL)) {
+        return;
+    }
+
+    RCU_LOCK();
+    RcuGpAdvance();
+    head = RcuCbReap();
+    RCU_UNLOCK();
+
+    RcuCbInvoke(head);
+}
+
+UINT32 LOS_RcuGpStart(VOID)
+{
+    UINT32 intSave = LOS_IntLock();
+    RCU_LOCK();
+    UINT32 cookie = RcuGpRequest();
+    RCU_UNLOCK();
+    LOS_IntRestore(intSave);
+    return cookie;
+}
+
+BOOL LOS_RcuGpDone(UINT32 cookie)
+{
+    return RCU_SEQ_DONE(cookie);
+}
+
+VOID LOS_RcuCall(LosRcuHead *head, VOID (*func)(LosRcuHead *head))
+{
+    UINT32 intSave;
+
+    if ((head == NULL) || (func == NULL)) {
+        return;
+    }
+
+    head->func = func;
+    head->next = NULL;
+
+    intSave = LOS_IntLock();
+    RCU_LOCK();
+    head->gpSeq = RcuGpRequest();
+    *g_rcu.cbTail = head;
+    g_rcu.cbTail = &head->next;
+    RCU_UNLOCK();
+    LOS_IntRestore(intSave);
+}
+
+VOID LOS_RcuSynchronize(VOID)
+{
+    LosRcuHead *head = NULL;
+    UINT32 intSave;
+    UINT32 target;
+
+    intSave = LOS_IntLock();
+    RCU_LOCK();
+    target = RcuGpRequest();
+    RCU_UNLOCK();
+    LOS_IntRestore(intSave);
+
+    while (1) {
+        intSave = LOS_IntLock();
+        /* the caller is outside any read-side critical section */
+        OsRcuQuiescentState();
+        RCU_LOCK();
+        RcuGpAdvance();
+        head = RcuCbReap();
+        RCU_UNLOCK();
+        LOS_IntRestore(intSave);
+
+        RcuCbInvoke(head);
+        if (RCU_SEQ_DONE(target)) {
+            return;
+        }
+        (VOID)LOS_TaskDelay(1);
+    }
+}
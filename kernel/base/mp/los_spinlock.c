@@ -33,6 +33,77 @@
 #ifdef LOSCFG_KERNEL_SMP
 #include "los_sched_pri.h"
 
+#ifdef LOSCFG_KERNEL_SMP_TICKET_SPINLOCK
+#define OS_SPIN_TICKET_SHIFT    16
+#define OS_SPIN_TICKET_MASK     ((1U << OS_SPIN_TICKET_SHIFT) - 1)
+#endif
+
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+STATIC INLINE VOID OsSpinLockAcquire(SPIN_LOCK_S *lock)
+{
+    SpinLockStat *stat = &lock->stat;
+
+    if (ArchSpinTrylock(&lock->rawLock) != LOS_OK) {
+        UINT64 spinStartTime = OsGetCurrSchedTimeCycle();
+        ArchSpinLock(&lock->rawLock);
+        stat->spinTime += OsGetCurrSchedTimeCycle() - spinStartTime;
+        stat->contendCount++;
+    }
+
+    stat->lockCount++;
+    stat->holdStartTime = OsGetCurrSchedTimeCycle();
+}
+
+STATIC INLINE INT32 OsSpinTryAcquire(SPIN_LOCK_S *lock)
+{
+    INT32 ret = ArchSpinTrylock(&lock->rawLock);
+    if (ret == LOS_OK) {
+        lock->stat.lockCount++;
+        lock->stat.holdStartTime = OsGetCurrSchedTimeCycle();
+    }
+    return ret;
+}
+
+STATIC INLINE VOID OsSpinRelease(SPIN_LOCK_S *lock)
+{
+    SpinLockStat *stat = &lock->stat;
+    UINT64 holdTime = OsGetCurrSchedTimeCycle() - stat->holdStartTime;
+
+    if (holdTime > stat->maxHoldTime) {
+        stat->maxHoldTime = holdTime;
+    }
+    ArchSpinUnlock(&lock->rawLock);
+}
+
+VOID LOS_SpinStatGet(SPIN_LOCK_S *lock, SpinLockStat *stat, BOOL clear)
+{
+    UINT32 intSave;
+
+    LOS_SpinLockSave(lock, &intSave);
+    *stat = lock->stat;
+    if (clear) {
+        (VOID)memset_s(&lock->stat, sizeof(SpinLockStat), 0, sizeof(SpinLockStat));
+        lock->stat.holdStartTime = stat->holdStartTime;
+    }
+    LOS_SpinUnlockRestore(lock, intSave);
+}
+#else
+STATIC INLINE VOID OsSpinLockAcquire(SPIN_LOCK_S *lock)
+{
+    ArchSpinLock(&lock->rawLock);
+}
+
+STATIC INLINE INT32 OsSpinTryAcquire(SPIN_LOCK_S *lock)
+{
+    return ArchSpinTrylock(&lock->rawLock);
+}
+
+STATIC INLINE VOID OsSpinRelease(SPIN_LOCK_S *lock)
+{
+    ArchSpinUnlock(&lock->rawLock);
+}
+#endif
+
 
 VOID LOS_SpinInit(SPIN_LOCK_S *lock)
 {
@@ -40,11 +111,19 @@ VOID LOS_SpinInit(SPIN_LOCK_S *lock)
     lock->cpuid   = (UINT32)-1;
     lock->owner   = SPINLOCK_OWNER_INIT;
     lock->name    = "spinlock";
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+    (VOID)memset_s(&lock->stat, sizeof(SpinLockStat), 0, sizeof(SpinLockStat));
+#endif
 }
 
 BOOL LOS_SpinHeld(const SPIN_LOCK_S *lock)
 {
+#ifdef LOSCFG_KERNEL_SMP_TICKET_SPINLOCK
+    UINT32 rawLock = (UINT32)lock->rawLock;
+    return ((rawLock & OS_SPIN_TICKET_MASK) != (rawLock >> OS_SPIN_TICKET_SHIFT));
+#else
     return (lock->rawLock != 0);
+#endif
 }
 
 VOID LOS_SpinLock(SPIN_LOCK_S *lock)
@@ -54,7 +133,7 @@ VOID LOS_SpinLock(SPIN_LOCK_S *lock)
     LOS_IntRestore(intSave);
 
     LOCKDEP_CHECK_IN(lock);
-    ArchSpinLock(&lock->rawLock);
+    OsSpinLockAcquire(lock);
     LOCKDEP_RECORD(lock);
 }
 
@@ -64,7 +143,7 @@ INT32 LOS_SpinTrylock(SPIN_LOCK_S *lock)
     OsSchedLock();
     LOS_IntRestore(intSave);
 
-    INT32 ret = ArchSpinTrylock(&lock->rawLock);
+    INT32 ret = OsSpinTryAcquire(lock);
     if (ret == LOS_OK) {
         LOCKDEP_CHECK_IN(lock);
         LOCKDEP_RECORD(lock);
@@ -85,7 +164,7 @@ VOID LOS_SpinUnlock(SPIN_LOCK_S *lock)
 {
     UINT32 intSave;
     LOCKDEP_CHECK_OUT(lock);
-    ArchSpinUnlock(&lock->rawLock);
+    OsSpinRelease(lock);
 
     intSave = LOS_IntLock();
     BOOL needSched = OsSchedUnlockResch();
@@ -101,14 +180,14 @@ VOID LOS_SpinLockSave(SPIN_LOCK_S *lock, UINT32 *intSave)
     OsSchedLock();
 
     LOCKDEP_CHECK_IN(lock);
-    ArchSpinLock(&lock->rawLock);
+    OsSpinLockAcquire(lock);
     LOCKDEP_RECORD(lock);
 }
 
 VOID LOS_SpinUnlockRestore(SPIN_LOCK_S *lock, UINT32 intSave)
 {
     LOCKDEP_CHECK_OUT(lock);
-    ArchSpinUnlock(&lock->rawLock);
+    OsSpinRelease(lock);
 
     BOOL needSched = OsSchedUnlockResch();
     LOS_IntRestore(intSave);
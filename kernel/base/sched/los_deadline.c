@@ -0,0 +1,586 @@
+/*
+ * Copyright (c) 2022-2022 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "los_sched_pri.h"
+#include "los_task_pri.h"
+#include "los_process_pri.h"
+#include "los_hook.h"
+
+#define OS_SCHED_EDF_BW_UNIT       (1U << OS_SCHED_EDF_BW_SHIFT)
+#define OS_SCHED_EDF_BW_LIMIT      ((OS_SCHED_EDF_BW_UNIT * 95) / 100) /* 5% of each cpu is left to FIFO/RR */
+#define OS_SCHED_EDF_RUNTIME_MIN   ((100 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 100us */
+#define OS_SCHED_EDF_PERIOD_MAX    ((UINT64)OS_SYS_CLOCK * 10) /* 10s */
+#define OS_SCHED_EDF_BUDGET_MIN    (INT64)((50 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 50us */
+
+STATIC EDFRunqueue g_schedEDF[LOSCFG_KERNEL_CORE_NUM];
+
+STATIC VOID EDFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB);
+STATIC VOID EDFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB);
+STATIC UINT32 EDFWait(LosTaskCB *runTask, LOS_DL_LIST *list, UINT32 ticks);
+STATIC VOID EDFWake(LosTaskCB *resumedTask);
+STATIC BOOL EDFSchedParamModify(LosTaskCB *taskCB, const SchedParam *param);
+STATIC UINT32 EDFSchedParamGet(const LosTaskCB *taskCB, SchedParam *param);
+STATIC UINT32 EDFDelay(LosTaskCB *runTask, UINT64 waitTime);
+STATIC VOID EDFYield(LosTaskCB *runTask);
+STATIC VOID EDFStartToRun(SchedRunqueue *rq, LosTaskCB *taskCB);
+STATIC VOID EDFExit(LosTaskCB *taskCB);
+STATIC UINT32 EDFSuspend(LosTaskCB *taskCB);
+STATIC UINT32 EDFResume(LosTaskCB *taskCB, BOOL *needSched);
+STATIC UINT64 EDFTimeSliceGet(const LosTaskCB *taskCB);
+STATIC VOID EDFTimeSliceUpdate(SchedRunqueue *rq, LosTaskCB *taskCB, UINT64 currTime);
+STATIC INT32 EDFParamCompare(const SchedPolicy *sp1, const SchedPolicy *sp2);
+STATIC VOID EDFPriorityInheritance(LosTaskCB *owner, const SchedParam *param);
+STATIC VOID EDFPriorityRestore(LosTaskCB *owner, const LOS_DL_LIST *list, const SchedParam *param);
+
+const STATIC SchedOps g_deadlineOps = {
+    .dequeue = EDFDequeue,
+    .enqueue = EDFEnqueue,
+    .wait = EDFWait,
+    .wake = EDFWake,
+    .schedParamModify = EDFSchedParamModify,
+    .schedParamGet = EDFSchedParamGet,
+    .delay = EDFDelay,
+    .yield = EDFYield,
+    .start = EDFStartToRun,
+    .exit = EDFExit,
+    .suspend = EDFSuspend,
+    .resume = EDFResume,
+    .deadlineGet = EDFTimeSliceGet,
+    .timeSliceUpdate = EDFTimeSliceUpdate,
+    .schedParamCompare = EDFParamCompare,
+    .priorityInheritance = EDFPriorityInheritance,
+    .priorityRestore = EDFPriorityRestore,
+};
+
+STATIC INLINE EDFRunqueue *EDFTaskRunqueue(const LosTaskCB *taskCB)
+{
+    return OsSchedRunqueueByID(((SchedEDF *)&taskCB->sp)->cpuid)->edfRunqueue;
+}
+
+STATIC INLINE VOID EDFJobStart(SchedEDF *sched, UINT64 startTime)
+{
+    sched->finishTime = startTime + sched->deadline;
+    sched->budget = (INT64)sched->runTime;
+    sched->flags &= ~OS_SCHED_EDF_FLAG_MISSED;
+}
+
+STATIC VOID EDFTimeSliceUpdate(SchedRunqueue *rq, LosTaskCB *taskCB, UINT64 currTime)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    LOS_ASSERT(currTime >= taskCB->startTime);
+
+    INT64 incTime = (INT64)(currTime - taskCB->startTime - taskCB->irqUsedTime);
+
+    LOS_ASSERT(incTime >= 0);
+
+    sched->budget -= incTime;
+    taskCB->irqUsedTime = 0;
+    taskCB->startTime = currTime;
+    if (sched->budget <= OS_SCHED_EDF_BUDGET_MIN) {
+        rq->schedFlag |= INT_PEND_RESCH;
+    }
+
+#ifdef LOSCFG_SCHED_DEBUG
+    if ((currTime > sched->finishTime) && !(sched->flags & OS_SCHED_EDF_FLAG_MISSED)) {
+        sched->flags |= OS_SCHED_EDF_FLAG_MISSED;
+        taskCB->schedStat.deadlineMissCount++;
+    }
+    taskCB->schedStat.allRuntime += incTime;
+#endif
+}
+
+STATIC UINT64 EDFTimeSliceGet(const LosTaskCB *taskCB)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    INT64 budget = (sched->budget > OS_SCHED_EDF_BUDGET_MIN) ? sched->budget : OS_SCHED_EDF_BUDGET_MIN;
+
+    return (taskCB->startTime + (UINT64)budget);
+}
+
+STATIC INLINE VOID EDFQueueInsert(EDFRunqueue *rq, LosTaskCB *taskCB)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    LOS_DL_LIST *pos = &rq->root;
+    LosTaskCB *task = NULL;
+
+    LOS_ASSERT(taskCB->pendList.pstNext == NULL);
+
+    /* Equal deadlines are served in arrival order */
+    LOS_DL_LIST_FOR_EACH_ENTRY(task, &rq->root, LosTaskCB, pendList) {
+        if (((SchedEDF *)&task->sp)->finishTime > sched->finishTime) {
+            pos = &task->pendList;
+            break;
+        }
+    }
+
+    LOS_ListTailInsert(pos, &taskCB->pendList);
+    rq->taskNum++;
+}
+
+/*
+ * CBS: the running task ran out of budget. It sleeps on the timeout queue
+ * until its next period begins, unless that period has begun already.
+ */
+STATIC BOOL EDFThrottle(LosTaskCB *taskCB, UINT64 currTime)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    UINT64 replenishTime = sched->finishTime - sched->deadline + sched->period;
+
+    if (replenishTime <= currTime) {
+        EDFJobStart(sched, currTime);
+        return FALSE;
+    }
+
+    sched->flags |= OS_SCHED_EDF_FLAG_THROTTLED;
+    taskCB->taskStatus |= OS_TASK_STATUS_DELAY;
+    taskCB->waitTime = replenishTime - currTime;
+#ifdef LOSCFG_SCHED_DEBUG
+    taskCB->schedStat.throttleCount++;
+#endif
+    return TRUE;
+}
+
+/* Take a throttled task off the timeout queue, return TRUE if it has to be queued again */
+STATIC BOOL EDFThrottleCancel(LosTaskCB *taskCB)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+
+    if (!(sched->flags & OS_SCHED_EDF_FLAG_THROTTLED)) {
+        return FALSE;
+    }
+
+    sched->flags &= ~OS_SCHED_EDF_FLAG_THROTTLED;
+    if (taskCB->taskStatus & OS_TASK_STATUS_DELAY) {
+        OsSchedTimeoutQueueDelete(taskCB);
+        taskCB->taskStatus &= ~OS_TASK_STATUS_DELAY;
+    }
+
+    return !OsTaskIsBlocked(taskCB);
+}
+
+STATIC VOID EDFReplenish(LosTaskCB *taskCB, UINT64 currTime)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+
+    if (sched->flags & OS_SCHED_EDF_FLAG_THROTTLED) {
+        sched->flags &= ~OS_SCHED_EDF_FLAG_THROTTLED;
+        EDFJobStart(sched, sched->finishTime - sched->deadline + sched->period);
+    }
+
+    /* Overrun while the task could not be preempted: postpone the deadline with the budget */
+    while (sched->budget <= 0) {
+        sched->finishTime += sched->period;
+        sched->budget += (INT64)sched->runTime;
+    }
+
+    /*
+     * CBS wakeup rule: keep the current job only if what is left of its
+     * budget fits in its bandwidth before the deadline.
+     */
+    if ((currTime >= sched->finishTime) ||
+        ((UINT64)sched->budget > (((sched->finishTime - currTime) * sched->bandwidth) >> OS_SCHED_EDF_BW_SHIFT))) {
+        EDFJobStart(sched, currTime);
+    }
+}
+
+STATIC VOID EDFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    UINT64 currTime = OsGetCurrSchedTimeCycle();
+    (VOID)rq;
+
+    LOS_ASSERT(!(taskCB->taskStatus & OS_TASK_STATUS_READY));
+    if (taskCB->taskStatus & OS_TASK_STATUS_RUNNING) {
+        if ((sched->budget <= OS_SCHED_EDF_BUDGET_MIN) && EDFThrottle(taskCB, currTime)) {
+            return;
+        }
+    } else {
+        EDFReplenish(taskCB, currTime);
+#ifdef LOSCFG_SCHED_DEBUG
+        taskCB->startTime = currTime;
+#endif
+    }
+
+    EDFQueueInsert(EDFTaskRunqueue(taskCB), taskCB);
+    taskCB->taskStatus &= ~OS_TASK_STATUS_BLOCKED;
+    taskCB->taskStatus |= OS_TASK_STATUS_READY;
+#ifdef LOSCFG_KERNEL_SMP
+    /* The task only runs on the cpu its bandwidth is reserved on */
+    taskCB->lastCpu = sched->cpuid;
+    OsSchedRunqueuePreemptCheck(taskCB, sched->cpuid);
+#endif
+}
+
+STATIC VOID EDFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
+{
+    (VOID)rq;
+
+    if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+        LOS_ListDelete(&taskCB->pendList);
+        EDFTaskRunqueue(taskCB)->taskNum--;
+        taskCB->taskStatus &= ~OS_TASK_STATUS_READY;
+    }
+}
+
+STATIC VOID EDFStartToRun(SchedRunqueue *rq, LosTaskCB *taskCB)
+{
+    EDFDequeue(rq, taskCB);
+}
+
+STATIC VOID EDFBandwidthRelease(SchedEDF *sched)
+{
+    if (sched->flags & OS_SCHED_EDF_FLAG_ADMITTED) {
+        OsSchedRunqueueByID(sched->cpuid)->edfRunqueue->bandwidth -= sched->bandwidth;
+        sched->flags &= ~OS_SCHED_EDF_FLAG_ADMITTED;
+    }
+}
+
+STATIC VOID EDFExit(LosTaskCB *taskCB)
+{
+    if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+        EDFDequeue(OsSchedRunqueue(), taskCB);
+    } else if (taskCB->taskStatus & OS_TASK_STATUS_PENDING) {
+        LOS_ListDelete(&taskCB->pendList);
+        taskCB->taskStatus &= ~OS_TASK_STATUS_PENDING;
+    }
+
+    if (taskCB->taskStatus & (OS_TASK_STATUS_DELAY | OS_TASK_STATUS_PEND_TIME)) {
+        OsSchedTimeoutQueueDelete(taskCB);
+        taskCB->taskStatus &= ~(OS_TASK_STATUS_DELAY | OS_TASK_STATUS_PEND_TIME);
+    }
+
+    /* Also called for the running task on its way out, the release must be idempotent */
+    EDFBandwidthRelease((SchedEDF *)&taskCB->sp);
+}
+
+/* The current job is done: the rest of the budget is given up until the next period */
+STATIC VOID EDFYield(LosTaskCB *runTask)
+{
+    SchedRunqueue *rq = OsSchedRunqueue();
+    SchedEDF *sched = (SchedEDF *)&runTask->sp;
+
+    runTask->ops->timeSliceUpdate(rq, runTask, OsGetCurrSchedTimeCycle());
+    sched->budget = 0;
+    EDFEnqueue(rq, runTask);
+    OsSchedResched();
+}
+
+STATIC UINT32 EDFDelay(LosTaskCB *runTask, UINT64 waitTime)
+{
+    runTask->taskStatus |= OS_TASK_STATUS_DELAY;
+    runTask->waitTime = waitTime;
+
+    OsSchedResched();
+    return LOS_OK;
+}
+
+STATIC UINT32 EDFWait(LosTaskCB *runTask, LOS_DL_LIST *list, UINT32 ticks)
+{
+    runTask->taskStatus |= OS_TASK_STATUS_PENDING;
+    LOS_ListTailInsert(list, &runTask->pendList);
+
+    if (ticks != LOS_WAIT_FOREVER) {
+        runTask->taskStatus |= OS_TASK_STATUS_PEND_TIME;
+        runTask->waitTime = OS_SCHED_TICK_TO_CYCLE(ticks);
+    }
+
+    if (OsPreemptableInSched()) {
+        OsSchedResched();
+        if (runTask->taskStatus & OS_TASK_STATUS_TIMEOUT) {
+            runTask->taskStatus &= ~OS_TASK_STATUS_TIMEOUT;
+            return LOS_ERRNO_TSK_TIMEOUT;
+        }
+    }
+
+    return LOS_OK;
+}
+
+STATIC VOID EDFWake(LosTaskCB *resumedTask)
+{
+    LOS_ListDelete(&resumedTask->pendList);
+    resumedTask->taskStatus &= ~OS_TASK_STATUS_PENDING;
+
+    if (resumedTask->taskStatus & OS_TASK_STATUS_PEND_TIME) {
+        OsSchedTimeoutQueueDelete(resumedTask);
+        resumedTask->taskStatus &= ~OS_TASK_STATUS_PEND_TIME;
+    }
+
+    if (!(resumedTask->taskStatus & OS_TASK_STATUS_SUSPENDED)) {
+#ifdef LOSCFG_SCHED_DEBUG
+        resumedTask->schedStat.pendTime += OsGetCurrSchedTimeCycle() - resumedTask->startTime;
+        resumedTask->schedStat.pendCount++;
+#endif
+        EDFEnqueue(OsSchedRunqueue(), resumedTask);
+    }
+}
+
+STATIC BOOL EDFSchedParamModify(LosTaskCB *taskCB, const SchedParam *param)
+{
+    SchedRunqueue *rq = OsSchedRunqueue();
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    BOOL needSched = FALSE;
+
+    if (param->policy == LOS_SCHED_DEADLINE) {
+        /* The reservation is changed by EDFTaskSchedParamSet, only the priorities kept for FIFO/RR change here */
+        if (sched->basePrio != param->basePrio) {
+            needSched = HPFBasePriorityModify(rq, taskCB, param->basePrio);
+        }
+        sched->priority = param->priority;
+        OsHookCall(LOS_HOOK_TYPE_TASK_PRIMODIFY, taskCB, sched->priority);
+        return needSched;
+    }
+
+    BOOL isReady = OsTaskIsReady(taskCB);
+    if (isReady) {
+        EDFDequeue(rq, taskCB);
+    } else {
+        isReady = EDFThrottleCancel(taskCB);
+    }
+    EDFBandwidthRelease(sched);
+
+    (VOID)memset_s(&taskCB->sp, sizeof(SchedPolicy), 0, sizeof(SchedPolicy));
+    HPFTaskSchedParamInit(taskCB, param->policy, param, NULL);
+    if (isReady || (taskCB->taskStatus & OS_TASK_STATUS_INIT)) {
+        taskCB->ops->enqueue(rq, taskCB);
+        return TRUE;
+    }
+
+    return OsTaskIsRunning(taskCB);
+}
+
+STATIC UINT32 EDFSchedParamGet(const LosTaskCB *taskCB, SchedParam *param)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    param->policy = sched->policy;
+    param->basePrio = sched->basePrio;
+    param->priority = sched->priority;
+    param->timeSlice = 0;
+    param->runTime = sched->runTime;
+    param->deadline = sched->deadline;
+    param->period = sched->period;
+    return LOS_OK;
+}
+
+STATIC UINT32 EDFSuspend(LosTaskCB *taskCB)
+{
+    if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+        EDFDequeue(OsSchedRunqueue(), taskCB);
+    }
+
+    SchedTaskFreeze(taskCB);
+
+    taskCB->taskStatus |= OS_TASK_STATUS_SUSPENDED;
+    OsHookCall(LOS_HOOK_TYPE_MOVEDTASKTOSUSPENDEDLIST, taskCB);
+    if (taskCB == OsCurrTaskGet()) {
+        OsSchedResched();
+    }
+    return LOS_OK;
+}
+
+STATIC UINT32 EDFResume(LosTaskCB *taskCB, BOOL *needSched)
+{
+    *needSched = FALSE;
+
+    SchedTaskUnfreeze(taskCB);
+
+    taskCB->taskStatus &= ~OS_TASK_STATUS_SUSPENDED;
+    if (!OsTaskIsBlocked(taskCB)) {
+        EDFEnqueue(OsSchedRunqueue(), taskCB);
+        *needSched = TRUE;
+    }
+
+    return LOS_OK;
+}
+
+STATIC INT32 EDFParamCompare(const SchedPolicy *sp1, const SchedPolicy *sp2)
+{
+    SchedEDF *param1 = (SchedEDF *)sp1;
+    SchedEDF *param2 = (SchedEDF *)sp2;
+
+    if (param1->finishTime < param2->finishTime) {
+        return -1;
+    } else if (param1->finishTime > param2->finishTime) {
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Deadline tasks already beat every FIFO/RR waiter, their budget is not lent */
+STATIC VOID EDFPriorityInheritance(LosTaskCB *owner, const SchedParam *param)
+{
+    (VOID)owner;
+    (VOID)param;
+    return;
+}
+
+STATIC VOID EDFPriorityRestore(LosTaskCB *owner, const LOS_DL_LIST *list, const SchedParam *param)
+{
+    (VOID)owner;
+    (VOID)list;
+    (VOID)param;
+    return;
+}
+
+/*
+ * Admission control: among the cpus of cpuAffiMask, the one with the
+ * least deadline bandwidth reserved that can still take bandwidth.
+ */
+STATIC UINT16 EDFRunqueueAdmit(const LosTaskCB *taskCB, UINT16 cpuAffiMask, UINT32 bandwidth)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    UINT16 target = OS_TASK_INVALID_CPUID;
+    UINT32 minReserved = OS_INVALID_VALUE;
+
+    (VOID)cpuAffiMask;
+    for (UINT16 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+#ifdef LOSCFG_KERNEL_SMP
+        if (!(cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid))) {
+            continue;
+        }
+#endif
+        UINT32 reserved = OsSchedRunqueueByID(cpuid)->edfRunqueue->bandwidth;
+        if ((sched->policy == LOS_SCHED_DEADLINE) && (sched->flags & OS_SCHED_EDF_FLAG_ADMITTED) &&
+            (sched->cpuid == cpuid)) {
+            reserved -= sched->bandwidth;
+        }
+
+        if (((reserved + bandwidth) <= OS_SCHED_EDF_BW_LIMIT) && (reserved < minReserved)) {
+            minReserved = reserved;
+            target = cpuid;
+        }
+    }
+
+    return target;
+}
+
+UINT32 EDFTaskSchedParamSet(LosTaskCB *taskCB, const SchedParam *param, BOOL *needSched)
+{
+    SchedRunqueue *rq = OsSchedRunqueue();
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    SchedParam oldParam = { 0 };
+    UINT64 period = (param->period == 0) ? param->deadline : param->period;
+
+    *needSched = FALSE;
+    if ((param->runTime < OS_SCHED_EDF_RUNTIME_MIN) || (param->deadline < param->runTime) ||
+        (period < param->deadline) || (period > OS_SCHED_EDF_PERIOD_MAX)) {
+        return LOS_EINVAL;
+    }
+
+    UINT32 bandwidth = (UINT32)((param->runTime << OS_SCHED_EDF_BW_SHIFT) / param->deadline);
+    UINT16 cpuid = EDFRunqueueAdmit(taskCB, taskCB->cpuAffiMask, bandwidth);
+    if (cpuid == OS_TASK_INVALID_CPUID) {
+        return LOS_EBUSY;
+    }
+
+    taskCB->ops->schedParamGet(taskCB, &oldParam);
+    BOOL isReady = OsTaskIsReady(taskCB);
+    if (isReady) {
+        taskCB->ops->dequeue(rq, taskCB);
+    } else if (oldParam.policy == LOS_SCHED_DEADLINE) {
+        isReady = EDFThrottleCancel(taskCB);
+    }
+
+    if (oldParam.policy == LOS_SCHED_DEADLINE) {
+        EDFBandwidthRelease(sched);
+    }
+
+    (VOID)memset_s(&taskCB->sp, sizeof(SchedPolicy), 0, sizeof(SchedPolicy));
+    sched->policy = LOS_SCHED_DEADLINE;
+    sched->basePrio = oldParam.basePrio;
+    sched->priority = oldParam.priority;
+    sched->cpuid = cpuid;
+    sched->flags = OS_SCHED_EDF_FLAG_ADMITTED;
+    sched->bandwidth = bandwidth;
+    sched->runTime = param->runTime;
+    sched->deadline = param->deadline;
+    sched->period = period;
+    EDFJobStart(sched, OsGetCurrSchedTimeCycle());
+    OsSchedRunqueueByID(cpuid)->edfRunqueue->bandwidth += bandwidth;
+
+    taskCB->timeSlice = 0;
+    taskCB->ops = &g_deadlineOps;
+    if (isReady || (taskCB->taskStatus & OS_TASK_STATUS_INIT)) {
+        EDFEnqueue(rq, taskCB);
+        *needSched = TRUE;
+        return LOS_OK;
+    }
+
+    *needSched = OsTaskIsRunning(taskCB);
+    return LOS_OK;
+}
+
+#ifdef LOSCFG_KERNEL_SMP
+/*
+ * The affinity of taskCB is about to become cpuAffiMask. A deadline task whose cpu is no longer
+ * allowed moves its bandwidth to an allowed cpu that can take it, if there is none the change
+ * is refused.
+ */
+UINT32 EDFTaskCpuAffiChange(LosTaskCB *taskCB, UINT16 cpuAffiMask)
+{
+    SchedEDF *sched = (SchedEDF *)&taskCB->sp;
+    BOOL isReady = FALSE;
+    UINT16 cpuid;
+
+    if ((sched->policy != LOS_SCHED_DEADLINE) || !(sched->flags & OS_SCHED_EDF_FLAG_ADMITTED) ||
+        (cpuAffiMask & CPUID_TO_AFFI_MASK(sched->cpuid))) {
+        return LOS_OK;
+    }
+
+    cpuid = EDFRunqueueAdmit(taskCB, cpuAffiMask, sched->bandwidth);
+    if (cpuid == OS_TASK_INVALID_CPUID) {
+        return LOS_EBUSY;
+    }
+
+    if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
+        EDFDequeue(OsSchedRunqueue(), taskCB);
+        isReady = TRUE;
+    }
+
+    OsSchedRunqueueByID(sched->cpuid)->edfRunqueue->bandwidth -= sched->bandwidth;
+    OsSchedRunqueueByID(cpuid)->edfRunqueue->bandwidth += sched->bandwidth;
+    sched->cpuid = cpuid;
+
+    /* a throttled or blocked task is queued on the new cpu when it wakes, a running one when it is switched out */
+    if (isReady) {
+        EDFEnqueue(OsSchedRunqueue(), taskCB);
+    }
+    return LOS_OK;
+}
+#endif
+
+VOID EDFSchedPolicyInit(SchedRunqueue *rq)
+{
+    EDFRunqueue *edfRunqueue = &g_schedEDF[rq - g_schedRunqueue];
+
+    LOS_ListInit(&edfRunqueue->root);
+    rq->edfRunqueue = edfRunqueue;
+}
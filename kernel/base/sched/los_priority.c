@@ -42,8 +42,9 @@
 #define OS_SCHED_TIME_SLICES_DIFF  (OS_SCHED_TIME_SLICES_MAX - OS_SCHED_TIME_SLICES_MIN)
 #define OS_SCHED_READY_MAX         30
 #define OS_TIME_SLICE_MIN          (INT32)((50 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 50us */
+#define OS_SCHED_CACHE_HOT_TIME    ((500 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 500us */
 
-STATIC HPFRunqueue g_schedHPF;
+STATIC HPFRunqueue g_schedHPF[LOSCFG_KERNEL_CORE_NUM];
 
 STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB);
 STATIC VOID HPFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB);
@@ -155,6 +156,7 @@ STATIC INLINE VOID PriQueHeadInsert(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIS
 
     LOS_ListHeadInsert(&priQueList[priority], priQue);
     queueList->readyTasks[priority]++;
+    rq->taskNum++;
 }
 
 STATIC INLINE VOID PriQueTailInsert(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIST *priQue, UINT32 priority)
@@ -180,6 +182,7 @@ STATIC INLINE VOID PriQueTailInsert(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIS
 
     LOS_ListTailInsert(&priQueList[priority], priQue);
     queueList->readyTasks[priority]++;
+    rq->taskNum++;
 }
 
 STATIC INLINE VOID PriQueDelete(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIST *priQue, UINT32 priority)
@@ -190,6 +193,7 @@ STATIC INLINE VOID PriQueDelete(HPFRunqueue *rq, UINT32 basePrio, LOS_DL_LIST *p
 
     LOS_ListDelete(priQue);
     queueList->readyTasks[priority]--;
+    rq->taskNum--;
     if (LOS_ListEmpty(&priQueList[priority])) {
         *bitmap &= ~(PRIQUEUE_PRIOR0_BIT >> priority);
     }
@@ -239,6 +243,18 @@ STATIC INLINE VOID PriQueInsert(HPFRunqueue *rq, LosTaskCB *taskCB)
     taskCB->taskStatus |= OS_TASK_STATUS_READY;
 }
 
+/* A ready task is queued on the runqueue of its lastCpu, whatever runqueue the caller passes in. */
+STATIC INLINE HPFRunqueue *HPFTaskRunqueue(SchedRunqueue *rq, const LosTaskCB *taskCB)
+{
+#ifdef LOSCFG_KERNEL_SMP
+    (VOID)rq;
+    return OsSchedRunqueueByID(taskCB->lastCpu)->hpfRunqueue;
+#else
+    (VOID)taskCB;
+    return rq->hpfRunqueue;
+#endif
+}
+
 STATIC VOID HPFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
 {
 #ifdef LOSCFG_SCHED_DEBUG
@@ -246,7 +262,15 @@ STATIC VOID HPFEnqueue(SchedRunqueue *rq, LosTaskCB *taskCB)
         taskCB->startTime = OsGetCurrSchedTimeCycle();
     }
 #endif
-    PriQueInsert(rq->hpfRunqueue, taskCB);
+#ifdef LOSCFG_KERNEL_SMP
+    /* The running task goes back to the queue of its own cpu, a task that became ready is placed */
+    UINT16 cpuid = ArchCurrCpuid();
+    if (!(taskCB->taskStatus & OS_TASK_STATUS_RUNNING) || !(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid))) {
+        cpuid = OsSchedRunqueueSelect(taskCB);
+    }
+    taskCB->lastCpu = cpuid;
+#endif
+    PriQueInsert(HPFTaskRunqueue(rq, taskCB), taskCB);
 }
 
 STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
@@ -254,7 +278,7 @@ STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
     SchedHPF *sched = (SchedHPF *)&taskCB->sp;
 
     if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
-        PriQueDelete(rq->hpfRunqueue, sched->basePrio, &taskCB->pendList, sched->priority);
+        PriQueDelete(HPFTaskRunqueue(rq, taskCB), sched->basePrio, &taskCB->pendList, sched->priority);
         taskCB->taskStatus &= ~OS_TASK_STATUS_READY;
     }
 }
@@ -262,6 +286,9 @@ STATIC VOID HPFDequeue(SchedRunqueue *rq, LosTaskCB *taskCB)
 STATIC VOID HPFStartToRun(SchedRunqueue *rq, LosTaskCB *taskCB)
 {
     HPFDequeue(rq, taskCB);
+#ifdef LOSCFG_KERNEL_SMP
+    taskCB->lastCpu = ArchCurrCpuid();
+#endif
 }
 
 STATIC VOID HPFExit(LosTaskCB *taskCB)
@@ -338,7 +365,48 @@ STATIC VOID HPFWake(LosTaskCB *resumedTask)
     }
 }
 
-STATIC BOOL BasePriorityModify(SchedRunqueue *rq, LosTaskCB *taskCB, UINT16 priority)
+/*
+ * Wake taskCB onto the current cpu ahead of its equal priority peers, so it runs here as soon as
+ * runTask blocks. taskCB takes over what is left of runTask's time slice and runTask keeps what
+ * taskCB had left, the pair does not get more cpu time than it had.
+ */
+VOID HPFTaskHandoff(SchedRunqueue *rq, LosTaskCB *runTask, LosTaskCB *taskCB)
+{
+    SchedHPF *sched = (SchedHPF *)&taskCB->sp;
+
+    LOS_ListDelete(&taskCB->pendList);
+    taskCB->taskStatus &= ~OS_TASK_STATUS_PENDING;
+
+    if (taskCB->taskStatus & OS_TASK_STATUS_PEND_TIME) {
+        OsSchedTimeoutQueueDelete(taskCB);
+        taskCB->taskStatus &= ~OS_TASK_STATUS_PEND_TIME;
+    }
+
+#ifdef LOSCFG_SCHED_DEBUG
+    taskCB->schedStat.pendTime += OsGetCurrSchedTimeCycle() - taskCB->startTime;
+    taskCB->schedStat.pendCount++;
+    taskCB->startTime = OsGetCurrSchedTimeCycle();
+#endif
+#ifdef LOSCFG_KERNEL_SMP
+    taskCB->lastCpu = ArchCurrCpuid();
+#endif
+    HPFTimeSliceUpdate(rq, runTask, OsGetCurrSchedTimeCycle());
+    if (runTask->timeSlice > taskCB->timeSlice) {
+        INT32 timeSlice = taskCB->timeSlice;
+        taskCB->timeSlice = runTask->timeSlice;
+        runTask->timeSlice = timeSlice;
+    }
+
+    if (taskCB->timeSlice > OS_TIME_SLICE_MIN) {
+        PriQueHeadInsert(HPFTaskRunqueue(rq, taskCB), sched->basePrio, &taskCB->pendList, sched->priority);
+        taskCB->taskStatus &= ~OS_TASK_STATUS_BLOCKED;
+        taskCB->taskStatus |= OS_TASK_STATUS_READY;
+    } else {
+        PriQueInsert(HPFTaskRunqueue(rq, taskCB), taskCB);
+    }
+}
+
+BOOL HPFBasePriorityModify(SchedRunqueue *rq, LosTaskCB *taskCB, UINT16 priority)
 {
     LosProcessCB *processCB = OS_PCB_FROM_PID(taskCB->processID);
     BOOL needSched = FALSE;
@@ -372,7 +440,7 @@ STATIC BOOL HPFSchedParamModify(LosTaskCB *taskCB, const SchedParam *param)
     }
 
     if (sched->basePrio != param->basePrio) {
-        needSched = BasePriorityModify(rq, taskCB, param->basePrio);
+        needSched = HPFBasePriorityModify(rq, taskCB, param->basePrio);
     }
 
     if (taskCB->taskStatus & OS_TASK_STATUS_READY) {
@@ -449,35 +517,50 @@ STATIC INT32 HPFParamCompare(const SchedPolicy *sp1, const SchedPolicy *sp2)
     return (param1->priority - param2->priority);
 }
 
+/* A deadline task waiting on the lock boosts the owner to the highest priority of its process */
+STATIC INLINE UINT16 HPFInheritPriorityGet(const SchedParam *param)
+{
+    if (param->policy == LOS_SCHED_DEADLINE) {
+        return OS_TASK_PRIORITY_HIGHEST;
+    }
+
+    if ((param->policy != LOS_SCHED_RR) && (param->policy != LOS_SCHED_FIFO)) {
+        return OS_PRIORITY_QUEUE_NUM; /* no inheritance */
+    }
+
+    return param->priority;
+}
+
 STATIC VOID HPFPriorityInheritance(LosTaskCB *owner, const SchedParam *param)
 {
     SchedHPF *sp = (SchedHPF *)&owner->sp;
+    UINT16 priority = HPFInheritPriorityGet(param);
 
-    if ((param->policy != LOS_SCHED_RR) && (param->policy != LOS_SCHED_FIFO)) {
+    if (priority > OS_TASK_PRIORITY_LOWEST) {
         return;
     }
 
-    if (sp->priority <= param->priority) {
+    if (sp->priority <= priority) {
         return;
     }
 
     LOS_BitmapSet(&sp->priBitmap, sp->priority);
-    sp->priority = param->priority;
+    sp->priority = priority;
 }
 
 STATIC VOID HPFPriorityRestore(LosTaskCB *owner, const LOS_DL_LIST *list, const SchedParam *param)
 {
-    UINT16 priority;
+    UINT16 priority = HPFInheritPriorityGet(param);
     LosTaskCB *pendedTask = NULL;
 
-    if ((param->policy != LOS_SCHED_RR) && (param->policy != LOS_SCHED_FIFO)) {
+    if (priority > OS_TASK_PRIORITY_LOWEST) {
         return;
     }
 
     SchedHPF *sp = (SchedHPF *)&owner->sp;
-    if (sp->priority < param->priority) {
-        if (LOS_HighBitGet(sp->priBitmap) != param->priority) {
-            LOS_BitmapClr(&sp->priBitmap, param->priority);
+    if (sp->priority < priority) {
+        if (LOS_HighBitGet(sp->priBitmap) != priority) {
+            LOS_BitmapClr(&sp->priBitmap, priority);
         }
         return;
     }
@@ -529,18 +612,86 @@ VOID HPFProcessDefaultSchedParamGet(SchedParam *param)
 
 VOID HPFSchedPolicyInit(SchedRunqueue *rq)
 {
-    if (ArchCurrCpuid() > 0) {
-        rq->hpfRunqueue = &g_schedHPF;
-        return;
-    }
+    HPFRunqueue *hpfRunqueue = &g_schedHPF[rq - g_schedRunqueue];
 
     for (UINT16 index = 0; index < OS_PRIORITY_QUEUE_NUM; index++) {
-        HPFQueue *queueList = &g_schedHPF.queueList[index];
+        HPFQueue *queueList = &hpfRunqueue->queueList[index];
         LOS_DL_LIST *priQue = &queueList->priQueList[0];
         for (UINT16 prio = 0; prio < OS_PRIORITY_QUEUE_NUM; prio++) {
             LOS_ListInit(&priQue[prio]);
         }
     }
 
-    rq->hpfRunqueue = &g_schedHPF;
+    rq->hpfRunqueue = hpfRunqueue;
+}
+
+#ifdef LOSCFG_KERNEL_SMP
+/*
+ * Called when the current cpu picks its next task: return the highest priority
+ * task queued on another cpu that may run here and beats topTask, the local
+ * candidate (NULL if the local queue has nothing to run). The caller starts the
+ * returned task, which dequeues it from the remote queue.
+ */
+LosTaskCB *HPFRunqueueTaskPull(SchedRunqueue *rq, LosTaskCB *topTask)
+{
+    LosTaskCB *pullTask = NULL;
+    LosTaskCB *bestTask = topTask;
+
+    for (UINT16 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        HPFRunqueue *srcRq = OsSchedRunqueueByID(cpuid)->hpfRunqueue;
+        if ((srcRq == rq->hpfRunqueue) || (srcRq->taskNum == 0)) {
+            continue;
+        }
+
+        /* Skip the queue without touching its task lists if its best base priority loses */
+        if ((bestTask != NULL) && (CLZ(srcRq->queueBitmap) > ((SchedHPF *)&bestTask->sp)->basePrio)) {
+            continue;
+        }
+
+        LosTaskCB *taskCB = HPFRunqueueTopTaskGet(srcRq);
+        if ((taskCB != NULL) && ((bestTask == NULL) || (OsSchedParamCompare(taskCB, bestTask) < 0))) {
+            bestTask = taskCB;
+            pullTask = taskCB;
+        }
+    }
+
+    return pullTask;
 }
+
+/*
+ * Periodic balance: move one task that is allowed on the current cpu and not
+ * cache hot from srcRq to rq, preferring the highest priority one.
+ */
+BOOL HPFRunqueueTaskMigrate(SchedRunqueue *rq, SchedRunqueue *srcRq, UINT64 currTime)
+{
+    HPFRunqueue *srcHpfRq = srcRq->hpfRunqueue;
+    UINT32 cpuid = ArchCurrCpuid();
+    UINT32 baseBitmap = srcHpfRq->queueBitmap;
+    LosTaskCB *taskCB = NULL;
+
+    while (baseBitmap) {
+        UINT32 basePrio = CLZ(baseBitmap);
+        HPFQueue *queueList = &srcHpfRq->queueList[basePrio];
+        UINT32 bitmap = queueList->queueBitmap;
+        while (bitmap) {
+            UINT32 priority = CLZ(bitmap);
+            LOS_DL_LIST_FOR_EACH_ENTRY(taskCB, &queueList->priQueList[priority], LosTaskCB, pendList) {
+                if (!(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid)) ||
+                    ((currTime - taskCB->startTime) < OS_SCHED_CACHE_HOT_TIME)) {
+                    continue;
+                }
+
+                PriQueDelete(srcHpfRq, basePrio, &taskCB->pendList, priority);
+                taskCB->taskStatus &= ~OS_TASK_STATUS_READY;
+                taskCB->lastCpu = cpuid;
+                PriQueInsert(rq->hpfRunqueue, taskCB);
+                return TRUE;
+            }
+            bitmap &= ~(1U << (OS_PRIORITY_QUEUE_NUM - priority - 1));
+        }
+        baseBitmap &= ~(1U << (OS_PRIORITY_QUEUE_NUM - basePrio - 1));
+    }
+
+    return FALSE;
+}
+#endif
@@ -36,6 +36,7 @@
 #include "los_process_pri.h"
 #include "los_arch_mmu.h"
 #include "los_hook.h"
+#include "los_rcu_pri.h"
 #ifdef LOSCFG_KERNEL_CPUP
 #include "los_cpup_pri.h"
 #endif
@@ -47,6 +48,9 @@
 #include "los_mp.h"
 
 SchedRunqueue g_schedRunqueue[LOSCFG_KERNEL_CORE_NUM];
+#ifdef LOSCFG_KERNEL_SMP
+STATIC Atomic g_schedPreemptTarget;
+#endif
 
 STATIC INLINE VOID SchedNextExpireTimeSet(UINT32 responseID, UINT64 taskEndTime, UINT32 oldResponseID)
 {
@@ -100,6 +104,190 @@ VOID OsSchedExpireTimeUpdate(VOID)
     SchedNextExpireTimeSet(runTask->taskID, deadline, runTask->taskID);
 }
 
+#ifdef LOSCFG_KERNEL_SMP
+STATIC INLINE UINT32 SchedRunqueueLoad(const SchedRunqueue *rq)
+{
+    UINT32 load = rq->hpfRunqueue->taskNum + rq->edfRunqueue->taskNum;
+    if ((rq->runTask != NULL) && (rq->runTask->taskID != rq->idleTaskID)) {
+        load++;
+    }
+    return load;
+}
+
+/* Between cpus running equal priority tasks prefer the current cpu (no ipi), the cache hot one, then a quiet one */
+STATIC INLINE BOOL SchedPreemptTargetPrefer(const LosTaskCB *taskCB, UINT16 cpuid, UINT16 target, UINT32 pending)
+{
+    UINT16 currCpuid = ArchCurrCpuid();
+    if ((target == currCpuid) || (cpuid == currCpuid)) {
+        return (cpuid == currCpuid);
+    }
+
+    if ((target == taskCB->lastCpu) || (cpuid == taskCB->lastCpu)) {
+        return (cpuid == taskCB->lastCpu);
+    }
+
+    return ((pending & CPUID_TO_AFFI_MASK(target)) && !(pending & CPUID_TO_AFFI_MASK(cpuid)));
+}
+
+/*
+ * Among the cpus taskCB may run on, pick the one whose running task is the
+ * least important and would be preempted by taskCB. Cpus running tasks of
+ * higher or equal priority do not need an ipi.
+ */
+STATIC UINT16 SchedPreemptTargetFind(const LosTaskCB *taskCB, UINT32 pending)
+{
+    LosTaskCB *targetTask = NULL;
+    UINT16 target = OS_TASK_INVALID_CPUID;
+
+    for (UINT16 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        UINT32 cpuMask = CPUID_TO_AFFI_MASK(cpuid);
+        if (!(taskCB->cpuAffiMask & cpuMask) || !(g_taskScheduled & cpuMask)) {
+            continue;
+        }
+
+        LosTaskCB *runTask = OsSchedRunqueueByID(cpuid)->runTask;
+        if (OsSchedParamCompare(taskCB, runTask) >= 0) {
+            continue;
+        }
+
+        if (targetTask != NULL) {
+            INT32 ret = OsSchedParamCompare(runTask, targetTask);
+            if (ret < 0) {
+                continue;
+            }
+            if ((ret == 0) && !SchedPreemptTargetPrefer(taskCB, cpuid, target, pending)) {
+                continue;
+            }
+        }
+        targetTask = runTask;
+        target = cpuid;
+    }
+
+    return target;
+}
+
+/* No cpu is preempted: stay on the last cpu while it is cache hot and not clearly busier */
+STATIC UINT16 SchedIdlestRunqueueFind(const LosTaskCB *taskCB)
+{
+    UINT16 target = OS_TASK_INVALID_CPUID;
+    UINT32 minLoad = OS_INVALID_VALUE;
+
+    for (UINT16 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        if (!(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(cpuid))) {
+            continue;
+        }
+
+        UINT32 load = SchedRunqueueLoad(OsSchedRunqueueByID(cpuid));
+        if (load < minLoad) {
+            minLoad = load;
+            target = cpuid;
+        }
+    }
+
+    UINT16 lastCpu = taskCB->lastCpu;
+    if ((lastCpu < LOSCFG_KERNEL_CORE_NUM) && (taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(lastCpu)) &&
+        (SchedRunqueueLoad(OsSchedRunqueueByID(lastCpu)) <= (minLoad + 1))) {
+        return lastCpu;
+    }
+
+    return (target == OS_TASK_INVALID_CPUID) ? ArchCurrCpuid() : target;
+}
+
+STATIC VOID SchedPreemptTargetSet(UINT16 target)
+{
+    UINT32 pending;
+
+    if (target == ArchCurrCpuid()) {
+        OsSchedRunqueuePendingSet();
+        return;
+    }
+
+    do {
+        pending = (UINT32)LOS_AtomicRead(&g_schedPreemptTarget);
+    } while (LOS_AtomicCmpXchg32bits(&g_schedPreemptTarget, (INT32)(pending | CPUID_TO_AFFI_MASK(target)),
+                                     (INT32)pending));
+}
+
+UINT16 OsSchedRunqueueSelect(const LosTaskCB *taskCB)
+{
+    UINT32 pending = (UINT32)LOS_AtomicRead(&g_schedPreemptTarget);
+    UINT16 target = SchedPreemptTargetFind(taskCB, pending);
+    if (target == OS_TASK_INVALID_CPUID) {
+        return SchedIdlestRunqueueFind(taskCB);
+    }
+
+    SchedPreemptTargetSet(target);
+    return target;
+}
+
+VOID OsSchedRunqueuePreemptCheck(const LosTaskCB *taskCB, UINT16 cpuid)
+{
+    LosTaskCB *runTask = OsSchedRunqueueByID(cpuid)->runTask;
+
+    if (!(g_taskScheduled & CPUID_TO_AFFI_MASK(cpuid)) || (runTask == NULL)) {
+        return;
+    }
+
+    if (OsSchedParamCompare(taskCB, runTask) < 0) {
+        SchedPreemptTargetSet(cpuid);
+    }
+}
+
+#define OS_SCHED_BALANCE_PERIOD    ((10000 * OS_SYS_NS_PER_US) / OS_NS_PER_CYCLE) /* 10ms */
+
+/*
+ * Called from the tick of every cpu: pull one task from the busiest runqueue
+ * if it holds at least two tasks more than this one.
+ */
+STATIC BOOL SchedRunqueueBalance(SchedRunqueue *rq, UINT64 currTime)
+{
+    SchedRunqueue *busiestRq = NULL;
+    BOOL migrated = FALSE;
+
+    if (currTime < rq->balanceTime) {
+        return FALSE;
+    }
+    rq->balanceTime = currTime + OS_SCHED_BALANCE_PERIOD;
+
+    LOS_SpinLock(&g_taskSpin);
+    UINT32 load = SchedRunqueueLoad(rq);
+    UINT32 maxLoad = load + 1;
+    for (UINT16 cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        SchedRunqueue *srcRq = OsSchedRunqueueByID(cpuid);
+        UINT32 srcLoad = SchedRunqueueLoad(srcRq);
+        if ((srcRq != rq) && (srcLoad > maxLoad) && (srcRq->hpfRunqueue->taskNum > 0)) {
+            maxLoad = srcLoad;
+            busiestRq = srcRq;
+        }
+    }
+
+    if (busiestRq != NULL) {
+        migrated = HPFRunqueueTaskMigrate(rq, busiestRq, currTime);
+    }
+    LOS_SpinUnlock(&g_taskSpin);
+
+    return migrated;
+}
+
+VOID OsSchedPreemptTargetNotify(VOID)
+{
+    UINT32 target = (UINT32)LOS_AtomicXchg32bits(&g_schedPreemptTarget, 0);
+#ifdef LOSCFG_SCHED_DEBUG
+    UINT32 intSave = LOS_IntLock();
+    SchedRunqueue *rq = OsSchedRunqueue();
+    if (target == 0) {
+        rq->stat.ipiSkipCount++;
+    } else {
+        rq->stat.ipiCount++;
+    }
+    LOS_IntRestore(intSave);
+#endif
+    if (target != 0) {
+        LOS_MpSchedule(target);
+    }
+}
+#endif
+
 STATIC INLINE VOID SchedTimeoutTaskWake(SchedRunqueue *rq, UINT64 currTime, LosTaskCB *taskCB, BOOL *needSched)
 {
 #ifndef LOSCFG_SCHED_DEBUG
@@ -134,7 +322,6 @@ STATIC INLINE BOOL SchedTimeoutQueueScan(SchedRunqueue *rq)
 {
     BOOL needSched = FALSE;
     SortLinkAttribute *timeoutQueue = &rq->timeoutQueue;
-    LOS_DL_LIST *listObject = &timeoutQueue->sortLink;
     /*
      * When task is pended with timeout, the task block is on the timeout sortlink
      * (per cpu) and ipc(mutex,sem and etc.)'s block at the same time, it can be waken
@@ -145,14 +332,14 @@ STATIC INLINE BOOL SchedTimeoutQueueScan(SchedRunqueue *rq)
      */
     LOS_SpinLock(&timeoutQueue->spinLock);
 
-    if (LOS_ListEmpty(listObject)) {
+    if (OsGetSortLinkNodeNum(timeoutQueue) == 0) {
         LOS_SpinUnlock(&timeoutQueue->spinLock);
         return needSched;
     }
 
-    SortLinkList *sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
     UINT64 currTime = OsGetCurrSchedTimeCycle();
-    while (sortList->responseTime <= currTime) {
+    SortLinkList *sortList = OsSortLinkExpiredNodeGet(timeoutQueue, currTime);
+    while (sortList != NULL) {
         LosTaskCB *taskCB = LOS_DL_LIST_ENTRY(sortList, LosTaskCB, sortList);
         OsDeleteNodeSortLink(timeoutQueue, &taskCB->sortList);
         LOS_SpinUnlock(&timeoutQueue->spinLock);
@@ -160,11 +347,7 @@ STATIC INLINE BOOL SchedTimeoutQueueScan(SchedRunqueue *rq)
         SchedTimeoutTaskWake(rq, currTime, taskCB, &needSched);
 
         LOS_SpinLock(&timeoutQueue->spinLock);
-        if (LOS_ListEmpty(listObject)) {
-            break;
-        }
-
-        sortList = LOS_DL_LIST_ENTRY(listObject->pstNext, SortLinkList, sortLinkNode);
+        sortList = OsSortLinkExpiredNodeGet(timeoutQueue, currTime);
     }
 
     LOS_SpinUnlock(&timeoutQueue->spinLock);
@@ -178,10 +361,15 @@ VOID OsSchedTick(VOID)
 
     if (rq->responseID == OS_INVALID_VALUE) {
         if (SchedTimeoutQueueScan(rq)) {
-            LOS_MpSchedule(OS_MP_CPU_ALL);
+            OsSchedPreemptTargetNotify();
             rq->schedFlag |= INT_PEND_RESCH;
         }
     }
+#ifdef LOSCFG_KERNEL_SMP
+    if (SchedRunqueueBalance(rq, OsGetCurrSchedTimeCycle())) {
+        rq->schedFlag |= INT_PEND_RESCH;
+    }
+#endif
     rq->schedFlag |= INT_PEND_TICK;
     rq->responseTime = OS_SCHED_MAX_RESPONSE_TIME;
 }
@@ -214,6 +402,7 @@ UINT32 OsSchedInit(VOID)
 {
     for (UINT16 cpuId = 0; cpuId < LOSCFG_KERNEL_CORE_NUM; cpuId++) {
         HPFSchedPolicyInit(OsSchedRunqueueByID(cpuId));
+        EDFSchedPolicyInit(OsSchedRunqueueByID(cpuId));
     }
 
 #ifdef LOSCFG_SCHED_TICK_DEBUG
@@ -244,6 +433,13 @@ INT32 OsSchedParamCompare(const LosTaskCB *task1, const LosTaskCB *task2)
     } else if (rp2->policy == LOS_SCHED_IDLE) {
         return -1;
     }
+
+    /* Deadline tasks run before any FIFO/RR task */
+    if (rp1->policy == LOS_SCHED_DEADLINE) {
+        return -1;
+    } else if (rp2->policy == LOS_SCHED_DEADLINE) {
+        return 1;
+    }
     return 0;
 }
 
@@ -254,6 +450,10 @@ UINT32 OsSchedParamInit(LosTaskCB *taskCB, UINT16 policy, const SchedParam *pare
         case LOS_SCHED_RR:
             HPFTaskSchedParamInit(taskCB, policy, parentParam, param);
             break;
+        case LOS_SCHED_DEADLINE:
+            /* Reservations are not inherited, the new task starts as RR */
+            HPFTaskSchedParamInit(taskCB, LOS_SCHED_RR, parentParam, param);
+            break;
         case LOS_SCHED_IDLE:
             IdleTaskSchedParamInit(taskCB);
             break;
@@ -264,11 +464,44 @@ UINT32 OsSchedParamInit(LosTaskCB *taskCB, UINT16 policy, const SchedParam *pare
     return LOS_OK;
 }
 
+UINT32 OsSchedParamSet(LosTaskCB *taskCB, const SchedParam *param, BOOL *needSched)
+{
+    if (param->policy == LOS_SCHED_DEADLINE) {
+        return EDFTaskSchedParamSet(taskCB, param, needSched);
+    }
+
+    *needSched = taskCB->ops->schedParamModify(taskCB, param);
+    return LOS_OK;
+}
+
+STATIC INLINE BOOL SchedPolicyIsHPF(const LosTaskCB *taskCB)
+{
+    UINT16 policy = ((SchedHPF *)&taskCB->sp)->policy;
+    return (policy == LOS_SCHED_RR) || (policy == LOS_SCHED_FIFO);
+}
+
+VOID OsSchedHandoffWake(LosTaskCB *taskCB)
+{
+    LosTaskCB *runTask = OsCurrTaskGet();
+
+    if ((taskCB->taskStatus & OS_TASK_STATUS_SUSPENDED) || !SchedPolicyIsHPF(taskCB) ||
+#ifdef LOSCFG_KERNEL_SMP
+        !(taskCB->cpuAffiMask & CPUID_TO_AFFI_MASK(ArchCurrCpuid())) ||
+#endif
+        !SchedPolicyIsHPF(runTask)) {
+        taskCB->ops->wake(taskCB);
+        return;
+    }
+
+    HPFTaskHandoff(OsSchedRunqueue(), runTask, taskCB);
+}
+
 VOID OsSchedProcessDefaultSchedParamGet(UINT16 policy, SchedParam *param)
 {
     switch (policy) {
         case LOS_SCHED_FIFO:
         case LOS_SCHED_RR:
+        case LOS_SCHED_DEADLINE:
             HPFProcessDefaultSchedParamGet(param);
             break;
         case LOS_SCHED_IDLE:
@@ -281,7 +514,20 @@ VOID OsSchedProcessDefaultSchedParamGet(UINT16 policy, SchedParam *param)
 
 STATIC LosTaskCB *TopTaskGet(SchedRunqueue *rq)
 {
-    LosTaskCB *newTask = HPFRunqueueTopTaskGet(rq->hpfRunqueue);
+    LosTaskCB *newTask = EDFRunqueueTopTaskGet(rq->edfRunqueue);
+    if (newTask != NULL) {
+        newTask->ops->start(rq, newTask);
+        return newTask;
+    }
+
+    newTask = HPFRunqueueTopTaskGet(rq->hpfRunqueue);
+#ifdef LOSCFG_KERNEL_SMP
+    /* steal when idle, or when another cpu has a more important task queued */
+    LosTaskCB *pullTask = HPFRunqueueTaskPull(rq, newTask);
+    if (pullTask != NULL) {
+        newTask = pullTask;
+    }
+#endif
 
     if (newTask == NULL) {
         newTask = OS_TCB_FROM_TID(rq->idleTaskID);
@@ -312,6 +558,7 @@ VOID OsSchedStart(VOID)
      * may fail because this flag mismatch with the real current cpu.
      */
     newTask->currCpu = cpuid;
+    rq->runTask = newTask;
 #endif
 
     OsCurrTaskSet((VOID *)newTask);
@@ -369,11 +616,13 @@ STATIC VOID SchedTaskSwitch(SchedRunqueue *rq, LosTaskCB *runTask, LosTaskCB *ne
 
     runTask->taskStatus &= ~OS_TASK_STATUS_RUNNING;
     newTask->taskStatus |= OS_TASK_STATUS_RUNNING;
+    OsRcuQuiescentState();
 
 #ifdef LOSCFG_KERNEL_SMP
     /* mask new running task's owner processor */
     runTask->currCpu = OS_TASK_INVALID_CPUID;
     newTask->currCpu = ArchCurrCpuid();
+    rq->runTask = newTask;
 #endif
 
     OsCurrTaskSet((VOID *)newTask);
@@ -422,6 +671,7 @@ VOID OsSchedIrqEndCheckNeedSched(VOID)
     SchedRunqueue *rq = OsSchedRunqueue();
     LosTaskCB *runTask = OsCurrTaskGet();
 
+    OsRcuIrqEnd();
     runTask->ops->timeSliceUpdate(rq, runTask, OsGetCurrSchedTimeCycle());
 
     if (OsPreemptable() && (rq->schedFlag & INT_PEND_RESCH)) {
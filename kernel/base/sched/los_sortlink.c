@@ -31,45 +31,182 @@
 
 #include "los_sortlink_pri.h"
 
+#define OS_SORT_LINK_LEVEL_SHIFT(level) ((level) * OS_SORT_LINK_WHEEL_SLOT_BITS)
+#define OS_SORT_LINK_WHEEL_SHIFT        OS_SORT_LINK_LEVEL_SHIFT(OS_SORT_LINK_WHEEL_LEVELS)
+#define OS_SORT_LINK_TIME_TO_CLOCK(time) ((time) >> OS_SORT_LINK_GRANULE_SHIFT)
+#define OS_SORT_LINK_CLOCK_TO_TIME(clock) ((clock) << OS_SORT_LINK_GRANULE_SHIFT)
+
 VOID OsSortLinkInit(SortLinkAttribute *sortLinkHeader)
 {
-    LOS_ListInit(&sortLinkHeader->sortLink);
+    for (UINT32 index = 0; index <= OS_SORT_LINK_OVERFLOW_BUCKET; index++) {
+        LOS_ListInit(&sortLinkHeader->wheel[index]);
+    }
+    (VOID)memset_s(sortLinkHeader->bitmap, sizeof(sortLinkHeader->bitmap), 0, sizeof(sortLinkHeader->bitmap));
     LOS_SpinInit(&sortLinkHeader->spinLock);
+    sortLinkHeader->clock = 0;
     sortLinkHeader->nodeNum = 0;
 }
 
-STATIC INLINE VOID AddNode2SortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
+/*
+ * A node is placed on the lowest level at which its expire clock and the wheel clock share all the higher digits,
+ * so that it is cascaded exactly when the wheel clock enters its slot.
+ */
+STATIC INLINE UINT16 SortLinkBucketGet(const SortLinkAttribute *sortLinkHeader, UINT64 responseTime)
 {
-    LOS_DL_LIST *head = (LOS_DL_LIST *)&sortLinkHeader->sortLink;
+    UINT64 clock = sortLinkHeader->clock;
+    UINT64 expires = OS_SORT_LINK_TIME_TO_CLOCK(responseTime);
 
-    if (LOS_ListEmpty(head)) {
-        LOS_ListHeadInsert(head, &sortList->sortLinkNode);
-        sortLinkHeader->nodeNum++;
-        return;
+    if (expires < clock) {
+        expires = clock;
     }
 
-    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(head->pstNext, SortLinkList, sortLinkNode);
-    if (listSorted->responseTime > sortList->responseTime) {
-        LOS_ListAdd(head, &sortList->sortLinkNode);
-        sortLinkHeader->nodeNum++;
-        return;
-    } else if (listSorted->responseTime == sortList->responseTime) {
-        LOS_ListAdd(head->pstNext, &sortList->sortLinkNode);
-        sortLinkHeader->nodeNum++;
+    for (UINT32 level = 0; level < OS_SORT_LINK_WHEEL_LEVELS; level++) {
+        UINT32 shift = OS_SORT_LINK_LEVEL_SHIFT(level + 1);
+        if ((expires >> shift) == (clock >> shift)) {
+            UINT32 slot = (UINT32)(expires >> OS_SORT_LINK_LEVEL_SHIFT(level)) & OS_SORT_LINK_WHEEL_SLOT_MASK;
+            return (UINT16)((level << OS_SORT_LINK_WHEEL_SLOT_BITS) + slot);
+        }
+    }
+
+    return OS_SORT_LINK_OVERFLOW_BUCKET;
+}
+
+STATIC INLINE VOID AddNode2SortLink(SortLinkAttribute *sortLinkHeader, SortLinkList *sortList)
+{
+    UINT16 bucket = SortLinkBucketGet(sortLinkHeader, sortList->responseTime);
+    LOS_DL_LIST *head = &sortLinkHeader->wheel[bucket];
+
+    sortList->bucket = bucket;
+    if (bucket >= OS_SORT_LINK_WHEEL_SLOTS) {
+        /* Only level 0 slots are kept in order, the others are sorted when they are cascaded down */
+        LOS_ListTailInsert(head, &sortList->sortLinkNode);
+        if (bucket != OS_SORT_LINK_OVERFLOW_BUCKET) {
+            sortLinkHeader->bitmap[bucket >> OS_SORT_LINK_WHEEL_SLOT_BITS] |=
+                1U << (bucket & OS_SORT_LINK_WHEEL_SLOT_MASK);
+        }
         return;
     }
 
+    /* A level 0 slot only holds the nodes of one granule, so the walk is short */
     LOS_DL_LIST *prevNode = head->pstPrev;
-    do {
-        listSorted = LOS_DL_LIST_ENTRY(prevNode, SortLinkList, sortLinkNode);
+    while (prevNode != head) {
+        SortLinkList *listSorted = LOS_DL_LIST_ENTRY(prevNode, SortLinkList, sortLinkNode);
         if (listSorted->responseTime <= sortList->responseTime) {
-            LOS_ListAdd(prevNode, &sortList->sortLinkNode);
-            sortLinkHeader->nodeNum++;
             break;
         }
-
         prevNode = prevNode->pstPrev;
-    } while (1);
+    }
+    LOS_ListAdd(prevNode, &sortList->sortLinkNode);
+    sortLinkHeader->bitmap[0] |= 1U << bucket;
+}
+
+/*
+ * Find the first bucket the wheel clock will reach. Lower levels always come first, as every slot of a higher
+ * level starts after the current slot of the level below it.
+ */
+STATIC INLINE UINT16 SortLinkNextBucketGet(const SortLinkAttribute *sortLinkHeader, UINT64 *bucketClock)
+{
+    UINT64 clock = sortLinkHeader->clock;
+
+    for (UINT32 level = 0; level < OS_SORT_LINK_WHEEL_LEVELS; level++) {
+        UINT32 bitmap = sortLinkHeader->bitmap[level];
+        if (bitmap == 0) {
+            continue;
+        }
+
+        UINT32 slot = CTZ(bitmap);
+        UINT32 shift = OS_SORT_LINK_LEVEL_SHIFT(level + 1);
+        *bucketClock = ((clock >> shift) << shift) | ((UINT64)slot << OS_SORT_LINK_LEVEL_SHIFT(level));
+        return (UINT16)((level << OS_SORT_LINK_WHEEL_SLOT_BITS) + slot);
+    }
+
+    if (!LOS_ListEmpty((LOS_DL_LIST *)&sortLinkHeader->wheel[OS_SORT_LINK_OVERFLOW_BUCKET])) {
+        *bucketClock = ((clock >> OS_SORT_LINK_WHEEL_SHIFT) + 1) << OS_SORT_LINK_WHEEL_SHIFT;
+        return OS_SORT_LINK_OVERFLOW_BUCKET;
+    }
+
+    return OS_SORT_LINK_INVALID_BUCKET;
+}
+
+STATIC VOID SortLinkBucketCascade(SortLinkAttribute *sortLinkHeader, UINT16 bucket)
+{
+    LOS_DL_LIST *head = &sortLinkHeader->wheel[bucket];
+    LOS_DL_LIST cascadeList;
+
+    if (bucket != OS_SORT_LINK_OVERFLOW_BUCKET) {
+        sortLinkHeader->bitmap[bucket >> OS_SORT_LINK_WHEEL_SLOT_BITS] &=
+            ~(1U << (bucket & OS_SORT_LINK_WHEEL_SLOT_MASK));
+    }
+
+    LOS_ListInit(&cascadeList);
+    LOS_ListTailInsertList(&cascadeList, head);
+    LOS_ListDelete(head);
+    LOS_ListInit(head);
+
+    while (!LOS_ListEmpty(&cascadeList)) {
+        SortLinkList *sortList = LOS_DL_LIST_ENTRY(cascadeList.pstNext, SortLinkList, sortLinkNode);
+        LOS_ListDelete(&sortList->sortLinkNode);
+        AddNode2SortLink(sortLinkHeader, sortList);
+    }
+}
+
+/*
+ * Move the wheel clock forward to targetClock, cascading every bucket passed on the way. The clock never moves
+ * past a non-empty level 0 slot, those nodes have to be expired by the caller first.
+ */
+STATIC VOID SortLinkWheelAdvance(SortLinkAttribute *sortLinkHeader, UINT64 targetClock)
+{
+    UINT64 bucketClock = 0;
+
+    while (sortLinkHeader->clock < targetClock) {
+        UINT16 bucket = SortLinkNextBucketGet(sortLinkHeader, &bucketClock);
+        if ((bucket == OS_SORT_LINK_INVALID_BUCKET) || (bucketClock > targetClock)) {
+            sortLinkHeader->clock = targetClock;
+            return;
+        }
+
+        sortLinkHeader->clock = bucketClock;
+        if (bucket < OS_SORT_LINK_WHEEL_SLOTS) {
+            return;
+        }
+
+        SortLinkBucketCascade(sortLinkHeader, bucket);
+    }
+}
+
+UINT64 OsSortLinkNextResponseTime(SortLinkAttribute *sortLinkHeader, UINT64 currTime)
+{
+    UINT64 bucketClock = 0;
+
+    SortLinkWheelAdvance(sortLinkHeader, OS_SORT_LINK_TIME_TO_CLOCK(currTime));
+    UINT16 bucket = SortLinkNextBucketGet(sortLinkHeader, &bucketClock);
+    if (bucket == OS_SORT_LINK_INVALID_BUCKET) {
+        return OS_SORT_LINK_INVALID_TIME;
+    }
+
+    if (bucket < OS_SORT_LINK_WHEEL_SLOTS) {
+        SortLinkList *listSorted = LOS_DL_LIST_ENTRY(sortLinkHeader->wheel[bucket].pstNext, SortLinkList, sortLinkNode);
+        return listSorted->responseTime;
+    }
+
+    return OS_SORT_LINK_CLOCK_TO_TIME(bucketClock);
+}
+
+SortLinkList *OsSortLinkExpiredNodeGet(SortLinkAttribute *sortLinkHeader, UINT64 currTime)
+{
+    SortLinkWheelAdvance(sortLinkHeader, OS_SORT_LINK_TIME_TO_CLOCK(currTime));
+
+    LOS_DL_LIST *head = &sortLinkHeader->wheel[sortLinkHeader->clock & OS_SORT_LINK_WHEEL_SLOT_MASK];
+    if (LOS_ListEmpty(head)) {
+        return NULL;
+    }
+
+    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(head->pstNext, SortLinkList, sortLinkNode);
+    if (listSorted->responseTime > currTime) {
+        return NULL;
+    }
+
+    return listSorted;
 }
 
 VOID OsAdd2SortLink(SortLinkAttribute *head, SortLinkList *node, UINT64 responseTime, UINT16 idleCpu)
@@ -77,6 +214,7 @@ VOID OsAdd2SortLink(SortLinkAttribute *head, SortLinkList *node, UINT64 response
     LOS_SpinLock(&head->spinLock);
     SET_SORTLIST_VALUE(node, responseTime);
     AddNode2SortLink(head, node);
+    head->nodeNum++;
 #ifdef LOSCFG_KERNEL_SMP
     node->cpuid = idleCpu;
 #endif
@@ -101,12 +239,53 @@ UINT32 OsSortLinkAdjustNodeResponseTime(SortLinkAttribute *head, SortLinkList *n
         OsDeleteNodeSortLink(head, node);
         SET_SORTLIST_VALUE(node, responseTime);
         AddNode2SortLink(head, node);
+        head->nodeNum++;
         ret = LOS_OK;
     }
     LOS_SpinUnlock(&head->spinLock);
     return ret;
 }
 
+/*
+ * Take every node off the wheel and chain it on list, the nodes are marked as deleted.
+ * Must be called with the sort link spinlock held.
+ */
+UINT32 OsSortLinkNodesDetach(SortLinkAttribute *head, LOS_DL_LIST *list)
+{
+    UINT32 nodeNum = head->nodeNum;
+
+    for (UINT32 index = 0; index <= OS_SORT_LINK_OVERFLOW_BUCKET; index++) {
+        LOS_DL_LIST *bucket = &head->wheel[index];
+        while (!LOS_ListEmpty(bucket)) {
+            SortLinkList *sortList = LOS_DL_LIST_ENTRY(bucket->pstNext, SortLinkList, sortLinkNode);
+            OsDeleteNodeSortLink(head, sortList);
+            LOS_ListTailInsert(list, &sortList->sortLinkNode);
+        }
+    }
+
+    return nodeNum;
+}
+
+/*
+ * Must be called with the sort link spinlock held.
+ */
+BOOL OsSortLinkFind(SortLinkAttribute *head, BOOL (*checkFunc)(UINTPTR, UINTPTR), UINTPTR arg)
+{
+    for (UINT32 index = 0; index <= OS_SORT_LINK_OVERFLOW_BUCKET; index++) {
+        LOS_DL_LIST *bucket = &head->wheel[index];
+        LOS_DL_LIST *list = bucket->pstNext;
+        while (list != bucket) {
+            SortLinkList *listSorted = LOS_DL_LIST_ENTRY(list, SortLinkList, sortLinkNode);
+            if (checkFunc((UINTPTR)listSorted, arg)) {
+                return TRUE;
+            }
+            list = list->pstNext;
+        }
+    }
+
+    return FALSE;
+}
+
 UINT64 OsSortLinkGetTargetExpireTime(UINT64 currTime, const SortLinkList *targetSortList)
 {
     if (currTime >= targetSortList->responseTime) {
@@ -116,15 +295,20 @@ UINT64 OsSortLinkGetTargetExpireTime(UINT64 currTime, const SortLinkList *target
     return (UINT32)(targetSortList->responseTime - currTime);
 }
 
-UINT64 OsSortLinkGetNextExpireTime(UINT64 currTime, const SortLinkAttribute *sortLinkHeader)
+UINT64 OsSortLinkGetNextExpireTime(UINT64 currTime, SortLinkAttribute *sortLinkHeader)
 {
-    LOS_DL_LIST *head = (LOS_DL_LIST *)&sortLinkHeader->sortLink;
+    UINT32 intSave;
 
-    if (LOS_ListEmpty(head)) {
+    LOS_SpinLockSave(&sortLinkHeader->spinLock, &intSave);
+    UINT64 responseTime = OsSortLinkNextResponseTime(sortLinkHeader, currTime);
+    LOS_SpinUnlockRestore(&sortLinkHeader->spinLock, intSave);
+    if (responseTime == OS_SORT_LINK_INVALID_TIME) {
         return OS_SORT_LINK_INVALID_TIME;
     }
 
-    SortLinkList *listSorted = LOS_DL_LIST_ENTRY(head->pstNext, SortLinkList, sortLinkNode);
-    return OsSortLinkGetTargetExpireTime(currTime, listSorted);
-}
+    if (currTime >= responseTime) {
+        return 0;
+    }
 
+    return (UINT32)(responseTime - currTime);
+}
@@ -99,6 +99,37 @@ UINT32 OsShellShowTickResponse(VOID)
 }
 #endif
 
+#ifdef LOSCFG_KERNEL_SMP
+STATIC VOID SchedLockStatShow(VOID)
+{
+    SchedRunqueueStat stat[LOSCFG_KERNEL_CORE_NUM];
+    UINT32 intSave;
+
+    SCHEDULER_LOCK(intSave);
+    for (UINT16 cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        stat[cpu] = OsSchedRunqueueByID(cpu)->stat;
+    }
+    SCHEDULER_UNLOCK(intSave);
+
+    PRINTK("cpu      IpiSent  IpiSkipped\n");
+    for (UINT16 cpu = 0; cpu < LOSCFG_KERNEL_CORE_NUM; cpu++) {
+        PRINTK("%3u%13llu%12llu\n", cpu, stat[cpu].ipiCount, stat[cpu].ipiSkipCount);
+    }
+
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+    SpinLockStat lockStat;
+    UINT64 averSpin = 0;
+
+    LOS_SpinStatGet(&g_taskSpin, &lockStat, FALSE);
+    if (lockStat.contendCount > 0) {
+        averSpin = (lockStat.spinTime / lockStat.contendCount) * OS_NS_PER_CYCLE;
+    }
+    PRINTK("scheduler lock: LockCount %u Contended %u AverSpin(ns) %llu HoldMax(ns) %llu\n",
+           lockStat.lockCount, lockStat.contendCount, averSpin, lockStat.maxHoldTime * OS_NS_PER_CYCLE);
+#endif
+}
+#endif
+
 STATIC VOID SchedDataGet(const LosTaskCB *taskCB, UINT64 *runTime, UINT64 *timeSlice,
                          UINT64 *pendTime, UINT64 *schedWait)
 {
@@ -123,6 +154,37 @@ STATIC VOID SchedDataGet(const LosTaskCB *taskCB, UINT64 *runTime, UINT64 *timeS
     }
 }
 
+STATIC VOID SchedDeadlineStatShow(VOID)
+{
+    BOOL titlePrinted = FALSE;
+    UINT32 intSave;
+    LosTaskCB task;
+
+    for (UINT32 tid = 0; tid < g_taskMaxNum; tid++) {
+        LosTaskCB *taskCB = g_taskCBArray + tid;
+        SCHEDULER_LOCK(intSave);
+        if (OsTaskIsUnused(taskCB) || (((SchedEDF *)&taskCB->sp)->policy != LOS_SCHED_DEADLINE)) {
+            SCHEDULER_UNLOCK(intSave);
+            continue;
+        }
+
+        (VOID)memcpy_s(&task, sizeof(LosTaskCB), taskCB, sizeof(LosTaskCB));
+        SCHEDULER_UNLOCK(intSave);
+
+        if (!titlePrinted) {
+            PRINTK("  Tid   Runtime(us)  Deadline(us)    Period(us)   Cpu  ThrottleCount  DeadlineMiss  TaskName \n");
+            titlePrinted = TRUE;
+        }
+
+        SchedEDF *sched = (SchedEDF *)&task.sp;
+        PRINTK("%5u%14llu%14llu%14llu%6u%15llu%14llu  %-32s\n", task.taskID,
+               OsSchedCycleToNs(sched->runTime) / OS_SYS_NS_PER_US,
+               OsSchedCycleToNs(sched->deadline) / OS_SYS_NS_PER_US,
+               OsSchedCycleToNs(sched->period) / OS_SYS_NS_PER_US, sched->cpuid,
+               task.schedStat.throttleCount, task.schedStat.deadlineMissCount, task.taskName);
+    }
+}
+
 UINT32 OsShellShowSchedStatistics(VOID)
 {
     UINT32 taskLinkNum[LOSCFG_KERNEL_CORE_NUM];
@@ -140,6 +202,10 @@ UINT32 OsShellShowSchedStatistics(VOID)
         PRINTK("cpu: %u Task SortMax: %u\n", cpu, taskLinkNum[cpu]);
     }
 
+#ifdef LOSCFG_KERNEL_SMP
+    SchedLockStatShow();
+#endif
+
     PRINTK("  Tid    AverRunTime(us)    SwitchCount  AverTimeSlice(us)    TimeSliceCount  AverReadyWait(us)  "
            "AverPendTime(us)  TaskName \n");
     for (UINT32 tid = 0; tid < g_taskMaxNum; tid++) {
@@ -166,6 +232,7 @@ UINT32 OsShellShowSchedStatistics(VOID)
                averSchedWait, averPendTime, taskCB->taskName);
     }
 
+    SchedDeadlineStatShow();
     return LOS_OK;
 }
 #endif
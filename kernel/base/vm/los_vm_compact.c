@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_compact.h"
+#include "los_vm_map.h"
+#include "los_vm_common.h"
+#include "los_sched_pri.h"
+#ifdef LOSCFG_FS_VFS
+#include "los_vm_filemap.h"
+#endif
+
+#ifdef LOSCFG_KERNEL_VM
+
+STATIC Atomic g_vmCompactRunning = 0;
+STATIC LosVmCompactStat g_vmCompactStat;
+
+VOID OsVmCompactStatGet(LosVmCompactStat *stat)
+{
+    *stat = g_vmCompactStat;
+}
+
+INT32 OsVmFragIndexGet(struct VmPhysSeg *seg, UINT32 order)
+{
+    UINT32 intSave;
+    UINT32 index;
+    UINT32 cnt;
+    UINT32 freePages = 0;
+    UINT32 freeChunks = 0;
+    UINT32 suitable = 0;
+
+    if (order >= VM_LIST_ORDER_MAX) {
+        return 0;
+    }
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    for (index = 0; index < VM_LIST_ORDER_MAX; index++) {
+        cnt = OsVmPhysFreeCntGet(seg, index);
+        freeChunks += cnt;
+        freePages += cnt << index;
+        if (index >= order) {
+            suitable += cnt;
+        }
+    }
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+
+    if (freeChunks == 0) {
+        return 0;
+    }
+    if (suitable != 0) {
+        return VM_FRAG_INDEX_SUITABLE;
+    }
+
+    /* close to 1000: the allocation fails for fragmentation, close to 0: for lack of memory */
+    return (INT32)(1000 - ((1000 + ((freePages * 1000) >> order)) / freeChunks)); /* 1000: index scale */
+}
+
+#ifdef LOSCFG_FS_VFS
+/* caller holds the lru lock and the mapping list lock, same as the shrinker */
+STATIC STATUS_T OsVmMigrateFilePage(struct VmPhysSeg *seg, LosFilePage *fpage)
+{
+    LosVmPage *oldPage = fpage->vmPage;
+    LosVmPage *newPage = NULL;
+    LosMapInfo *info = NULL;
+    LosMapInfo *next = NULL;
+    UINT32 flags = 0;
+
+    /* a locked page is being filled or faulted in, its data and mappings are not settled yet */
+    if (!OsVmPageIsMovable(oldPage) || OsIsPageLocked(oldPage) || OsIsPageDirty(oldPage)) {
+        return LOS_NOK;
+    }
+
+    /* the cache holds no reference of its own, any beyond the mappings is a user we cannot redirect */
+    if (LOS_AtomicRead(&oldPage->refCounts) != (INT32)fpage->n_maps) {
+        return LOS_NOK;
+    }
+
+    /* a writable mapping could change the page behind our back */
+    LOS_DL_LIST_FOR_EACH_ENTRY(info, &fpage->i_mmap, LosMapInfo, node) {
+        if ((LOS_ArchMmuQuery(info->archMmu, info->vaddr, NULL, &flags) != LOS_OK) ||
+            (flags & VM_MAP_REGION_FLAG_PERM_WRITE)) {
+            return LOS_NOK;
+        }
+    }
+
+    newPage = OsVmPhysMigratePageGet(seg);
+    if (newPage == NULL) {
+        return LOS_ERRNO_VM_NO_MEMORY;
+    }
+
+    (VOID)memcpy_s(OsVmPageToVaddr(newPage), PAGE_SIZE, OsVmPageToVaddr(oldPage), PAGE_SIZE);
+    newPage->flags = oldPage->flags;
+    LOS_AtomicSet(&newPage->refCounts, LOS_AtomicRead(&oldPage->refCounts));
+    fpage->vmPage = newPage;
+
+    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(info, next, &fpage->i_mmap, LosMapInfo, node) {
+        (VOID)LOS_ArchMmuQuery(info->archMmu, info->vaddr, NULL, &flags);
+        (VOID)LOS_ArchMmuUnmap(info->archMmu, info->vaddr, 1);
+        if (LOS_ArchMmuMap(info->archMmu, info->vaddr, VM_PAGE_TO_PHYS(newPage), 1, flags) < 0) {
+            /* let the next access fault the page in again */
+            OsUnmapPageLocked(fpage, info);
+        }
+    }
+
+    oldPage->flags = 0;
+    LOS_AtomicSet(&oldPage->refCounts, 1);
+    LOS_PhysPageFree(oldPage);
+    return LOS_OK;
+}
+
+STATIC VOID OsVmCompactFilePages(struct VmPhysSeg *seg, PADDR_T start, PADDR_T end)
+{
+    UINT32 intSave;
+    UINT32 lruType;
+    PADDR_T paddr;
+    SPIN_LOCK_S *flock = NULL;
+    LosFilePage *fpage = NULL;
+
+    LOS_SpinLockSave(&seg->lruLock, &intSave);
+    for (lruType = VM_LRU_INACTIVE_FILE; lruType <= VM_LRU_ACTIVE_FILE; lruType++) {
+        LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &seg->lruList[lruType], LosFilePage, lru) {
+            paddr = VM_PAGE_TO_PHYS(fpage->vmPage);
+            if ((paddr < start) || (paddr >= end)) {
+                continue;
+            }
+
+            flock = &fpage->mapping->list_lock;
+            if (LOS_SpinTrylock(flock) != LOS_OK) {
+                g_vmCompactStat.failCount++;
+                continue;
+            }
+            if (OsVmMigrateFilePage(seg, fpage) == LOS_OK) {
+                g_vmCompactStat.migrateCount++;
+            } else {
+                g_vmCompactStat.failCount++;
+            }
+            LOS_SpinUnlock(flock);
+        }
+    }
+    LOS_SpinUnlockRestore(&seg->lruLock, intSave);
+}
+#endif
+
+/* caller holds the region mutex of space, faults on vaddr wait until the new page is mapped */
+STATIC STATUS_T OsVmMigrateAnonPage(struct VmPhysSeg *seg, LosVmSpace *space, VADDR_T vaddr,
+                                    LosVmPage *oldPage, UINT32 flags)
+{
+    LosVmPage *newPage = NULL;
+
+    if (!OsVmPageIsMovable(oldPage) || (LOS_AtomicRead(&oldPage->refCounts) != 1)) {
+        return LOS_NOK;
+    }
+
+    newPage = OsVmPhysMigratePageGet(seg);
+    if (newPage == NULL) {
+        return LOS_ERRNO_VM_NO_MEMORY;
+    }
+
+    (VOID)LOS_ArchMmuUnmap(&space->archMmu, vaddr, 1);
+    (VOID)memcpy_s(OsVmPageToVaddr(newPage), PAGE_SIZE, OsVmPageToVaddr(oldPage), PAGE_SIZE);
+    if (LOS_ArchMmuMap(&space->archMmu, vaddr, VM_PAGE_TO_PHYS(newPage), 1, flags) < 0) {
+        (VOID)LOS_ArchMmuMap(&space->archMmu, vaddr, VM_PAGE_TO_PHYS(oldPage), 1, flags);
+        LOS_PhysPageFree(newPage);
+        return LOS_NOK;
+    }
+
+    LOS_AtomicSet(&newPage->refCounts, 1);
+    LOS_PhysPageFree(oldPage);
+    return LOS_OK;
+}
+
+STATIC VOID OsVmCompactAnonRegion(struct VmPhysSeg *seg, LosVmSpace *space, LosVmMapRegion *region,
+                                  PADDR_T start, PADDR_T end)
+{
+    VADDR_T vaddr;
+    PADDR_T paddr;
+    UINT32 flags;
+    LosVmPage *page = NULL;
+
+    for (vaddr = region->range.base; vaddr < (region->range.base + region->range.size); vaddr += PAGE_SIZE) {
+        if ((LOS_ArchMmuQuery(&space->archMmu, vaddr, &paddr, &flags) != LOS_OK) ||
+            (paddr < start) || (paddr >= end)) {
+            continue;
+        }
+
+        page = OsVmPhysToPage(paddr, (UINT8)(seg - OsGVmPhysSegGet()));
+        if (page == NULL) {
+            continue;
+        }
+        if (OsVmMigrateAnonPage(seg, space, vaddr, page, flags) == LOS_OK) {
+            g_vmCompactStat.migrateCount++;
+        } else {
+            g_vmCompactStat.failCount++;
+        }
+    }
+}
+
+/* Anonymous pages have no reverse map, so walk the user address spaces that are not busy */
+STATIC VOID OsVmCompactAnonPages(struct VmPhysSeg *seg, PADDR_T start, PADDR_T end)
+{
+    LosVmSpace *space = NULL;
+    LosVmMapRegion *region = NULL;
+    LosRbNode *pstRbNode = NULL;
+    LosRbNode *pstRbNodeNext = NULL;
+    LosMux *vmSpaceListMux = OsGVmSpaceMuxGet();
+
+    if (LOS_MuxTrylock(vmSpaceListMux) != LOS_OK) {
+        return;
+    }
+
+    LOS_DL_LIST_FOR_EACH_ENTRY(space, LOS_GetVmSpaceList(), LosVmSpace, node) {
+        if (!LOS_IsUserAddress(space->base) || (LOS_MuxTrylock(&space->regionMux) != LOS_OK)) {
+            continue;
+        }
+
+        RB_SCAN_SAFE(&space->regionRbTree, pstRbNode, pstRbNodeNext)
+            region = (LosVmMapRegion *)pstRbNode;
+            if (LOS_IsRegionTypeFile(region) || LOS_IsRegionTypeDev(region) ||
+                (region->regionFlags & VM_MAP_REGION_FLAG_SHM)) {
+                continue;
+            }
+            OsVmCompactAnonRegion(seg, space, region, start, end);
+        RB_SCAN_SAFE_END(&space->regionRbTree, pstRbNode, pstRbNodeNext)
+
+        (VOID)LOS_MuxRelease(&space->regionMux);
+    }
+
+    (VOID)LOS_MuxRelease(vmSpaceListMux);
+}
+
+/* Only worth emptying a block whose in-use pages can all be moved */
+STATIC BOOL OsVmCompactBlockSuitable(struct VmPhysSeg *seg, PADDR_T start, PADDR_T end)
+{
+    LosVmPage *page = NULL;
+    UINT32 used = 0;
+    PADDR_T pa;
+
+    for (pa = start; pa < end; pa += PAGE_SIZE) {
+        page = &seg->pageBase[(pa - seg->start) >> PAGE_SHIFT];
+        if (page->order < VM_LIST_ORDER_MAX) {
+            pa += VM_ORDER_TO_PHYS(page->order) - PAGE_SIZE;
+            continue;
+        }
+        if (LOS_AtomicRead(&page->refCounts) == 0) {
+            continue;
+        }
+        if (!OsVmPageIsMovable(page)) {
+            return FALSE;
+        }
+        used++;
+    }
+
+    return (used != 0);
+}
+
+STATIC VOID OsVmCompactSeg(struct VmPhysSeg *seg, size_t nPages, BOOL anon)
+{
+    UINT32 blockNum = OsVmPhysBlockNumGet(seg);
+    UINT32 index;
+    UINT32 type;
+    PADDR_T start;
+    PADDR_T end;
+    LosVmPage *block = NULL;
+
+    for (index = 0; index < blockNum; index++) {
+        if ((nPages != 0) && OsVmPhysSegAllocable(seg, nPages)) {
+            return;
+        }
+
+        start = ((seg->start >> VM_PAGE_BLOCK_SHIFT) + index) << VM_PAGE_BLOCK_SHIFT;
+        end = start + VM_ORDER_TO_PHYS(VM_PAGE_BLOCK_ORDER);
+        start = (start < seg->start) ? seg->start : start;
+        end = (end > (seg->start + seg->size)) ? (seg->start + seg->size) : end;
+        block = &seg->pageBase[(start - seg->start) >> PAGE_SHIFT];
+        if ((OsVmPhysBlockTypeGet(block) != VM_MIGRATE_MOVABLE) || !OsVmCompactBlockSuitable(seg, start, end)) {
+            continue;
+        }
+
+        type = OsVmPhysBlockIsolate(seg, block);
+#ifdef LOSCFG_FS_VFS
+        OsVmCompactFilePages(seg, start, end);
+#endif
+        if (anon) {
+            OsVmCompactAnonPages(seg, start, end);
+        }
+        OsVmPhysBlockUnisolate(seg, block, type);
+
+        if (block->order == VM_PAGE_BLOCK_ORDER) {
+            g_vmCompactStat.freeBlockCount++;
+        }
+    }
+}
+
+/*
+ * Move in-use movable pages out of page blocks until nPages contiguous pages can be allocated,
+ * or through every page block when nPages is 0. Returns the number of pages moved.
+ */
+size_t OsVmCompact(size_t nPages)
+{
+    UINT32 migrated;
+    /* anonymous pages need the address space mutexes, which atomic callers can not take */
+    BOOL anon = OS_SCHEDULER_ACTIVE && OsPreemptable();
+    INT32 segID;
+
+    if (LOS_AtomicCmpXchg32bits(&g_vmCompactRunning, 1, 0)) {
+        return 0;
+    }
+
+    migrated = g_vmCompactStat.migrateCount;
+    g_vmCompactStat.compactCount++;
+    (VOID)OsVmPhysPcpDrainAll();
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        OsVmCompactSeg(&g_vmPhysSeg[segID], nPages, anon);
+    }
+    migrated = g_vmCompactStat.migrateCount - migrated;
+
+    LOS_AtomicSet(&g_vmCompactRunning, 0);
+    return migrated;
+}
+
+#endif
@@ -494,9 +494,10 @@ UINT32 OsVmPhySegPagesGet(LosVmPhysSeg *seg)
 
     LOS_SpinLockSave(&seg->freeListLock, &intSave);
     for (flindex = 0; flindex < VM_LIST_ORDER_MAX; flindex++) {
-        segFreePages += ((1 << flindex) * seg->freeList[flindex].listCnt);
+        segFreePages += ((1 << flindex) * OsVmPhysFreeCntGet(seg, flindex));
     }
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+    segFreePages += OsVmPhysPcpPagesGet(seg);
 
     return segFreePages;
 }
@@ -511,6 +512,7 @@ VOID OsVmPhysDump(VOID)
     UINT32 intSave;
     UINT32 flindex;
     UINT32 listCount[VM_LIST_ORDER_MAX] = {0};
+    UINT32 pcpHit, pcpFallback;
 
     for (segIndex = 0; segIndex < g_vmPhysSegNum; segIndex++) {
         seg = &g_vmPhysSeg[segIndex];
@@ -526,12 +528,15 @@ VOID OsVmPhysDump(VOID)
 
             LOS_SpinLockSave(&seg->freeListLock, &intSave);
             for (flindex = 0; flindex < VM_LIST_ORDER_MAX; flindex++) {
-                listCount[flindex] = seg->freeList[flindex].listCnt;
+                listCount[flindex] = OsVmPhysFreeCntGet(seg, flindex);
             }
             LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
             for (flindex = 0; flindex < VM_LIST_ORDER_MAX; flindex++) {
                 PRINTK("order = %d, free_count = %d\n", flindex, listCount[flindex]);
             }
+            OsVmPhysPcpStatGet(seg, &pcpHit, &pcpFallback);
+            PRINTK("pcp free_count = %u, hit = %u, fallback = %u\n",
+                   (UINT32)OsVmPhysPcpPagesGet(seg), pcpHit, pcpFallback);
 
             PRINTK("active   anon   %d\n", seg->lruSize[VM_LRU_ACTIVE_ANON]);
             PRINTK("inactive anon   %d\n", seg->lruSize[VM_LRU_INACTIVE_ANON]);
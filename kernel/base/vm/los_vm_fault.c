@@ -84,6 +84,11 @@ STATIC VOID OsFaultTryFixup(ExcContext *frame, VADDR_T excVaddr, STATUS_T *statu
     INT32 tableNum = (__exc_table_end - __exc_table_start) / sizeof(LosExcTable);
     LosExcTable *excTable = (LosExcTable *)__exc_table_start;
 
+    /* faults raised on purpose by the kernel, see LOS_VmUserPin, have no frame to fix up */
+    if (frame == NULL) {
+        return;
+    }
+
     if ((frame->regCPSR & CPSR_MODE_MASK) != CPSR_MODE_USR) {
         for (int i = 0; i < tableNum; ++i, ++excTable) {
             if (frame->PC == (UINTPTR)excTable->excAddr) {
@@ -132,6 +137,10 @@ STATIC STATUS_T OsDoReadFault(LosVmMapRegion *region, LosVmPgFault *vmPgFault)
             return LOS_ERRNO_VM_NO_MEMORY;
         }
 
+        /* fault-around: map the cached neighbours too, a sequential scan then faults once per window */
+        if (region->unTypeData.rf.vmFOps->mapPages != NULL) {
+            region->unTypeData.rf.vmFOps->mapPages(region, vmPgFault);
+        }
         (VOID)LOS_MuxRelease(&region->unTypeData.rf.vnode->mapping.mux_lock);
         return LOS_OK;
     }
@@ -359,6 +368,15 @@ STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
         return LOS_ERRNO_VM_ACCESS_DENIED;
     }
 
+    /* The region lock may sleep, a fixable user access made with the scheduler locked fails back to its caller */
+    if (((flags & VM_MAP_PF_FLAG_USER) == 0) && OsSchedIsLock()) {
+        status = LOS_ERRNO_VM_NOT_FOUND;
+        OsFaultTryFixup(frame, excVaddr, &status);
+        if (status == LOS_OK) {
+            return status;
+        }
+    }
+
     (VOID)LOS_MuxAcquire(&space->regionMux);
     region = LOS_RegionFind(space, vaddr);
     if (region == NULL) {
@@ -403,7 +421,7 @@ STATUS_T OsVmPageFaultHandler(VADDR_T vaddr, UINT32 flags, ExcContext *frame)
     }
 #endif
 
-    newPage = LOS_PhysPageAlloc();
+    newPage = OsVmPhysMovablePageAlloc();
     if (newPage == NULL) {
         status = LOS_ERRNO_VM_NO_MEMORY;
         goto CHECK_FAILED;
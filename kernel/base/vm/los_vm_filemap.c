@@ -41,6 +41,10 @@
 #include "los_vm_fault.h"
 #include "los_process_pri.h"
 #include "los_vm_lock.h"
+#include "los_init.h"
+#include "los_event.h"
+#include "los_sys.h"
+#include "user_copy.h"
 #ifdef LOSCFG_FS_VFS
 #include "vnode.h"
 #endif
@@ -69,34 +73,84 @@ VOID ResetPageCacheHitInfo(int *try, int *hit)
 
 #ifdef LOSCFG_KERNEL_VM
 
-STATIC VOID OsPageCacheAdd(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
+LosKmemCache *g_filePageCache = NULL;
+LosKmemCache *g_mapInfoCache = NULL;
+
+STATIC UINT32 OsFileMapCacheInit(VOID)
 {
-    LosFilePage *fpage = NULL;
+    g_filePageCache = LOS_KmemCacheCreate("file_page", sizeof(LosFilePage), 0, NULL);
+    g_mapInfoCache = LOS_KmemCacheCreate("map_info", sizeof(LosMapInfo), 0, NULL);
+    if ((g_filePageCache == NULL) || (g_mapInfoCache == NULL)) {
+        VM_ERR("create file map caches failed");
+        return LOS_NOK;
+    }
+    return LOS_OK;
+}
 
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        if (fpage->pgoff > pgoff) {
-            LOS_ListTailInsert(&fpage->node, &page->node);
-            goto done_add;
-        }
+LOS_MODULE_INIT(OsFileMapCacheInit, LOS_INIT_LEVEL_VM_COMPLETE);
+
+/* vnodes holding dirty cached pages, written back by the flusher task */
+STATIC LOS_DL_LIST_HEAD(g_dirtyVnodeList);
+LITE_OS_SEC_BSS STATIC SPIN_LOCK_INIT(g_dirtyVnodeSpin);
+STATIC EVENT_CB_S g_fileFlushEvent;
+STATIC Atomic g_fileDirtyPages = 0;
+
+STATIC VOID OsFileCacheDirtyAdd(struct page_mapping *mapping)
+{
+    UINT32 intSave;
+    struct Vnode *vnode = (struct Vnode *)mapping->host;
+
+    LOS_SpinLockSave(&g_dirtyVnodeSpin, &intSave);
+    if (LOS_ListEmpty(&vnode->dirtyEntry)) {
+        LOS_ListTailInsert(&g_dirtyVnodeList, &vnode->dirtyEntry);
     }
+    LOS_SpinUnlockRestore(&g_dirtyVnodeSpin, intSave);
+}
+
+STATIC VOID OsFileCacheDirtyDel(struct page_mapping *mapping)
+{
+    UINT32 intSave;
+    struct Vnode *vnode = (struct Vnode *)mapping->host;
+
+    LOS_SpinLockSave(&g_dirtyVnodeSpin, &intSave);
+    LOS_ListDelInit(&vnode->dirtyEntry);
+    LOS_SpinUnlockRestore(&g_dirtyVnodeSpin, intSave);
+}
 
-    LOS_ListTailInsert(&mapping->page_list, &page->node);
+/* the cached pages of a mapping are indexed by pgoff, updated under mapping->list_lock */
+STATIC INLINE LosRadixTree *OsPageCacheTree(struct page_mapping *mapping)
+{
+    return &((struct Vnode *)mapping->host)->pageTree;
+}
+
+STATIC UINT32 OsPageCacheAdd(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
+{
+    if (LOS_RadixTreeInsert(OsPageCacheTree(mapping), pgoff, page) != LOS_OK) {
+        return LOS_NOK;
+    }
 
-done_add:
     mapping->nrpages++;
+    return LOS_OK;
 }
 
-VOID OsAddToPageacheLru(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
+UINT32 OsAddToPageacheLru(LosFilePage *page, struct page_mapping *mapping, VM_OFFSET_T pgoff)
 {
-    OsPageCacheAdd(page, mapping, pgoff);
+    if (OsPageCacheAdd(page, mapping, pgoff) != LOS_OK) {
+        return LOS_NOK;
+    }
     OsLruCacheAdd(page, VM_LRU_ACTIVE_FILE);
+    return LOS_OK;
 }
 
 VOID OsPageCacheDel(LosFilePage *fpage)
 {
-    /* delete from file cache list */
-    LOS_ListDelete(&fpage->node);
-    fpage->mapping->nrpages--;
+    LosRadixTree *tree = OsPageCacheTree(fpage->mapping);
+
+    /* delete from file cache index, a page failed to read was never added */
+    if (LOS_RadixTreeLookup(tree, fpage->pgoff) == fpage) {
+        (VOID)LOS_RadixTreeDelete(tree, fpage->pgoff);
+        fpage->mapping->nrpages--;
+    }
 
     /* unmap and remove map info */
     if (OsIsPageMapped(fpage)) {
@@ -105,14 +159,14 @@ VOID OsPageCacheDel(LosFilePage *fpage)
 
     LOS_PhysPageFree(fpage->vmPage);
 
-    LOS_MemFree(m_aucSysMem0, fpage);
+    (VOID)LOS_KmemCacheFree(g_filePageCache, fpage);
 }
 
 VOID OsAddMapInfo(LosFilePage *page, LosArchMmu *archMmu, VADDR_T vaddr)
 {
     LosMapInfo *info = NULL;
 
-    info = (LosMapInfo *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosMapInfo));
+    info = (LosMapInfo *)LOS_KmemCacheAlloc(g_mapInfoCache);
     if (info == NULL) {
         VM_ERR("OsAddMapInfo alloc memory failed!");
         return;
@@ -216,10 +270,15 @@ VOID OsVmmFileRemove(LosVmMapRegion *region, LosArchMmu *archMmu, VM_OFFSET_T pg
 
 VOID OsMarkPageDirty(LosFilePage *fpage, LosVmMapRegion *region, INT32 off, INT32 len)
 {
+    LOS_RadixTreeTagSet(OsPageCacheTree(fpage->mapping), fpage->pgoff, PAGE_CACHE_TAG_DIRTY);
+    OsFileCacheDirtyAdd(fpage->mapping);
     if (region != NULL) {
         OsSetPageDirty(fpage->vmPage);
         fpage->dirtyOff = off;
         fpage->dirtyEnd = len;
+    } else if (OsIsPageDirty(fpage->vmPage) && (fpage->dirtyEnd == 0)) {
+        /* already dirty through a shared mapping, the whole page is written back */
+        return;
     } else {
         OsSetPageDirty(fpage->vmPage);
         if ((off + len) > fpage->dirtyEnd) {
@@ -239,7 +298,7 @@ STATIC UINT32 GetDirtySize(LosFilePage *fpage, struct Vnode *vnode)
     UINT32 dirtyEnd;
     struct stat buf_stat;
 
-    if (stat(vnode->filePath, &buf_stat) != OK) {
+    if ((vnode->vop->Getattr == NULL) || (vnode->vop->Getattr(vnode, &buf_stat) != OK)) {
         VM_ERR("FlushDirtyPage get file size failed. (filePath=%s)", vnode->filePath);
         return 0;
     }
@@ -261,7 +320,7 @@ STATIC UINT32 GetDirtySize(LosFilePage *fpage, struct Vnode *vnode)
 
 STATIC INT32 OsFlushDirtyPage(LosFilePage *fpage)
 {
-    UINT32 ret;
+    ssize_t ret;
     size_t len;
     char *buff = NULL;
     struct Vnode *vnode = fpage->mapping->host;
@@ -270,8 +329,11 @@ STATIC INT32 OsFlushDirtyPage(LosFilePage *fpage)
         return LOS_NOK;
     }
 
-    len = fpage->dirtyEnd - fpage->dirtyOff;
-    len = (len == 0) ? GetDirtySize(fpage, vnode) : len;
+    /* written from the page start, block file systems can only write whole sectors from there */
+    len = GetDirtySize(fpage, vnode);
+    if ((fpage->dirtyEnd != 0) && (fpage->dirtyEnd < len)) {
+        len = fpage->dirtyEnd;
+    }
     if (len == 0) {
         OsCleanPageDirty(fpage->vmPage);
         return LOS_OK;
@@ -279,8 +341,7 @@ STATIC INT32 OsFlushDirtyPage(LosFilePage *fpage)
 
     buff = (char *)OsVmPageToVaddr(fpage->vmPage);
 
-    /* actually, we did not update the fpage->dirtyOff */
-    ret = vnode->vop->WritePage(vnode, (VOID *)buff, fpage->pgoff, len);
+    ret = vnode->vop->WritePage(vnode, (VOID *)buff, (off_t)fpage->pgoff << PAGE_SHIFT, len);
     if (ret <= 0) {
         VM_ERR("WritePage error ret %d", ret);
     } else {
@@ -295,14 +356,17 @@ LosFilePage *OsDumpDirtyPage(LosFilePage *oldFPage)
 {
     LosFilePage *newFPage = NULL;
 
-    newFPage = (LosFilePage *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosFilePage));
+    newFPage = (LosFilePage *)LOS_KmemCacheAlloc(g_filePageCache);
     if (newFPage == NULL) {
         VM_ERR("Failed to allocate for temp page!");
         return NULL;
     }
 
     OsCleanPageDirty(oldFPage->vmPage);
+    LOS_RadixTreeTagClear(OsPageCacheTree(oldFPage->mapping), oldFPage->pgoff, PAGE_CACHE_TAG_DIRTY);
     (VOID)memcpy_s(newFPage, sizeof(LosFilePage), oldFPage, sizeof(LosFilePage));
+    oldFPage->dirtyOff = PAGE_SIZE;
+    oldFPage->dirtyEnd = 0;
 
     return newFPage;
 }
@@ -313,7 +377,7 @@ VOID OsDoFlushDirtyPage(LosFilePage *fpage)
         return;
     }
     (VOID)OsFlushDirtyPage(fpage);
-    LOS_MemFree(m_aucSysMem0, fpage);
+    (VOID)LOS_KmemCacheFree(g_filePageCache, fpage);
 }
 
 STATIC VOID OsReleaseFpage(struct page_mapping *mapping, LosFilePage *fpage)
@@ -357,12 +421,96 @@ VOID OsDelMapInfo(LosVmMapRegion *region, LosVmPgFault *vmf, BOOL cleanDirty)
         LOS_ListDelete(&info->node);
         LOS_AtomicDec(&fpage->vmPage->refCounts);
         LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
-        LOS_MemFree(m_aucSysMem0, info);
+        (VOID)LOS_KmemCacheFree(g_mapInfoCache, info);
         return;
     }
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 }
 
+/* read the missing pages of [start, start + nPages) into the cache, stop at the region end or the file end */
+STATIC VOID OsPageCacheReadAhead(LosVmMapRegion *region, VM_OFFSET_T start, UINT32 nPages)
+{
+    INT32 ret;
+    UINT32 intSave;
+    VM_OFFSET_T pgoff;
+    VM_OFFSET_T end;
+    LosFilePage *fpage = NULL;
+    struct Vnode *vnode = region->unTypeData.rf.vnode;
+    struct page_mapping *mapping = &vnode->mapping;
+
+    end = region->pgOff + (region->range.size >> PAGE_SHIFT);
+    if (start + nPages < end) {
+        end = start + nPages;
+    }
+
+    for (pgoff = start; pgoff < end; pgoff++) {
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        fpage = OsFindGetEntry(mapping, pgoff);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+        if (fpage != NULL) {
+            continue;
+        }
+
+        fpage = OsPageCacheAlloc(mapping, pgoff);
+        if (fpage == NULL) {
+            return;
+        }
+
+        ret = vnode->vop->ReadPage(vnode, OsVmPageToVaddr(fpage->vmPage), pgoff << PAGE_SHIFT);
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        if ((ret <= 0) || (OsAddToPageacheLru(fpage, mapping, pgoff) != LOS_OK)) {
+            OsPageCacheDel(fpage);
+            LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+            return;
+        }
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    }
+}
+
+STATIC INLINE UINT32 OsReadAheadNextSize(UINT32 size)
+{
+    if (size == 0) {
+        return VM_FILE_RA_INIT_PAGES;
+    }
+    return ((size << 1) > VM_FILE_RA_MAX_PAGES) ? VM_FILE_RA_MAX_PAGES : (size << 1);
+}
+
+/*
+ * Per region readahead, called with mapping->mux_lock held. A miss that continues the previous
+ * fault or lands in/right after the current window reads the next, larger window synchronously
+ * behind the faulting page. A hit on the trailing asyncSize pages of the window reads the window
+ * after it before the stream gets there, so a sequential scan mostly faults on cached pages.
+ */
+STATIC VOID OsFileReadAhead(LosVmMapRegion *region, VM_OFFSET_T pgoff, BOOL hit)
+{
+    LosVmFileRa *ra = &region->unTypeData.rf.readAhead;
+    BOOL sequential = (pgoff == ra->prevPgoff + 1) ||
+                      ((pgoff >= ra->start) && (pgoff <= ra->start + ra->size));
+
+    ra->prevPgoff = pgoff;
+    if (!hit) {
+        if (!sequential) {
+            ra->start = pgoff + 1;
+            ra->size = 0;
+            ra->asyncSize = 0;
+            return;
+        }
+        ra->start = pgoff + 1;
+        ra->size = OsReadAheadNextSize(ra->size);
+        ra->asyncSize = ra->size >> 1;
+    } else {
+        if ((ra->size == 0) || (pgoff < ra->start + ra->size - ra->asyncSize) ||
+            (pgoff >= ra->start + ra->size)) {
+            return;
+        }
+        ra->start += ra->size;
+        ra->size = OsReadAheadNextSize(ra->size);
+        ra->asyncSize = ra->size;
+    }
+
+    OsPageCacheReadAhead(region, ra->start, ra->size);
+}
+
 INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
 {
     INT32 ret;
@@ -410,8 +558,13 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
             return LOS_NOK;
         }
         LOS_SpinLockSave(&mapping->list_lock, &intSave);
-        OsAddToPageacheLru(fpage, mapping, vmf->pgoff);
+        ret = OsAddToPageacheLru(fpage, mapping, vmf->pgoff);
         LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+        if (ret != LOS_OK) {
+            VM_ERR("Failed to add page cache!");
+            OsReleaseFpage(mapping, fpage);
+            return LOS_NOK;
+        }
     }
 
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
@@ -428,13 +581,68 @@ INT32 OsVmmFileFault(LosVmMapRegion *region, LosVmPgFault *vmf)
 
     vmf->pageKVaddr = kvaddr;
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+    OsFileReadAhead(region, vmf->pgoff, !newCache);
     return LOS_OK;
 }
 
+/* map the already cached pages of the aligned window around a read fault, called with mapping->mux_lock held */
+VOID OsVmmFileMapPages(LosVmMapRegion *region, LosVmPgFault *vmf)
+{
+    UINT32 intSave;
+    UINT32 num;
+    UINT32 index;
+    VADDR_T vaddr;
+    VM_OFFSET_T start;
+    VM_OFFSET_T end;
+    LosFilePage *fpage = NULL;
+    LosFilePage *pages[VM_FILE_FAULT_AROUND_PAGES];
+    LosArchMmu *archMmu = &region->space->archMmu;
+    struct page_mapping *mapping = &region->unTypeData.rf.vnode->mapping;
+
+    start = ROUNDDOWN(vmf->pgoff, VM_FILE_FAULT_AROUND_PAGES);
+    end = start + VM_FILE_FAULT_AROUND_PAGES;
+    if (start < region->pgOff) {
+        start = region->pgOff;
+    }
+    if (end > region->pgOff + (region->range.size >> PAGE_SHIFT)) {
+        end = region->pgOff + (region->range.size >> PAGE_SHIFT);
+    }
+
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    num = LOS_RadixTreeGangLookup(OsPageCacheTree(mapping), (VOID **)pages, start, end - start);
+    for (index = 0; index < num; index++) {
+        fpage = pages[index];
+        if (fpage->pgoff >= end) {
+            break;
+        }
+        if ((fpage->pgoff == vmf->pgoff) || OsIsPageLocked(fpage->vmPage)) {
+            continue;
+        }
+
+        vaddr = region->range.base + ((UINT32)(fpage->pgoff - region->pgOff) << PAGE_SHIFT);
+        if (LOS_ArchMmuQuery(archMmu, vaddr, NULL, NULL) == LOS_OK) {
+            continue;
+        }
+        if (LOS_ArchMmuMap(archMmu, vaddr, VM_PAGE_TO_PHYS(fpage->vmPage), 1,
+                           region->regionFlags & (~VM_MAP_REGION_FLAG_PERM_WRITE)) < 0) {
+            break;
+        }
+        OsAddMapInfo(fpage, archMmu, vaddr);
+        fpage->flags = region->regionFlags;
+        LOS_AtomicInc(&fpage->vmPage->refCounts);
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+}
+
 VOID OsFileCacheFlush(struct page_mapping *mapping)
 {
     UINT32 intSave;
     UINT32 lruLock;
+    UINT32 num;
+    UINT32 index;
+    VM_OFFSET_T pgoff = 0;
+    LosFilePage *pages[PAGE_CACHE_GANG_SIZE];
     LOS_DL_LIST_HEAD(dirtyList);
     LosFilePage *ftemp = NULL;
     LosFilePage *fpage = NULL;
@@ -442,17 +650,30 @@ VOID OsFileCacheFlush(struct page_mapping *mapping)
     if (mapping == NULL) {
         return;
     }
+    /* pages dirtied from here on link the vnode again */
+    OsFileCacheDirtyDel(mapping);
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        LOS_SpinLockSave(&fpage->physSeg->lruLock, &lruLock);
-        if (OsIsPageDirty(fpage->vmPage)) {
-            ftemp = OsDumpDirtyPage(fpage);
-            if (ftemp != NULL) {
-                LOS_ListTailInsert(&dirtyList, &ftemp->node);
+    /* only the pages tagged dirty are visited */
+    do {
+        num = LOS_RadixTreeGangLookupTag(OsPageCacheTree(mapping), (VOID **)pages, pgoff,
+                                         PAGE_CACHE_GANG_SIZE, PAGE_CACHE_TAG_DIRTY);
+        for (index = 0; index < num; index++) {
+            fpage = pages[index];
+            LOS_SpinLockSave(&fpage->physSeg->lruLock, &lruLock);
+            if (OsIsPageDirty(fpage->vmPage)) {
+                ftemp = OsDumpDirtyPage(fpage);
+                if (ftemp != NULL) {
+                    LOS_ListTailInsert(&dirtyList, &ftemp->node);
+                }
+            } else {
+                LOS_RadixTreeTagClear(OsPageCacheTree(mapping), fpage->pgoff, PAGE_CACHE_TAG_DIRTY);
             }
+            LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, lruLock);
         }
-        LOS_SpinUnlockRestore(&fpage->physSeg->lruLock, lruLock);
-    }
+        if (num > 0) {
+            pgoff = pages[num - 1]->pgoff + 1;
+        }
+    } while (num == PAGE_CACHE_GANG_SIZE);
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, ftemp, &dirtyList, LosFilePage, node) {
@@ -466,24 +687,33 @@ VOID OsFileCacheRemove(struct page_mapping *mapping)
     UINT32 lruSave;
     SPIN_LOCK_S *lruLock = NULL;
     LOS_DL_LIST_HEAD(dirtyList);
+    LosFilePage *pages[PAGE_CACHE_GANG_SIZE];
     LosFilePage *ftemp = NULL;
     LosFilePage *fpage = NULL;
     LosFilePage *fnext = NULL;
+    UINT32 num;
+    UINT32 index;
 
+    OsFileCacheDirtyDel(mapping);
     LOS_SpinLockSave(&mapping->list_lock, &intSave);
-    LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, &mapping->page_list, LosFilePage, node) {
-        lruLock = &fpage->physSeg->lruLock;
-        LOS_SpinLockSave(lruLock, &lruSave);
-        if (OsIsPageDirty(fpage->vmPage)) {
-            ftemp = OsDumpDirtyPage(fpage);
-            if (ftemp != NULL) {
-                LOS_ListTailInsert(&dirtyList, &ftemp->node);
+    do {
+        /* the deleted pages leave the index, so always restart from the first one */
+        num = LOS_RadixTreeGangLookup(OsPageCacheTree(mapping), (VOID **)pages, 0, PAGE_CACHE_GANG_SIZE);
+        for (index = 0; index < num; index++) {
+            fpage = pages[index];
+            lruLock = &fpage->physSeg->lruLock;
+            LOS_SpinLockSave(lruLock, &lruSave);
+            if (OsIsPageDirty(fpage->vmPage)) {
+                ftemp = OsDumpDirtyPage(fpage);
+                if (ftemp != NULL) {
+                    LOS_ListTailInsert(&dirtyList, &ftemp->node);
+                }
             }
-        }
 
-        OsDeletePageCacheLru(fpage);
-        LOS_SpinUnlockRestore(lruLock, lruSave);
-    }
+            OsDeletePageCacheLru(fpage);
+            LOS_SpinUnlockRestore(lruLock, lruSave);
+        }
+    } while (num == PAGE_CACHE_GANG_SIZE);
     LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
 
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(fpage, fnext, &dirtyList, LosFilePage, node) {
@@ -491,11 +721,335 @@ VOID OsFileCacheRemove(struct page_mapping *mapping)
     }
 }
 
+/* forget the pending write-back of a file whose blocks are being released */
+VOID OsFileCacheDropDirty(struct page_mapping *mapping)
+{
+    UINT32 intSave;
+    UINT32 num;
+    UINT32 index;
+    VM_OFFSET_T pgoff = 0;
+    LosFilePage *pages[PAGE_CACHE_GANG_SIZE];
+
+    OsFileCacheDirtyDel(mapping);
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    do {
+        num = LOS_RadixTreeGangLookupTag(OsPageCacheTree(mapping), (VOID **)pages, pgoff,
+                                         PAGE_CACHE_GANG_SIZE, PAGE_CACHE_TAG_DIRTY);
+        for (index = 0; index < num; index++) {
+            OsCleanPageDirty(pages[index]->vmPage);
+            pages[index]->dirtyOff = PAGE_SIZE;
+            pages[index]->dirtyEnd = 0;
+            LOS_RadixTreeTagClear(OsPageCacheTree(mapping), pages[index]->pgoff, PAGE_CACHE_TAG_DIRTY);
+        }
+        if (num > 0) {
+            pgoff = pages[num - 1]->pgoff + 1;
+        }
+    } while (num == PAGE_CACHE_GANG_SIZE);
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+}
+
+/* the file shrinks to size: drop the pages past it and zero the tail of the last one, so an extension reads zeroes */
+VOID OsFileCacheTruncate(struct page_mapping *mapping, off_t size)
+{
+    UINT32 intSave;
+    UINT32 lruSave;
+    UINT32 num;
+    UINT32 index;
+    UINT32 off = (UINT32)size & (PAGE_SIZE - 1);
+    VM_OFFSET_T pgoff = (VM_OFFSET_T)(size >> PAGE_SHIFT);
+    SPIN_LOCK_S *lruLock = NULL;
+    LosFilePage *pages[PAGE_CACHE_GANG_SIZE];
+    LosFilePage *fpage = NULL;
+
+    (VOID)LOS_MuxAcquire(&mapping->mux_lock);
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    if (off != 0) {
+        fpage = OsFindGetEntry(mapping, pgoff);
+        if (fpage != NULL) {
+            (VOID)memset_s((CHAR *)OsVmPageToVaddr(fpage->vmPage) + off, PAGE_SIZE - off, 0, PAGE_SIZE - off);
+        }
+        pgoff++;
+    }
+
+    do {
+        /* the deleted pages leave the index, so the lookup restarts from pgoff */
+        num = LOS_RadixTreeGangLookup(OsPageCacheTree(mapping), (VOID **)pages, pgoff, PAGE_CACHE_GANG_SIZE);
+        for (index = 0; index < num; index++) {
+            fpage = pages[index];
+            lruLock = &fpage->physSeg->lruLock;
+            LOS_SpinLockSave(lruLock, &lruSave);
+            OsCleanPageDirty(fpage->vmPage);
+            OsDeletePageCacheLru(fpage);
+            LOS_SpinUnlockRestore(lruLock, lruSave);
+        }
+    } while (num == PAGE_CACHE_GANG_SIZE);
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    (VOID)LOS_MuxRelease(&mapping->mux_lock);
+}
+
+STATIC INT32 OsVnodeFileSize(struct Vnode *vnode, off_t *size)
+{
+    INT32 ret;
+    struct stat st;
+
+    if (vnode->vop->Getattr == NULL) {
+        return -ENOSYS;
+    }
+    ret = vnode->vop->Getattr(vnode, &st);
+    if (ret != 0) {
+        return (ret < 0) ? ret : -ret;
+    }
+    *size = st.st_size;
+    return LOS_OK;
+}
+
+/* find or read in the cached page of pgoff and lock it, called with mapping->mux_lock held */
+STATIC LosFilePage *OsFileCacheGetLocked(struct Vnode *vnode, VM_OFFSET_T pgoff, off_t fileSize)
+{
+    ssize_t ret;
+    UINT32 intSave;
+    CHAR *kvaddr = NULL;
+    off_t pos = (off_t)pgoff << PAGE_SHIFT;
+    struct page_mapping *mapping = &vnode->mapping;
+    LosFilePage *fpage = NULL;
+
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    fpage = OsFindGetEntry(mapping, pgoff);
+    TRACE_TRY_CACHE();
+    if (fpage != NULL) {
+        TRACE_HIT_CACHE();
+        OsPageRefIncLocked(fpage);
+        OsSetPageLocked(fpage->vmPage);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+        return fpage;
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+
+    fpage = OsPageCacheAlloc(mapping, pgoff);
+    if (fpage == NULL) {
+        return NULL;
+    }
+
+    /* a page past the end of file stays zero, so does the tail of the last one */
+    kvaddr = (CHAR *)OsVmPageToVaddr(fpage->vmPage);
+    if (pos < fileSize) {
+        ret = vnode->vop->ReadPage(vnode, kvaddr, pos);
+        if (ret <= 0) {
+            VM_ERR("Failed to read from file!");
+            LOS_SpinLockSave(&mapping->list_lock, &intSave);
+            OsPageCacheDel(fpage);
+            LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+            return NULL;
+        }
+        if (ret < PAGE_SIZE) {
+            (VOID)memset_s(kvaddr + ret, PAGE_SIZE - ret, 0, PAGE_SIZE - ret);
+        }
+    }
+
+    OsSetPageLocked(fpage->vmPage);
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    if (OsAddToPageacheLru(fpage, mapping, pgoff) != LOS_OK) {
+        OsPageCacheDel(fpage);
+        fpage = NULL;
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+    return fpage;
+}
+
+ssize_t VfsGenericFileRead(struct file *filep, char *buf, size_t buflen)
+{
+    ssize_t ret;
+    off_t size;
+    UINT32 off;
+    size_t len;
+    size_t done = 0;
+    off_t pos = filep->f_pos;
+    LosFilePage *fpage = NULL;
+    struct Vnode *vnode = filep->f_vnode;
+    struct page_mapping *mapping = &vnode->mapping;
+
+    ret = OsVnodeFileSize(vnode, &size);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+    if (pos >= size) {
+        return 0;
+    }
+    buflen = min(buflen, (size_t)(size - pos));
+
+    (VOID)LOS_MuxAcquire(&mapping->mux_lock);
+    while (done < buflen) {
+        off = (UINT32)(pos + done) & (PAGE_SIZE - 1);
+        len = min(PAGE_SIZE - off, buflen - done);
+        fpage = OsFileCacheGetLocked(vnode, (VM_OFFSET_T)((pos + done) >> PAGE_SHIFT), size);
+        if (fpage == NULL) {
+            ret = -EIO;
+            break;
+        }
+        ret = LOS_CopyFromKernel(buf + done, len, (CHAR *)OsVmPageToVaddr(fpage->vmPage) + off, len);
+        OsCleanPageLocked(fpage->vmPage);
+        if (ret != 0) {
+            ret = -EFAULT;
+            break;
+        }
+        done += len;
+    }
+    (VOID)LOS_MuxRelease(&mapping->mux_lock);
+
+    filep->f_pos = pos + done;
+    return (done > 0) ? (ssize_t)done : ret;
+}
+
+ssize_t VfsGenericFileWrite(struct file *filep, const char *buf, size_t buflen)
+{
+    ssize_t ret;
+    UINT32 intSave;
+    off_t size;
+    off_t pos;
+    off_t cur;
+    off_t end;
+    UINT32 off;
+    size_t len = 0;
+    INT32 dirtied = 0;
+    CHAR *kvaddr = NULL;
+    LosFilePage *fpage = NULL;
+    struct Vnode *vnode = filep->f_vnode;
+    struct page_mapping *mapping = &vnode->mapping;
+
+    if (buflen == 0) {
+        return 0;
+    }
+    if ((vnode->vop->Truncate == NULL) || (vnode->vop->WritePage == NULL)) {
+        return -ENOSYS;
+    }
+
+    (VOID)LOS_MuxAcquire(&mapping->mux_lock);
+    ret = OsVnodeFileSize(vnode, &size);
+    if (ret != LOS_OK) {
+        goto OUT;
+    }
+    pos = ((unsigned int)filep->f_oflags & O_APPEND) ? size : filep->f_pos;
+    end = pos + (off_t)buflen;
+    if (end > size) {
+        /* allocate the new tail now, the data reaches it by write-back */
+        ret = vnode->vop->Truncate(vnode, end);
+        if (ret != 0) {
+            goto OUT;
+        }
+    }
+
+    /* a hole between the old end of file and pos is written back as zeroes */
+    for (cur = min(pos, size); cur < end; cur += len) {
+        off = (UINT32)cur & (PAGE_SIZE - 1);
+        len = min(PAGE_SIZE - off, (size_t)(((cur < pos) ? pos : end) - cur));
+        fpage = OsFileCacheGetLocked(vnode, (VM_OFFSET_T)(cur >> PAGE_SHIFT), size);
+        if (fpage == NULL) {
+            ret = -ENOMEM;
+            break;
+        }
+
+        kvaddr = (CHAR *)OsVmPageToVaddr(fpage->vmPage) + off;
+        if (cur < pos) {
+            (VOID)memset_s(kvaddr, len, 0, len);
+        } else if (LOS_CopyToKernel(kvaddr, len, buf + (cur - pos), len) != 0) {
+            OsCleanPageLocked(fpage->vmPage);
+            ret = -EFAULT;
+            break;
+        }
+        LOS_SpinLockSave(&mapping->list_lock, &intSave);
+        OsMarkPageDirty(fpage, NULL, (INT32)off, (INT32)len);
+        LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+        OsCleanPageLocked(fpage->vmPage);
+        dirtied++;
+    }
+
+    if ((cur < end) && (end > size)) {
+        /* give back the tail that was not written */
+        (VOID)vnode->vop->Truncate(vnode, (cur > pos) ? cur : size);
+    }
+    if (cur > pos) {
+        filep->f_pos = cur;
+        ret = (ssize_t)(cur - pos);
+    }
+
+OUT:
+    (VOID)LOS_MuxRelease(&mapping->mux_lock);
+    if ((dirtied > 0) && (LOS_AtomicAdd(&g_fileDirtyPages, dirtied) >= VM_FILE_FLUSH_DIRTY_PAGES)) {
+        (VOID)LOS_EventWrite(&g_fileFlushEvent, VM_FILE_FLUSH_EVENT);
+    }
+    return ret;
+}
+
+STATIC VOID OsFileCacheWriteback(VOID)
+{
+    UINT32 intSave;
+    UINT32 count;
+    struct Vnode *vnode = NULL;
+
+    LOS_AtomicSet(&g_fileDirtyPages, 0);
+    /* bounded, a vnode dirtied again while it is written back waits for the next round */
+    for (count = 0; count < LOSCFG_MAX_VNODE_SIZE; count++) {
+        VnodeHold();
+        LOS_SpinLockSave(&g_dirtyVnodeSpin, &intSave);
+        if (LOS_ListEmpty(&g_dirtyVnodeList)) {
+            LOS_SpinUnlockRestore(&g_dirtyVnodeSpin, intSave);
+            VnodeDrop();
+            return;
+        }
+        vnode = LOS_DL_LIST_ENTRY(g_dirtyVnodeList.pstNext, struct Vnode, dirtyEntry);
+        LOS_SpinUnlockRestore(&g_dirtyVnodeSpin, intSave);
+        /* keep the vnode from being freed without holding the vnode lock across the I/O */
+        vnode->useCount++;
+        VnodeDrop();
+
+        OsFileCacheFlush(&vnode->mapping);
+
+        VnodeHold();
+        vnode->useCount--;
+        VnodeDrop();
+    }
+}
+
+STATIC VOID OsFileFlusherTask(VOID)
+{
+    while (1) {
+        (VOID)LOS_EventRead(&g_fileFlushEvent, VM_FILE_FLUSH_EVENT, LOS_WAITMODE_OR | LOS_WAITMODE_CLR,
+                            LOS_MS2Tick(VM_FILE_FLUSH_INTERVAL));
+        OsFileCacheWriteback();
+    }
+}
+
+STATIC UINT32 OsFileFlusherInit(VOID)
+{
+    UINT32 ret;
+    UINT32 taskID;
+    TSK_INIT_PARAM_S taskInitParam;
+
+    ret = LOS_EventInit(&g_fileFlushEvent);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    (VOID)memset_s(&taskInitParam, sizeof(TSK_INIT_PARAM_S), 0, sizeof(TSK_INIT_PARAM_S));
+    taskInitParam.pfnTaskEntry = (TSK_ENTRY_FUNC)OsFileFlusherTask;
+    taskInitParam.uwStackSize = LOSCFG_BASE_CORE_TSK_DEFAULT_STACK_SIZE;
+    taskInitParam.pcName = "PageFlusher";
+    taskInitParam.usTaskPrio = VM_FILE_FLUSH_PRIO;
+    ret = LOS_TaskCreate(&taskID, &taskInitParam);
+    if (ret == LOS_OK) {
+        OS_TCB_FROM_TID(taskID)->taskStatus |= OS_TASK_FLAG_NO_DELETE;
+    }
+    return ret;
+}
+
+LOS_MODULE_INIT(OsFileFlusherInit, LOS_INIT_LEVEL_KMOD_TASK);
+
 LosVmFileOps g_commVmOps = {
     .open = NULL,
     .close = NULL,
     .fault = OsVmmFileFault,
     .remove = OsVmmFileRemove,
+    .mapPages = OsVmmFileMapPages,
 };
 
 INT32 OsVfsFileMmap(struct file *filep, LosVmMapRegion *region)
@@ -503,6 +1057,7 @@ INT32 OsVfsFileMmap(struct file *filep, LosVmMapRegion *region)
     region->unTypeData.rf.vmFOps = &g_commVmOps;
     region->unTypeData.rf.vnode = filep->f_vnode;
     region->unTypeData.rf.f_oflags = filep->f_oflags;
+    OsVmFileRaInit(&region->unTypeData.rf.readAhead);
 
     return ENOERR;
 }
@@ -540,19 +1095,7 @@ STATUS_T OsNamedMMap(struct file *filep, LosVmMapRegion *region)
 
 LosFilePage *OsFindGetEntry(struct page_mapping *mapping, VM_OFFSET_T pgoff)
 {
-    LosFilePage *fpage = NULL;
-
-    LOS_DL_LIST_FOR_EACH_ENTRY(fpage, &mapping->page_list, LosFilePage, node) {
-        if (fpage->pgoff == pgoff) {
-            return fpage;
-        }
-
-        if (fpage->pgoff > pgoff) {
-            break;
-        }
-    }
-
-    return NULL;
+    return (LosFilePage *)LOS_RadixTreeLookup(OsPageCacheTree(mapping), pgoff);
 }
 
 /* need mutex & change memory to dma zone. */
@@ -563,7 +1106,7 @@ LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff)
     LosVmPage *vmPage = NULL;
     LosFilePage *fpage = NULL;
 
-    vmPage = LOS_PhysPageAlloc();
+    vmPage = OsVmPhysMovablePageAlloc();
     if (vmPage == NULL) {
         VM_ERR("alloc vm page failed");
         return NULL;
@@ -576,7 +1119,7 @@ LosFilePage *OsPageCacheAlloc(struct page_mapping *mapping, VM_OFFSET_T pgoff)
         return NULL;
     }
 
-    fpage = (LosFilePage *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosFilePage));
+    fpage = (LosFilePage *)LOS_KmemCacheAlloc(g_filePageCache);
     if (fpage == NULL) {
         LOS_PhysPageFree(vmPage);
         VM_ERR("Failed to allocate for page!");
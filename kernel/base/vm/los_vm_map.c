@@ -241,6 +241,34 @@ STATIC BOOL OsVmSpaceParamCheck(LosVmSpace *vmSpace)
     return TRUE;
 }
 
+#ifdef LOSCFG_FS_VFS
+STATIC VOID OsVmRegionFileMapInfoClone(LosVmMapRegion *oldRegion, LosVmMapRegion *newRegion, LosVmSpace *newVmSpace)
+{
+    struct page_mapping *mapping = &oldRegion->unTypeData.rf.vnode->mapping;
+    UINT32 numPages = newRegion->range.size >> PAGE_SHIFT;
+    LosFilePage *fpage = NULL;
+    LosVmPage *page = NULL;
+    PADDR_T paddr;
+    VADDR_T vaddr;
+    UINT32 intSave;
+    UINT32 i;
+
+    LOS_SpinLockSave(&mapping->list_lock, &intSave);
+    for (i = 0; i < numPages; i++) {
+        vaddr = newRegion->range.base + (i << PAGE_SHIFT);
+        if (LOS_ArchMmuQuery(&newVmSpace->archMmu, vaddr, &paddr, NULL) != LOS_OK) {
+            continue;
+        }
+        page = LOS_VmPageGet(paddr);
+        fpage = OsFindGetEntry(mapping, newRegion->pgOff + i);
+        if ((fpage != NULL) && (fpage->vmPage == page)) { /* cow page no need map */
+            OsAddMapInfo(fpage, &newVmSpace->archMmu, vaddr);
+        }
+    }
+    LOS_SpinUnlockRestore(&mapping->list_lock, intSave);
+}
+#endif
+
 STATUS_T LOS_VmSpaceClone(LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
 {
     LosVmMapRegion *oldRegion = NULL;
@@ -248,13 +276,6 @@ STATUS_T LOS_VmSpaceClone(LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
     LosRbNode *pstRbNode = NULL;
     LosRbNode *pstRbNodeNext = NULL;
     STATUS_T ret = LOS_OK;
-    UINT32 numPages;
-    PADDR_T paddr;
-    VADDR_T vaddr;
-    UINT32 intSave;
-    LosVmPage *page = NULL;
-    UINT32 flags;
-    UINT32 i;
 
     if ((OsVmSpaceParamCheck(oldVmSpace) == FALSE) || (OsVmSpaceParamCheck(newVmSpace) == FALSE)) {
         return LOS_ERRNO_VM_INVALID_ARGS;
@@ -289,35 +310,19 @@ STATUS_T LOS_VmSpaceClone(LosVmSpace *oldVmSpace, LosVmSpace *newVmSpace)
             newVmSpace->heap = newRegion;
         }
 
-        numPages = newRegion->range.size >> PAGE_SHIFT;
-        for (i = 0; i < numPages; i++) {
-            vaddr = newRegion->range.base + (i << PAGE_SHIFT);
-            if (LOS_ArchMmuQuery(&oldVmSpace->archMmu, vaddr, &paddr, &flags) != LOS_OK) {
-                continue;
-            }
-
-            page = LOS_VmPageGet(paddr);
-            if (page != NULL) {
-                LOS_AtomicInc(&page->refCounts);
-            }
-            if (flags & VM_MAP_REGION_FLAG_PERM_WRITE) {
-                LOS_ArchMmuUnmap(&oldVmSpace->archMmu, vaddr, 1);
-                LOS_ArchMmuMap(&oldVmSpace->archMmu, vaddr, paddr, 1, flags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
-            }
-            LOS_ArchMmuMap(&newVmSpace->archMmu, vaddr, paddr, 1, flags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
+        /* share the whole region copy-on-write, one page table walk and one tlb flush per region */
+        ret = LOS_ArchMmuCowClone(&oldVmSpace->archMmu, &newVmSpace->archMmu, newRegion->range.base,
+                                  newRegion->range.size >> PAGE_SHIFT);
+        if (ret != LOS_OK) {
+            VM_ERR("cow clone region %#x failed", newRegion->range.base);
+            break;
+        }
 
 #ifdef LOSCFG_FS_VFS
-            if (LOS_IsRegionFileValid(oldRegion)) {
-                LosFilePage *fpage = NULL;
-                LOS_SpinLockSave(&oldRegion->unTypeData.rf.vnode->mapping.list_lock, &intSave);
-                fpage = OsFindGetEntry(&oldRegion->unTypeData.rf.vnode->mapping, newRegion->pgOff + i);
-                if ((fpage != NULL) && (fpage->vmPage == page)) { /* cow page no need map */
-                    OsAddMapInfo(fpage, &newVmSpace->archMmu, vaddr);
-                }
-                LOS_SpinUnlockRestore(&oldRegion->unTypeData.rf.vnode->mapping.list_lock, intSave);
-            }
-#endif
+        if (LOS_IsRegionFileValid(oldRegion)) {
+            OsVmRegionFileMapInfoClone(oldRegion, newRegion, newVmSpace);
         }
+#endif
     RB_SCAN_SAFE_END(&oldVmSpace->regionRbTree, pstRbNode, pstRbNodeNext)
     (VOID)LOS_MuxRelease(&oldVmSpace->regionMux);
     return ret;
@@ -678,6 +683,7 @@ LosVmMapRegion *OsVmRegionDup(LosVmSpace *space, LosVmMapRegion *oldRegion, VADD
         newRegion->unTypeData.rf.vmFOps = oldRegion->unTypeData.rf.vmFOps;
         newRegion->unTypeData.rf.vnode = oldRegion->unTypeData.rf.vnode;
         newRegion->unTypeData.rf.f_oflags = oldRegion->unTypeData.rf.f_oflags;
+        OsVmFileRaInit(&newRegion->unTypeData.rf.readAhead);
         VnodeHold();
         newRegion->unTypeData.rf.vnode->useCount++;
         VnodeDrop();
@@ -73,6 +73,7 @@ VOID OsVmPageStartup(VOID)
     paddr_t pa;
     UINT32 nPage;
     INT32 segID;
+    size_t blockTypeSize;
 
     OsVmPhysAreaSizeAdjust(ROUNDUP((g_vmBootMemBase - KERNEL_ASPACE_BASE), PAGE_SIZE));
 
@@ -84,8 +85,9 @@ VOID OsVmPageStartup(VOID)
     nPage = OsVmPhysPageNumGet() * PAGE_SIZE / (sizeof(LosVmPage) + PAGE_SIZE);
     g_vmPageArraySize = nPage * sizeof(LosVmPage);
     g_vmPageArray = (LosVmPage *)OsVmBootMemAlloc(g_vmPageArraySize);
+    blockTypeSize = OsVmPhysBlockTypeAlloc(nPage);
 
-    OsVmPhysAreaSizeAdjust(ROUNDUP(g_vmPageArraySize, PAGE_SIZE));
+    OsVmPhysAreaSizeAdjust(ROUNDUP(g_vmPageArraySize + blockTypeSize, PAGE_SIZE));
 
     OsVmPhysSegAdd();
     OsVmPhysInit();
@@ -35,6 +35,7 @@
 #include "los_vm_map.h"
 #include "los_vm_dump.h"
 #include "los_process_pri.h"
+#include "los_vm_compact.h"
 
 
 #ifdef LOSCFG_KERNEL_VM
@@ -52,6 +53,8 @@ STATIC struct VmPhysArea g_physArea[] = {
 struct VmPhysSeg g_vmPhysSeg[VM_PHYS_SEG_MAX];
 INT32 g_vmPhysSegNum = 0;
 
+STATIC UINT8 *g_vmPhysBlockType = NULL;
+
 LosVmPhysSeg *OsGVmPhysSegGet()
 {
     return g_vmPhysSeg;
@@ -125,26 +128,83 @@ UINT32 OsVmPhysPageNumGet(VOID)
     return nPages;
 }
 
-STATIC INLINE VOID OsVmPhysFreeListInit(struct VmPhysSeg *seg)
+size_t OsVmPhysBlockTypeAlloc(size_t nPages)
+{
+    /* every segment may start and end in the middle of a page block */
+    size_t size = LOS_Align((nPages >> VM_PAGE_BLOCK_ORDER) + (VM_PHYS_SEG_MAX << 1), sizeof(UINTPTR));
+
+    g_vmPhysBlockType = (UINT8 *)OsVmBootMemAlloc(size);
+    return size;
+}
+
+UINT32 OsVmPhysBlockNumGet(struct VmPhysSeg *seg)
+{
+    if (seg->size == 0) {
+        return 0;
+    }
+
+    return ((seg->start + seg->size - 1) >> VM_PAGE_BLOCK_SHIFT) - (seg->start >> VM_PAGE_BLOCK_SHIFT) + 1;
+}
+
+STATIC INLINE UINT8 *OsVmPhysBlockTypePtr(struct VmPhysSeg *seg, LosVmPage *page)
+{
+    return &seg->blockType[(page->physAddr >> VM_PAGE_BLOCK_SHIFT) - (seg->start >> VM_PAGE_BLOCK_SHIFT)];
+}
+
+UINT32 OsVmPhysBlockTypeGet(LosVmPage *page)
+{
+    return *OsVmPhysBlockTypePtr(&g_vmPhysSeg[page->segID], page);
+}
+
+STATIC INLINE VOID OsVmPhysFreeListInit(struct VmPhysSeg *seg, UINT8 *blockType)
 {
     int i;
+    int type;
     UINT32 intSave;
+    UINT32 blockNum = OsVmPhysBlockNumGet(seg);
     struct VmFreeList *list = NULL;
 
     LOS_SpinInit(&seg->freeListLock);
 
     LOS_SpinLockSave(&seg->freeListLock, &intSave);
-    for (i = 0; i < VM_LIST_ORDER_MAX; i++) {
-        list = &seg->freeList[i];
-        LOS_ListInit(&list->node);
-        list->listCnt = 0;
+    for (type = 0; type < VM_MIGRATE_TYPE_MAX; type++) {
+        for (i = 0; i < VM_LIST_ORDER_MAX; i++) {
+            list = &seg->freeList[type][i];
+            LOS_ListInit(&list->node);
+            list->listCnt = 0;
+        }
     }
+    /* unmovable allocations claim page blocks from the movable group on demand */
+    seg->blockType = blockType;
+    (VOID)memset_s(seg->blockType, blockNum, VM_MIGRATE_MOVABLE, blockNum);
     LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
 }
 
+STATIC INLINE VOID OsVmPhysPcpInit(struct VmPhysSeg *seg)
+{
+    struct VmPcpList *pcp = NULL;
+    UINT32 cpuid;
+    UINT32 type;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        pcp = &seg->pcpList[cpuid];
+        LOS_SpinInit(&pcp->lock);
+        for (type = 0; type < VM_MIGRATE_PCP_TYPES; type++) {
+            LOS_ListInit(&pcp->node[type]);
+        }
+        pcp->count = 0;
+        pcp->high = VM_PCP_HIGH_WATERMARK;
+        pcp->low = VM_PCP_LOW_WATERMARK;
+        pcp->batch = VM_PCP_BATCH;
+        pcp->hitCount = 0;
+        pcp->fallbackCount = 0;
+    }
+}
+
 VOID OsVmPhysInit(VOID)
 {
     struct VmPhysSeg *seg = NULL;
+    UINT8 *blockType = g_vmPhysBlockType;
     UINT32 nPages = 0;
     int i;
 
@@ -152,7 +212,9 @@ VOID OsVmPhysInit(VOID)
         seg = &g_vmPhysSeg[i];
         seg->pageBase = &g_vmPageArray[nPages];
         nPages += seg->size >> PAGE_SHIFT;
-        OsVmPhysFreeListInit(seg);
+        OsVmPhysFreeListInit(seg, blockType);
+        blockType += OsVmPhysBlockNumGet(seg);
+        OsVmPhysPcpInit(seg);
         OsVmPhysLruInit(seg);
     }
 }
@@ -169,7 +231,7 @@ STATIC VOID OsVmPhysFreeListAddUnsafe(LosVmPage *page, UINT8 order)
     page->order = order;
     seg = &g_vmPhysSeg[page->segID];
 
-    list = &seg->freeList[order];
+    list = &seg->freeList[*OsVmPhysBlockTypePtr(seg, page)][order];
     LOS_ListTailInsert(&list->node, &page->node);
     list->listCnt++;
 }
@@ -184,7 +246,7 @@ STATIC VOID OsVmPhysFreeListDelUnsafe(LosVmPage *page)
     }
 
     seg = &g_vmPhysSeg[page->segID];
-    list = &seg->freeList[page->order];
+    list = &seg->freeList[*OsVmPhysBlockTypePtr(seg, page)][page->order];
     list->listCnt--;
     LOS_ListDelete(&page->node);
     page->order = VM_LIST_ORDER_MAX;
@@ -203,6 +265,39 @@ STATIC VOID OsVmPhysPagesSpiltUnsafe(LosVmPage *page, UINT8 oldOrder, UINT8 newO
     }
 }
 
+/* Change the migrate type of the page block holding page, moving its free chunks along */
+STATIC VOID OsVmPhysBlockTypeSetUnsafe(struct VmPhysSeg *seg, LosVmPage *page, UINT32 type)
+{
+    UINT8 *blockType = OsVmPhysBlockTypePtr(seg, page);
+    PADDR_T pa = ROUNDDOWN(VM_PAGE_TO_PHYS(page), VM_ORDER_TO_PHYS(VM_PAGE_BLOCK_ORDER));
+    PADDR_T end = pa + VM_ORDER_TO_PHYS(VM_PAGE_BLOCK_ORDER);
+    struct VmFreeList *list = NULL;
+    LosVmPage *tmp = NULL;
+    UINT32 order;
+
+    if (*blockType == type) {
+        return;
+    }
+
+    pa = (pa < seg->start) ? seg->start : pa;
+    end = (end > (seg->start + seg->size)) ? (seg->start + seg->size) : end;
+    for (; pa < end; pa += VM_ORDER_TO_PHYS(order)) {
+        tmp = &seg->pageBase[(pa - seg->start) >> PAGE_SHIFT];
+        order = tmp->order;
+        if (order >= VM_LIST_ORDER_MAX) {
+            order = 0;
+            continue;
+        }
+        list = &seg->freeList[*blockType][order];
+        list->listCnt--;
+        LOS_ListDelete(&tmp->node);
+        list = &seg->freeList[type][order];
+        LOS_ListTailInsert(&list->node, &tmp->node);
+        list->listCnt++;
+    }
+    *blockType = type;
+}
+
 LosVmPage *OsVmPhysToPage(paddr_t pa, UINT8 segID)
 {
     struct VmPhysSeg *seg = NULL;
@@ -275,52 +370,72 @@ STATIC LosVmPage *OsVmPhysLargeAlloc(struct VmPhysSeg *seg, size_t nPages)
     PADDR_T paStart;
     PADDR_T paEnd;
     size_t size = nPages << PAGE_SHIFT;
+    UINT32 type;
+
+    for (type = 0; type < VM_MIGRATE_PCP_TYPES; type++) {
+        list = &seg->freeList[type][VM_LIST_ORDER_MAX - 1];
+        LOS_DL_LIST_FOR_EACH_ENTRY(page, &list->node, LosVmPage, node) {
+            paStart = page->physAddr;
+            paEnd = paStart + size;
+            if (paEnd > (seg->start + seg->size)) {
+                continue;
+            }
 
-    list = &seg->freeList[VM_LIST_ORDER_MAX - 1];
-    LOS_DL_LIST_FOR_EACH_ENTRY(page, &list->node, LosVmPage, node) {
-        paStart = page->physAddr;
-        paEnd = paStart + size;
-        if (paEnd > (seg->start + seg->size)) {
-            continue;
-        }
-
-        for (;;) {
-            paStart += PAGE_SIZE << (VM_LIST_ORDER_MAX - 1);
-            if ((paStart >= paEnd) || (paStart < seg->start) ||
-                (paStart >= (seg->start + seg->size))) {
-                break;
+            for (;;) {
+                paStart += PAGE_SIZE << (VM_LIST_ORDER_MAX - 1);
+                if ((paStart >= paEnd) || (paStart < seg->start) ||
+                    (paStart >= (seg->start + seg->size))) {
+                    break;
+                }
+                tmp = &seg->pageBase[(paStart - seg->start) >> PAGE_SHIFT];
+                if ((tmp->order != (VM_LIST_ORDER_MAX - 1)) ||
+                    (*OsVmPhysBlockTypePtr(seg, tmp) == VM_MIGRATE_ISOLATE)) {
+                    break;
+                }
             }
-            tmp = &seg->pageBase[(paStart - seg->start) >> PAGE_SHIFT];
-            if (tmp->order != (VM_LIST_ORDER_MAX - 1)) {
-                break;
+            if (paStart >= paEnd) {
+                return page;
             }
         }
-        if (paStart >= paEnd) {
-            return page;
-        }
     }
 
     return NULL;
 }
 
-STATIC LosVmPage *OsVmPhysPagesAlloc(struct VmPhysSeg *seg, size_t nPages)
+STATIC LosVmPage *OsVmPhysPagesAlloc(struct VmPhysSeg *seg, size_t nPages, UINT32 type)
 {
     struct VmFreeList *list = NULL;
     LosVmPage *page = NULL;
     LosVmPage *tmp = NULL;
     UINT32 order;
     UINT32 newOrder;
+    UINT32 fallback = (type == VM_MIGRATE_MOVABLE) ? VM_MIGRATE_UNMOVABLE : VM_MIGRATE_MOVABLE;
 
     order = OsVmPagesToOrder(nPages);
     if (order < VM_LIST_ORDER_MAX) {
         for (newOrder = order; newOrder < VM_LIST_ORDER_MAX; newOrder++) {
-            list = &seg->freeList[newOrder];
+            list = &seg->freeList[type][newOrder];
             if (LOS_ListEmpty(&list->node)) {
                 continue;
             }
             page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&list->node), LosVmPage, node);
             goto DONE;
         }
+
+        /* steal from the other group, largest chunk first so that fewer page blocks end up mixed */
+        newOrder = VM_LIST_ORDER_MAX;
+        while (newOrder > order) {
+            newOrder--;
+            list = &seg->freeList[fallback][newOrder];
+            if (LOS_ListEmpty(&list->node)) {
+                continue;
+            }
+            page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&list->node), LosVmPage, node);
+            if (newOrder >= (VM_PAGE_BLOCK_ORDER - 1)) {
+                OsVmPhysBlockTypeSetUnsafe(seg, page, type);
+            }
+            goto DONE;
+        }
     } else {
         newOrder = VM_LIST_ORDER_MAX - 1;
         page = OsVmPhysLargeAlloc(seg, nPages);
@@ -333,6 +448,9 @@ DONE:
 
     for (tmp = page; tmp < &page[nPages]; tmp = &tmp[1 << newOrder]) {
         OsVmPhysFreeListDelUnsafe(tmp);
+        if (newOrder == VM_PAGE_BLOCK_ORDER) {
+            *OsVmPhysBlockTypePtr(seg, tmp) = type;
+        }
     }
     OsVmPhysPagesSpiltUnsafe(page, order, newOrder);
     OsVmRecycleExtraPages(&page[nPages], nPages, ROUNDUP(nPages, (1 << min(order, newOrder))));
@@ -394,7 +512,272 @@ VOID OsVmPhysPagesFreeContiguous(LosVmPage *page, size_t nPages)
     }
 }
 
-STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
+/* Move up to one batch of order-0 pages from the buddy lists to the tail of the per-cpu list */
+STATIC UINT32 OsVmPhysPcpRefillUnsafe(struct VmPhysSeg *seg, struct VmPcpList *pcp, UINT32 type)
+{
+    LosVmPage *page = NULL;
+    UINT32 count = 0;
+
+    LOS_SpinLock(&seg->freeListLock);
+    page = OsVmPhysPagesAlloc(seg, pcp->batch, type);
+    if (page != NULL) {
+        for (count = 0; count < pcp->batch; count++) {
+            LOS_ListTailInsert(&pcp->node[type], &page[count].node);
+        }
+    } else {
+        while (count < pcp->batch) {
+            page = OsVmPhysPagesAlloc(seg, ONE_PAGE, type);
+            if (page == NULL) {
+                break;
+            }
+            LOS_ListTailInsert(&pcp->node[type], &page->node);
+            count++;
+        }
+    }
+    LOS_SpinUnlock(&seg->freeListLock);
+
+    pcp->count += count;
+    return count;
+}
+
+/* Give the coldest pages of the per-cpu list back to the buddy lists */
+STATIC UINT32 OsVmPhysPcpDrainUnsafe(struct VmPhysSeg *seg, struct VmPcpList *pcp, UINT32 nPages)
+{
+    LosVmPage *page = NULL;
+    UINT32 count = 0;
+    UINT32 type;
+
+    LOS_SpinLock(&seg->freeListLock);
+    for (type = 0; type < VM_MIGRATE_PCP_TYPES; type++) {
+        while ((count < nPages) && !LOS_ListEmpty(&pcp->node[type])) {
+            page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_LAST(&pcp->node[type]), LosVmPage, node);
+            LOS_ListDelete(&page->node);
+            OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
+            count++;
+        }
+    }
+    LOS_SpinUnlock(&seg->freeListLock);
+
+    pcp->count -= count;
+    return count;
+}
+
+STATIC size_t OsVmPhysPcpAlloc(struct VmPhysSeg *seg, size_t nPages, LOS_DL_LIST *list, UINT32 type)
+{
+    UINT32 intSave;
+    struct VmPcpList *pcp = NULL;
+    LosVmPage *page = NULL;
+    size_t count = 0;
+
+    intSave = LOS_IntLock();
+    pcp = &seg->pcpList[ArchCurrCpuid()];
+    LOS_SpinLock(&pcp->lock);
+    while (count < nPages) {
+        if (LOS_ListEmpty(&pcp->node[type])) {
+            pcp->fallbackCount++;
+            if (OsVmPhysPcpRefillUnsafe(seg, pcp, type) == 0) {
+                break;
+            }
+        } else {
+            pcp->hitCount++;
+        }
+
+        page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&pcp->node[type]), LosVmPage, node);
+        LOS_ListDelete(&page->node);
+        pcp->count--;
+
+        LOS_AtomicSet(&page->refCounts, 0);
+        page->nPages = ONE_PAGE;
+        if (type == VM_MIGRATE_MOVABLE) {
+            LOS_BitmapSet(&page->flags, VM_PAGE_FLAG_MOVABLE);
+        }
+        LOS_ListTailInsert(list, &page->node);
+        count++;
+    }
+    LOS_SpinUnlock(&pcp->lock);
+    LOS_IntRestore(intSave);
+
+    return count;
+}
+
+STATIC VOID OsVmPhysPcpFree(LosVmPage *page)
+{
+    UINT32 intSave;
+    struct VmPhysSeg *seg = &g_vmPhysSeg[page->segID];
+    struct VmPcpList *pcp = NULL;
+    UINT32 type;
+
+    LOS_BitmapClr(&page->flags, VM_PAGE_FLAG_MOVABLE);
+    intSave = LOS_IntLock();
+    type = *OsVmPhysBlockTypePtr(seg, page);
+    if (type == VM_MIGRATE_ISOLATE) {
+        /* keep pages of a block under compaction out of circulation */
+        LOS_SpinLock(&seg->freeListLock);
+        OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
+        LOS_AtomicSet(&page->refCounts, 0);
+        LOS_SpinUnlock(&seg->freeListLock);
+        LOS_IntRestore(intSave);
+        return;
+    }
+
+    pcp = &seg->pcpList[ArchCurrCpuid()];
+    LOS_SpinLock(&pcp->lock);
+    LOS_AtomicSet(&page->refCounts, 0);
+    LOS_ListAdd(&pcp->node[type], &page->node);
+    pcp->count++;
+    if (pcp->count > pcp->high) {
+        (VOID)OsVmPhysPcpDrainUnsafe(seg, pcp, pcp->count - pcp->low);
+    }
+    LOS_SpinUnlock(&pcp->lock);
+    LOS_IntRestore(intSave);
+}
+
+size_t OsVmPhysPcpDrainAll(VOID)
+{
+    UINT32 intSave;
+    struct VmPhysSeg *seg = NULL;
+    struct VmPcpList *pcp = NULL;
+    size_t count = 0;
+    UINT32 segID;
+    UINT32 cpuid;
+
+    for (segID = 0; segID < g_vmPhysSegNum; segID++) {
+        seg = &g_vmPhysSeg[segID];
+        for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+            pcp = &seg->pcpList[cpuid];
+            LOS_SpinLockSave(&pcp->lock, &intSave);
+            count += OsVmPhysPcpDrainUnsafe(seg, pcp, pcp->count);
+            LOS_SpinUnlockRestore(&pcp->lock, intSave);
+        }
+    }
+
+    return count;
+}
+
+size_t OsVmPhysPcpPagesGet(struct VmPhysSeg *seg)
+{
+    size_t count = 0;
+    UINT32 cpuid;
+
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        count += seg->pcpList[cpuid].count;
+    }
+
+    return count;
+}
+
+VOID OsVmPhysPcpStatGet(struct VmPhysSeg *seg, UINT32 *hitCount, UINT32 *fallbackCount)
+{
+    UINT32 cpuid;
+
+    *hitCount = 0;
+    *fallbackCount = 0;
+    for (cpuid = 0; cpuid < LOSCFG_KERNEL_CORE_NUM; cpuid++) {
+        *hitCount += seg->pcpList[cpuid].hitCount;
+        *fallbackCount += seg->pcpList[cpuid].fallbackCount;
+    }
+}
+
+STATIC size_t OsVmPhysPcpPagesAlloc(size_t nPages, LOS_DL_LIST *list, UINT32 type)
+{
+    size_t count = 0;
+    BOOL drained = FALSE;
+    UINT32 segID;
+
+    while (TRUE) {
+        for (segID = 0; (segID < g_vmPhysSegNum) && (count < nPages); segID++) {
+            count += OsVmPhysPcpAlloc(&g_vmPhysSeg[segID], nPages - count, list, type);
+        }
+        /* the remaining free pages may be parked on other cpus' lists */
+        if ((count == nPages) || drained || (OsVmPhysPcpDrainAll() == 0)) {
+            break;
+        }
+        drained = TRUE;
+    }
+
+    return count;
+}
+
+UINT32 OsVmPhysFreeCntGet(struct VmPhysSeg *seg, UINT32 order)
+{
+    UINT32 count = 0;
+    UINT32 type;
+
+    for (type = 0; type < VM_MIGRATE_TYPE_MAX; type++) {
+        count += seg->freeList[type][order].listCnt;
+    }
+
+    return count;
+}
+
+UINT32 OsVmPhysBlockIsolate(struct VmPhysSeg *seg, LosVmPage *block)
+{
+    UINT32 intSave;
+    UINT32 type;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    type = *OsVmPhysBlockTypePtr(seg, block);
+    OsVmPhysBlockTypeSetUnsafe(seg, block, VM_MIGRATE_ISOLATE);
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+
+    return type;
+}
+
+VOID OsVmPhysBlockUnisolate(struct VmPhysSeg *seg, LosVmPage *block, UINT32 type)
+{
+    UINT32 intSave;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    OsVmPhysBlockTypeSetUnsafe(seg, block, type);
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+}
+
+BOOL OsVmPhysSegAllocable(struct VmPhysSeg *seg, size_t nPages)
+{
+    UINT32 intSave;
+    UINT32 order = OsVmPagesToOrder(nPages);
+    UINT32 type;
+    BOOL ret = FALSE;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    if (order >= VM_LIST_ORDER_MAX) {
+        ret = (OsVmPhysLargeAlloc(seg, nPages) != NULL);
+        goto OUT;
+    }
+
+    for (; order < VM_LIST_ORDER_MAX; order++) {
+        for (type = 0; type < VM_MIGRATE_PCP_TYPES; type++) {
+            if (!LOS_ListEmpty(&seg->freeList[type][order].node)) {
+                ret = TRUE;
+                goto OUT;
+            }
+        }
+    }
+OUT:
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+    return ret;
+}
+
+/* Destination page for compaction, taken straight from buddy so it never comes from an isolated block */
+LosVmPage *OsVmPhysMigratePageGet(struct VmPhysSeg *seg)
+{
+    UINT32 intSave;
+    LosVmPage *page = NULL;
+
+    LOS_SpinLockSave(&seg->freeListLock, &intSave);
+    page = OsVmPhysPagesAlloc(seg, ONE_PAGE, VM_MIGRATE_MOVABLE);
+    LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+    if (page == NULL) {
+        return NULL;
+    }
+
+    LOS_AtomicSet(&page->refCounts, 0);
+    page->nPages = ONE_PAGE;
+    LOS_BitmapSet(&page->flags, VM_PAGE_FLAG_MOVABLE);
+    return page;
+}
+
+STATIC LosVmPage *OsVmPhysBuddyPagesGet(size_t nPages)
 {
     UINT32 intSave;
     struct VmPhysSeg *seg = NULL;
@@ -404,7 +787,7 @@ STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
     for (segID = 0; segID < g_vmPhysSegNum; segID++) {
         seg = &g_vmPhysSeg[segID];
         LOS_SpinLockSave(&seg->freeListLock, &intSave);
-        page = OsVmPhysPagesAlloc(seg, nPages);
+        page = OsVmPhysPagesAlloc(seg, nPages, VM_MIGRATE_UNMOVABLE);
         if (page != NULL) {
             /* the first page of continuous physical addresses holds refCounts */
             LOS_AtomicSet(&page->refCounts, 0);
@@ -417,6 +800,37 @@ STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
     return NULL;
 }
 
+STATIC LosVmPage *OsVmPhysPageGet(UINT32 type)
+{
+    LosVmPage *page = NULL;
+    LOS_DL_LIST_HEAD(list);
+
+    if (OsVmPhysPcpPagesAlloc(ONE_PAGE, &list, type) == 0) {
+        return NULL;
+    }
+    page = LOS_DL_LIST_ENTRY(LOS_DL_LIST_FIRST(&list), LosVmPage, node);
+    LOS_ListDelete(&page->node);
+    return page;
+}
+
+STATIC LosVmPage *OsVmPhysPagesGet(size_t nPages)
+{
+    LosVmPage *page = NULL;
+
+    if (nPages == ONE_PAGE) {
+        return OsVmPhysPageGet(VM_MIGRATE_UNMOVABLE);
+    }
+
+    page = OsVmPhysBuddyPagesGet(nPages);
+    if ((page == NULL) && (OsVmPhysPcpDrainAll() != 0)) {
+        page = OsVmPhysBuddyPagesGet(nPages);
+    }
+    if ((page == NULL) && (OsVmCompact(nPages) != 0)) {
+        page = OsVmPhysBuddyPagesGet(nPages);
+    }
+    return page;
+}
+
 VOID *LOS_PhysPagesAllocContiguous(size_t nPages)
 {
     LosVmPage *page = NULL;
@@ -487,21 +901,12 @@ VADDR_T *LOS_PaddrToKVaddr(PADDR_T paddr)
 
 VOID LOS_PhysPageFree(LosVmPage *page)
 {
-    UINT32 intSave;
-    struct VmPhysSeg *seg = NULL;
-
     if (page == NULL) {
         return;
     }
 
     if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
-        seg = &g_vmPhysSeg[page->segID];
-        LOS_SpinLockSave(&seg->freeListLock, &intSave);
-
-        OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
-        LOS_AtomicSet(&page->refCounts, 0);
-
-        LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+        OsVmPhysPcpFree(page);
     }
 }
 
@@ -510,25 +915,18 @@ LosVmPage *LOS_PhysPageAlloc(VOID)
     return OsVmPhysPagesGet(ONE_PAGE);
 }
 
-size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list)
+LosVmPage *OsVmPhysMovablePageAlloc(VOID)
 {
-    LosVmPage *page = NULL;
-    size_t count = 0;
+    return OsVmPhysPageGet(VM_MIGRATE_MOVABLE);
+}
 
+size_t LOS_PhysPagesAlloc(size_t nPages, LOS_DL_LIST *list)
+{
     if ((list == NULL) || (nPages == 0)) {
         return 0;
     }
 
-    while (nPages--) {
-        page = OsVmPhysPagesGet(ONE_PAGE);
-        if (page == NULL) {
-            break;
-        }
-        LOS_ListTailInsert(list, &page->node);
-        count++;
-    }
-
-    return count;
+    return OsVmPhysPcpPagesAlloc(nPages, list, VM_MIGRATE_UNMOVABLE);
 }
 
 VOID OsPhysSharePageCopy(PADDR_T oldPaddr, PADDR_T *newPaddr, LosVmPage *newPage)
@@ -592,10 +990,8 @@ UINT32 OsVmPagesToOrder(size_t nPages)
 
 size_t LOS_PhysPagesFree(LOS_DL_LIST *list)
 {
-    UINT32 intSave;
     LosVmPage *page = NULL;
     LosVmPage *nPage = NULL;
-    LosVmPhysSeg *seg = NULL;
     size_t count = 0;
 
     if (list == NULL) {
@@ -605,11 +1001,7 @@ size_t LOS_PhysPagesFree(LOS_DL_LIST *list)
     LOS_DL_LIST_FOR_EACH_ENTRY_SAFE(page, nPage, list, LosVmPage, node) {
         LOS_ListDelete(&page->node);
         if (LOS_AtomicDecRet(&page->refCounts) <= 0) {
-            seg = &g_vmPhysSeg[page->segID];
-            LOS_SpinLockSave(&seg->freeListLock, &intSave);
-            OsVmPhysPagesFreeContiguous(page, ONE_PAGE);
-            LOS_AtomicSet(&page->refCounts, 0);
-            LOS_SpinUnlockRestore(&seg->freeListLock, intSave);
+            OsVmPhysPcpFree(page);
         }
         count++;
     }
@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "los_vm_pin.h"
+#include "los_vm_map.h"
+#include "los_vm_fault.h"
+#include "los_vm_phys.h"
+#include "los_vm_common.h"
+#include "los_vm_lock.h"
+#include "los_process_pri.h"
+#include "los_memory.h"
+#include "user_copy.h"
+
+#ifdef LOSCFG_KERNEL_VM
+
+STATIC LosVmPage *OsVmUserPagePin(LosVmSpace *space, VADDR_T vaddr, BOOL write)
+{
+    UINT32 pfFlags = VM_MAP_PF_FLAG_NOT_PRESENT | (write ? VM_MAP_PF_FLAG_WRITE : 0);
+    LosVmMapRegion *region = NULL;
+    LosVmPage *page = NULL;
+    PADDR_T paddr;
+    UINT32 mmuFlags;
+    INT32 tries;
+
+    /* the second round sees the page the fault handler mapped */
+    for (tries = 0; tries < 2; tries++) { /* 2, once before and once after faulting it in */
+        (VOID)LOS_MuxAcquire(&space->regionMux);
+        region = LOS_RegionFind(space, vaddr);
+        if ((region == NULL) || LOS_IsRegionTypeFile(region) || LOS_IsRegionTypeDev(region)) {
+            (VOID)LOS_MuxRelease(&space->regionMux);
+            return NULL;
+        }
+
+        if ((LOS_ArchMmuQuery(&space->archMmu, vaddr, &paddr, &mmuFlags) == LOS_OK) &&
+            (!write || (mmuFlags & VM_MAP_REGION_FLAG_PERM_WRITE))) {
+            page = LOS_VmPageGet(paddr);
+            if (page != NULL) {
+                LOS_AtomicInc(&page->refCounts);
+            }
+            (VOID)LOS_MuxRelease(&space->regionMux);
+            return page;
+        }
+        (VOID)LOS_MuxRelease(&space->regionMux);
+
+        /* demand paging or copy on write, the same work a user access would trigger */
+        if (OsVmPageFaultHandler(vaddr, pfFlags, NULL) != LOS_OK) {
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+STATUS_T LOS_VmUserPin(LosVmUserPin *pin, VADDR_T uaddr, size_t len, BOOL write)
+{
+    LosVmSpace *space = OsCurrProcessGet()->vmSpace;
+    VADDR_T vaddr = ROUNDDOWN(uaddr, PAGE_SIZE);
+    VADDR_T end;
+    LosVmPage *page = NULL;
+
+    pin->uaddr = uaddr;
+    pin->len = 0;
+    pin->count = 0;
+    if ((len == 0) || !LOS_IsUserAddressRange(uaddr, len)) {
+        return LOS_ERRNO_VM_INVALID_ARGS;
+    }
+
+    end = ROUNDUP(uaddr + len, PAGE_SIZE);
+    if (((end - vaddr) >> PAGE_SHIFT) > VM_PIN_BATCH_PAGES) {
+        end = vaddr + (VM_PIN_BATCH_PAGES << PAGE_SHIFT);
+    }
+
+    for (; vaddr < end; vaddr += PAGE_SIZE) {
+        page = OsVmUserPagePin(space, vaddr, write);
+        if (page == NULL) {
+            break;
+        }
+        pin->pages[pin->count++] = page;
+    }
+
+    if (pin->count == 0) {
+        return LOS_ERRNO_VM_NOT_FOUND;
+    }
+
+    pin->len = min(((size_t)pin->count << PAGE_SHIFT) - (uaddr & (PAGE_SIZE - 1)), len);
+    return LOS_OK;
+}
+
+VOID LOS_VmUserUnpin(LosVmUserPin *pin)
+{
+    UINT32 i;
+
+    for (i = 0; i < pin->count; i++) {
+        LOS_PhysPageFree(pin->pages[i]);
+    }
+    pin->count = 0;
+    pin->len = 0;
+}
+
+VOID *LOS_VmUserPinKvaddr(const LosVmUserPin *pin, size_t off, size_t *runLen)
+{
+    size_t pageOff = (pin->uaddr & (PAGE_SIZE - 1)) + off;
+    UINT32 index = pageOff >> PAGE_SHIFT;
+    PADDR_T paddr = VM_PAGE_TO_PHYS(pin->pages[index]);
+    UINT32 next = index + 1;
+
+    while ((next < pin->count) &&
+           (VM_PAGE_TO_PHYS(pin->pages[next]) == (paddr + ((PADDR_T)(next - index) << PAGE_SHIFT)))) {
+        next++;
+    }
+
+    *runLen = min(((size_t)next << PAGE_SHIFT) - pageOff, pin->len - off);
+    return (CHAR *)LOS_PaddrToKVaddr(paddr) + (pageOff & (PAGE_SIZE - 1));
+}
+
+STATIC ssize_t OsVmUserPinIo(LosVmUserPin *pin, size_t pos, LosVmUserIoFn io, VOID *arg)
+{
+    size_t off = 0;
+    size_t runLen;
+    VOID *kbuf = NULL;
+    ssize_t ret;
+
+    while (off < pin->len) {
+        kbuf = LOS_VmUserPinKvaddr(pin, off, &runLen);
+        ret = io(arg, kbuf, runLen, pos + off);
+        if (ret < 0) {
+            return (off > 0) ? (ssize_t)off : ret;
+        }
+        off += (size_t)ret;
+        if ((size_t)ret < runLen) {
+            break;
+        }
+    }
+
+    return (ssize_t)off;
+}
+
+STATIC ssize_t OsVmUserBounceIo(CHAR *ubuf, size_t len, BOOL toUser, CHAR *bounce, size_t pos,
+                                LosVmUserIoFn io, VOID *arg)
+{
+    ssize_t ret;
+
+    if (!toUser && (LOS_ArchCopyFromUser(bounce, ubuf, len) != 0)) {
+        return -EFAULT;
+    }
+
+    ret = io(arg, bounce, len, pos);
+    if (toUser && (ret > 0) && (LOS_ArchCopyToUser(ubuf, bounce, ret) != 0)) {
+        return -EFAULT;
+    }
+
+    return ret;
+}
+
+ssize_t LOS_VmUserBufIo(VOID *buf, size_t len, BOOL toUser, LosVmUserIoFn io, VOID *arg)
+{
+    CHAR *ubuf = (CHAR *)buf;
+    CHAR *bounce = NULL;
+    LosVmUserPin pin;
+    size_t done = 0;
+    size_t chunk;
+    ssize_t ret = 0;
+
+    if (!LOS_IsUserAddressRange((VADDR_T)(UINTPTR)buf, len)) {
+        return io(arg, buf, len, 0);
+    }
+
+    while (done < len) {
+        if (LOS_VmUserPin(&pin, (VADDR_T)(UINTPTR)(ubuf + done), len - done, toUser) == LOS_OK) {
+            chunk = pin.len;
+            ret = OsVmUserPinIo(&pin, done, io, arg);
+            LOS_VmUserUnpin(&pin);
+        } else {
+            chunk = min(len - done, VM_PIN_BOUNCE_SIZE);
+            if (bounce == NULL) {
+                bounce = (CHAR *)LOS_MemAlloc(OS_SYS_MEM_ADDR, min(len, VM_PIN_BOUNCE_SIZE));
+                if (bounce == NULL) {
+                    ret = -ENOMEM;
+                    break;
+                }
+            }
+            ret = OsVmUserBounceIo(ubuf + done, chunk, toUser, bounce, done, io, arg);
+        }
+
+        if (ret < 0) {
+            break;
+        }
+        done += (size_t)ret;
+        if ((size_t)ret < chunk) {
+            break;
+        }
+    }
+
+    if (bounce != NULL) {
+        (VOID)LOS_MemFree(OS_SYS_MEM_ADDR, bounce);
+    }
+    return ((done > 0) || (ret >= 0)) ? (ssize_t)done : ret;
+}
+
+#endif
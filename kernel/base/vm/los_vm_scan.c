@@ -47,7 +47,7 @@ VOID OsUnmapPageLocked(LosFilePage *page, LosMapInfo *info)
     LOS_ListDelete(&info->node);
     LOS_AtomicDec(&page->vmPage->refCounts);
     LOS_ArchMmuUnmap(info->archMmu, info->vaddr, 1);
-    LOS_MemFree(m_aucSysMem0, info);
+    (VOID)LOS_KmemCacheFree(g_mapInfoCache, info);
 }
 
 VOID OsUnmapAllLocked(LosFilePage *page)
@@ -305,6 +305,8 @@ int OsTryShrinkMemory(size_t nPage)
         nPage = VM_FILEMAP_MAX_SCAN;
     }
 
+    (VOID)OsVmPhysPcpDrainAll();
+
     for (index = 0; index < g_vmPhysSegNum; index++) {
         physSeg = &g_vmPhysSeg[index];
         LOS_SpinLockSave(&physSeg->lruLock, &intSave);
@@ -335,6 +337,7 @@ int OsTryShrinkMemory(size_t nPage)
 #else
 int OsTryShrinkMemory(size_t nPage)
 {
+    (VOID)OsVmPhysPcpDrainAll();
     return 0;
 }
 #endif
@@ -272,6 +272,14 @@ extern UINT32 __heap_end;
 #define LOSCFG_BASE_IPC_MUX
 #endif
 
+/**
+ * @ingroup los_config
+ * Times a contended mutex locker polls the owner running on another core before it pends, 0 disables spinning
+ */
+#ifndef LOSCFG_BASE_IPC_MUX_SPIN_COUNT
+#define LOSCFG_BASE_IPC_MUX_SPIN_COUNT 100
+#endif
+
 /****************************** rwlock module configuration ******************************/
 /**
  * @ingroup los_config
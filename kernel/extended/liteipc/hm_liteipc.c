@@ -63,9 +63,21 @@
 #define LITEIPC_TIMEOUT_MS 5000UL
 #define LITEIPC_TIMEOUT_NS 5000000000ULL
 
+#define IPC_RING_SLOT_SIZE 512
+#define IPC_RING_SLOT_MIN_NUM 4
+#define IPC_RING_POOL_SHIFT 2 /* a quarter of the pool is given to the ring */
+#define IPC_PTR_LEND_MIN_SIZE (4 * PAGE_SIZE)
+
+typedef enum {
+    IPC_SLOT_FREE,
+    IPC_SLOT_KERNEL, /* being filled, queued or rolled back by the kernel */
+    IPC_SLOT_USER    /* delivered, given back by BUFF_FREE */
+} IpcSlotState;
+
 typedef struct {
     LOS_DL_LIST list;
     VOID *ptr;
+    BOOL isLent; /* ptr is a receiver region mapping the sender's pages, not a pool buffer */
 } IpcUsedNode;
 
 STATIC LosMux g_serviceHandleMapMux;
@@ -192,6 +204,43 @@ LITE_OS_SEC_TEXT STATIC INT32 DoIpcMmap(LosProcessCB *pcb, LosVmMapRegion *regio
     return ret;
 }
 
+LITE_OS_SEC_TEXT STATIC VOID LiteIpcRingInit(ProcIpcInfo *ipcInfo)
+{
+    IpcRing *ring = &ipcInfo->ring;
+    UINT32 slotNum = (ipcInfo->pool.poolSize >> IPC_RING_POOL_SHIFT) / IPC_RING_SLOT_SIZE;
+
+    /* small pools keep every message in the heap */
+    if (slotNum < IPC_RING_SLOT_MIN_NUM) {
+        return;
+    }
+    ring->slotState = (UINT8 *)LOS_MemAlloc(m_aucSysMem1, slotNum);
+    if (ring->slotState == NULL) {
+        return;
+    }
+    ring->kvaddr = LOS_MemAlloc(ipcInfo->pool.kvaddr, slotNum * IPC_RING_SLOT_SIZE);
+    if (ring->kvaddr == NULL) {
+        (VOID)LOS_MemFree(m_aucSysMem1, ring->slotState);
+        ring->slotState = NULL;
+        return;
+    }
+    (VOID)memset_s(ring->slotState, slotNum, IPC_SLOT_FREE, slotNum);
+    ring->head = 0;
+    ring->slotNum = slotNum;
+    ring->freeNum = slotNum;
+}
+
+LITE_OS_SEC_TEXT STATIC VOID LiteIpcRingDeinit(IpcRing *ring)
+{
+    if (ring->slotState != NULL) {
+        (VOID)LOS_MemFree(m_aucSysMem1, ring->slotState);
+    }
+    ring->slotState = NULL;
+    ring->kvaddr = NULL;
+    ring->slotNum = 0;
+    ring->freeNum = 0;
+    ring->head = 0;
+}
+
 LITE_OS_SEC_TEXT STATIC int LiteIpcMmap(struct file *filep, LosVmMapRegion *region)
 {
     int ret = 0;
@@ -235,6 +284,7 @@ LITE_OS_SEC_TEXT STATIC int LiteIpcMmap(struct file *filep, LosVmMapRegion *regi
         goto ERROR_MAP_OUT;
     }
     ipcInfo->pool.poolSize = region->range.size;
+    LiteIpcRingInit(ipcInfo);
     return 0;
 ERROR_MAP_OUT:
     LOS_VFree(ipcInfo->pool.kvaddr);
@@ -290,6 +340,7 @@ STATIC VOID LiteIpcPoolDelete(ProcIpcInfo *ipcInfo, UINT32 processID)
     if (ipcInfo->pool.kvaddr != NULL) {
         LOS_VFree(ipcInfo->pool.kvaddr);
         ipcInfo->pool.kvaddr = NULL;
+        LiteIpcRingDeinit(&ipcInfo->ring);
         IPC_LOCK(intSave);
         while (!LOS_ListEmpty(&ipcInfo->ipcUsedNodelist)) {
             node = LOS_DL_LIST_ENTRY(ipcInfo->ipcUsedNodelist.pstNext, IpcUsedNode, list);
@@ -335,51 +386,143 @@ LITE_OS_SEC_TEXT_INIT STATIC IpcTaskInfo *LiteIpcTaskInit(VOID)
     return taskInfo;
 }
 
-/* Only when kernenl no longer access ipc node content, can user free the ipc node */
-LITE_OS_SEC_TEXT STATIC VOID EnableIpcNodeFreeByUser(UINT32 processID, VOID *buf)
+LITE_OS_SEC_TEXT STATIC INT32 LiteIpcRingSlotGet(const IpcRing *ring, const VOID *buf)
+{
+    UINTPTR offset = (UINTPTR)buf - (UINTPTR)ring->kvaddr;
+
+    if ((ring->slotNum == 0) || ((UINTPTR)buf < (UINTPTR)ring->kvaddr) ||
+        (offset >= (ring->slotNum * IPC_RING_SLOT_SIZE)) || ((offset % IPC_RING_SLOT_SIZE) != 0)) {
+        return INVAILD_ID;
+    }
+    return (INT32)(offset / IPC_RING_SLOT_SIZE);
+}
+
+/*
+ * Slots are handed out in order from head, skipping the ones a receiver still holds. Only a sender
+ * finding no free slot at all falls back to the pool heap.
+ */
+LITE_OS_SEC_TEXT STATIC VOID *LiteIpcRingAlloc(IpcRing *ring, UINT32 size)
+{
+    UINT32 intSave;
+    UINT32 slot;
+    UINT32 i;
+    VOID *ptr = NULL;
+
+    if ((ring->slotNum == 0) || (size > IPC_RING_SLOT_SIZE)) {
+        return NULL;
+    }
+    IPC_LOCK(intSave);
+    for (i = 0; (ring->freeNum > 0) && (i < ring->slotNum); i++) {
+        slot = (ring->head + i) % ring->slotNum;
+        if (ring->slotState[slot] == IPC_SLOT_FREE) {
+            ring->slotState[slot] = IPC_SLOT_KERNEL;
+            ring->freeNum--;
+            ring->head = (slot + 1) % ring->slotNum;
+            ptr = (VOID *)((UINTPTR)ring->kvaddr + slot * IPC_RING_SLOT_SIZE);
+            break;
+        }
+    }
+    IPC_UNLOCK(intSave);
+    return ptr;
+}
+
+LITE_OS_SEC_TEXT STATIC VOID IpcUsedNodeAdd(ProcIpcInfo *ipcInfo, VOID *buf, BOOL isLent)
 {
     UINT32 intSave;
-    ProcIpcInfo *ipcInfo = OS_PCB_FROM_PID(processID)->ipcInfo;
     IpcUsedNode *node = (IpcUsedNode *)malloc(sizeof(IpcUsedNode));
     if (node != NULL) {
         node->ptr = buf;
+        node->isLent = isLent;
         IPC_LOCK(intSave);
         LOS_ListAdd(&ipcInfo->ipcUsedNodelist, &node->list);
         IPC_UNLOCK(intSave);
     }
 }
 
+LITE_OS_SEC_TEXT STATIC BOOL IpcUsedNodeRemove(ProcIpcInfo *ipcInfo, const VOID *buf, BOOL isLent)
+{
+    IpcUsedNode *node = NULL;
+    UINT32 intSave;
+    IPC_LOCK(intSave);
+    LOS_DL_LIST_FOR_EACH_ENTRY(node, &ipcInfo->ipcUsedNodelist, IpcUsedNode, list) {
+        if ((node->ptr == buf) && (node->isLent == isLent)) {
+            LOS_ListDelete(&node->list);
+            IPC_UNLOCK(intSave);
+            free(node);
+            return TRUE;
+        }
+    }
+    IPC_UNLOCK(intSave);
+    return FALSE;
+}
+
+/* Only when kernenl no longer access ipc node content, can user free the ipc node */
+LITE_OS_SEC_TEXT STATIC VOID EnableIpcNodeFreeByUser(UINT32 processID, VOID *buf)
+{
+    UINT32 intSave;
+    ProcIpcInfo *ipcInfo = OS_PCB_FROM_PID(processID)->ipcInfo;
+    INT32 slot = LiteIpcRingSlotGet(&ipcInfo->ring, buf);
+    if (slot != INVAILD_ID) {
+        IPC_LOCK(intSave);
+        ipcInfo->ring.slotState[slot] = IPC_SLOT_USER;
+        IPC_UNLOCK(intSave);
+        return;
+    }
+    IpcUsedNodeAdd(ipcInfo, buf, FALSE);
+}
+
 LITE_OS_SEC_TEXT STATIC VOID *LiteIpcNodeAlloc(UINT32 processID, UINT32 size)
 {
-    VOID *ptr = LOS_MemAlloc(OS_PCB_FROM_PID(processID)->ipcInfo->pool.kvaddr, size);
-    PRINT_INFO("LiteIpcNodeAlloc pid:%d, pool:%x buf:%x size:%d\n",
-               processID, OS_PCB_FROM_PID(processID)->ipcInfo->pool.kvaddr, ptr, size);
+    ProcIpcInfo *ipcInfo = OS_PCB_FROM_PID(processID)->ipcInfo;
+    VOID *ptr = LiteIpcRingAlloc(&ipcInfo->ring, size);
+    if (ptr == NULL) {
+        ptr = LOS_MemAlloc(ipcInfo->pool.kvaddr, size);
+    }
     return ptr;
 }
 
 LITE_OS_SEC_TEXT STATIC UINT32 LiteIpcNodeFree(UINT32 processID, VOID *buf)
 {
+    UINT32 intSave;
+    ProcIpcInfo *ipcInfo = OS_PCB_FROM_PID(processID)->ipcInfo;
+    INT32 slot = LiteIpcRingSlotGet(&ipcInfo->ring, buf);
     PRINT_INFO("LiteIpcNodeFree pid:%d, pool:%x buf:%x\n",
-               processID, OS_PCB_FROM_PID(processID)->ipcInfo->pool.kvaddr, buf);
-    return LOS_MemFree(OS_PCB_FROM_PID(processID)->ipcInfo->pool.kvaddr, buf);
+               processID, ipcInfo->pool.kvaddr, buf);
+    if (slot != INVAILD_ID) {
+        IPC_LOCK(intSave);
+        if (ipcInfo->ring.slotState[slot] != IPC_SLOT_FREE) {
+            ipcInfo->ring.slotState[slot] = IPC_SLOT_FREE;
+            ipcInfo->ring.freeNum++;
+        }
+        IPC_UNLOCK(intSave);
+        return LOS_OK;
+    }
+    return LOS_MemFree(ipcInfo->pool.kvaddr, buf);
 }
 
 LITE_OS_SEC_TEXT STATIC BOOL IsIpcNode(UINT32 processID, const VOID *buf)
 {
-    IpcUsedNode *node = NULL;
     UINT32 intSave;
+    BOOL ret = FALSE;
     ProcIpcInfo *ipcInfo = OS_PCB_FROM_PID(processID)->ipcInfo;
+    INT32 slot = LiteIpcRingSlotGet(&ipcInfo->ring, buf);
+    if (slot == INVAILD_ID) {
+        return IpcUsedNodeRemove(ipcInfo, buf, FALSE);
+    }
+    /* the slot goes back to the kernel so a second BUFF_FREE of it fails */
     IPC_LOCK(intSave);
-    LOS_DL_LIST_FOR_EACH_ENTRY(node, &ipcInfo->ipcUsedNodelist, IpcUsedNode, list) {
-        if (node->ptr == buf) {
-            LOS_ListDelete(&node->list);
-            IPC_UNLOCK(intSave);
-            free(node);
-            return TRUE;
-        }
+    if (ipcInfo->ring.slotState[slot] == IPC_SLOT_USER) {
+        ipcInfo->ring.slotState[slot] = IPC_SLOT_KERNEL;
+        ret = TRUE;
     }
     IPC_UNLOCK(intSave);
-    return FALSE;
+    return ret;
+}
+
+LITE_OS_SEC_TEXT STATIC BOOL IsIpcPoolAddr(UINT32 processID, const VOID *uaddr)
+{
+    IpcPool *pool = &OS_PCB_FROM_PID(processID)->ipcInfo->pool;
+    return ((UINTPTR)uaddr >= (UINTPTR)pool->uvaddr) && ((UINTPTR)uaddr < ((UINTPTR)pool->uvaddr + pool->poolSize));
 }
 
 LITE_OS_SEC_TEXT STATIC INTPTR GetIpcUserAddr(UINT32 processID, INTPTR kernelAddr)
@@ -396,15 +539,146 @@ LITE_OS_SEC_TEXT STATIC INTPTR GetIpcKernelAddr(UINT32 processID, INTPTR userAdd
     return userAddr - offset;
 }
 
+LITE_OS_SEC_TEXT STATIC BOOL IsPageLendable(const LosVmMapRegion *region, VADDR_T vaddr, UINT32 size)
+{
+    if ((region == NULL) || (vaddr < region->range.base) ||
+        ((vaddr + size) > (region->range.base + region->range.size)) ||
+        ((region->regionFlags & VM_MAP_REGION_FLAG_PERM_USER) == 0) ||
+        ((region->regionFlags & (VM_MAP_REGION_FLAG_SHARED | VM_MAP_REGION_FLAG_SHM)) != 0) ||
+        LOS_IsRegionTypeFile((LosVmMapRegion *)region) || LOS_IsRegionTypeDev((LosVmMapRegion *)region)) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * Map the sender's pages read only into the receiver instead of copying them. The sender's
+ * mapping is write protected, so a later write by either side takes the copy on write fault.
+ * A partial tail page is copied so nothing past buffSz is exposed. Returns the receiver address.
+ */
+LITE_OS_SEC_TEXT STATIC VOID *LiteIpcPagesLend(UINT32 processID, const VOID *buff, UINT32 size)
+{
+    LosVmSpace *srcSpace = OsCurrProcessGet()->vmSpace;
+    LosVmSpace *dstSpace = OS_PCB_FROM_PID(processID)->vmSpace;
+    UINT32 dstFlags = VM_MAP_REGION_FLAG_PERM_USER | VM_MAP_REGION_FLAG_PERM_READ;
+    VADDR_T src = (VADDR_T)(UINTPTR)buff;
+    UINT32 count = ROUNDUP(size, PAGE_SIZE) >> PAGE_SHIFT;
+    UINT32 shareCount = size >> PAGE_SHIFT;
+    UINT32 tail = size & (PAGE_SIZE - 1);
+    LosVmMapRegion *region = NULL;
+    LosVmPage *page = NULL;
+    PADDR_T *paddrs = NULL;
+    VOID *uaddr = NULL;
+    UINT32 i;
+
+    if ((size < IPC_PTR_LEND_MIN_SIZE) || !IS_PAGE_ALIGNED(src) || (srcSpace == dstSpace)) {
+        return NULL;
+    }
+    paddrs = (PADDR_T *)LOS_MemAlloc(m_aucSysMem1, count * sizeof(PADDR_T));
+    if (paddrs == NULL) {
+        return NULL;
+    }
+
+    (VOID)LOS_MuxAcquire(&srcSpace->regionMux);
+    region = LOS_RegionRangeFind(srcSpace, src, size);
+    if (!IsPageLendable(region, src, size)) {
+        goto ERROR_SRC;
+    }
+    for (i = 0; i < count; i++) {
+        if (LOS_ArchMmuQuery(&srcSpace->archMmu, src + (i << PAGE_SHIFT), &paddrs[i], NULL) != LOS_OK) {
+            goto ERROR_SRC;
+        }
+        page = LOS_VmPageGet(paddrs[i]);
+        if ((page == NULL) || OsIsPageShared(page)) {
+            goto ERROR_SRC;
+        }
+    }
+    if (tail != 0) {
+        page = LOS_PhysPageAlloc();
+        if (page == NULL) {
+            goto ERROR_SRC;
+        }
+        LOS_AtomicInc(&page->refCounts);
+        (VOID)memcpy_s(LOS_PaddrToKVaddr(VM_PAGE_TO_PHYS(page)), PAGE_SIZE, LOS_PaddrToKVaddr(paddrs[shareCount]), tail);
+        (VOID)memset_s((CHAR *)LOS_PaddrToKVaddr(VM_PAGE_TO_PHYS(page)) + tail, PAGE_SIZE - tail, 0, PAGE_SIZE - tail);
+        paddrs[shareCount] = VM_PAGE_TO_PHYS(page);
+    }
+    for (i = 0; i < shareCount; i++) {
+        LOS_AtomicInc(&LOS_VmPageGet(paddrs[i])->refCounts);
+    }
+    if ((shareCount != 0) && (region->regionFlags & VM_MAP_REGION_FLAG_PERM_WRITE)) {
+        (VOID)LOS_ArchMmuChangeProt(&srcSpace->archMmu, src, shareCount,
+                                    region->regionFlags & ~VM_MAP_REGION_FLAG_PERM_WRITE);
+    }
+    (VOID)LOS_MuxRelease(&srcSpace->regionMux);
+
+    (VOID)LOS_MuxAcquire(&dstSpace->regionMux);
+    region = LOS_RegionAlloc(dstSpace, 0, count << PAGE_SHIFT, dstFlags, 0);
+    if (region == NULL) {
+        (VOID)LOS_MuxRelease(&dstSpace->regionMux);
+        goto ERROR_DST;
+    }
+    LOS_SetRegionTypeAnon(region);
+    for (i = 0; i < count; i++) {
+        if (LOS_ArchMmuMap(&dstSpace->archMmu, region->range.base + (i << PAGE_SHIFT), paddrs[i], 1, dstFlags) < 0) {
+            break;
+        }
+    }
+    if (i != count) {
+        /* the mapped pages are dropped by the region, the rest here */
+        (VOID)LOS_RegionFree(dstSpace, region);
+        (VOID)LOS_MuxRelease(&dstSpace->regionMux);
+        while (i < count) {
+            LOS_PhysPageFree(LOS_VmPageGet(paddrs[i]));
+            i++;
+        }
+        goto OUT;
+    }
+    uaddr = (VOID *)(UINTPTR)region->range.base;
+    (VOID)LOS_MuxRelease(&dstSpace->regionMux);
+    IpcUsedNodeAdd(OS_PCB_FROM_PID(processID)->ipcInfo, uaddr, TRUE);
+    goto OUT;
+
+ERROR_DST:
+    for (i = 0; i < count; i++) {
+        LOS_PhysPageFree(LOS_VmPageGet(paddrs[i]));
+    }
+    goto OUT;
+ERROR_SRC:
+    (VOID)LOS_MuxRelease(&srcSpace->regionMux);
+OUT:
+    (VOID)LOS_MemFree(m_aucSysMem1, paddrs);
+    return uaddr;
+}
+
+LITE_OS_SEC_TEXT STATIC UINT32 LiteIpcPagesReturn(UINT32 processID, const VOID *uaddr)
+{
+    LosVmSpace *space = OS_PCB_FROM_PID(processID)->vmSpace;
+    LosVmMapRegion *region = NULL;
+
+    if (IpcUsedNodeRemove(OS_PCB_FROM_PID(processID)->ipcInfo, uaddr, TRUE) == FALSE) {
+        return -EINVAL;
+    }
+    (VOID)LOS_MuxAcquire(&space->regionMux);
+    region = LOS_RegionFind(space, (VADDR_T)(UINTPTR)uaddr);
+    if ((region != NULL) && (region->range.base == (VADDR_T)(UINTPTR)uaddr)) {
+        (VOID)LOS_RegionFree(space, region);
+    }
+    (VOID)LOS_MuxRelease(&space->regionMux);
+    return LOS_OK;
+}
+
 LITE_OS_SEC_TEXT STATIC UINT32 CheckUsedBuffer(const VOID *node, IpcListNode **outPtr)
 {
     VOID *ptr = NULL;
     LosProcessCB *pcb = OsCurrProcessGet();
-    IpcPool pool = pcb->ipcInfo->pool;
-    if ((node == NULL) || ((INTPTR)node < (INTPTR)(pool.uvaddr)) ||
-        ((INTPTR)node > (INTPTR)(pool.uvaddr) + pool.poolSize)) {
+    if (node == NULL) {
         return -EINVAL;
     }
+    if (IsIpcPoolAddr(pcb->processID, node) == FALSE) {
+        /* lent pages are unmapped at once, nothing is left for the caller to free */
+        return LiteIpcPagesReturn(pcb->processID, node);
+    }
     ptr = (VOID *)GetIpcKernelAddr(pcb->processID, (INTPTR)(node));
     if (IsIpcNode(pcb->processID, ptr) != TRUE) {
         return -EFAULT;
@@ -740,6 +1014,11 @@ LITE_OS_SEC_TEXT STATIC UINT32 HandlePtr(UINT32 processID, SpecialObj *obj, BOOL
             PRINT_ERR("Liteipc Bad ptr address\n");
             return -EINVAL;
         }
+        buf = LiteIpcPagesLend(processID, obj->content.ptr.buff, obj->content.ptr.buffSz);
+        if (buf != NULL) {
+            obj->content.ptr.buff = buf;
+            return LOS_OK;
+        }
         buf = LiteIpcNodeAlloc(processID, obj->content.ptr.buffSz);
         if (buf == NULL) {
             PRINT_ERR("Liteipc DealPtr alloc mem failed\n");
@@ -752,6 +1031,8 @@ LITE_OS_SEC_TEXT STATIC UINT32 HandlePtr(UINT32 processID, SpecialObj *obj, BOOL
         }
         obj->content.ptr.buff = (VOID *)GetIpcUserAddr(processID, (INTPTR)buf);
         EnableIpcNodeFreeByUser(processID, (VOID *)buf);
+    } else if (IsIpcPoolAddr(processID, obj->content.ptr.buff) == FALSE) {
+        (VOID)LiteIpcPagesReturn(processID, obj->content.ptr.buff);
     } else {
         (VOID)LiteIpcNodeFree(processID, (VOID *)GetIpcKernelAddr(processID, (INTPTR)obj->content.ptr.buff));
     }
@@ -925,6 +1206,9 @@ LITE_OS_SEC_TEXT STATIC BOOL IsValidReply(const IpcContent *content)
     IpcMsg *requestMsg = &node->msg;
     IpcMsg *replyMsg = content->outMsg;
     UINT32 reqDstTid = 0;
+    if (IsIpcPoolAddr(curProcessID, content->buffToFree) == FALSE) {
+        return FALSE;
+    }
     /* Check whether the reply matches the request */
     if ((requestMsg->type != MT_REQUEST)  ||
         (requestMsg->flag == LITEIPC_FLAG_ONEWAY) ||
@@ -1054,9 +1338,18 @@ LITE_OS_SEC_TEXT STATIC UINT32 LiteIpcWrite(IpcContent *content)
     OsHookCall(LOS_HOOK_TYPE_IPC_WRITE, &buf->msg, dstTid, tcb->processID, tcb->waitFlag);
     if (tcb->waitFlag == OS_TASK_WAIT_LITEIPC) {
         OsTaskWakeClearPendMask(tcb);
-        tcb->ops->wake(tcb);
+        if (((content->flag & RECV) == RECV) || (msg->type == MT_REPLY) || (msg->type == MT_FAILED_REPLY)) {
+            /* the other side of a call is switched to on this cpu once the sender waits */
+            OsSchedHandoffWake(tcb);
+        } else {
+            tcb->ops->wake(tcb);
+        }
         SCHEDULER_UNLOCK(intSave);
-        LOS_MpSchedule(OS_MP_CPU_ALL);
+        /* the handoff falls back to a plain wake that may have to kick another cpu */
+        OsSchedPreemptTargetNotify();
+        if ((content->flag & RECV) == RECV) {
+            return LOS_OK;
+        }
         LOS_Schedule();
     } else {
         SCHEDULER_UNLOCK(intSave);
@@ -1243,6 +1536,33 @@ BUFFER_FREE:
     return ret;
 }
 
+LITE_OS_SEC_TEXT STATIC UINT32 LiteIpcBatchHandle(IpcBatchContent *batch)
+{
+    UINT32 ret = LOS_OK;
+    IpcBatchContent localBatch;
+    UINT32 i;
+
+    if (copy_from_user((void *)(&localBatch), (const void *)batch, sizeof(IpcBatchContent)) != LOS_OK) {
+        PRINT_ERR("%s, %d\n", __FUNCTION__, __LINE__);
+        return -EINVAL;
+    }
+    if ((localBatch.num == 0) || (localBatch.num > IPC_BATCH_NUM_MAX) || (localBatch.contents == NULL)) {
+        return -EINVAL;
+    }
+    for (i = 0; i < localBatch.num; i++) {
+        ret = LiteIpcMsgHandle(&localBatch.contents[i]);
+        if (ret != LOS_OK) {
+            break;
+        }
+    }
+    localBatch.done = i;
+    if (copy_to_user((void *)(&batch->done), (const void *)(&localBatch.done), sizeof(UINT32)) != LOS_OK) {
+        PRINT_ERR("%s, %d\n", __FUNCTION__, __LINE__);
+        return -EINVAL;
+    }
+    return ret;
+}
+
 LITE_OS_SEC_TEXT STATIC UINT32 HandleCmsCmd(CmsCmdContent *content)
 {
     UINT32 ret = LOS_OK;
@@ -1328,6 +1648,15 @@ LITE_OS_SEC_TEXT int LiteIpcIoctl(struct file *filep, int cmd, unsigned long arg
                 return (INT32)ret;
             }
             break;
+        case IPC_SEND_RECV_BATCH:
+            if (arg == 0) {
+                return -EINVAL;
+            }
+            if (IsCmsSet() == FALSE) {
+                PRINT_ERR("Liteipc ServiceManager not set!\n");
+                return -EINVAL;
+            }
+            return (INT32)LiteIpcBatchHandle((IpcBatchContent *)(UINTPTR)arg);
         default:
             PRINT_ERR("Unknow liteipc ioctl cmd:%d\n", cmd);
             return -EINVAL;
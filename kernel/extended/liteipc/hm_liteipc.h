@@ -66,8 +66,17 @@ typedef struct {
     UINT32 poolSize;
 } IpcPool;
 
+typedef struct {
+    VOID   *kvaddr;    /* fixed size message slots carved from the pool */
+    UINT8  *slotState;
+    UINT32 slotNum;
+    UINT32 freeNum;    /* slots in IPC_SLOT_FREE */
+    UINT32 head;       /* where the search for a free slot starts */
+} IpcRing;
+
 typedef struct {
     IpcPool pool;
+    IpcRing ring;
     UINT32 ipcTaskID;
     LOS_DL_LIST ipcUsedNodelist;
     UINT32 access[LOSCFG_BASE_CORE_TSK_LIMIT];
@@ -120,6 +129,7 @@ typedef enum {
 #define IPC_CMS_CMD         _IOWR(IPC_IOC_MAGIC, 2, CmsCmdContent)
 #define IPC_SET_IPC_THREAD  _IO(IPC_IOC_MAGIC, 3)
 #define IPC_SEND_RECV_MSG   _IOWR(IPC_IOC_MAGIC, 4, IpcContent)
+#define IPC_SEND_RECV_BATCH _IOWR(IPC_IOC_MAGIC, 5, IpcBatchContent)
 
 typedef enum {
     CMS_GEN_HANDLE,
@@ -174,6 +184,14 @@ typedef struct {
     VOID                 *buffToFree;
 } IpcContent;
 
+#define IPC_BATCH_NUM_MAX 16
+
+typedef struct {
+    UINT32               num;       /**< number of contents, handled in order */
+    IpcContent           *contents;
+    UINT32               done;      /**< filled by kernel, number of contents handled successfully */
+} IpcBatchContent;
+
 /* init liteipc driver */
 extern UINT32 OsLiteIpcInit(VOID);
 
@@ -33,7 +33,7 @@
 #include "los_trace.h"
 #include "los_task.h"
 #include "los_sem.h"
-#include "los_mux.h"
+#include "los_mux_pri.h"
 #include "los_queue.h"
 #include "los_event.h"
 #include "los_swtmr.h"
@@ -138,19 +138,19 @@ STATIC VOID LOS_TraceMuxCreate(const LosMux *muxCB)
 STATIC VOID LOS_TraceMuxPost(const LosMux *muxCB)
 {
     LOS_TRACE(MUX_POST, (UINTPTR)muxCB, muxCB->muxCount,
-        (muxCB->owner == NULL) ? 0xffffffff : ((LosTaskCB *)muxCB->owner)->taskID);
+        (OsMuxOwnerGet(muxCB) == NULL) ? 0xffffffff : OsMuxOwnerGet(muxCB)->taskID);
 }
 
 STATIC VOID LOS_TraceMuxPend(const LosMux *muxCB, UINT32 timeout)
 {
     LOS_TRACE(MUX_PEND, (UINTPTR)muxCB, muxCB->muxCount,
-        (muxCB->owner == NULL) ? 0xffffffff : ((LosTaskCB *)muxCB->owner)->taskID, timeout);
+        (OsMuxOwnerGet(muxCB) == NULL) ? 0xffffffff : OsMuxOwnerGet(muxCB)->taskID, timeout);
 }
 
 STATIC VOID LOS_TraceMuxDelete(const LosMux *muxCB)
 {
     LOS_TRACE(MUX_DELETE, (UINTPTR)muxCB, muxCB->attr.type, muxCB->muxCount,
-        (muxCB->owner == NULL) ? 0xffffffff : ((LosTaskCB *)muxCB->owner)->taskID);
+        (OsMuxOwnerGet(muxCB) == NULL) ? 0xffffffff : OsMuxOwnerGet(muxCB)->taskID);
 }
 
 STATIC VOID LOS_TraceTaskCreate(const LosTaskCB *taskCB)
@@ -46,8 +46,16 @@ typedef struct {
     INT64 realTimeNsec;
     INT64 monoTimeSec;
     INT64 monoTimeNsec;
-    /* lock DataPage  0:Unlock State  1:Lock State */
-    UINT64 lockCount;
+    /* Counter value the timeval above was taken at */
+    UINT64 cycleLast;
+    /* Counter to ns: ((cycle - cycleLast) * clockMult) >> clockShift, trusted up to maxCycles */
+    UINT64 clockMult;
+    UINT64 maxCycles;
+    UINT32 clockShift;
+    /* 1: user mode may read the counter, 0: only the coarse clocks are served */
+    UINT32 hrEnable;
+    /* Sequence count, odd while the kernel is updating the DataPage */
+    UINT32 seqCount;
 } VdsoDataPage;
 
 #define ELF_HEAD "\177ELF"
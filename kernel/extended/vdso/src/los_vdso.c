@@ -36,10 +36,31 @@
 #include "los_vm_lock.h"
 #include "los_vm_phys.h"
 #include "los_process_pri.h"
+#include "los_tick.h"
+
+#define VDSO_CLOCK_SHIFT        24
+#define VDSO_CLOCK_MAX_DELTA    4 /* seconds user mode may extrapolate before falling back to the syscall */
 
 LITE_VDSO_DATAPAGE VdsoDataPage g_vdsoDataPage __attribute__((__used__));
 
 STATIC size_t g_vdsoSize;
+STATIC SPIN_LOCK_INIT(g_vdsoSpin);
+
+STATIC VOID OsVdsoClockInit(VdsoDataPage *vdsoDataPage)
+{
+    UINT64 maxCycles;
+
+    if (g_sysClock == 0) {
+        return;
+    }
+
+    vdsoDataPage->clockShift = VDSO_CLOCK_SHIFT;
+    vdsoDataPage->clockMult = ((UINT64)OS_SYS_NS_PER_SECOND << VDSO_CLOCK_SHIFT) / g_sysClock;
+    /* keep (delta * clockMult) inside 64 bits */
+    maxCycles = OS_64BIT_MAX / vdsoDataPage->clockMult;
+    vdsoDataPage->maxCycles = MIN2(maxCycles, (UINT64)g_sysClock * VDSO_CLOCK_MAX_DELTA);
+    vdsoDataPage->hrEnable = 1;
+}
 
 UINT32 OsVdsoInit(VOID)
 {
@@ -49,6 +70,8 @@ UINT32 OsVdsoInit(VOID)
         PRINT_ERR("VDSO Init Failed!\n");
         return LOS_NOK;
     }
+
+    OsVdsoClockInit((VdsoDataPage *)(&__vdso_data_start));
     return LOS_OK;
 }
 
@@ -110,21 +133,26 @@ LOCK_RELEASE:
 
 STATIC VOID LockVdsoDataPage(VdsoDataPage *vdsoDataPage)
 {
-    vdsoDataPage->lockCount = 1;
+    vdsoDataPage->seqCount++;
     DMB;
 }
 
 STATIC VOID UnlockVdsoDataPage(VdsoDataPage *vdsoDataPage)
 {
     DMB;
-    vdsoDataPage->lockCount = 0;
+    vdsoDataPage->seqCount++;
 }
 
 VOID OsVdsoTimevalUpdate(VOID)
 {
     VdsoDataPage *kVdsoDataPage = (VdsoDataPage *)(&__vdso_data_start);
 
+    /* every cpu ticks, one fresh update is enough when they race */
+    if (LOS_SpinTrylock(&g_vdsoSpin) != LOS_OK) {
+        return;
+    }
     LockVdsoDataPage(kVdsoDataPage);
     OsVdsoTimeGet(kVdsoDataPage);
     UnlockVdsoDataPage(kVdsoDataPage);
+    LOS_SpinUnlock(&g_vdsoSpin);
 }
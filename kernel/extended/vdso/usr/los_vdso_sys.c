@@ -35,26 +35,93 @@
 #include "los_typedef.h"
 #include "los_vdso_datapage.h"
 
+#define VDSO_NS_PER_SECOND 1000000000
+
+STATIC INLINE UINT32 VdsoReadSeqBegin(const VdsoDataPage *usrVdsoDataPage)
+{
+    UINT32 seq;
+
+    do {
+        seq = *(volatile const UINT32 *)&usrVdsoDataPage->seqCount;
+    } while (seq & 1);
+    __asm__ __volatile__("dmb" ::: "memory");
+    return seq;
+}
+
+STATIC INLINE INT32 VdsoReadSeqRetry(const VdsoDataPage *usrVdsoDataPage, UINT32 seq)
+{
+    __asm__ __volatile__("dmb" ::: "memory");
+    return (*(volatile const UINT32 *)&usrVdsoDataPage->seqCount != seq);
+}
+
+STATIC INLINE UINT64 VdsoReadCycles(VOID)
+{
+    UINT64 cycle;
+
+    /* CNTPCT, the counter the kernel keeps time with */
+    __asm__ __volatile__("isb\n\tmrrc p15, 0, %0, %H0, c14" : "=r"(cycle) : : "memory");
+    return cycle;
+}
+
 STATIC INT32 VdsoGetRealtimeCoarse(struct timespec *ts, const VdsoDataPage *usrVdsoDataPage)
 {
+    UINT32 seq;
+
     do {
-        if (!usrVdsoDataPage->lockCount) {
-            ts->tv_sec = usrVdsoDataPage->realTimeSec;
-            ts->tv_nsec = usrVdsoDataPage->realTimeNsec;
-            return 0;
-        }
-    } while (1);
+        seq = VdsoReadSeqBegin(usrVdsoDataPage);
+        ts->tv_sec = usrVdsoDataPage->realTimeSec;
+        ts->tv_nsec = usrVdsoDataPage->realTimeNsec;
+    } while (VdsoReadSeqRetry(usrVdsoDataPage, seq));
+    return 0;
 }
 
 STATIC INT32 VdsoGetMonotimeCoarse(struct timespec *ts, const VdsoDataPage *usrVdsoDataPage)
 {
+    UINT32 seq;
+
+    do {
+        seq = VdsoReadSeqBegin(usrVdsoDataPage);
+        ts->tv_sec = usrVdsoDataPage->monoTimeSec;
+        ts->tv_nsec = usrVdsoDataPage->monoTimeNsec;
+    } while (VdsoReadSeqRetry(usrVdsoDataPage, seq));
+    return 0;
+}
+
+STATIC INT32 VdsoGetHrtime(struct timespec *ts, const VdsoDataPage *usrVdsoDataPage, BOOL isRealtime)
+{
+    UINT32 seq;
+    UINT64 delta;
+    INT64 sec;
+    INT64 nsec;
+
     do {
-        if (!usrVdsoDataPage->lockCount) {
-            ts->tv_sec = usrVdsoDataPage->monoTimeSec;
-            ts->tv_nsec = usrVdsoDataPage->monoTimeNsec;
-            return 0;
+        seq = VdsoReadSeqBegin(usrVdsoDataPage);
+        if (!usrVdsoDataPage->hrEnable) {
+            return -1;
         }
-    } while (1);
+        delta = VdsoReadCycles() - usrVdsoDataPage->cycleLast;
+        if (delta > usrVdsoDataPage->maxCycles) {
+            /* the page went stale (or the counter went backwards), let the syscall answer */
+            return -1;
+        }
+        if (isRealtime) {
+            sec = usrVdsoDataPage->realTimeSec;
+            nsec = usrVdsoDataPage->realTimeNsec;
+        } else {
+            sec = usrVdsoDataPage->monoTimeSec;
+            nsec = usrVdsoDataPage->monoTimeNsec;
+        }
+        nsec += (INT64)((delta * usrVdsoDataPage->clockMult) >> usrVdsoDataPage->clockShift);
+    } while (VdsoReadSeqRetry(usrVdsoDataPage, seq));
+
+    /* no libgcc in here, and delta is bounded by maxCycles, so a few subtractions at most */
+    while (nsec >= VDSO_NS_PER_SECOND) {
+        nsec -= VDSO_NS_PER_SECOND;
+        sec++;
+    }
+    ts->tv_sec = sec;
+    ts->tv_nsec = nsec;
+    return 0;
 }
 
 STATIC size_t LocVdsoStart(size_t vdsoStart, const CHAR *elfHead, const size_t len)
@@ -104,6 +171,12 @@ INT32 VdsoClockGettime(clockid_t clk, struct timespec *ts)
         case CLOCK_MONOTONIC_COARSE:
             ret = VdsoGetMonotimeCoarse(ts, usrVdsoDataPage);
             break;
+        case CLOCK_REALTIME:
+            ret = VdsoGetHrtime(ts, usrVdsoDataPage, TRUE);
+            break;
+        case CLOCK_MONOTONIC:
+            ret = VdsoGetHrtime(ts, usrVdsoDataPage, FALSE);
+            break;
         default:
             ret = -1;
             break;
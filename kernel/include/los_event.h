@@ -200,6 +200,8 @@ extern UINT32 LOS_EventInit(PEVENT_CB_S eventCB);
  * <ul>
  * <li>When the mode is LOS_WAITMODE_CLR, the eventID is passed-out.</li>
  * <li>Otherwise the eventID is passed-in.</li>
+ * <li>The event bits are checked and cleared with atomic operations, without taking the scheduler lock.
+ * The event ID must only be changed through the event APIs meanwhile.</li>
  * <li>An error code and an event return value can be same. To differentiate the error code and return value, bit 25 of
  * the event mask is forbidden to be used.</li>
  * </ul>
@@ -131,6 +131,10 @@ typedef struct {
 #ifdef LOSCFG_MEM_WATERLINE
     UINT32 usageWaterLine;
 #endif
+    UINT32 cachedSize;      /* Size held by the per-cpu caches, included in totalUsedSize */
+    UINT32 cachedNodeNum;   /* Node number held by the per-cpu caches, included in usedNodeNum */
+    UINT32 cacheHitCount;
+    UINT32 cacheMissCount;
 } LOS_MEM_POOL_STATUS;
 
 /**
@@ -229,6 +229,16 @@ extern "C" {
  */
 #define LOS_ERRNO_QUEUE_WRITE_PTR_NULL      LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x12)
 
+/**
+ * @ingroup los_queue
+ * Queue error code: The operation is not supported by a ring queue.
+ *
+ * Value: 0x02000611
+ *
+ * Solution: Do not write to the head of a queue created with LOS_QUEUE_FLAG_MPSC or LOS_QUEUE_FLAG_SPSC.
+ */
+#define LOS_ERRNO_QUEUE_OPERATE_UNSUPPORTED LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x11)
+
 /**
  * @ingroup los_queue
  * Queue error code: The buffer size passed in during queue writing is 0.
@@ -239,6 +249,17 @@ extern "C" {
  */
 #define LOS_ERRNO_QUEUE_WRITESIZE_ISZERO    LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x13)
 
+/**
+ * @ingroup los_queue
+ * Queue error code: The flags or the length passed in during queue creation are invalid.
+ *
+ * Value: 0x02000614
+ *
+ * Solution: Pass in exactly one of LOS_QUEUE_FLAG_MPSC and LOS_QUEUE_FLAG_SPSC, optionally with
+ * LOS_QUEUE_FLAG_POINTER, and a length not bigger than LOS_QUEUE_RING_LEN_MAX.
+ */
+#define LOS_ERRNO_QUEUE_FLAGS_INVALID       LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x14)
+
 /**
  * @ingroup los_queue
  * Queue error code: The buffer size passed in during queue writing is bigger than the queue size.
@@ -331,6 +352,30 @@ extern "C" {
  */
 #define LOS_ERRNO_QUEUE_READ_SIZE_TOO_SMALL LOS_ERRNO_OS_ERROR(LOS_MOD_QUE, 0x1f)
 
+/**
+ * @ingroup los_queue
+ * Queue flag: lock-free ring written by any number of tasks and read by a single task.
+ */
+#define LOS_QUEUE_FLAG_MPSC                 0x1U
+
+/**
+ * @ingroup los_queue
+ * Queue flag: lock-free ring written by a single task and read by a single task.
+ */
+#define LOS_QUEUE_FLAG_SPSC                 0x2U
+
+/**
+ * @ingroup los_queue
+ * Queue flag: every message of a ring queue is one pointer, which is passed without copying the buffer.
+ */
+#define LOS_QUEUE_FLAG_POINTER              0x4U
+
+/**
+ * @ingroup los_queue
+ * Maximum length of a ring queue. The length of a ring queue is rounded up to a power of two.
+ */
+#define LOS_QUEUE_RING_LEN_MAX              0x8000U
+
 /**
  * @ingroup los_queue
  * Structure of the block for queue information query
@@ -357,11 +402,17 @@ typedef struct tagQueueInfo {
  * @attention
  * <ul>
  * <li>There are LOSCFG_BASE_IPC_QUEUE_LIMIT queues available, change it's value when necessary.</li>
+ * <li>A queue created with LOS_QUEUE_FLAG_MPSC or LOS_QUEUE_FLAG_SPSC is a lock-free ring: reading and writing
+ * only take the scheduler lock when the queue is empty or full and a task has to wait. Such a queue must be read
+ * by one task at a time, and LOS_QUEUE_FLAG_SPSC additionally requires that it is written by one task at a
+ * time. Writing to the head of a ring queue is not supported.</li>
+ * <li>With LOS_QUEUE_FLAG_POINTER every message is the pointer passed to LOS_QueueWrite and maxMsgSize is
+ * ignored.</li>
  * </ul>
  * @param queueName        [IN]  Message queue name. Reserved parameter, not used for now.
  * @param len              [IN]  Queue length. The value range is [1,0xffff].
  * @param queueID          [OUT] ID of the queue control structure that is successfully created.
- * @param flags            [IN]  Queue mode. Reserved parameter, not used for now.
+ * @param flags            [IN]  Queue mode. 0, or a combination of LOS_QUEUE_FLAG_XXX for a ring queue.
  * @param maxMsgSize       [IN]  Node size. The value range is [1,0xffff-4].
  *
  * @retval   #LOS_OK                            The message queue is successfully created.
@@ -371,6 +422,7 @@ typedef struct tagQueueInfo {
  * @retval   #LOS_ERRNO_QUEUE_PARA_ISZERO       The queue length or message node size passed in during queue
  * creation is 0.
  * @retval   #LOS_ERRNO_QUEUE_SIZE_TOO_BIG      The parameter usMaxMsgSize is larger than 0xffff - 4.
+ * @retval   #LOS_ERRNO_QUEUE_FLAGS_INVALID     The flags are invalid, or len is too big for a ring queue.
  * @par Dependency:
  * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
  * @see LOS_QueueDelete
@@ -726,6 +778,75 @@ extern UINT32 LOS_QueueDelete(UINT32 queueID);
  */
 extern UINT32 LOS_QueueInfoGet(UINT32 queueID, QUEUE_INFO_S *queueInfo);
 
+/**
+ * @ingroup los_queue
+ * @brief Write a batch of messages into a queue.
+ *
+ * @par Description:
+ * This API is used to write up to *count messages of msgSize bytes each, stored one after another at the address
+ * specified by bufferAddr, into the tail of a queue.
+ * @attention
+ * <ul>
+ * <li>The task waits at most timeout ticks for the first message to be written. The remaining messages are
+ * written only as long as the queue has free nodes.</li>
+ * <li>A ring queue reserves all the nodes with a single atomic operation and wakes the reader once.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]     Queue ID created by LOS_QueueCreate.
+ * @param bufferAddr     [IN]     Starting address of the messages to be written.
+ * @param msgSize        [IN]     Size of every message.
+ * @param count          [IN/OUT] Number of messages to be written before the call, written after the call.
+ * @param timeout        [IN]     Expiry time. The value range is [0,LOS_WAIT_FOREVER](unit: Tick).
+ *
+ * @retval   #LOS_OK                              At least one message is written into the queue.
+ * @retval   #LOS_ERRNO_QUEUE_WRITE_PTR_NULL      The pointer passed in is null.
+ * @retval   #LOS_ERRNO_QUEUE_PARA_ISZERO         The number of messages is 0.
+ * @retval   #LOS_ERRNO_QUEUE_ISFULL              No free node is available during queue writing.
+ * @retval   #LOS_ERRNO_QUEUE_TIMEOUT             The time set for waiting to processing the queue expires.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueWriteCopy | LOS_QueueReadBatch
+ */
+extern UINT32 LOS_QueueWriteBatch(UINT32 queueID,
+                                  VOID *bufferAddr,
+                                  UINT32 msgSize,
+                                  UINT32 *count,
+                                  UINT32 timeout);
+
+/**
+ * @ingroup los_queue
+ * @brief Read a batch of messages from a queue.
+ *
+ * @par Description:
+ * This API is used to read up to *count messages from a queue into consecutive buffers of msgSize bytes each,
+ * starting at the address specified by bufferAddr. Messages bigger than msgSize are truncated.
+ * @attention
+ * <ul>
+ * <li>The task waits at most timeout ticks for the first message. The remaining messages are read only as long
+ * as the queue is not empty.</li>
+ * </ul>
+ *
+ * @param queueID        [IN]     Queue ID created by LOS_QueueCreate.
+ * @param bufferAddr     [OUT]    Starting address that stores the obtained messages.
+ * @param msgSize        [IN]     Size of the buffer of every message.
+ * @param count          [IN/OUT] Number of messages wanted before the call, read after the call.
+ * @param timeout        [IN]     Expiry time. The value range is [0,LOS_WAIT_FOREVER](unit: Tick).
+ *
+ * @retval   #LOS_OK                              At least one message is read from the queue.
+ * @retval   #LOS_ERRNO_QUEUE_READ_PTR_NULL       The pointer passed in is null.
+ * @retval   #LOS_ERRNO_QUEUE_PARA_ISZERO         The number of messages is 0.
+ * @retval   #LOS_ERRNO_QUEUE_ISEMPTY             No message is in the queue.
+ * @retval   #LOS_ERRNO_QUEUE_TIMEOUT             The time set for waiting to processing the queue expires.
+ * @par Dependency:
+ * <ul><li>los_queue.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_QueueReadCopy | LOS_QueueWriteBatch
+ */
+extern UINT32 LOS_QueueReadBatch(UINT32 queueID,
+                                 VOID *bufferAddr,
+                                 UINT32 msgSize,
+                                 UINT32 *count,
+                                 UINT32 timeout);
+
 #ifdef __cplusplus
 #if __cplusplus
 }
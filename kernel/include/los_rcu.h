@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @defgroup los_rcu Rcu
+ * @ingroup kernel
+ */
+
+#ifndef _LOS_RCU_H
+#define _LOS_RCU_H
+
+#include "los_list.h"
+#include "los_task.h"
+#include "los_hw_cpu.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+/**
+ * @ingroup los_rcu
+ * Rcu callback head, embedded in the object which is released after a grace period.
+ */
+typedef struct LosRcuHead {
+    struct LosRcuHead *next;                   /**< Next pending callback */
+    VOID (*func)(struct LosRcuHead *head);     /**< Callback invoked after the grace period */
+    UINT32 gpSeq;                              /**< Grace period the callback waits for */
+} LosRcuHead;
+
+/**
+ * @ingroup los_rcu
+ * @brief Enter an rcu read-side critical section.
+ *
+ * @par Description:
+ * Objects reached through rcu protected lists stay valid until the matching LOS_RcuReadUnlock.
+ * The read side only disables task preemption on the current cpu, readers never wait for each other.
+ * @attention
+ * <ul>
+ * <li>The read-side critical section must not block.</li>
+ * <li>Can be nested.</li>
+ * </ul>
+ *
+ * @param None.
+ *
+ * @retval None.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_RcuReadUnlock
+ */
+STATIC INLINE VOID LOS_RcuReadLock(VOID)
+{
+    LOS_TaskLock();
+}
+
+/**
+ * @ingroup los_rcu
+ * @brief Leave an rcu read-side critical section.
+ *
+ * @par Description:
+ * This API is used to leave the critical section entered by LOS_RcuReadLock.
+ * @attention None.
+ *
+ * @param None.
+ *
+ * @retval None.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_RcuReadLock
+ */
+STATIC INLINE VOID LOS_RcuReadUnlock(VOID)
+{
+    LOS_TaskUnlock();
+}
+
+/**
+ * @ingroup los_rcu
+ * @brief Insert a node after the list head, visible to concurrent rcu readers.
+ *
+ * @par Description:
+ * The node is fully initialized before it is published, so readers walking the list forward
+ * see either the old or the new list.
+ * @attention
+ * <ul>
+ * <li>Writers must still be serialized by the caller.</li>
+ * <li>Only forward traversal is safe for readers.</li>
+ * </ul>
+ *
+ * @param list [IN] Doubly linked list head.
+ * @param node [IN] Node to be inserted.
+ *
+ * @retval None.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_ListRcuDelete
+ */
+STATIC INLINE VOID LOS_ListRcuAdd(LOS_DL_LIST *list, LOS_DL_LIST *node)
+{
+    node->pstNext = list->pstNext;
+    node->pstPrev = list;
+    DMB;
+    list->pstNext->pstPrev = node;
+    list->pstNext = node;
+}
+
+/**
+ * @ingroup los_rcu
+ * @brief Unlink a node from an rcu protected list.
+ *
+ * @par Description:
+ * The forward pointer of the node is kept so that readers standing on it can go on walking.
+ * The node can only be reused after a grace period, see LOS_RcuSynchronize and LOS_RcuCall.
+ * @attention
+ * <ul>
+ * <li>Writers must still be serialized by the caller.</li>
+ * <li>The previous pointer of the node is cleared to mark it unlinked.</li>
+ * </ul>
+ *
+ * @param node [IN] Node to be deleted.
+ *
+ * @retval None.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_ListRcuAdd
+ */
+STATIC INLINE VOID LOS_ListRcuDelete(LOS_DL_LIST *node)
+{
+    node->pstNext->pstPrev = node->pstPrev;
+    node->pstPrev->pstNext = node->pstNext;
+    node->pstPrev = NULL;
+}
+
+/**
+ * @ingroup los_rcu
+ * @brief Wait for a grace period.
+ *
+ * @par Description:
+ * Return after every rcu read-side critical section that was running on any cpu has finished.
+ * @attention
+ * <ul>
+ * <li>Can only be called in task context, and not inside a read-side critical section.</li>
+ * </ul>
+ *
+ * @param None.
+ *
+ * @retval None.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_RcuCall
+ */
+extern VOID LOS_RcuSynchronize(VOID);
+
+/**
+ * @ingroup los_rcu
+ * @brief Invoke a callback after a grace period.
+ *
+ * @par Description:
+ * The callback is invoked once all the read-side critical sections running at the time of the call have finished.
+ * @attention
+ * <ul>
+ * <li>The callback usually runs in interrupt context, from the end of the interrupt that finishes the grace
+ * period, and otherwise in the task calling LOS_RcuSynchronize. It must be irq safe: no blocking, no mutex
+ * or semaphore, no LOS_TaskDelay, only memory frees that are irq safe such as LOS_MemFree and
+ * LOS_KmemCacheFree. Work that may sleep is queued by the callback to a task.</li>
+ * </ul>
+ *
+ * @param head [IN] Rcu head embedded in the object to be released.
+ * @param func [IN] Callback function.
+ *
+ * @retval None.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_RcuSynchronize
+ */
+extern VOID LOS_RcuCall(LosRcuHead *head, VOID (*func)(LosRcuHead *head));
+
+/**
+ * @ingroup los_rcu
+ * @brief Start a grace period without waiting for it.
+ *
+ * @par Description:
+ * The returned cookie is polled by LOS_RcuGpDone, this lets the caller keep the objects on its own list.
+ * @attention None.
+ *
+ * @param None.
+ *
+ * @retval #UINT32 The grace period cookie.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_RcuGpDone
+ */
+extern UINT32 LOS_RcuGpStart(VOID);
+
+/**
+ * @ingroup los_rcu
+ * @brief Check whether the grace period of a cookie has finished.
+ *
+ * @par Description:
+ * This API is used to check the cookie returned by LOS_RcuGpStart.
+ * @attention None.
+ *
+ * @param cookie [IN] Grace period cookie.
+ *
+ * @retval #TRUE  The grace period has finished.
+ * @retval #FALSE The grace period is still in progress.
+ * @par Dependency:
+ * <ul><li>los_rcu.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_RcuGpStart
+ */
+extern BOOL LOS_RcuGpDone(UINT32 cookie);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* _LOS_RCU_H */
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @defgroup los_slab Object cache
+ * @ingroup kernel
+ */
+
+#ifndef _LOS_SLAB_H
+#define _LOS_SLAB_H
+
+#include "los_config.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+/**
+ * @ingroup los_slab
+ * Object cache handle
+ */
+typedef struct KmemCache LosKmemCache;
+
+/**
+ * @ingroup los_slab
+ * Object constructor, called once for every object when its slab is populated
+ */
+typedef VOID (*KmemCacheCtor)(VOID *obj);
+
+/**
+ * @ingroup los_slab
+ * @brief Create an object cache.
+ *
+ * @par Description:
+ * <ul>
+ * <li>This API is used to create a cache of fixed-size objects backed by contiguous physical pages.</li>
+ * </ul>
+ * @attention
+ * <ul>
+ * <li>The name is referenced, not copied, it must stay valid for the lifetime of the cache.</li>
+ * <li>Objects are constructed once when their slab is populated, not on every allocation. An object
+ * must be returned to the cache in its constructed state.</li>
+ * <li>The constructor runs in task context without any lock held and must not sleep.</li>
+ * </ul>
+ *
+ * @param name    [IN] Cache name shown in /proc/slabinfo.
+ * @param size    [IN] Object size.
+ * @param align   [IN] Object alignment, 0 or a power of two.
+ * @param ctor    [IN] Object constructor, may be NULL.
+ *
+ * @retval #LosKmemCache*   The cache is created.
+ * @retval #NULL            The parameters are invalid or memory is insufficient.
+ * @par Dependency:
+ * <ul>
+ * <li>los_slab.h: the header file that contains the API declaration.</li>
+ * </ul>
+ * @see LOS_KmemCacheDestroy
+ */
+extern LosKmemCache *LOS_KmemCacheCreate(const CHAR *name, UINT32 size, UINT32 align, KmemCacheCtor ctor);
+
+/**
+ * @ingroup los_slab
+ * @brief Destroy an object cache.
+ *
+ * @par Description:
+ * <ul>
+ * <li>This API is used to destroy an object cache and release its slabs.</li>
+ * </ul>
+ * @attention
+ * <ul>
+ * <li>All objects must have been freed, and the cache must be quiescent: every LOS_KmemCacheAlloc and
+ * LOS_KmemCacheFree on it, on any core, must have returned before the call, and none may start after it.
+ * The per-cpu stashes of the other cores are drained without synchronizing with their owners.</li>
+ * </ul>
+ *
+ * @param cache   [IN] Cache handle.
+ *
+ * @retval #LOS_NOK   The cache is invalid or still has allocated objects.
+ * @retval #LOS_OK    The cache is destroyed.
+ * @par Dependency:
+ * <ul>
+ * <li>los_slab.h: the header file that contains the API declaration.</li>
+ * </ul>
+ * @see LOS_KmemCacheCreate
+ */
+extern UINT32 LOS_KmemCacheDestroy(LosKmemCache *cache);
+
+/**
+ * @ingroup los_slab
+ * @brief Allocate an object from an object cache.
+ *
+ * @par Description:
+ * <ul>
+ * <li>This API is used to allocate an object, served from the per-cpu stash of the current core when possible.</li>
+ * </ul>
+ *
+ * @param cache   [IN] Cache handle.
+ *
+ * @retval #VOID*   The object address.
+ * @retval #NULL    Memory is insufficient.
+ * @par Dependency:
+ * <ul>
+ * <li>los_slab.h: the header file that contains the API declaration.</li>
+ * </ul>
+ * @see LOS_KmemCacheFree
+ */
+extern VOID *LOS_KmemCacheAlloc(LosKmemCache *cache);
+
+/**
+ * @ingroup los_slab
+ * @brief Free an object to its object cache.
+ *
+ * @par Description:
+ * <ul>
+ * <li>This API is used to return an object allocated by LOS_KmemCacheAlloc.</li>
+ * </ul>
+ *
+ * @param cache   [IN] Cache handle.
+ * @param obj     [IN] Object address.
+ *
+ * @retval #LOS_NOK   The object does not belong to the cache.
+ * @retval #LOS_OK    The object is freed.
+ * @par Dependency:
+ * <ul>
+ * <li>los_slab.h: the header file that contains the API declaration.</li>
+ * </ul>
+ * @see LOS_KmemCacheAlloc
+ */
+extern UINT32 LOS_KmemCacheFree(LosKmemCache *cache, VOID *obj);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* _LOS_SLAB_H */
@@ -47,6 +47,16 @@ extern VOID ArchSpinLock(size_t *lock);
 extern VOID ArchSpinUnlock(size_t *lock);
 extern INT32 ArchSpinTrylock(size_t *lock);
 
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+typedef struct {
+    UINT32      lockCount;      /**< Times the lock is taken */
+    UINT32      contendCount;   /**< Times the lock is found held by another core */
+    UINT64      spinTime;       /**< Cycles spent waiting for the lock */
+    UINT64      maxHoldTime;    /**< Longest time in cycles the lock is held */
+    UINT64      holdStartTime;
+} SpinLockStat;
+#endif
+
 typedef struct Spinlock {
     size_t      rawLock;
 #ifdef LOSCFG_KERNEL_SMP
@@ -54,6 +64,9 @@ typedef struct Spinlock {
     VOID        *owner;
     const CHAR  *name;
 #endif
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+    SpinLockStat stat;
+#endif
 } SPIN_LOCK_S;
 
 #ifdef LOSCFG_KERNEL_SMP_LOCKDEP
@@ -208,6 +221,28 @@ extern BOOL LOS_SpinHeld(const SPIN_LOCK_S *lock);
  */
 extern VOID LOS_SpinInit(SPIN_LOCK_S *lock);
 
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+/**
+ * @ingroup  los_spinlock
+ * @brief Obtain the contention statistics of a spinlock.
+ *
+ * @par Description:
+ * This API is used to copy the contention statistics of a spinlock, and to clear them if required.
+ *
+ * @attention None.
+ *
+ * @param  lock     [IN]    Type #SPIN_LOCK_S spinlock pointer.
+ * @param  stat     [OUT]   Type #SpinLockStat statistics of the spinlock.
+ * @param  clear    [IN]    Type #BOOL whether to clear the statistics after reading them.
+ *
+ * @retval None.
+ *
+ * @par Dependency:
+ * <ul><li>los_spinlock.h: the header file that contains the API declaration.</li></ul>
+ */
+extern VOID LOS_SpinStatGet(SPIN_LOCK_S *lock, SpinLockStat *stat, BOOL clear);
+#endif
+
 #else
 #define SPIN_LOCK_INITIALIZER(lockName) \
 {                                       \
@@ -986,7 +986,8 @@ extern UINT32 LOS_TaskInfoGet(UINT32 taskID, TSK_INFO_S *taskInfo);
  *
  * @retval #LOS_ERRNO_TSK_ID_INVALID                Invalid task ID.
  * @retval #LOS_ERRNO_TSK_NOT_CREATED               The task is not created.
- * @retval #LOS_ERRNO_TSK_CPU_AFFINITY_MASK_ERR     The task cpu affinity mask is incorrect.
+ * @retval #LOS_ERRNO_TSK_CPU_AFFINITY_MASK_ERR     The task cpu affinity mask is incorrect, or none of its cpus
+ *                                                  can take the bandwidth of the deadline task.
  * @retval #LOS_OK                                  The task cpu affinity mask is successfully setted.
  * @par Dependency:
  * <ul><li>los_task.h: the header file that contains the API declaration.</li></ul>
@@ -1056,6 +1057,37 @@ extern INT32 LOS_GetTaskScheduler(INT32 taskID);
  */
 extern INT32 LOS_SetTaskScheduler(INT32 taskID, UINT16 policy, UINT16 priority);
 
+/**
+ * @ingroup  los_task
+ * @brief Reserve a cpu budget for the task and schedule it by earliest deadline.
+ *
+ * @par Description:
+ * This API is used to move the task to the deadline scheduling policy. In each period the task may run for
+ * runTime before its relative deadline, it is throttled until the next period once the budget is used up.
+ *
+ * @attention
+ * <ul>
+ * <li>The reservation is admitted only if the bandwidth runTime / deadline still fits on one of the cpus the task
+ * may run on, the task then stays on that cpu.</li>
+ * <li>Deadline tasks run before any FIFO/RR task, LOS_SetTaskScheduler moves the task back to FIFO/RR.</li>
+ * </ul>
+ *
+ * @param  taskID       [IN]  Type  #UINT32 Task ID. The task id value is obtained from task creation.
+ * @param  runTime      [IN]  Type  #UINT64 Budget of each period, in nanoseconds.
+ * @param  deadline     [IN]  Type  #UINT64 Relative deadline, in nanoseconds, not less than runTime.
+ * @param  period       [IN]  Type  #UINT64 Period, in nanoseconds, not less than deadline. 0 means equal to deadline.
+ *
+ * @retval #LOS_ESRCH       Invalid task id.
+ * @retval #LOS_EINVAL      Invalid parameters.
+ * @retval #LOS_EPERM       The task is a system task.
+ * @retval #LOS_EBUSY       Not enough bandwidth left for the reservation.
+ * @retval #0               Set up the success.
+ * @par Dependency:
+ * <ul><li>los_task.h: the header file that contains the API declaration.</li></ul>
+ * @see LOS_SetTaskScheduler
+ */
+extern INT32 LOS_SetTaskDeadline(INT32 taskID, UINT64 runTime, UINT64 deadline, UINT64 period);
+
 /**
  * @ingroup  los_task
  * @brief Trigger active task scheduling.
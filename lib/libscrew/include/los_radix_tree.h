@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* *
+ * @defgroup los_radix_tree Radix tree
+ * @ingroup kernel
+ */
+
+#ifndef _LOS_RADIX_TREE_H
+#define _LOS_RADIX_TREE_H
+
+#include "los_typedef.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#define RADIX_TREE_MAP_SHIFT    5
+#define RADIX_TREE_MAP_SIZE     (1U << RADIX_TREE_MAP_SHIFT)
+#define RADIX_TREE_MAP_MASK     (RADIX_TREE_MAP_SIZE - 1)
+#define RADIX_TREE_TAG_MAX      2
+
+typedef struct TagRadixNode {
+    struct TagRadixNode *parent;
+    UINT8 shift;                            /* index bits below the node, 0 for the leaves */
+    UINT8 offset;                           /* slot of the node in its parent */
+    UINT32 bitmap;                          /* slots in use */
+    UINT32 tags[RADIX_TREE_TAG_MAX];        /* slots holding a tagged item, or a node that does */
+    VOID *slots[RADIX_TREE_MAP_SIZE];
+} LosRadixNode;
+
+typedef struct TagRadixTree {
+    LosRadixNode *root;
+    ULONG_T count;
+} LosRadixTree;
+
+#define RADIX_COUNT(tree) ((tree)->count)
+
+/**
+ * @ingroup los_radix_tree
+ * Items are kept in index order. The tree does no locking, the caller
+ * serializes the updates and the lookups of one tree. Nodes are allocated
+ * from the system memory pool on insert and freed once they become empty.
+ */
+VOID LOS_RadixTreeInit(LosRadixTree *tree);
+/* Returns LOS_NOK if item is NULL, index is already used or no memory. */
+ULONG_T LOS_RadixTreeInsert(LosRadixTree *tree, ULONG_T index, VOID *item);
+VOID *LOS_RadixTreeLookup(const LosRadixTree *tree, ULONG_T index);
+/* Returns the removed item, its tags are cleared. */
+VOID *LOS_RadixTreeDelete(LosRadixTree *tree, ULONG_T index);
+VOID LOS_RadixTreeTagSet(LosRadixTree *tree, ULONG_T index, UINT32 tag);
+VOID LOS_RadixTreeTagClear(LosRadixTree *tree, ULONG_T index, UINT32 tag);
+BOOL LOS_RadixTreeTagGet(const LosRadixTree *tree, ULONG_T index, UINT32 tag);
+/* Fill items with up to maxItems items from index first on, returns the number found. */
+UINT32 LOS_RadixTreeGangLookup(const LosRadixTree *tree, VOID **items, ULONG_T first, UINT32 maxItems);
+/* Same as LOS_RadixTreeGangLookup, only visits the items carrying tag. */
+UINT32 LOS_RadixTreeGangLookupTag(const LosRadixTree *tree, VOID **items, ULONG_T first, UINT32 maxItems,
+                                  UINT32 tag);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* _LOS_RADIX_TREE_H */
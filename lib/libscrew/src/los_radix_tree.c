@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ *    conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ *    of conditions and the following disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* *
+ * @defgroup los_radix_tree Radix tree
+ * @ingroup kernel
+ */
+
+#include "los_radix_tree.h"
+#include "los_memory.h"
+#include "los_toolchain.h"
+#include "securec.h"
+
+#define RADIX_TREE_TAG_NONE     RADIX_TREE_TAG_MAX
+#define RADIX_INDEX_BITS        (sizeof(ULONG_T) * 8)
+
+STATIC INLINE UINT32 OsRadixSlot(const LosRadixNode *node, ULONG_T index)
+{
+    return (UINT32)(index >> node->shift) & RADIX_TREE_MAP_MASK;
+}
+
+STATIC INLINE ULONG_T OsRadixMaxIndex(const LosRadixNode *node)
+{
+    UINT32 bits = node->shift + RADIX_TREE_MAP_SHIFT;
+
+    return (bits >= RADIX_INDEX_BITS) ? (ULONG_T)-1 : (((ULONG_T)1 << bits) - 1);
+}
+
+/* index with its slot in node set to offset and the bits below cleared */
+STATIC INLINE ULONG_T OsRadixIndexSet(const LosRadixNode *node, ULONG_T index, UINT32 offset)
+{
+    ULONG_T low = ((ULONG_T)RADIX_TREE_MAP_MASK << node->shift) | (((ULONG_T)1 << node->shift) - 1);
+
+    return (index & ~low) | ((ULONG_T)offset << node->shift);
+}
+
+STATIC LosRadixNode *OsRadixNodeAlloc(LosRadixNode *parent, UINT32 shift, UINT32 offset)
+{
+    LosRadixNode *node = (LosRadixNode *)LOS_MemAlloc(m_aucSysMem0, sizeof(LosRadixNode));
+    if (node == NULL) {
+        return NULL;
+    }
+
+    (VOID)memset_s(node, sizeof(LosRadixNode), 0, sizeof(LosRadixNode));
+    node->parent = parent;
+    node->shift = (UINT8)shift;
+    node->offset = (UINT8)offset;
+    return node;
+}
+
+/* Free the empty nodes from node up, then drop the roots that only use their first slot. */
+STATIC VOID OsRadixNodePrune(LosRadixTree *tree, LosRadixNode *node)
+{
+    LosRadixNode *parent = NULL;
+    UINT32 tag;
+
+    while ((node != NULL) && (node->bitmap == 0)) {
+        parent = node->parent;
+        if (parent == NULL) {
+            tree->root = NULL;
+        } else {
+            parent->slots[node->offset] = NULL;
+            parent->bitmap &= ~(1U << node->offset);
+            for (tag = 0; tag < RADIX_TREE_TAG_MAX; tag++) {
+                parent->tags[tag] &= ~(1U << node->offset);
+            }
+        }
+        (VOID)LOS_MemFree(m_aucSysMem0, node);
+        node = parent;
+    }
+
+    node = tree->root;
+    while ((node != NULL) && (node->shift != 0) && (node->bitmap == 1)) {
+        tree->root = (LosRadixNode *)node->slots[0];
+        tree->root->parent = NULL;
+        (VOID)LOS_MemFree(m_aucSysMem0, node);
+        node = tree->root;
+    }
+}
+
+/* Add levels above the root until index fits in the tree. */
+STATIC ULONG_T OsRadixTreeExtend(LosRadixTree *tree, ULONG_T index)
+{
+    LosRadixNode *root = tree->root;
+    LosRadixNode *node = NULL;
+    UINT32 tag;
+
+    if (root == NULL) {
+        root = OsRadixNodeAlloc(NULL, 0, 0);
+        if (root == NULL) {
+            return LOS_NOK;
+        }
+        tree->root = root;
+    }
+
+    while (index > OsRadixMaxIndex(root)) {
+        node = OsRadixNodeAlloc(NULL, root->shift + RADIX_TREE_MAP_SHIFT, 0);
+        if (node == NULL) {
+            return LOS_NOK;
+        }
+        node->slots[0] = root;
+        node->bitmap = 1;
+        for (tag = 0; tag < RADIX_TREE_TAG_MAX; tag++) {
+            node->tags[tag] = (root->tags[tag] != 0) ? 1 : 0;
+        }
+        root->parent = node;
+        root = node;
+        tree->root = root;
+    }
+    return LOS_OK;
+}
+
+STATIC LosRadixNode *OsRadixLeafGet(const LosRadixTree *tree, ULONG_T index)
+{
+    LosRadixNode *node = tree->root;
+
+    if ((node == NULL) || (index > OsRadixMaxIndex(node))) {
+        return NULL;
+    }
+
+    while ((node != NULL) && (node->shift != 0)) {
+        node = (LosRadixNode *)node->slots[OsRadixSlot(node, index)];
+    }
+    return node;
+}
+
+STATIC INLINE UINT32 OsRadixNodeMask(const LosRadixNode *node, UINT32 tag)
+{
+    return (tag == RADIX_TREE_TAG_NONE) ? node->bitmap : node->tags[tag];
+}
+
+/* Find the first item, carrying tag if given, at or after *index. */
+STATIC VOID *OsRadixNextGet(const LosRadixTree *tree, ULONG_T *index, UINT32 tag)
+{
+    LosRadixNode *node = tree->root;
+    ULONG_T cursor = *index;
+    UINT32 offset;
+    UINT32 mask;
+
+    if ((node == NULL) || (cursor > OsRadixMaxIndex(node))) {
+        return NULL;
+    }
+
+    for (;;) {
+        offset = OsRadixSlot(node, cursor);
+        mask = OsRadixNodeMask(node, tag) & (~0U << offset);
+        if (mask == 0) {
+            /* nothing left below this node, go on after it in the parent */
+            do {
+                if (node->parent == NULL) {
+                    return NULL;
+                }
+                offset = node->offset + 1;
+                node = node->parent;
+            } while (offset == RADIX_TREE_MAP_SIZE);
+            cursor = OsRadixIndexSet(node, cursor, offset);
+            continue;
+        }
+
+        if ((UINT32)CTZ(mask) != offset) {
+            offset = (UINT32)CTZ(mask);
+            cursor = OsRadixIndexSet(node, cursor, offset);
+        }
+
+        if (node->shift == 0) {
+            *index = cursor;
+            return node->slots[offset];
+        }
+        node = (LosRadixNode *)node->slots[offset];
+    }
+}
+
+STATIC UINT32 OsRadixGangLookup(const LosRadixTree *tree, VOID **items, ULONG_T first, UINT32 maxItems, UINT32 tag)
+{
+    ULONG_T index = first;
+    UINT32 num = 0;
+    VOID *item = NULL;
+
+    while (num < maxItems) {
+        item = OsRadixNextGet(tree, &index, tag);
+        if (item == NULL) {
+            break;
+        }
+        items[num++] = item;
+        if (index == (ULONG_T)-1) {
+            break;
+        }
+        index++;
+    }
+    return num;
+}
+
+VOID LOS_RadixTreeInit(LosRadixTree *tree)
+{
+    tree->root = NULL;
+    tree->count = 0;
+}
+
+ULONG_T LOS_RadixTreeInsert(LosRadixTree *tree, ULONG_T index, VOID *item)
+{
+    LosRadixNode *node = NULL;
+    LosRadixNode *child = NULL;
+    UINT32 offset;
+
+    if ((tree == NULL) || (item == NULL)) {
+        return LOS_NOK;
+    }
+
+    if (OsRadixTreeExtend(tree, index) != LOS_OK) {
+        OsRadixNodePrune(tree, tree->root);
+        return LOS_NOK;
+    }
+
+    node = tree->root;
+    while (node->shift != 0) {
+        offset = OsRadixSlot(node, index);
+        child = (LosRadixNode *)node->slots[offset];
+        if (child == NULL) {
+            child = OsRadixNodeAlloc(node, node->shift - RADIX_TREE_MAP_SHIFT, offset);
+            if (child == NULL) {
+                OsRadixNodePrune(tree, node);
+                return LOS_NOK;
+            }
+            node->slots[offset] = child;
+            node->bitmap |= 1U << offset;
+        }
+        node = child;
+    }
+
+    offset = OsRadixSlot(node, index);
+    if (node->slots[offset] != NULL) {
+        return LOS_NOK;
+    }
+    node->slots[offset] = item;
+    node->bitmap |= 1U << offset;
+    tree->count++;
+    return LOS_OK;
+}
+
+VOID *LOS_RadixTreeLookup(const LosRadixTree *tree, ULONG_T index)
+{
+    LosRadixNode *leaf = OsRadixLeafGet(tree, index);
+
+    return (leaf == NULL) ? NULL : leaf->slots[OsRadixSlot(leaf, index)];
+}
+
+VOID *LOS_RadixTreeDelete(LosRadixTree *tree, ULONG_T index)
+{
+    LosRadixNode *leaf = OsRadixLeafGet(tree, index);
+    UINT32 offset;
+    UINT32 tag;
+    VOID *item = NULL;
+
+    if (leaf == NULL) {
+        return NULL;
+    }
+
+    offset = OsRadixSlot(leaf, index);
+    item = leaf->slots[offset];
+    if (item == NULL) {
+        return NULL;
+    }
+
+    for (tag = 0; tag < RADIX_TREE_TAG_MAX; tag++) {
+        LOS_RadixTreeTagClear(tree, index, tag);
+    }
+    leaf->slots[offset] = NULL;
+    leaf->bitmap &= ~(1U << offset);
+    tree->count--;
+    OsRadixNodePrune(tree, leaf);
+    return item;
+}
+
+VOID LOS_RadixTreeTagSet(LosRadixTree *tree, ULONG_T index, UINT32 tag)
+{
+    LosRadixNode *node = OsRadixLeafGet(tree, index);
+    UINT32 offset;
+
+    if ((node == NULL) || (tag >= RADIX_TREE_TAG_MAX)) {
+        return;
+    }
+
+    offset = OsRadixSlot(node, index);
+    if (node->slots[offset] == NULL) {
+        return;
+    }
+
+    /* the ancestors are tagged already once a node has the tag */
+    while ((node != NULL) && !(node->tags[tag] & (1U << offset))) {
+        node->tags[tag] |= 1U << offset;
+        offset = node->offset;
+        node = node->parent;
+    }
+}
+
+VOID LOS_RadixTreeTagClear(LosRadixTree *tree, ULONG_T index, UINT32 tag)
+{
+    LosRadixNode *node = OsRadixLeafGet(tree, index);
+    UINT32 offset;
+
+    if ((node == NULL) || (tag >= RADIX_TREE_TAG_MAX)) {
+        return;
+    }
+
+    offset = OsRadixSlot(node, index);
+    while (node != NULL) {
+        node->tags[tag] &= ~(1U << offset);
+        if (node->tags[tag] != 0) {
+            break;
+        }
+        offset = node->offset;
+        node = node->parent;
+    }
+}
+
+BOOL LOS_RadixTreeTagGet(const LosRadixTree *tree, ULONG_T index, UINT32 tag)
+{
+    LosRadixNode *leaf = OsRadixLeafGet(tree, index);
+
+    if ((leaf == NULL) || (tag >= RADIX_TREE_TAG_MAX)) {
+        return FALSE;
+    }
+    return (leaf->tags[tag] & (1U << OsRadixSlot(leaf, index))) ? TRUE : FALSE;
+}
+
+UINT32 LOS_RadixTreeGangLookup(const LosRadixTree *tree, VOID **items, ULONG_T first, UINT32 maxItems)
+{
+    return OsRadixGangLookup(tree, items, first, maxItems, RADIX_TREE_TAG_NONE);
+}
+
+UINT32 LOS_RadixTreeGangLookupTag(const LosRadixTree *tree, VOID **items, ULONG_T first, UINT32 maxItems,
+                                  UINT32 tag)
+{
+    if (tag >= RADIX_TREE_TAG_MAX) {
+        return 0;
+    }
+    return OsRadixGangLookup(tree, items, first, maxItems, tag);
+}
@@ -81,6 +81,9 @@ int socks_poll(int sockfd, poll_table *wait);
 int socks_ioctl(int sockfd, long cmd, void *argp);
 int socks_close(int sockfd);
 void socks_refer(int sockfd);
+#ifdef LOSCFG_FS_VFS
+struct epoll_source *socks_epoll_source(int sockfd);
+#endif
 
 #ifdef __cplusplus
 }
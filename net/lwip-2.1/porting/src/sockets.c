@@ -32,6 +32,9 @@
 #include <lwip/sockets.h>
 #include <lwip/priv/tcpip_priv.h>
 #include <lwip/fixme.h>
+#ifdef LOSCFG_FS_VFS
+#include "epoll.h"
+#endif
 
 #if LWIP_ENABLE_NET_CAPABILITY
 #include "capability_type.h"
@@ -258,6 +261,23 @@ struct file;
 extern void poll_wait(struct file *filp, wait_queue_head_t *wait_address, poll_table *p);
 extern void __wake_up_interruptible_poll(wait_queue_head_t *wait, pollevent_t key);
 
+#ifdef LOSCFG_FS_VFS
+/* readiness sources feeding epoll, indexed like sockets[] */
+static struct epoll_source sock_epoll_sources[NUM_SOCKETS];
+#endif
+
+/* called with SYS_ARCH_PROTECT held */
+static pollevent_t sock_poll_mask(const struct lwip_sock *sock)
+{
+    pollevent_t mask = 0;
+
+    mask |= (sock->rcvevent > 0 || sock->lastdata.pbuf) ? (POLLIN | POLLPRI | POLLRDNORM | POLLRDBAND) : 0;
+    mask |= (sock->sendevent != 0) ? (POLLOUT | POLLWRNORM | POLLWRBAND) : 0;
+    mask |= (sock->errevent != 0) ? (POLLERR) : 0;
+
+    return mask;
+}
+
 static void poll_check_waiters(int s, int check_waiters)
 {
     unsigned long int_save, wq_empty;
@@ -276,9 +296,7 @@ static void poll_check_waiters(int s, int check_waiters)
 
     SYS_ARCH_PROTECT(lev);
 
-    mask |= (sock->rcvevent > 0) ? (POLLIN | POLLPRI | POLLRDNORM | POLLRDBAND) : 0;
-    mask |= (sock->sendevent != 0) ? (POLLOUT | POLLWRNORM | POLLWRBAND) : 0;
-    mask |= (sock->errevent != 0) ? (POLLERR) : 0;
+    mask = sock_poll_mask(sock);
 
     SYS_ARCH_UNPROTECT(lev);
 
@@ -290,6 +308,12 @@ static void poll_check_waiters(int s, int check_waiters)
         __wake_up_interruptible_poll(&sock->wq, mask);
     }
 
+#ifdef LOSCFG_FS_VFS
+    if (mask) {
+        epoll_source_notify(&sock_epoll_sources[s - LWIP_SOCKET_OFFSET], mask);
+    }
+#endif
+
     done_socket(sock);
 }
 
@@ -311,9 +335,7 @@ int socks_poll(int s, poll_table *wait)
 
     SYS_ARCH_PROTECT(lev);
 
-    mask |= (sock->rcvevent > 0 || sock->lastdata.pbuf) ? (POLLIN | POLLPRI | POLLRDNORM | POLLRDBAND) : 0;
-    mask |= (sock->sendevent != 0) ? (POLLOUT | POLLWRNORM | POLLWRBAND) : 0;
-    mask |= (sock->errevent != 0) ? (POLLERR) : 0;
+    mask = sock_poll_mask(sock);
 
     SYS_ARCH_UNPROTECT(lev);
 
@@ -326,6 +348,49 @@ int socks_poll(int s, poll_table *wait)
     return ret;
 }
 
+#ifdef LOSCFG_FS_VFS
+static UINT32 socks_epoll_poll(int s)
+{
+    pollevent_t mask;
+    struct lwip_sock *sock;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    sock = get_socket(s);
+    if (!sock) {
+        return POLLNVAL;
+    }
+
+    SYS_ARCH_PROTECT(lev);
+    mask = sock_poll_mask(sock);
+    SYS_ARCH_UNPROTECT(lev);
+
+    done_socket(sock);
+    return (UINT32)mask;
+}
+
+struct epoll_source *socks_epoll_source(int s)
+{
+    struct epoll_source *src;
+    struct lwip_sock *sock;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    sock = get_socket(s);
+    if (!sock) {
+        return NULL;
+    }
+
+    src = &sock_epoll_sources[s - LWIP_SOCKET_OFFSET];
+    SYS_ARCH_PROTECT(lev);
+    if (src->items.pstNext == NULL) {
+        epoll_source_init(src, socks_epoll_poll);
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    done_socket(sock);
+    return src;
+}
+#endif
+
 #endif /* LWIP_SOCKET_SELECT || LWIP_SOCKET_POLL */
 
 #if !LWIP_COMPAT_SOCKETS
@@ -1642,6 +1707,9 @@ int socks_close(int sockfd)
     if (sock->s_refcount == 0) {
         SYS_ARCH_UNPROTECT(lev);
         done_socket(sock);
+#if (LWIP_SOCKET_SELECT || LWIP_SOCKET_POLL) && defined(LOSCFG_FS_VFS)
+        epoll_source_release(&sock_epoll_sources[sockfd - LWIP_SOCKET_OFFSET]);
+#endif
         return lwip_close(sockfd);
     }
 
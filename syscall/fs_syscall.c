@@ -51,14 +51,18 @@
 #include "dirent.h"
 #include "user_copy.h"
 #include "los_vm_map.h"
+#include "los_vm_pin.h"
 #include "los_memory.h"
 #include "los_strncpy_from_user.h"
 #include "capability_type.h"
 #include "capability_api.h"
 #include "sys/statfs.h"
+#include "limits.h"
 
 #define HIGH_SHIFT_BIT 32
 #define TIMESPEC_TIMES_NUM  2
+/* events harvested by one epoll_wait, bounds the kernel copy whatever maxevents the caller passes */
+#define EPOLL_WAIT_BATCH    256
 
 static int CheckNewAttrTime(struct IATTR *attr, struct timespec times[TIMESPEC_TIMES_NUM])
 {
@@ -1499,15 +1503,34 @@ ERROR:
     return -err;
 }
 
+struct PosIoArg {
+    int fd;
+    off64_t offset;
+};
+
+static ssize_t PreadChunk(VOID *arg, VOID *kbuf, size_t len, size_t pos)
+{
+    struct PosIoArg *io = (struct PosIoArg *)arg;
+    ssize_t ret = pread64(io->fd, kbuf, len, io->offset + (off64_t)pos);
+    return (ret < 0) ? -get_errno() : ret;
+}
+
+static ssize_t PwriteChunk(VOID *arg, VOID *kbuf, size_t len, size_t pos)
+{
+    struct PosIoArg *io = (struct PosIoArg *)arg;
+    ssize_t ret = pwrite64(io->fd, kbuf, len, io->offset + (off64_t)pos);
+    return (ret < 0) ? -get_errno() : ret;
+}
+
 ssize_t SysPread64(int fd, void *buf, size_t nbytes, off64_t offset)
 {
-    int ret, retVal;
-    char *bufRet = NULL;
+    int ret;
+    struct PosIoArg arg;
 
     /* Process fd convert to system global fd */
     fd = GetAssociatedSystemFd(fd);
 
-    if (nbytes == 0) {
+    if ((nbytes == 0) || (buf == NULL)) {
         ret = pread64(fd, buf, nbytes, offset);
         if (ret < 0) {
             return -get_errno();
@@ -1516,36 +1539,24 @@ ssize_t SysPread64(int fd, void *buf, size_t nbytes, off64_t offset)
         }
     }
 
-    bufRet = (char *)LOS_MemAlloc(OS_SYS_MEM_ADDR, nbytes);
-    if (bufRet == NULL) {
-        return -ENOMEM;
-    }
-
-    ret = pread64(fd, (buf ? bufRet : NULL), nbytes, offset);
-    if (ret < 0) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
-        return -get_errno();
-    }
-
-    retVal = LOS_ArchCopyToUser(buf, bufRet, ret);
-    if (retVal != 0) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
+    if (!LOS_IsUserAddressRange((VADDR_T)(UINTPTR)buf, nbytes)) {
         return -EFAULT;
     }
 
-    (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
-    return ret;
+    arg.fd = fd;
+    arg.offset = offset;
+    return LOS_VmUserBufIo(buf, nbytes, TRUE, PreadChunk, &arg);
 }
 
 ssize_t SysPwrite64(int fd, const void *buf, size_t nbytes, off64_t offset)
 {
     int ret;
-    char *bufRet = NULL;
+    struct PosIoArg arg;
 
     /* Process fd convert to system global fd */
     fd = GetAssociatedSystemFd(fd);
 
-    if (nbytes == 0) {
+    if ((nbytes == 0) || (buf == NULL)) {
         ret = pwrite64(fd, buf, nbytes, offset);
         if (ret < 0) {
             return -get_errno();
@@ -1553,27 +1564,13 @@ ssize_t SysPwrite64(int fd, const void *buf, size_t nbytes, off64_t offset)
         return ret;
     }
 
-    bufRet = (char *)LOS_MemAlloc(OS_SYS_MEM_ADDR, nbytes);
-    if (bufRet == NULL) {
-        return -ENOMEM;
-    }
-
-    if (buf != NULL) {
-        ret = LOS_ArchCopyFromUser(bufRet, buf, nbytes);
-        if (ret != 0) {
-            (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
-            return -EFAULT;
-        }
-    }
-
-    ret = pwrite64(fd, (buf ? bufRet : NULL), nbytes, offset);
-    if (ret < 0) {
-        (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
-        return -get_errno();
+    if (!LOS_IsUserAddressRange((VADDR_T)(UINTPTR)buf, nbytes)) {
+        return -EFAULT;
     }
 
-    (void)LOS_MemFree(OS_SYS_MEM_ADDR, bufRet);
-    return ret;
+    arg.fd = fd;
+    arg.offset = offset;
+    return LOS_VmUserBufIo((VOID *)buf, nbytes, FALSE, PwriteChunk, &arg);
 }
 
 char *SysGetcwd(char *buf, size_t n)
@@ -2648,7 +2645,6 @@ int SysEpollCtl(int epfd, int op, int fd, struct epoll_event *ev)
 
     ret = epoll_ctl(epfd, op, fd, ev);
     if (ret < 0) {
-        ret = -EBADF;
         goto OUT;
     }
 
@@ -2657,34 +2653,49 @@ OUT:
     return (ret == -1) ? -get_errno() : ret;
 }
 
-int SysEpollWait(int epfd, struct epoll_event *evs, int maxevents, int timeout)
+/* every ready event is copied back to the caller, not only the first one */
+static int DoEpollWait(int epfd, struct epoll_event *evs, int maxevents, int timeout)
 {
-    int ret = 0;
+    int ret;
+
+    if ((maxevents <= 0) || (maxevents > (INT_MAX / (int)sizeof(struct epoll_event)))) {
+        return -EINVAL;
+    }
 
-    CHECK_ASPACE(evs, sizeof(struct epoll_event));
-    CPY_FROM_USER(evs);
+    CHECK_ASPACE(evs, sizeof(struct epoll_event) * maxevents);
+    /* returning fewer events than asked for is fine, the rest are reported by the next call */
+    if (maxevents > EPOLL_WAIT_BATCH) {
+        maxevents = EPOLL_WAIT_BATCH;
+    }
+    DUP_FROM_USER_NOCOPY(evs, sizeof(struct epoll_event) * maxevents);
 
     epfd = GetAssociatedSystemFd(epfd);
-    if  (epfd < 0) {
-        ret = -EBADF;
-        goto OUT;
+    if (epfd < 0) {
+        FREE_DUP(evs);
+        return -EBADF;
     }
 
     ret = epoll_wait(epfd, evs, maxevents, timeout);
     if (ret < 0) {
-        ret = -get_errno();
+        FREE_DUP(evs);
+        return -get_errno();
     }
 
-    CPY_TO_USER(evs);
-OUT:
-    return (ret == -1) ? -get_errno() : ret;
+    DUP_TO_USER(evs, sizeof(struct epoll_event) * ret, FREE_DUP(evs));
+    FREE_DUP(evs);
+    return ret;
+}
+
+int SysEpollWait(int epfd, struct epoll_event *evs, int maxevents, int timeout)
+{
+    return DoEpollWait(epfd, evs, maxevents, timeout);
 }
 
 int SysEpollPwait(int epfd, struct epoll_event *evs, int maxevents, int timeout, const sigset_t *mask)
 {
     sigset_t_l origMask;
     sigset_t_l setl;
-    int ret = 0;
+    int ret;
 
     CHECK_ASPACE(mask, sizeof(sigset_t));
 
@@ -2693,28 +2704,15 @@ int SysEpollPwait(int epfd, struct epoll_event *evs, int maxevents, int timeout,
         if (ret != 0) {
             return -EFAULT;
         }
+        OsSigprocMask(SIG_SETMASK, &setl, &origMask);
     }
 
-    CHECK_ASPACE(evs, sizeof(struct epoll_event));
-    CPY_FROM_USER(evs);
-
-    epfd = GetAssociatedSystemFd(epfd);
-    if (epfd < 0) {
-        ret = -EBADF;
-        goto OUT;
-    }
+    ret = DoEpollWait(epfd, evs, maxevents, timeout);
 
-    OsSigprocMask(SIG_SETMASK, &setl, &origMask);
-    ret = epoll_wait(epfd, evs, maxevents, timeout);
-    if (ret < 0) {
-        ret = -get_errno();
+    if (mask != NULL) {
+        OsSigprocMask(SIG_SETMASK, &origMask, NULL);
     }
-
-    OsSigprocMask(SIG_SETMASK, &origMask, NULL);
-
-    CPY_TO_USER(evs);
-OUT:
-    return (ret == -1) ? -get_errno() : ret;
+    return ret;
 }
 
 #endif
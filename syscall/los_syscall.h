@@ -67,6 +67,8 @@
 #include "vnode.h"
 #endif
 
+struct sched_attr;
+
 /* process */
 extern unsigned int SysGetGroupId(void);
 extern unsigned int SysGetTid(void);
@@ -80,6 +82,8 @@ extern int SysGetProcessPriority(int which, int who);
 extern int SysSchedGetPriorityMin(int policy);
 extern int SysSchedGetPriorityMax(int policy);
 extern int SysSchedRRGetInterval(int pid, struct timespec *tp);
+extern int SysSchedSetAttr(int id, struct sched_attr *userAttr, unsigned int flags);
+extern int SysSchedGetAttr(int id, struct sched_attr *userAttr, unsigned int size, unsigned int flags);
 extern int SysWait(int pid, USER int *status, int options, void *rusage);
 extern int SysWaitid(idtype_t type, int pid, USER siginfo_t *info, int options, void *rusage);
 extern int SysFork(void);
@@ -112,7 +116,7 @@ extern int SysThreadJoin(unsigned int taskID);
 extern void SysUserExitGroup(int status);
 extern void SysThreadExit(int status);
 extern int SysFutex(const unsigned int *uAddr, unsigned int flags, int val,
-                    unsigned int absTime, const unsigned int *newUserAddr);
+                    unsigned int absTime, const unsigned int *newUserAddr, unsigned int val3);
 extern int SysSchedGetAffinity(int id, unsigned int *cpuset, int flag);
 extern int SysSchedSetAffinity(int id, const unsigned short cpuset, int flag);
 
@@ -43,6 +43,18 @@
 #include "capability_api.h"
 #endif
 
+/* The linux sched_setattr layout, the times are in nanoseconds */
+struct sched_attr {
+    unsigned int size;
+    unsigned int sched_policy;
+    unsigned long long sched_flags;
+    int sched_nice;
+    unsigned int sched_priority;
+    unsigned long long sched_runtime;
+    unsigned long long sched_deadline;
+    unsigned long long sched_period;
+};
+
 static int OsPermissionToCheck(unsigned int pid, unsigned int who)
 {
     int ret = LOS_GetProcessGroupID(pid);
@@ -100,6 +112,54 @@ static int OsUserTaskSchedulerSet(unsigned int tid, unsigned short policy, unsig
     return LOS_OK;
 }
 
+static int OsUserTaskDeadlineSet(unsigned int tid, const struct sched_attr *attr)
+{
+    int ret;
+    unsigned int intSave;
+    BOOL needSched = FALSE;
+    SchedParam param = { 0 };
+
+    if (OS_TID_CHECK_INVALID(tid)) {
+        return EINVAL;
+    }
+
+    if ((attr->sched_runtime == 0) || (attr->sched_deadline == 0)) {
+        return EINVAL;
+    }
+
+#ifdef LOSCFG_SECURITY_CAPABILITY
+    if (!IsCapPermit(CAP_SCHED_SETPRIORITY)) {
+        return EPERM;
+    }
+#endif
+
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(tid);
+    SCHEDULER_LOCK(intSave);
+    ret = OsUserTaskOperatePermissionsCheck(taskCB);
+    if (ret != LOS_OK) {
+        SCHEDULER_UNLOCK(intSave);
+        return ret;
+    }
+
+    taskCB->ops->schedParamGet(taskCB, &param);
+    param.policy = LOS_SCHED_DEADLINE;
+    param.runTime = OsSchedNsToCycle(attr->sched_runtime);
+    param.deadline = OsSchedNsToCycle(attr->sched_deadline);
+    param.period = OsSchedNsToCycle(attr->sched_period);
+    ret = (int)OsSchedParamSet(taskCB, &param, &needSched);
+    SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return ret;
+    }
+
+    LOS_MpSchedule(OS_MP_CPU_ALL);
+    if (needSched && OS_SCHEDULER_ACTIVE) {
+        LOS_Schedule();
+    }
+
+    return LOS_OK;
+}
+
 void SysSchedYield(int type)
 {
     (void)type;
@@ -222,6 +282,86 @@ int SysSchedSetParam(int id, unsigned int prio, int flag)
     return SysSetProcessPriority(LOS_PRIO_PROCESS, id, prio);
 }
 
+int SysSchedSetAttr(int id, struct sched_attr *userAttr, unsigned int flags)
+{
+    struct sched_attr attr = { 0 };
+
+    if ((userAttr == NULL) || (flags != 0)) {
+        return -EINVAL;
+    }
+
+    if (LOS_ArchCopyFromUser(&attr, userAttr, sizeof(struct sched_attr)) != 0) {
+        return -EFAULT;
+    }
+
+    if ((attr.size != 0) && (attr.size < sizeof(struct sched_attr))) {
+        return -EINVAL;
+    }
+
+    if (id == 0) {
+        id = (int)OsCurrTaskGet()->taskID;
+    }
+
+    if (attr.sched_policy == LOS_SCHED_DEADLINE) {
+        return -OsUserTaskDeadlineSet(id, &attr);
+    }
+
+    if ((attr.sched_policy != LOS_SCHED_FIFO) && (attr.sched_policy != LOS_SCHED_RR)) {
+        return -EINVAL;
+    }
+
+    if (attr.sched_priority > OS_TASK_PRIORITY_LOWEST) {
+        return -EINVAL;
+    }
+
+    return -OsUserTaskSchedulerSet(id, attr.sched_policy, attr.sched_priority, true);
+}
+
+int SysSchedGetAttr(int id, struct sched_attr *userAttr, unsigned int size, unsigned int flags)
+{
+    struct sched_attr attr = { 0 };
+    SchedParam param = { 0 };
+    unsigned int intSave;
+
+    if ((userAttr == NULL) || (flags != 0) || (size < sizeof(struct sched_attr))) {
+        return -EINVAL;
+    }
+
+    if (id == 0) {
+        id = (int)OsCurrTaskGet()->taskID;
+    }
+
+    if (OS_TID_CHECK_INVALID(id)) {
+        return -EINVAL;
+    }
+
+    LosTaskCB *taskCB = OS_TCB_FROM_TID(id);
+    SCHEDULER_LOCK(intSave);
+    int ret = OsUserTaskOperatePermissionsCheck(taskCB);
+    if (ret != LOS_OK) {
+        SCHEDULER_UNLOCK(intSave);
+        return -ret;
+    }
+
+    taskCB->ops->schedParamGet(taskCB, &param);
+    SCHEDULER_UNLOCK(intSave);
+
+    attr.size = sizeof(struct sched_attr);
+    attr.sched_policy = param.policy;
+    attr.sched_priority = param.priority;
+    if (param.policy == LOS_SCHED_DEADLINE) {
+        attr.sched_runtime = OsSchedCycleToNs(param.runTime);
+        attr.sched_deadline = OsSchedCycleToNs(param.deadline);
+        attr.sched_period = OsSchedCycleToNs(param.period);
+    }
+
+    if (LOS_ArchCopyToUser(userAttr, &attr, sizeof(struct sched_attr)) != 0) {
+        return -EFAULT;
+    }
+
+    return 0;
+}
+
 int SysGetProcessPriority(int which, int who)
 {
     if (who == 0) {
@@ -1006,14 +1146,28 @@ void SysThreadExit(int status)
 }
 
 int SysFutex(const unsigned int *uAddr, unsigned int flags, int val,
-             unsigned int absTime, const unsigned int *newUserAddr)
+             unsigned int absTime, const unsigned int *newUserAddr, unsigned int val3)
 {
-    if ((flags & FUTEX_MASK) == FUTEX_REQUEUE) {
-        return -OsFutexRequeue(uAddr, flags, val, absTime, newUserAddr);
-    }
-
-    if ((flags & FUTEX_MASK) == FUTEX_WAKE) {
-        return -OsFutexWake(uAddr, flags, val);
+    switch (flags & FUTEX_MASK) {
+        case FUTEX_REQUEUE:
+            return -OsFutexRequeue(uAddr, flags, val, absTime, newUserAddr);
+        case FUTEX_WAKE:
+            return -OsFutexWake(uAddr, flags, val);
+        case FUTEX_WAKE_BITSET:
+            return -OsFutexWakeBitset(uAddr, flags, val, val3);
+        case FUTEX_WAKE_OP:
+            /* the timeout slot carries the wake count for the second address */
+            return -OsFutexWakeOp(uAddr, flags, val, (int)absTime, newUserAddr, val3);
+        case FUTEX_WAIT_BITSET:
+            return -OsFutexWaitBitset(uAddr, flags, val, absTime, val3);
+        case FUTEX_LOCK_PI:
+            return -OsFutexLockPi(uAddr, flags, absTime, FALSE);
+        case FUTEX_TRYLOCK_PI:
+            return -OsFutexLockPi(uAddr, flags, absTime, TRUE);
+        case FUTEX_UNLOCK_PI:
+            return -OsFutexUnlockPi(uAddr, flags);
+        default:
+            break;
     }
 
     return -OsFutexWait(uAddr, flags, val, absTime);
@@ -1097,7 +1251,7 @@ int SysSchedSetAffinity(int id, const unsigned short cpuset, int flag)
     unsigned int taskID;
     unsigned int intSave;
     unsigned short currCpuMask;
-    bool needSched = FALSE;
+    BOOL needSched = FALSE;
 
     if (cpuset > LOSCFG_KERNEL_CPU_MASK) {
         return -EINVAL;
@@ -1130,8 +1284,12 @@ int SysSchedSetAffinity(int id, const unsigned short cpuset, int flag)
         }
     }
 
-    needSched = OsTaskCpuAffiSetUnsafe(taskID, cpuset, &currCpuMask);
+    ret = OsTaskCpuAffiSetUnsafe(taskID, cpuset, &currCpuMask, &needSched);
     SCHEDULER_UNLOCK(intSave);
+    if (ret != LOS_OK) {
+        return -EBUSY;
+    }
+    OsSchedPreemptTargetNotify();
     if (needSched && OS_SCHEDULER_ACTIVE) {
         LOS_MpSchedule(currCpuMask);
         LOS_Schedule();
@@ -172,6 +172,8 @@ SYSCALL_HAND_DEF(__NR_sched_get_priority_min, SysSchedGetPriorityMin, int, ARG_N
 SYSCALL_HAND_DEF(__NR_sched_setaffinity, SysSchedSetAffinity, int, ARG_NUM_3)
 SYSCALL_HAND_DEF(__NR_sched_getaffinity, SysSchedGetAffinity, int, ARG_NUM_3)
 SYSCALL_HAND_DEF(__NR_sched_rr_get_interval, SysSchedRRGetInterval, int, ARG_NUM_2)
+SYSCALL_HAND_DEF(__NR_sched_setattr, SysSchedSetAttr, int, ARG_NUM_3)
+SYSCALL_HAND_DEF(__NR_sched_getattr, SysSchedGetAttr, int, ARG_NUM_4)
 SYSCALL_HAND_DEF(__NR_nanosleep, SysNanoSleep, int, ARG_NUM_2)
 SYSCALL_HAND_DEF(__NR_mremap, SysMremap, void *, ARG_NUM_5)
 SYSCALL_HAND_DEF(__NR_umask, SysUmask, mode_t, ARG_NUM_1)
@@ -211,7 +213,7 @@ SYSCALL_HAND_DEF(__NR_gettid, SysGetTid, unsigned int, ARG_NUM_0)
 
 SYSCALL_HAND_DEF(__NR_tkill, SysPthreadKill, int, ARG_NUM_2)
 
-SYSCALL_HAND_DEF(__NR_futex, SysFutex, int, ARG_NUM_4)
+SYSCALL_HAND_DEF(__NR_futex, SysFutex, int, ARG_NUM_6)
 SYSCALL_HAND_DEF(__NR_exit_group, SysUserExitGroup, void, ARG_NUM_1)
 SYSCALL_HAND_DEF(__NR_set_thread_area, SysSetThreadArea, int, ARG_NUM_1)
 SYSCALL_HAND_DEF(__NR_get_thread_area, SysGetThreadArea, char *, ARG_NUM_0)
@@ -132,6 +132,7 @@ VOID ItSuiteLosSwtmr(VOID)
     ItLosSwtmr076();
     ItLosSwtmr077();
     ItLosSwtmr078();
+    ItLosSwtmr084();
 #endif
 
 #if defined(LOSCFG_TEST_PRESSURE)
@@ -177,6 +177,7 @@ VOID ItLosSwtmr075(VOID);
 VOID ItLosSwtmr076(VOID);
 VOID ItLosSwtmr077(VOID);
 VOID ItLosSwtmr078(VOID);
+VOID ItLosSwtmr084(VOID);
 #endif
 
 #if defined(LOSCFG_TEST_PRESSURE)
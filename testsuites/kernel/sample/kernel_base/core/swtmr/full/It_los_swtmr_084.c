@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_swtmr.h"
+#include "los_sortlink_pri.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define SORTLINK_BENCH_SPAN_TICKS 1000 /* timers are spread over 1000 ticks */
+
+static UINT32 SortLinkBench(UINT32 nodeNum)
+{
+    UINT32 ret;
+    UINT32 count = 0;
+    UINT64 lastTime = 0;
+    SortLinkList *sortList = NULL;
+    SortLinkList *nodes = (SortLinkList *)LOS_MemAlloc(m_aucSysMem1, sizeof(SortLinkList) * nodeNum);
+    SortLinkAttribute *head = (SortLinkAttribute *)LOS_MemAlloc(m_aucSysMem1, sizeof(SortLinkAttribute));
+    ICUNIT_GOTO_NOT_EQUAL(nodes, NULL, nodes, EXIT);
+    ICUNIT_GOTO_NOT_EQUAL(head, NULL, head, EXIT);
+
+    OsSortLinkInit(head);
+    UINT64 span = OS_SCHED_TICK_TO_CYCLE(SORTLINK_BENCH_SPAN_TICKS);
+    UINT64 baseTime = OsGetCurrSchedTimeCycle();
+    UINT32 seed = 0x5a5a5a5a;
+    /* start the wheel at the current time like a runqueue's, or every node lands on the overflow bucket */
+    head->clock = baseTime >> OS_SORT_LINK_GRANULE_SHIFT;
+
+    UINT64 startTime = OsGetCurrSchedTimeCycle();
+    for (UINT32 index = 0; index < nodeNum; index++) {
+        seed = seed * 1103515245 + 12345; /* 1103515245, 12345: LCG parameters */
+        OsAdd2SortLink(head, &nodes[index], baseTime + (seed % span), 0);
+    }
+    UINT64 insertTime = OsGetCurrSchedTimeCycle() - startTime;
+    ICUNIT_GOTO_EQUAL(OsGetSortLinkNodeNum(head), nodeNum, OsGetSortLinkNodeNum(head), EXIT);
+    for (UINT32 index = 0; index < nodeNum; index++) {
+        ICUNIT_GOTO_NOT_EQUAL(nodes[index].bucket, OS_SORT_LINK_OVERFLOW_BUCKET, index, EXIT);
+    }
+
+    startTime = OsGetCurrSchedTimeCycle();
+    LOS_SpinLock(&head->spinLock);
+    sortList = OsSortLinkExpiredNodeGet(head, baseTime + span);
+    while (sortList != NULL) {
+        if (sortList->responseTime < lastTime) {
+            break;
+        }
+        lastTime = sortList->responseTime;
+        OsDeleteNodeSortLink(head, sortList);
+        count++;
+        sortList = OsSortLinkExpiredNodeGet(head, baseTime + span);
+    }
+    LOS_SpinUnlock(&head->spinLock);
+    UINT64 expireTime = OsGetCurrSchedTimeCycle() - startTime;
+    ICUNIT_GOTO_EQUAL(count, nodeNum, count, EXIT);
+
+    dprintf("sortlink %u timers: insert %llu cycles/op, expire %llu cycles/op\n", nodeNum,
+            insertTime / nodeNum, expireTime / nodeNum);
+    ret = LOS_OK;
+    goto FREE;
+
+EXIT:
+    ret = LOS_NOK;
+FREE:
+    (VOID)LOS_MemFree(m_aucSysMem1, head);
+    (VOID)LOS_MemFree(m_aucSysMem1, nodes);
+    return ret;
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret;
+
+    ret = SortLinkBench(10); /* 10 outstanding timers */
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    ret = SortLinkBench(1000); /* 1000 outstanding timers */
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    ret = SortLinkBench(10000); /* 10000 outstanding timers */
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    return LOS_OK;
+}
+
+VOID ItLosSwtmr084(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItLosSwtmr084", Testcase, TEST_LOS, TEST_SWTMR, TEST_LEVEL1, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -174,6 +174,10 @@ void ItSuiteLosTask(void)
     ItSmpLosTask155();
     ItSmpLosTask156();
     ItSmpLosTask157();
+    ItSmpLosTask162();
+    ItSmpLosTask163();
+    ItSmpLosTask164();
+    ItSmpLosTask165();
 #endif
 }
 #ifdef __cplusplus
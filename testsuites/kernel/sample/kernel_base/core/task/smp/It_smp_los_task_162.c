@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_task.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define BENCH_CPU_TASK_NUM    4
+#define BENCH_IO_TASK_NUM     8
+#define BENCH_TASK_NUM        (BENCH_CPU_TASK_NUM + BENCH_IO_TASK_NUM)
+#define BENCH_RUN_TICKS       1000
+#define BENCH_IO_WORK_LOOP    1000
+
+static volatile UINT32 g_benchStop;
+static volatile UINT64 g_benchCpuLoops[BENCH_CPU_TASK_NUM];
+static volatile UINT64 g_benchIoLoops[BENCH_IO_TASK_NUM];
+
+static void CpuBoundTask(UINTPTR index)
+{
+    while (!g_benchStop) {
+        g_benchCpuLoops[index]++;
+    }
+    LOS_AtomicInc(&g_testCount);
+}
+
+static void IoBoundTask(UINTPTR index)
+{
+    while (!g_benchStop) {
+        for (volatile UINT32 loop = 0; loop < BENCH_IO_WORK_LOOP; loop++) {
+        }
+        g_benchIoLoops[index]++;
+        (VOID)LOS_TaskDelay(1);
+    }
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 SchedBench(UINT16 cpuNum)
+{
+    UINT32 ret;
+    UINT32 taskID[BENCH_TASK_NUM];
+    TSK_INIT_PARAM_S task = { 0 };
+    UINT16 affiMask = (UINT16)((1U << cpuNum) - 1);
+    UINT64 cpuLoops = 0;
+    UINT64 ioLoops = 0;
+
+    g_testCount = 0;
+    g_benchStop = 0;
+    (VOID)memset_s((VOID *)g_benchCpuLoops, sizeof(g_benchCpuLoops), 0, sizeof(g_benchCpuLoops));
+    (VOID)memset_s((VOID *)g_benchIoLoops, sizeof(g_benchIoLoops), 0, sizeof(g_benchIoLoops));
+
+    for (UINT32 index = 0; index < BENCH_TASK_NUM; index++) {
+        if (index < BENCH_CPU_TASK_NUM) {
+            TEST_TASK_PARAM_INIT_AFFI(task, "it_smp_task_162_cpu", CpuBoundTask, TASK_PRIO_TEST_TASK + 2, affiMask);
+            task.auwArgs[0] = index;
+        } else {
+            TEST_TASK_PARAM_INIT_AFFI(task, "it_smp_task_162_io", IoBoundTask, TASK_PRIO_TEST_TASK + 1, affiMask);
+            task.auwArgs[0] = index - BENCH_CPU_TASK_NUM;
+        }
+        ret = LOS_TaskCreate(&taskID[index], &task);
+        ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    }
+
+    (VOID)LOS_TaskDelay(BENCH_RUN_TICKS);
+    g_benchStop = 1;
+
+    while (g_testCount < BENCH_TASK_NUM) {
+        (VOID)LOS_TaskDelay(1);
+    }
+
+    for (UINT32 index = 0; index < BENCH_CPU_TASK_NUM; index++) {
+        ICUNIT_ASSERT_NOT_EQUAL(g_benchCpuLoops[index], 0, index);
+        cpuLoops += g_benchCpuLoops[index];
+    }
+    for (UINT32 index = 0; index < BENCH_IO_TASK_NUM; index++) {
+        ICUNIT_ASSERT_NOT_EQUAL(g_benchIoLoops[index], 0, index);
+        ioLoops += g_benchIoLoops[index];
+    }
+
+    dprintf("%u cpus, %u cpu-bound + %u io-bound tasks in %u ticks: cpu loops %llu, io rounds %llu\n",
+            cpuNum, BENCH_CPU_TASK_NUM, BENCH_IO_TASK_NUM, BENCH_RUN_TICKS, cpuLoops, ioLoops);
+    return LOS_OK;
+}
+
+static UINT32 Testcase(void)
+{
+    UINT32 ret;
+
+    ret = SchedBench(2); /* 2: run the tasks on two cores */
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    if (LOSCFG_KERNEL_CORE_NUM >= 4) { /* 4: run the tasks on four cores when available */
+        ret = SchedBench(4); /* 4: four cores */
+        ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    }
+
+    return LOS_OK;
+}
+
+void ItSmpLosTask162(void)
+{
+    TEST_ADD_CASE("ItSmpLosTask162", Testcase, TEST_LOS, TEST_TASK, TEST_LEVEL1, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_task.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define DEADLINE_RUNTIME_NS    2000000  /* 2ms */
+#define DEADLINE_PERIOD_NS     10000000 /* 10ms */
+#define DEADLINE_RUN_TICKS     100
+
+static volatile UINT32 g_deadlineStop;
+static volatile UINT64 g_deadlineMaxGap;
+
+static void DeadlineTask(void)
+{
+    UINT64 last = LOS_CurrNanosec();
+
+    while (!g_deadlineStop) {
+        UINT64 now = LOS_CurrNanosec();
+        if ((now - last) > g_deadlineMaxGap) {
+            g_deadlineMaxGap = now - last;
+        }
+        last = now;
+    }
+    LOS_AtomicInc(&g_testCount);
+}
+
+static void ReserveTask(void)
+{
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(void)
+{
+    UINT32 ret;
+    UINT32 taskID1, taskID2;
+    TSK_INIT_PARAM_S task = { 0 };
+    UINT16 affiMask = CPUID_TO_AFFI_MASK(ArchCurrCpuid());
+
+    g_testCount = 0;
+    g_deadlineStop = 0;
+    g_deadlineMaxGap = 0;
+
+    TEST_TASK_PARAM_INIT_AFFI(task, "it_smp_task_163_1", (TSK_ENTRY_FUNC)DeadlineTask, TASK_PRIO_TEST_TASK + 1,
+                              affiMask);
+    ret = LOS_TaskCreateOnly(&taskID1, &task);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    TEST_TASK_PARAM_INIT_AFFI(task, "it_smp_task_163_2", (TSK_ENTRY_FUNC)ReserveTask, TASK_PRIO_TEST_TASK + 1,
+                              affiMask);
+    ret = LOS_TaskCreateOnly(&taskID2, &task);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    /* the budget can not exceed the deadline */
+    ret = LOS_SetTaskDeadline(taskID1, DEADLINE_PERIOD_NS, DEADLINE_RUNTIME_NS, 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_EINVAL, ret, EXIT);
+
+    ret = LOS_SetTaskDeadline(taskID1, DEADLINE_RUNTIME_NS, DEADLINE_PERIOD_NS, DEADLINE_PERIOD_NS);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = LOS_GetTaskScheduler(taskID1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_SCHED_DEADLINE, ret, EXIT);
+
+    /* 20% is reserved on this cpu already, 90% more does not fit */
+    ret = LOS_SetTaskDeadline(taskID2, (DEADLINE_PERIOD_NS * 9) / 10, DEADLINE_PERIOD_NS, 0); /* 9 / 10: 90% */
+    ICUNIT_GOTO_EQUAL(ret, LOS_EBUSY, ret, EXIT);
+
+    (VOID)LOS_TaskDelay(DEADLINE_RUN_TICKS);
+
+    /* the spinning task is throttled for the rest of each period once its budget is used up */
+    ICUNIT_GOTO_NOT_EQUAL((g_deadlineMaxGap >= ((DEADLINE_PERIOD_NS - DEADLINE_RUNTIME_NS) / 2)), 0,
+                          g_deadlineMaxGap, EXIT);
+
+    ret = LOS_SetTaskScheduler(taskID1, LOS_SCHED_RR, TASK_PRIO_TEST_TASK + 1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* the bandwidth came back with the return to RR */
+    ret = LOS_SetTaskDeadline(taskID2, (DEADLINE_PERIOD_NS * 9) / 10, DEADLINE_PERIOD_NS, 0); /* 9 / 10: 90% */
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    g_deadlineStop = 1;
+    while (g_testCount < 2) { /* 2: both tasks exited */
+        (VOID)LOS_TaskDelay(1);
+    }
+
+    return LOS_OK;
+
+EXIT:
+    g_deadlineStop = 1;
+    (VOID)LOS_TaskDelete(taskID1);
+    (VOID)LOS_TaskDelete(taskID2);
+    return LOS_OK;
+}
+
+void ItSmpLosTask163(void)
+{
+    TEST_ADD_CASE("ItSmpLosTask163", Testcase, TEST_LOS, TEST_TASK, TEST_LEVEL1, TEST_FUNCTION);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "It_los_task.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define SPIN_STRESS_LOOP    100000
+
+static SPIN_LOCK_INIT(g_stressSpin);
+static volatile UINT32 g_stressStart;
+static volatile UINT32 g_stressCount;
+static UINT64 g_stressCost[LOSCFG_KERNEL_CORE_NUM];
+
+static void TaskF01(void)
+{
+    UINT32 intSave;
+    UINT32 index;
+    UINT32 cpuid = ArchCurrCpuid();
+    UINT64 start;
+
+    while (!g_stressStart) {
+    }
+
+    start = LOS_CurrNanosec();
+    for (index = 0; index < SPIN_STRESS_LOOP; index++) {
+        LOS_SpinLockSave(&g_stressSpin, &intSave);
+        g_stressCount++;
+        LOS_SpinUnlockRestore(&g_stressSpin, intSave);
+    }
+    g_stressCost[cpuid] = LOS_CurrNanosec() - start;
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(void)
+{
+    TSK_INIT_PARAM_S testTask;
+    UINT32 ret;
+    UINT32 testid;
+    UINT32 coreIdx;
+    UINT64 minCost = (UINT64)-1;
+    UINT64 maxCost = 0;
+
+    g_testCount = 0;
+    g_stressStart = 0;
+    g_stressCount = 0;
+
+    /* the task on this core preempts the runner, so it must not start spinning before the flag is set */
+    LOS_TaskLock();
+    for (coreIdx = 0; coreIdx < LOSCFG_KERNEL_CORE_NUM; coreIdx++) {
+        TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_task_164", TaskF01, TASK_PRIO_TEST_TASK - 1,
+            CPUID_TO_AFFI_MASK(coreIdx));
+        ret = LOS_TaskCreate(&testid, &testTask);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    }
+
+    g_stressStart = 1;
+    LOS_TaskUnlock();
+    while (g_testCount < LOSCFG_KERNEL_CORE_NUM) {
+        (VOID)LOS_TaskDelay(1);
+    }
+
+    ICUNIT_ASSERT_EQUAL(g_stressCount, SPIN_STRESS_LOOP * LOSCFG_KERNEL_CORE_NUM, g_stressCount);
+
+    for (coreIdx = 0; coreIdx < LOSCFG_KERNEL_CORE_NUM; coreIdx++) {
+        minCost = (g_stressCost[coreIdx] < minCost) ? g_stressCost[coreIdx] : minCost;
+        maxCost = (g_stressCost[coreIdx] > maxCost) ? g_stressCost[coreIdx] : maxCost;
+    }
+    PRINTK("spinlock stress %u x %u: fastest core %llu ns, slowest core %llu ns\n",
+           LOSCFG_KERNEL_CORE_NUM, SPIN_STRESS_LOOP, minCost, maxCost);
+
+#ifdef LOSCFG_KERNEL_SMP_SPINLOCK_STATISTICS
+    SpinLockStat stat;
+    LOS_SpinStatGet(&g_stressSpin, &stat, TRUE);
+    ICUNIT_ASSERT_NOT_EQUAL((stat.lockCount >= SPIN_STRESS_LOOP * LOSCFG_KERNEL_CORE_NUM), 0, stat.lockCount);
+    PRINTK("spinlock stress: contended %u of %u, spin %llu cycles, max hold %llu cycles\n",
+           stat.contendCount, stat.lockCount, stat.spinTime, stat.maxHoldTime);
+#endif
+
+    return LOS_OK;
+
+EXIT:
+    g_stressStart = 1;
+    LOS_TaskUnlock();
+    return LOS_NOK;
+}
+
+void ItSmpLosTask164(void)
+{
+    TEST_ADD_CASE("ItSmpLosTask164", Testcase, TEST_LOS, TEST_TASK, TEST_LEVEL1, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -73,6 +73,7 @@ VOID ItSuiteLosEvent(VOID)
     ItSmpLosEvent032();
     ItSmpLosEvent034();
     ItSmpLosEvent037();
+    ItSmpLosEvent038();
 #endif
 
 #if defined(LOSCFG_TEST_SMOKE)
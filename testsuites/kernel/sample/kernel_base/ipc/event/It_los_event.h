@@ -189,6 +189,7 @@ VOID ItSmpLosEvent034(VOID);
 VOID ItSmpLosEvent035(VOID);
 VOID ItSmpLosEvent036(VOID);
 VOID ItSmpLosEvent037(VOID);
+VOID ItSmpLosEvent038(VOID);
 #endif
 
 #ifdef __cplusplus
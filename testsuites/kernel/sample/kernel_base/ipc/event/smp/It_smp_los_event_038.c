@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_event.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define EVENT_BENCH_WAITERS (LOSCFG_KERNEL_CORE_NUM * 4)
+#define EVENT_BENCH_ROUNDS  50
+
+static volatile UINT32 g_readyCount;
+static volatile UINT32 g_wakeCount;
+static volatile UINT64 g_writeTime;
+static UINT64 g_wakeCost[EVENT_BENCH_WAITERS];
+static UINT64 g_wakeMax[EVENT_BENCH_WAITERS];
+static UINT32 g_waiterID[EVENT_BENCH_WAITERS];
+
+static VOID TaskF01(UINTPTR index)
+{
+    UINT32 round;
+    UINT32 ret;
+    UINT64 cost;
+
+    for (round = 0; round < EVENT_BENCH_ROUNDS; round++) {
+        LOS_AtomicInc((Atomic *)&g_readyCount);
+        ret = LOS_EventRead(&g_event, 1U << (round % 2), LOS_WAITMODE_OR, LOS_WAIT_FOREVER); // 2, two bits in turn
+        ICUNIT_ASSERT_EQUAL_VOID(ret, 1U << (round % 2), ret); // 2, two bits in turn
+
+        cost = LOS_CurrNanosec() - g_writeTime;
+        g_wakeCost[index] += cost;
+        g_wakeMax[index] = (cost > g_wakeMax[index]) ? cost : g_wakeMax[index];
+        LOS_AtomicInc((Atomic *)&g_wakeCount);
+    }
+}
+
+static UINT32 Testcase(VOID)
+{
+    TSK_INIT_PARAM_S testTask;
+    UINT64 totalCost = 0;
+    UINT64 maxCost = 0;
+    UINT32 round;
+    UINT32 index;
+    UINT32 ret;
+
+    g_readyCount = 0;
+    g_wakeCount = 0;
+    ret = LOS_EventInit(&g_event);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    for (index = 0; index < EVENT_BENCH_WAITERS; index++) {
+        g_wakeCost[index] = 0;
+        g_wakeMax[index] = 0;
+        TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_event_038", TaskF01, TASK_PRIO_TEST - 1,
+            CPUID_TO_AFFI_MASK(index % LOSCFG_KERNEL_CORE_NUM));
+        testTask.auwArgs[0] = index;
+        ret = LOS_TaskCreate(&g_waiterID[index], &testTask);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    }
+
+    for (round = 0; round < EVENT_BENCH_ROUNDS; round++) {
+        while (g_readyCount < (EVENT_BENCH_WAITERS * (round + 1))) {
+            (VOID)LOS_TaskDelay(1);
+        }
+        (VOID)LOS_TaskDelay(1); /* let the last waiters pend */
+
+        /* one write wakes every waiter with a single ipi per cpu */
+        g_writeTime = LOS_CurrNanosec();
+        ret = LOS_EventWrite(&g_event, 1U << (round % 2)); // 2, two bits in turn
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+        while (g_wakeCount < (EVENT_BENCH_WAITERS * (round + 1))) {
+            (VOID)LOS_TaskDelay(1);
+        }
+        ret = LOS_EventClear(&g_event, ~(1U << (round % 2))); // 2, two bits in turn
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    }
+
+    for (index = 0; index < EVENT_BENCH_WAITERS; index++) {
+        totalCost += g_wakeCost[index];
+        maxCost = (g_wakeMax[index] > maxCost) ? g_wakeMax[index] : maxCost;
+    }
+    PRINTK("event broadcast %u waiters: average wake %llu ns, worst wake %llu ns\n", EVENT_BENCH_WAITERS,
+           totalCost / (EVENT_BENCH_WAITERS * EVENT_BENCH_ROUNDS), maxCost);
+
+    /* the bits are already there, read and poll do not pend */
+    ret = LOS_EventWrite(&g_event, 0x5);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_EventRead(&g_event, 0x5, LOS_WAITMODE_AND | LOS_WAITMODE_CLR, LOS_WAIT_FOREVER);
+    ICUNIT_GOTO_EQUAL(ret, 0x5, ret, EXIT);
+    ret = LOS_EventPoll(&g_event.uwEventID, 0x5, LOS_WAITMODE_OR);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+
+EXIT:
+    for (index = 0; index < EVENT_BENCH_WAITERS; index++) {
+        (VOID)LOS_TaskDelete(g_waiterID[index]);
+    }
+    ret = LOS_EventDestroy(&g_event);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    return LOS_OK;
+}
+
+VOID ItSmpLosEvent038(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItSmpLosEvent038", Testcase, TEST_LOS, TEST_EVENT, TEST_LEVEL1, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -141,6 +141,10 @@ VOID ItSuiteLosMux(void)
     ItSmpLosMux2027();
     ItSmpLosMux2028();
     ItSmpLosMux2029();
+    ItSmpLosMux2030();
+    ItSmpLosMux2031();
+    ItSmpLosMux2032();
+    ItSmpLosMux2033();
 #endif
 
 #ifdef LOSCFG_KERNEL_SMP
@@ -141,6 +141,10 @@ VOID ItSmpLosMux2026(void);
 VOID ItSmpLosMux2027(void);
 VOID ItSmpLosMux2028(void);
 VOID ItSmpLosMux2029(void);
+VOID ItSmpLosMux2030(void);
+VOID ItSmpLosMux2031(void);
+VOID ItSmpLosMux2032(void);
+VOID ItSmpLosMux2033(void);
 #endif
 
 #ifdef __cplusplus
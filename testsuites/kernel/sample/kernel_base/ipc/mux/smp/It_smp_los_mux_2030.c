@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mux.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define MUX_FAST_LOOP 10000
+
+static UINT32 MuxLockLoop(LosMux *mutex)
+{
+    LosTaskCB *runTask = OsCurrTaskGet();
+    UINT32 ret;
+    UINT32 i;
+
+    for (i = 0; i < MUX_FAST_LOOP; i++) {
+        ret = ((i % 2) == 0) ? LOS_MuxLock(mutex, LOS_WAIT_FOREVER) : LOS_MuxTrylock(mutex);
+        if (ret != LOS_OK) {
+            return ret;
+        }
+        /* a held mutex is in the lock list of its owner, even when it was taken without contention */
+        if ((OsMuxOwnerGet(mutex) != runTask) || (mutex->holdList.pstNext == NULL) ||
+            LOS_ListEmpty(&runTask->lockList)) {
+            return LOS_NOK;
+        }
+        ret = LOS_MuxUnlock(mutex);
+        if (ret != LOS_OK) {
+            return ret;
+        }
+    }
+    return LOS_ListEmpty(&runTask->lockList) ? LOS_OK : LOS_NOK;
+}
+
+static VOID TaskF01(VOID)
+{
+    UINT32 ret = MuxLockLoop(&g_mutexTest2);
+    ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret, currCpuid;
+    TSK_INIT_PARAM_S testTask = {0};
+
+    g_testCount = 0;
+    currCpuid = (ArchCurrCpuid() + 1) % (LOSCFG_KERNEL_CORE_NUM);
+
+    ret = LosMuxCreate(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    ret = LosMuxCreate(&g_mutexTest2);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_mux_2030_task", TaskF01, TASK_PRIO_TEST_TASK - 1,
+        CPUID_TO_AFFI_MASK(currCpuid)); // other cpu
+    ret = LOS_TaskCreate(&g_testTaskID01, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = MuxLockLoop(&g_mutexTest1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TestAssertBusyTaskDelay(100, 1); // 100, delay for Timing control.
+    ICUNIT_GOTO_EQUAL(g_testCount, 1, g_testCount, EXIT);
+
+    ICUNIT_GOTO_EQUAL((UINTPTR)g_mutexTest1.owner, 0, (UINTPTR)g_mutexTest1.owner, EXIT);
+    ICUNIT_GOTO_EQUAL((UINTPTR)g_mutexTest2.owner, 0, (UINTPTR)g_mutexTest2.owner, EXIT);
+
+    ret = LOS_MuxDestroy(&g_mutexTest1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_MuxDestroy(&g_mutexTest2);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    return LOS_OK;
+
+EXIT:
+    LOS_TaskDelete(g_testTaskID01);
+    LOS_MuxDestroy(&g_mutexTest1);
+    LOS_MuxDestroy(&g_mutexTest2);
+    return LOS_OK;
+}
+
+VOID ItSmpLosMux2030(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItSmpLosMux2030", Testcase, TEST_LOS, TEST_MUX, TEST_LEVEL2, TEST_FUNCTION);
+}
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
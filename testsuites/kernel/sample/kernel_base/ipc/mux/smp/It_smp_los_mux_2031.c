@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mux.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define MUX_CONTEND_LOOP 2000
+
+static volatile UINT32 g_muxCounter;
+
+static UINT32 MuxCountLoop(VOID)
+{
+    UINT32 ret;
+    UINT32 val;
+    UINT32 i;
+
+    for (i = 0; i < MUX_CONTEND_LOOP; i++) {
+        ret = LOS_MuxLock(&g_mutexTest1, LOS_WAIT_FOREVER);
+        if (ret != LOS_OK) {
+            return ret;
+        }
+        /* not atomic on purpose, a lost update means two holders at once */
+        val = g_muxCounter;
+        if ((i % 16) == 0) { // 16, yield now and then so that the other side has to queue
+            LOS_TaskYield();
+        }
+        g_muxCounter = val + 1;
+        ret = LOS_MuxUnlock(&g_mutexTest1);
+        if (ret != LOS_OK) {
+            return ret;
+        }
+    }
+    return LOS_OK;
+}
+
+static VOID TaskF01(VOID)
+{
+    UINT32 ret = MuxCountLoop();
+    ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret, currCpuid;
+    TSK_INIT_PARAM_S testTask = {0};
+
+    g_testCount = 0;
+    g_muxCounter = 0;
+    currCpuid = (ArchCurrCpuid() + 1) % (LOSCFG_KERNEL_CORE_NUM);
+
+    ret = LosMuxCreate(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_mux_2031_task1", TaskF01, TASK_PRIO_TEST_TASK - 1,
+        CPUID_TO_AFFI_MASK(currCpuid)); // other cpu
+    ret = LOS_TaskCreate(&g_testTaskID01, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_mux_2031_task2", TaskF01, TASK_PRIO_TEST_TASK - 1,
+        CPUID_TO_AFFI_MASK(ArchCurrCpuid())); // current cpu
+    ret = LOS_TaskCreate(&g_testTaskID02, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = MuxCountLoop();
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TestAssertBusyTaskDelay(1000, 2); // 1000, delay for Timing control, 2, both tasks done.
+    ICUNIT_GOTO_EQUAL(g_testCount, 2, g_testCount, EXIT); // 2, both tasks done.
+    ICUNIT_GOTO_EQUAL(g_muxCounter, MUX_CONTEND_LOOP * 3, g_muxCounter, EXIT); // 3, three lockers.
+
+    ret = LOS_MuxDestroy(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    return LOS_OK;
+
+EXIT:
+    LOS_TaskDelete(g_testTaskID01);
+    LOS_TaskDelete(g_testTaskID02);
+    LOS_MuxDestroy(&g_mutexTest1);
+    return LOS_OK;
+}
+
+VOID ItSmpLosMux2031(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItSmpLosMux2031", Testcase, TEST_LOS, TEST_MUX, TEST_LEVEL2, TEST_FUNCTION);
+}
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mux.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+static VOID TaskF01(VOID)
+{
+    UINT32 ret;
+
+    ret = LOS_MuxLock(&g_mutexTest1, LOS_WAIT_FOREVER); // uncontended, taken on the fast path
+    ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+
+    LOS_AtomicInc(&g_testCount);
+    LOS_TaskDelay(LOS_WAIT_FOREVER); // deleted while holding the mutex
+}
+
+static VOID TaskF02(VOID)
+{
+    UINT32 ret;
+
+    ret = LOS_MuxLock(&g_mutexTest1, LOS_WAIT_FOREVER); // handed over when the owner is deleted
+    ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+
+    LOS_AtomicInc(&g_testCount);
+
+    ret = LOS_MuxUnlock(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret, currCpuid;
+    TSK_INIT_PARAM_S testTask = {0};
+
+    g_testCount = 0;
+    currCpuid = (ArchCurrCpuid() + 1) % (LOSCFG_KERNEL_CORE_NUM);
+
+    ret = LosMuxCreate(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    /* without waiters: deleting the owner leaves the mutex free */
+    TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_mux_2032_task1", TaskF01, TASK_PRIO_TEST_TASK - 1,
+        CPUID_TO_AFFI_MASK(currCpuid)); // other cpu
+    ret = LOS_TaskCreate(&g_testTaskID01, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TestAssertBusyTaskDelay(100, 1); // 100, delay for Timing control.
+    ICUNIT_GOTO_EQUAL(g_testCount, 1, g_testCount, EXIT);
+
+    ret = LOS_TaskDelete(g_testTaskID01);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL((UINTPTR)g_mutexTest1.owner, 0, (UINTPTR)g_mutexTest1.owner, EXIT);
+
+    ret = LOS_MuxTrylock(&g_mutexTest1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_MuxUnlock(&g_mutexTest1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* with a waiter: deleting the owner hands the mutex to it */
+    g_testCount = 0;
+    ret = LOS_TaskCreate(&g_testTaskID01, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TestAssertBusyTaskDelay(100, 1); // 100, delay for Timing control.
+    ICUNIT_GOTO_EQUAL(g_testCount, 1, g_testCount, EXIT);
+
+    TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_mux_2032_task2", TaskF02, TASK_PRIO_TEST_TASK - 1,
+        CPUID_TO_AFFI_MASK(ArchCurrCpuid())); // current cpu
+    ret = LOS_TaskCreate(&g_testTaskID02, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(g_testCount, 1, g_testCount, EXIT);
+
+    ret = LOS_TaskDelete(g_testTaskID01);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TestAssertBusyTaskDelay(100, 2); // 100, delay for Timing control, 2, the waiter got the mutex.
+    ICUNIT_GOTO_EQUAL(g_testCount, 2, g_testCount, EXIT); // 2, the waiter got the mutex.
+
+    ret = LOS_MuxDestroy(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    return LOS_OK;
+
+EXIT:
+    LOS_TaskDelete(g_testTaskID01);
+    LOS_TaskDelete(g_testTaskID02);
+    LOS_MuxDestroy(&g_mutexTest1);
+    return LOS_OK;
+}
+
+VOID ItSmpLosMux2032(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItSmpLosMux2032", Testcase, TEST_LOS, TEST_MUX, TEST_LEVEL2, TEST_FUNCTION);
+}
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
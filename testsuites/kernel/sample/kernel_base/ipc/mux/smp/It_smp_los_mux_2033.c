@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_mux.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define MUX_DESTROY_LOOP 1000
+
+static volatile UINT32 g_muxStop;
+static volatile UINT32 g_muxHeld;
+
+static VOID TaskF01(VOID)
+{
+    UINT32 ret;
+
+    /* races the fast path lock against destroy on the other cpu */
+    while (!g_muxStop) {
+        ret = LOS_MuxTrylock(&g_mutexTest1);
+        if (ret != LOS_OK) {
+            continue;
+        }
+        g_muxHeld = 1;
+        /* destroy must not have wiped a mutex that was locked */
+        if ((g_mutexTest1.magic != OS_MUX_MAGIC) || (OsMuxOwnerGet(&g_mutexTest1) != OsCurrTaskGet())) {
+            g_muxHeld = 0;
+            break;
+        }
+        g_muxHeld = 0;
+        ret = LOS_MuxUnlock(&g_mutexTest1);
+        ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+    }
+
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret, currCpuid, i;
+    UINT32 busy = 0;
+    TSK_INIT_PARAM_S testTask = {0};
+
+    g_testCount = 0;
+    g_muxStop = 0;
+    g_muxHeld = 0;
+    currCpuid = (ArchCurrCpuid() + 1) % (LOSCFG_KERNEL_CORE_NUM);
+
+    /* destroying a mutex that is held by the caller fails */
+    ret = LosMuxCreate(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    ret = LOS_MuxLock(&g_mutexTest1, LOS_WAIT_FOREVER);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ret = LOS_MuxDestroy(&g_mutexTest1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_EBUSY, ret, EXIT);
+    ret = LOS_MuxUnlock(&g_mutexTest1);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    TEST_TASK_PARAM_INIT_AFFI(testTask, "it_smp_mux_2033_task", TaskF01, TASK_PRIO_TEST_TASK - 1,
+        CPUID_TO_AFFI_MASK(currCpuid)); // other cpu
+    ret = LOS_TaskCreate(&g_testTaskID01, &testTask);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    for (i = 0; i < MUX_DESTROY_LOOP; i++) {
+        ret = LOS_MuxDestroy(&g_mutexTest1);
+        if (ret == LOS_EBUSY) {
+            busy++;
+            continue;
+        }
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(g_muxHeld, 0, g_muxHeld, EXIT);
+        ret = LosMuxCreate(&g_mutexTest1);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    }
+    PRINT_DEBUG("busy = %u\n", busy);
+
+    g_muxStop = 1;
+    TestAssertBusyTaskDelay(100, 1); // 100, delay for Timing control.
+    ICUNIT_GOTO_EQUAL(g_testCount, 1, g_testCount, EXIT);
+
+    ret = LOS_MuxDestroy(&g_mutexTest1);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    return LOS_OK;
+
+EXIT:
+    g_muxStop = 1;
+    LOS_TaskDelete(g_testTaskID01);
+    LOS_MuxDestroy(&g_mutexTest1);
+    return LOS_OK;
+}
+
+VOID ItSmpLosMux2033(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItSmpLosMux2033", Testcase, TEST_LOS, TEST_MUX, TEST_LEVEL2, TEST_FUNCTION);
+}
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
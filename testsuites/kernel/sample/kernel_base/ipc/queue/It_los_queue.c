@@ -71,6 +71,7 @@ VOID ItSuiteLosQueue(VOID)
     ItSmpLosQueue029();
     ItSmpLosQueue031();
     ItSmpLosQueue032();
+    ItSmpLosQueue033();
 #endif
 #if defined(LOSCFG_TEST_SMOKE)
     ItLosQueue001();
@@ -189,6 +190,7 @@ VOID ItSuiteLosQueue(VOID)
     ItLosQueue113();
     ItLosQueue114();
     ItLosQueue116();
+    ItLosQueue124();
 #endif
 
     ItLosQueueHead003();
@@ -176,6 +176,7 @@ VOID ItLosQueue112(VOID);
 VOID ItLosQueue113(VOID);
 VOID ItLosQueue114(VOID);
 VOID ItLosQueue116(VOID);
+VOID ItLosQueue124(VOID);
 
 VOID ItLosQueueHead003(VOID);
 VOID ItLosQueueHead004(VOID);
@@ -289,6 +290,7 @@ VOID ItSmpLosQueue029(VOID);
 VOID ItSmpLosQueue030(VOID);
 VOID ItSmpLosQueue031(VOID);
 VOID ItSmpLosQueue032(VOID);
+VOID ItSmpLosQueue033(VOID);
 #endif
 
 #ifdef __cplusplus
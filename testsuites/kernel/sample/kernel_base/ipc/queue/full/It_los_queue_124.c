@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_queue.h"
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define QUEUE_PERF_LEN      16
+#define QUEUE_PERF_LOOP     10000
+#define QUEUE_PERF_BATCH    8
+
+static UINT64 g_perfMsg[QUEUE_PERF_BATCH];
+static UINT64 g_perfBuf[QUEUE_PERF_BATCH];
+
+static UINT32 QueuePerfSingle(UINT32 flags, UINT64 *cost)
+{
+    UINT32 ret, index;
+    UINT32 readSize;
+    UINT64 start;
+
+    ret = LOS_QueueCreate("Q1", QUEUE_PERF_LEN, &g_testQueueID01, flags, sizeof(UINT64));
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    start = LOS_CurrNanosec();
+    for (index = 0; index < QUEUE_PERF_LOOP; index++) {
+        g_perfMsg[0] = index;
+        ret = LOS_QueueWriteCopy(g_testQueueID01, &g_perfMsg[0], sizeof(UINT64), 0);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+        readSize = sizeof(UINT64);
+        ret = LOS_QueueReadCopy(g_testQueueID01, &g_perfBuf[0], &readSize, 0);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(g_perfBuf[0], index, g_perfBuf[0], EXIT);
+    }
+    *cost = LOS_CurrNanosec() - start;
+
+EXIT:
+    LOS_QueueDelete(g_testQueueID01);
+    return ret;
+}
+
+static UINT32 QueuePerfBatch(UINT32 flags, UINT64 *cost)
+{
+    UINT32 ret, index;
+    UINT32 count;
+    UINT64 start;
+
+    ret = LOS_QueueCreate("Q1", QUEUE_PERF_LEN, &g_testQueueID01, flags, sizeof(UINT64));
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    start = LOS_CurrNanosec();
+    for (index = 0; index < (QUEUE_PERF_LOOP / QUEUE_PERF_BATCH); index++) {
+        g_perfMsg[QUEUE_PERF_BATCH - 1] = index;
+        count = QUEUE_PERF_BATCH;
+        ret = LOS_QueueWriteBatch(g_testQueueID01, g_perfMsg, sizeof(UINT64), &count, 0);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(count, QUEUE_PERF_BATCH, count, EXIT);
+        count = QUEUE_PERF_BATCH;
+        ret = LOS_QueueReadBatch(g_testQueueID01, g_perfBuf, sizeof(UINT64), &count, 0);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(count, QUEUE_PERF_BATCH, count, EXIT);
+        ICUNIT_GOTO_EQUAL(g_perfBuf[QUEUE_PERF_BATCH - 1], index, g_perfBuf[QUEUE_PERF_BATCH - 1], EXIT);
+    }
+    *cost = LOS_CurrNanosec() - start;
+
+EXIT:
+    LOS_QueueDelete(g_testQueueID01);
+    return ret;
+}
+
+static VOID TaskF01(VOID)
+{
+    UINT32 ret;
+    UINTPTR msg = 0;
+
+    ret = LOS_QueueRead(g_testQueueID01, &msg, sizeof(UINTPTR), LOS_WAIT_FOREVER);
+    ICUNIT_ASSERT_EQUAL_VOID(ret, LOS_OK, ret);
+    ICUNIT_ASSERT_EQUAL_VOID(msg, (UINTPTR)g_perfMsg, msg);
+    g_testCount++;
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret;
+    UINT64 normal = 0;
+    UINT64 ring = 0;
+    UINT64 pointer = 0;
+    UINT64 normalBatch = 0;
+    UINT64 ringBatch = 0;
+    TSK_INIT_PARAM_S task = { 0 };
+    QUEUE_INFO_S queueInfo;
+
+    ret = LOS_QueueCreate("Q1", QUEUE_PERF_LEN, &g_testQueueID01, LOS_QUEUE_FLAG_MPSC | LOS_QUEUE_FLAG_SPSC, 8);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_ERRNO_QUEUE_FLAGS_INVALID, ret);
+
+    ret = QueuePerfSingle(0, &normal);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    ret = QueuePerfSingle(LOS_QUEUE_FLAG_MPSC, &ring);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    ret = QueuePerfSingle(LOS_QUEUE_FLAG_SPSC | LOS_QUEUE_FLAG_POINTER, &pointer);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    ret = QueuePerfBatch(0, &normalBatch);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    ret = QueuePerfBatch(LOS_QUEUE_FLAG_MPSC, &ringBatch);
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    PRINTK("queue %u messages(ns): normal %llu, mpsc %llu, spsc pointer %llu, normal batch %llu, mpsc batch %llu\n",
+           QUEUE_PERF_LOOP, normal, ring, pointer, normalBatch, ringBatch);
+
+    /* the length of a ring queue is rounded up, and the reader blocks until a pointer is passed in */
+    ret = LOS_QueueCreate("Q1", 3, &g_testQueueID01, LOS_QUEUE_FLAG_MPSC | LOS_QUEUE_FLAG_POINTER,
+                          sizeof(UINTPTR));
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    ret = LOS_QueueInfoGet(g_testQueueID01, &queueInfo);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(queueInfo.usQueueLen, 4, queueInfo.usQueueLen, EXIT); // 4, rounded up from 3.
+
+    ret = LOS_QueueWriteHead(g_testQueueID01, g_perfMsg, sizeof(UINTPTR), 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_ERRNO_QUEUE_OPERATE_UNSUPPORTED, ret, EXIT);
+
+    g_testCount = 0;
+    TEST_TASK_PARAM_INIT_AFFI(task, "it_queue_124", (TSK_ENTRY_FUNC)TaskF01, TASK_PRIO_TEST - 1,
+                              CPUID_TO_AFFI_MASK(ArchCurrCpuid()));
+    ret = LOS_TaskCreate(&g_testTaskID01, &task);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(g_testCount, 0, g_testCount, EXIT);
+
+    ret = LOS_QueueWrite(g_testQueueID01, g_perfMsg, sizeof(UINTPTR), 0);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+    ICUNIT_GOTO_EQUAL(g_testCount, 1, g_testCount, EXIT);
+
+EXIT:
+    LOS_TaskDelete(g_testTaskID01);
+    LOS_QueueDelete(g_testQueueID01);
+    return LOS_OK;
+}
+
+VOID ItLosQueue124(VOID)
+{
+    TEST_ADD_CASE("ItLosQueue124", Testcase, TEST_LOS, TEST_QUE, TEST_LEVEL2, TEST_PERFORMANCE);
+}
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
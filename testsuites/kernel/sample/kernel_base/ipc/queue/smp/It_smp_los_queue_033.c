@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_los_queue.h"
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
+
+#define QUEUE_MP_LEN          16
+#define QUEUE_MP_WRITER_NUM   (2 * (LOSCFG_KERNEL_CORE_NUM - 1))
+#define QUEUE_MP_LOOP         2000
+#define QUEUE_MP_SEQ_MASK     0xFFFFU
+#define QUEUE_MP_WRITER_SHIFT 16
+
+static UINT32 g_writerTaskID[QUEUE_MP_WRITER_NUM];
+static UINT32 g_writerNext[QUEUE_MP_WRITER_NUM];
+static volatile UINT32 g_writerStop;
+static volatile UINT32 g_writerRet;
+
+static VOID TaskWriter(UINTPTR writer)
+{
+    UINT32 ret, index;
+    UINT32 msg;
+
+    for (index = 0; index < QUEUE_MP_LOOP; index++) {
+        msg = ((UINT32)writer << QUEUE_MP_WRITER_SHIFT) | index;
+        ret = LOS_QueueWriteCopy(g_testQueueID01, &msg, sizeof(UINT32), LOS_WAIT_FOREVER);
+        if (ret != LOS_OK) {
+            g_writerRet = ret;
+            break;
+        }
+    }
+    LOS_AtomicInc(&g_testCount);
+}
+
+static VOID TaskDeleteWriter(UINTPTR writer)
+{
+    UINT32 ret;
+    UINT32 msg = (UINT32)writer;
+
+    /* writers may only ever see the queue alive or gone, never a freed ring */
+    while (!g_writerStop) {
+        ret = LOS_QueueWriteCopy(g_testQueueID01, &msg, sizeof(UINT32), 0);
+        if ((ret != LOS_OK) && (ret != LOS_ERRNO_QUEUE_ISFULL) && (ret != LOS_ERRNO_QUEUE_NOT_CREATE)) {
+            g_writerRet = ret;
+            break;
+        }
+    }
+    LOS_AtomicInc(&g_testCount);
+}
+
+static UINT32 WritersCreate(TSK_ENTRY_FUNC entry, UINT32 currCpuid)
+{
+    TSK_INIT_PARAM_S task = { 0 };
+    UINT32 ret, index, cpuid;
+
+    for (index = 0; index < QUEUE_MP_WRITER_NUM; index++) {
+        cpuid = (currCpuid + 1 + (index % (LOSCFG_KERNEL_CORE_NUM - 1))) % LOSCFG_KERNEL_CORE_NUM;
+        TEST_TASK_PARAM_INIT_AFFI(task, "it_queue_033_task", entry, TASK_PRIO_TEST - 1,
+            CPUID_TO_AFFI_MASK(cpuid)); // other cpu
+        task.auwArgs[0] = index;
+        ret = LOS_TaskCreate(&g_writerTaskID[index], &task);
+        ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+    }
+    return LOS_OK;
+}
+
+static VOID WritersWait(VOID)
+{
+    while (g_testCount < QUEUE_MP_WRITER_NUM) {
+        LOS_TaskDelay(1);
+    }
+}
+
+static UINT32 Testcase(VOID)
+{
+    UINT32 ret, index, writer;
+    UINT32 currCpuid = ArchCurrCpuid();
+    UINT32 readSize;
+    UINT32 msg = 0;
+
+    g_testCount = 0;
+    g_writerRet = LOS_OK;
+    (VOID)memset_s(g_writerNext, sizeof(g_writerNext), 0, sizeof(g_writerNext));
+    ret = LOS_QueueCreate("Q1", QUEUE_MP_LEN, &g_testQueueID01, LOS_QUEUE_FLAG_MPSC, sizeof(UINT32));
+    ICUNIT_ASSERT_EQUAL(ret, LOS_OK, ret);
+
+    ret = WritersCreate((TSK_ENTRY_FUNC)TaskWriter, currCpuid);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* every message arrives once, and the messages of one writer keep their order */
+    for (index = 0; index < (QUEUE_MP_WRITER_NUM * QUEUE_MP_LOOP); index++) {
+        readSize = sizeof(UINT32);
+        ret = LOS_QueueReadCopy(g_testQueueID01, &msg, &readSize, LOS_WAIT_FOREVER);
+        ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(readSize, sizeof(UINT32), readSize, EXIT);
+        writer = msg >> QUEUE_MP_WRITER_SHIFT;
+        ICUNIT_GOTO_EQUAL(writer < QUEUE_MP_WRITER_NUM, TRUE, msg, EXIT);
+        ICUNIT_GOTO_EQUAL(msg & QUEUE_MP_SEQ_MASK, g_writerNext[writer], msg, EXIT);
+        g_writerNext[writer]++;
+    }
+    WritersWait();
+    ICUNIT_GOTO_EQUAL(g_writerRet, LOS_OK, g_writerRet, EXIT);
+
+    ret = LOS_QueueDelete(g_testQueueID01);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    /* delete the queue while the writers keep pushing into it from the other cores */
+    g_testCount = 0;
+    g_writerStop = FALSE;
+    ret = LOS_QueueCreate("Q1", QUEUE_MP_LEN, &g_testQueueID01, LOS_QUEUE_FLAG_MPSC, sizeof(UINT32));
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT);
+
+    ret = WritersCreate((TSK_ENTRY_FUNC)TaskDeleteWriter, currCpuid);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT1);
+    LOS_TaskDelay(1);
+
+    do {
+        ret = LOS_QueueDelete(g_testQueueID01);
+    } while (ret == LOS_ERRNO_QUEUE_IN_TSKUSE);
+    ICUNIT_GOTO_EQUAL(ret, LOS_OK, ret, EXIT1);
+
+    LOS_TaskDelay(1);
+    g_writerStop = TRUE;
+    WritersWait();
+    ICUNIT_GOTO_EQUAL(g_writerRet, LOS_OK, g_writerRet, EXIT1);
+
+    return LOS_OK;
+EXIT1:
+    g_writerStop = TRUE;
+EXIT:
+    for (index = 0; index < QUEUE_MP_WRITER_NUM; index++) {
+        LOS_TaskDelete(g_writerTaskID[index]);
+    }
+    LOS_QueueDelete(g_testQueueID01);
+    return LOS_OK;
+}
+
+VOID ItSmpLosQueue033(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("ItSmpLosQueue033", Testcase, TEST_LOS, TEST_QUE, TEST_LEVEL2, TEST_FUNCTION);
+}
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cpluscplus */
+#endif /* __cpluscplus */
@@ -78,6 +78,7 @@ VOID ItSuiteLosSem(void)
     ItSmpLosSem034();
     ItSmpLosSem035();
     ItSmpLosSem036();
+    ItSmpLosSem037();
 #endif
 
 #if defined(LOSCFG_TEST_SMOKE)
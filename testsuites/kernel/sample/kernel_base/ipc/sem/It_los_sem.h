@@ -139,6 +139,7 @@ VOID ItSmpLosSem033(VOID);
 VOID ItSmpLosSem034(VOID);
 VOID ItSmpLosSem035(VOID);
 VOID ItSmpLosSem036(VOID);
+VOID ItSmpLosSem037(VOID);
 #endif
 
 VOID ItSuiteLosSem(void);
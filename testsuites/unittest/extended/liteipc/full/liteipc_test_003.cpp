@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "it_test_liteipc.h"
+#include "sys/wait.h"
+
+#include "unistd.h"
+#include "liteipc.h"
+#include "stdlib.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "sys/mman.h"
+#include "sys/ioctl.h"
+#include "fcntl.h"
+
+#include "smgr_demo.h"
+
+#define BENCH_LOOP_NUM 2000
+#define BENCH_SMALL_SZ 1
+#define BENCH_MEDIUM_SZ 1024
+#define BENCH_LARGE_SZ (64 * 1024)
+#define BENCH_POOL_SZ (64 * 4096)
+#define BENCH_BATCH_NUM 8
+
+static int g_ipcFd;
+static char g_serviceName[] = "ohos.benchservice";
+
+static uint64_t NowUs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000; /* 1000000: us per sec, 1000: ns per us */
+}
+
+static int RoundTrip(unsigned int serviceHandle, void *data, uint32_t dataSz, uint32_t *offset, uint32_t objNum)
+{
+    IpcContent data1;
+    IpcMsg dataOut;
+    int ret;
+
+    data1.flag = SEND | RECV;
+    data1.outMsg = &dataOut;
+    memset(data1.outMsg, 0, sizeof(IpcMsg));
+    data1.outMsg->type = MT_REQUEST;
+    data1.outMsg->target.handle = serviceHandle;
+    data1.outMsg->dataSz = dataSz;
+    data1.outMsg->data = data;
+    data1.outMsg->spObjNum = objNum;
+    data1.outMsg->offsets = offset;
+    ret = ioctl(g_ipcFd, IPC_SEND_RECV_MSG, &data1);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = ((uint32_t *)data1.inMsg->data)[1];
+    FreeBuffer(g_ipcFd, data1.inMsg);
+    return ret;
+}
+
+/* BENCH_BATCH_NUM - 1 oneway messages and a call in one ioctl */
+static int BatchRoundTrip(unsigned int serviceHandle, char *data)
+{
+    IpcBatchContent batch;
+    IpcContent contents[BENCH_BATCH_NUM];
+    IpcMsg dataOut[BENCH_BATCH_NUM];
+    int ret;
+
+    for (int i = 0; i < BENCH_BATCH_NUM; i++) {
+        contents[i].flag = (i == (BENCH_BATCH_NUM - 1)) ? (SEND | RECV) : SEND;
+        contents[i].outMsg = &dataOut[i];
+        memset(&dataOut[i], 0, sizeof(IpcMsg));
+        dataOut[i].type = MT_REQUEST;
+        dataOut[i].flag = (i == (BENCH_BATCH_NUM - 1)) ? LITEIPC_FLAG_DEFAULT : LITEIPC_FLAG_ONEWAY;
+        dataOut[i].target.handle = serviceHandle;
+        dataOut[i].dataSz = BENCH_SMALL_SZ;
+        dataOut[i].data = data;
+    }
+    batch.num = BENCH_BATCH_NUM;
+    batch.contents = contents;
+    batch.done = 0;
+    ret = ioctl(g_ipcFd, IPC_SEND_RECV_BATCH, &batch);
+    if (ret != 0) {
+        return ret;
+    }
+    if (batch.done != BENCH_BATCH_NUM) {
+        return -1;
+    }
+    ret = ((uint32_t *)contents[BENCH_BATCH_NUM - 1].inMsg->data)[1];
+    FreeBuffer(g_ipcFd, contents[BENCH_BATCH_NUM - 1].inMsg);
+    return ret;
+}
+
+static int BenchClient(void)
+{
+    char inlineBuff[BENCH_MEDIUM_SZ] = {0};
+    SpecialObj obj;
+    uint32_t offset = 0;
+    unsigned int serviceHandle;
+    uint64_t start;
+    void *retptr = nullptr;
+    char *large = nullptr;
+    int ret;
+    int i;
+
+    retptr = mmap(NULL, BENCH_POOL_SZ, PROT_READ, MAP_PRIVATE, g_ipcFd, 0);
+    ICUNIT_ASSERT_NOT_EQUAL((int)(intptr_t)retptr, -1, retptr);
+    ret = GetService(g_ipcFd, g_serviceName, sizeof(g_serviceName), &serviceHandle);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    start = NowUs();
+    for (i = 0; i < BENCH_LOOP_NUM; i++) {
+        ret = RoundTrip(serviceHandle, inlineBuff, BENCH_SMALL_SZ, nullptr, 0);
+        ICUNIT_ASSERT_EQUAL(ret, BENCH_SMALL_SZ, ret);
+    }
+    printf("LiteIPC round trip %d bytes: %llu us\n", BENCH_SMALL_SZ, (NowUs() - start) / BENCH_LOOP_NUM);
+
+    start = NowUs();
+    for (i = 0; i < BENCH_LOOP_NUM; i++) {
+        ret = RoundTrip(serviceHandle, inlineBuff, BENCH_MEDIUM_SZ, nullptr, 0);
+        ICUNIT_ASSERT_EQUAL(ret, BENCH_MEDIUM_SZ, ret);
+    }
+    printf("LiteIPC round trip %d bytes: %llu us\n", BENCH_MEDIUM_SZ, (NowUs() - start) / BENCH_LOOP_NUM);
+
+    /* a page aligned buffer can be lent to the service rather than copied */
+    large = (char *)mmap(NULL, BENCH_LARGE_SZ, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ICUNIT_ASSERT_NOT_EQUAL((int)(intptr_t)large, -1, large);
+    memset(large, 0, BENCH_LARGE_SZ);
+    obj.type = OBJ_PTR;
+    obj.content.ptr.buffSz = BENCH_LARGE_SZ;
+    obj.content.ptr.buff = large;
+    start = NowUs();
+    for (i = 0; i < BENCH_LOOP_NUM; i++) {
+        large[0] = (char)i;
+        large[BENCH_LARGE_SZ - 1] = (char)i;
+        ret = RoundTrip(serviceHandle, &obj, sizeof(SpecialObj), &offset, 1);
+        ICUNIT_ASSERT_EQUAL(ret, BENCH_LARGE_SZ, ret);
+    }
+    printf("LiteIPC round trip %d bytes: %llu us\n", BENCH_LARGE_SZ, (NowUs() - start) / BENCH_LOOP_NUM);
+    (void)munmap(large, BENCH_LARGE_SZ);
+
+    start = NowUs();
+    for (i = 0; i < (BENCH_LOOP_NUM / BENCH_BATCH_NUM); i++) {
+        ret = BatchRoundTrip(serviceHandle, inlineBuff);
+        ICUNIT_ASSERT_EQUAL(ret, BENCH_SMALL_SZ, ret);
+    }
+    printf("LiteIPC batched %d bytes: %llu us per message\n", BENCH_SMALL_SZ, (NowUs() - start) / BENCH_LOOP_NUM);
+    exit(0);
+    return 0;
+}
+
+static uint32_t HandleBenchRequest(IpcMsg *data)
+{
+    SpecialObj *obj = nullptr;
+    char *buff = nullptr;
+    uint32_t size;
+
+    if (data->spObjNum == 0) {
+        return data->dataSz;
+    }
+    obj = (SpecialObj *)((char *)data->data + ((uint32_t *)data->offsets)[0]);
+    if (obj->type != OBJ_PTR) {
+        return 0;
+    }
+    buff = (char *)obj->content.ptr.buff;
+    size = obj->content.ptr.buffSz;
+    if (buff[0] != buff[size - 1]) {
+        size = 0;
+    }
+    FreeBuffer(g_ipcFd, (IpcMsg *)buff);
+    return size;
+}
+
+static int BenchService(void)
+{
+    IpcContent data1;
+    void *retptr = nullptr;
+    unsigned int serviceHandle;
+    int ret;
+    int cnt;
+
+    retptr = mmap(NULL, BENCH_POOL_SZ, PROT_READ, MAP_PRIVATE, g_ipcFd, 0);
+    ICUNIT_ASSERT_NOT_EQUAL((int)(intptr_t)retptr, -1, retptr);
+    ret = RegService(g_ipcFd, g_serviceName, sizeof(g_serviceName), &serviceHandle);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    for (cnt = 0; cnt < BENCH_LOOP_NUM * 4; cnt++) { /* 4: rounds measured by the client */
+        data1.flag = RECV;
+        ret = ioctl(g_ipcFd, IPC_SEND_RECV_MSG, &data1);
+        ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+        if ((data1.inMsg->type != MT_REQUEST) || (data1.inMsg->flag == LITEIPC_FLAG_ONEWAY)) {
+            FreeBuffer(g_ipcFd, data1.inMsg);
+            continue;
+        }
+        SendReply(g_ipcFd, data1.inMsg, 0, HandleBenchRequest(data1.inMsg));
+    }
+    exit(0);
+    return 0;
+}
+
+static int LiteIpcTest(void)
+{
+    pid_t pid;
+    int status = 0;
+    int ret;
+
+    pid = fork();
+    ICUNIT_GOTO_WITHIN_EQUAL(pid, 0, 100000, pid, EXIT1);
+    if (pid == 0) {
+        BenchService();
+        exit(-1);
+    }
+    sleep(1); // wait server start
+
+    pid = fork();
+    ICUNIT_GOTO_WITHIN_EQUAL(pid, 0, 100000, pid, EXIT1);
+    if (pid == 0) {
+        BenchClient();
+        exit(-1);
+    }
+
+    for (int i = 0; i < 2; i++) { /* 2: service and client */
+        ret = waitpid(-1, &status, 0);
+        ICUNIT_GOTO_NOT_EQUAL(ret, -1, ret, EXIT1);
+        status = WEXITSTATUS(status);
+        ICUNIT_GOTO_EQUAL(status, 0, status, EXIT2);
+    }
+    return 0;
+EXIT1:
+    return 1;
+EXIT2:
+    return status;
+}
+
+static int TestCase(void)
+{
+    int ret;
+    int status;
+    g_ipcFd = open(LITEIPC_DRIVER, O_RDWR);
+    ICUNIT_ASSERT_NOT_EQUAL(g_ipcFd, -1, g_ipcFd);
+
+    pid_t pid = fork();
+    ICUNIT_GOTO_WITHIN_EQUAL(pid, 0, 100000, pid, EXIT);
+    if (pid == 0) {
+        sleep(1); // wait cms start
+        ret = LiteIpcTest();
+        StopCms(g_ipcFd);
+        exit(ret);
+    }
+
+    StartCms(g_ipcFd);
+
+    ret = waitpid(pid, &status, 0);
+    ICUNIT_GOTO_EQUAL(ret, pid, ret, EXIT);
+    status = WEXITSTATUS(status);
+    ICUNIT_GOTO_EQUAL(status, 0, status, EXIT);
+
+    return 0;
+EXIT:
+    return 1;
+}
+
+void ItPosixLiteIpc003(void)
+{
+    TEST_ADD_CASE("ItPosixLiteIpc003", TestCase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
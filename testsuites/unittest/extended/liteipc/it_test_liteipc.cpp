@@ -60,4 +60,16 @@ HWTEST_F(LiteIpcTest, ItPosixLiteIpc002, TestSize.Level0)
 {
     ItPosixLiteIpc002();
 }
+
+#if defined(LOSCFG_USER_TEST_FULL)
+/* *
+ * @tc.name: ItPosixLiteIpc003
+ * @tc.desc: round trip cost of 1B, 1KB, 64KB and batched messages
+ * @tc.type: PERF
+ */
+HWTEST_F(LiteIpcTest, ItPosixLiteIpc003, TestSize.Level0)
+{
+    ItPosixLiteIpc003();
+}
+#endif
 } 
\ No newline at end of file
@@ -69,6 +69,12 @@ typedef enum { CMS_GEN_HANDLE, CMS_REMOVE_HANDLE, CMS_ADD_ACCESS } CmsCmd;
 #define IPC_CMS_CMD         _IOWR(IPC_IOC_MAGIC, 2, CmsCmdContent)
 #define IPC_SET_IPC_THREAD  _IO(IPC_IOC_MAGIC, 3)
 #define IPC_SEND_RECV_MSG   _IOWR(IPC_IOC_MAGIC, 4, IpcContent)
+#define IPC_SEND_RECV_BATCH _IOWR(IPC_IOC_MAGIC, 5, IpcBatchContent)
+
+typedef enum {
+    LITEIPC_FLAG_DEFAULT = 0, // send and reply
+    LITEIPC_FLAG_ONEWAY,      // send message only
+} IpcFlag;
 
 typedef struct {
     CmsCmd cmd;
@@ -107,4 +113,12 @@ typedef struct {
     void *buffToFree;
 } IpcContent;
 
+#define IPC_BATCH_NUM_MAX 16
+
+typedef struct {
+    uint32_t num;
+    IpcContent *contents;
+    uint32_t done;  /**< filled by kernel, number of contents handled successfully */
+} IpcBatchContent;
+
 #endif //_LITEIPC_H
\ No newline at end of file
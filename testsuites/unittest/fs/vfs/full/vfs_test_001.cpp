@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vfs.h"
+#include <inttypes.h>
+#include <pthread.h>
+
+static const int CHMOD_THREAD_MAX = 4;
+static const int CHMOD_LOOP_COUNT = 20000;
+static const char *CHMOD_TEST_PATH = "/storage/vfs_chmod_test";
+static const char *CHMOD_MOVED_PATH = "/storage/vfs_chmod_moved";
+
+static volatile int g_chmodFailed;
+
+static void *ChmodThread(void *arg)
+{
+    int i;
+
+    (void)arg;
+    for (i = 0; i < CHMOD_LOOP_COUNT; i++) {
+        if (chmod(CHMOD_TEST_PATH, (i & 1) ? (S_IRUSR | S_IWUSR) : S_IRUSR) != 0) {
+            g_chmodFailed = 1;
+            break;
+        }
+    }
+    return nullptr;
+}
+
+static int64_t ParallelChmodCost(int threadNum)
+{
+    pthread_t tid[CHMOD_THREAD_MAX];
+    struct timespec start, end;
+    int ret;
+    int i;
+
+    g_chmodFailed = 0;
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < threadNum; i++) {
+        ret = pthread_create(&tid[i], nullptr, ChmodThread, nullptr);
+        ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    }
+    for (i = 0; i < threadNum; i++) {
+        ret = pthread_join(tid[i], nullptr);
+        ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    ICUNIT_ASSERT_EQUAL(g_chmodFailed, 0, -1);
+
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / CHMOD_LOOP_COUNT;
+}
+
+static int Testcase(void)
+{
+    struct stat buf;
+    int64_t cost;
+    int threadNum;
+    int ret;
+    int fd;
+
+    fd = open(CHMOD_TEST_PATH, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+    (void)close(fd);
+
+    /* chmod resolves its path with VnodeLookupHold, the lockless path cache walk */
+    for (threadNum = 1; threadNum <= CHMOD_THREAD_MAX; threadNum <<= 1) {
+        cost = ParallelChmodCost(threadNum);
+        ICUNIT_GOTO_NOT_EQUAL(cost, -1, cost, EXIT);
+        LogPrintln("parallel chmod: %d threads, %" PRId64 " ns/round\n", threadNum, cost);
+    }
+
+    /* a rename drops the cached entry, the lockless walk must not resolve the stale name */
+    ret = rename(CHMOD_TEST_PATH, CHMOD_MOVED_PATH);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ret = chmod(CHMOD_TEST_PATH, S_IRUSR | S_IWUSR);
+    ICUNIT_GOTO_EQUAL(ret, -1, ret, EXIT1);
+    ICUNIT_GOTO_EQUAL(errno, ENOENT, errno, EXIT1);
+    ret = chmod(CHMOD_MOVED_PATH, S_IRUSR);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT1);
+    ret = stat(CHMOD_MOVED_PATH, &buf);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT1);
+    ICUNIT_GOTO_EQUAL(buf.st_mode & S_IWUSR, 0, buf.st_mode, EXIT1);
+
+    (void)unlink(CHMOD_MOVED_PATH);
+    return 0;
+
+EXIT1:
+    (void)unlink(CHMOD_MOVED_PATH);
+    return -1;
+EXIT:
+    (void)unlink(CHMOD_TEST_PATH);
+    return -1;
+}
+
+void ItTestVfs001(void)
+{
+    TEST_ADD_CASE("IT_TEST_VFS_001", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
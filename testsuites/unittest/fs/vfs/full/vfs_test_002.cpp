@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vfs.h"
+#include <inttypes.h>
+#include <sys/mman.h>
+
+static const char *FAULT_TEST_FILE = "/storage/vfs_fault_test";
+static const size_t FAULT_TEST_SIZES[] = { 1 << 20, 8 << 20, 32 << 20 }; // 1M, 8M and 32M files
+
+/* touch every page of the file through a fresh mapping, returns the cost per fault or -1 on a wrong page */
+static int64_t FaultFilePages(int fd, size_t size)
+{
+    struct timespec start, end;
+    volatile char *addr = nullptr;
+    size_t pageSize = (size_t)getpagesize();
+    size_t off;
+    size_t wrong = 0;
+
+    addr = (volatile char *)mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == (volatile char *)MAP_FAILED) {
+        return -1;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (off = 0; off < size; off += pageSize) {
+        wrong += (addr[off] != VfsTestPageByte(off / pageSize)) ? 1 : 0;
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    (void)munmap((void *)addr, size);
+
+    /* every fault has to find the page of its own index in the cache */
+    if (wrong != 0) {
+        return -1;
+    }
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / (int64_t)(size / pageSize);
+}
+
+static int Testcase(void)
+{
+    int64_t coldCost, warmCost;
+    unsigned int i;
+    int fd;
+
+    /* page cache lookups on fault go through a radix tree instead of walking every cached page */
+    for (i = 0; i < sizeof(FAULT_TEST_SIZES) / sizeof(FAULT_TEST_SIZES[0]); i++) {
+        fd = VfsTestFileCreate(FAULT_TEST_FILE, FAULT_TEST_SIZES[i]);
+        ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+
+        coldCost = FaultFilePages(fd, FAULT_TEST_SIZES[i]);
+        ICUNIT_GOTO_NOT_EQUAL(coldCost, -1, coldCost, EXIT);
+        warmCost = FaultFilePages(fd, FAULT_TEST_SIZES[i]);
+        ICUNIT_GOTO_NOT_EQUAL(warmCost, -1, warmCost, EXIT);
+        LogPrintln("file fault: %zu KB file, %" PRId64 " ns/fault cold, %" PRId64 " ns/fault cached\n",
+            FAULT_TEST_SIZES[i] >> 10, coldCost, warmCost); // 10, bytes to KB
+
+        (void)close(fd);
+        (void)unlink(FAULT_TEST_FILE);
+    }
+    return 0;
+
+EXIT:
+    (void)close(fd);
+    (void)unlink(FAULT_TEST_FILE);
+    return -1;
+}
+
+void ItTestVfs002(void)
+{
+    TEST_ADD_CASE("IT_TEST_VFS_002", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vfs.h"
+#include <inttypes.h>
+#include <sys/mman.h>
+
+static const size_t SCAN_TEST_SIZE = 8 << 20;
+static const size_t SCAN_RANDOM_STRIDE = 7919; // odd, so it permutes a power of two page count
+
+/* touch every page of a fresh mapping in file order or in a scattered order, returns ns per page or -1 */
+static int64_t ScanFilePages(int fd, bool sequential)
+{
+    struct timespec start, end;
+    volatile char *addr = nullptr;
+    size_t pageSize = (size_t)getpagesize();
+    size_t pages = SCAN_TEST_SIZE / pageSize;
+    size_t i, index;
+    size_t wrong = 0;
+
+    addr = (volatile char *)mmap(nullptr, SCAN_TEST_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == (volatile char *)MAP_FAILED) {
+        return -1;
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < pages; i++) {
+        index = sequential ? i : ((i * SCAN_RANDOM_STRIDE) & (pages - 1));
+        wrong += (addr[index * pageSize] != VfsTestPageByte(index)) ? 1 : 0;
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    (void)munmap((void *)addr, SCAN_TEST_SIZE);
+
+    /* readahead and fault-around must map each page at its own offset, whatever the order */
+    if (wrong != 0) {
+        return -1;
+    }
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / (int64_t)pages;
+}
+
+static int ScanDir(const char *dir)
+{
+    char path[PATH_MAX];
+    int64_t seqCost, randCost;
+    int fd = -1;
+    int ret;
+
+    ret = snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s/vfs_scan_test", dir);
+    ICUNIT_ASSERT_NOT_EQUAL(ret, -1, ret);
+
+    /* a new file per pattern, so both scans start with nothing of it in the page cache */
+    fd = VfsTestFileCreate(path, SCAN_TEST_SIZE);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+    seqCost = ScanFilePages(fd, true);
+    ICUNIT_GOTO_NOT_EQUAL(seqCost, -1, seqCost, EXIT);
+    (void)close(fd);
+    (void)unlink(path);
+
+    fd = VfsTestFileCreate(path, SCAN_TEST_SIZE);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+    randCost = ScanFilePages(fd, false);
+    ICUNIT_GOTO_NOT_EQUAL(randCost, -1, randCost, EXIT);
+
+    LogPrintln("mmap scan on %s: %" PRId64 " ns/page sequential, %" PRId64 " ns/page random\n",
+        dir, seqCost, randCost);
+
+    (void)close(fd);
+    (void)unlink(path);
+    return 0;
+
+EXIT:
+    (void)close(fd);
+    (void)unlink(path);
+    return -1;
+}
+
+static int Testcase(void)
+{
+    unsigned int i;
+    int ret;
+
+    /* sequential faults are served by readahead and fault-around, random ones read a page each */
+    for (i = 0; i < VFS_TEST_DIR_NUM; i++) {
+        if (access(g_vfsTestDirs[i], W_OK) != 0) {
+            continue;
+        }
+        ret = ScanDir(g_vfsTestDirs[i]);
+        ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    }
+    return 0;
+}
+
+void ItTestVfs003(void)
+{
+    TEST_ADD_CASE("IT_TEST_VFS_003", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
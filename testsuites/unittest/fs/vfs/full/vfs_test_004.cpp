@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vfs.h"
+#include <inttypes.h>
+
+static const size_t RW_TEST_SIZE = 1 << 20;
+static const size_t RW_TEST_CHUNK = 64 << 10;
+static const int RW_READ_LOOPS = 8;
+static const off_t RW_HOLE_START = (1 << 20) + 100; // unaligned, past the end of the file
+static const off_t RW_PATCH_POS = 4096 - 10;        // straddles a page boundary
+static const off_t RW_SHRINK_SIZE = 4096 + 100;     // ends in the middle of a cached page
+static const char RW_PATCH[] = "0123456789abcdefghij";
+
+static int RwFileFill(int fd, char *chunk)
+{
+    size_t done;
+
+    (void)memset_s(chunk, RW_TEST_CHUNK, 'r', RW_TEST_CHUNK);
+    for (done = 0; done < RW_TEST_SIZE; done += RW_TEST_CHUNK) {
+        if (write(fd, chunk, RW_TEST_CHUNK) != (ssize_t)RW_TEST_CHUNK) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* read the whole file a few times, the passes after the first one are served from the cache */
+static int64_t RwFileRead(int fd, char *chunk, int loops)
+{
+    struct timespec start, end;
+    size_t done;
+    int i;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < loops; i++) {
+        if (lseek(fd, 0, SEEK_SET) != 0) {
+            return -1;
+        }
+        for (done = 0; done < RW_TEST_SIZE; done += RW_TEST_CHUNK) {
+            if (read(fd, chunk, RW_TEST_CHUNK) != (ssize_t)RW_TEST_CHUNK) {
+                return -1;
+            }
+        }
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /* KB per ms, 1024 bytes per KB and 1e6 ns per ms */
+    return (int64_t)(RW_TEST_SIZE >> 10) * loops * (int64_t)1e6 / (TimespecToNs(&end) - TimespecToNs(&start) + 1);
+}
+
+/* the first chunk of the file once RW_PATCH is written over the fill */
+static char RwPatchedByte(off_t pos)
+{
+    bool inPatch = (pos >= RW_PATCH_POS) && (pos < RW_PATCH_POS + (off_t)sizeof(RW_PATCH));
+    return inPatch ? RW_PATCH[pos - RW_PATCH_POS] : 'r';
+}
+
+/* overwrite across a page boundary and append behind a hole, then check it all reads back */
+static int RwFileCheck(int fd, char *chunk)
+{
+    const char *patch = RW_PATCH;
+    off_t pos;
+    int i;
+
+    if (pwrite(fd, patch, sizeof(RW_PATCH), RW_PATCH_POS) != (ssize_t)sizeof(RW_PATCH)) {
+        return -1;
+    }
+    if (pwrite(fd, patch, sizeof(RW_PATCH), RW_HOLE_START) != (ssize_t)sizeof(RW_PATCH)) {
+        return -1;
+    }
+    if (lseek(fd, 0, SEEK_END) != RW_HOLE_START + (off_t)sizeof(RW_PATCH)) {
+        return -1;
+    }
+
+    if (pread(fd, chunk, RW_TEST_CHUNK, 0) != (ssize_t)RW_TEST_CHUNK) {
+        return -1;
+    }
+    for (pos = 0; pos < (off_t)RW_TEST_CHUNK; pos++) {
+        if (chunk[pos] != RwPatchedByte(pos)) {
+            return -1;
+        }
+    }
+
+    if (pread(fd, chunk, RW_TEST_CHUNK, RW_TEST_SIZE) !=
+        RW_HOLE_START - (off_t)RW_TEST_SIZE + (off_t)sizeof(RW_PATCH)) {
+        return -1;
+    }
+    for (i = 0; i < RW_HOLE_START - (off_t)RW_TEST_SIZE; i++) {
+        if (chunk[i] != 0) {
+            return -1;
+        }
+    }
+    return memcmp(chunk + (RW_HOLE_START - RW_TEST_SIZE), patch, sizeof(RW_PATCH));
+}
+
+/* shrink into a cached page and grow back, the bytes past the shrink point must read as zero */
+static int RwTruncateCheck(int fd, char *chunk)
+{
+    off_t pos;
+
+    if ((ftruncate(fd, RW_SHRINK_SIZE) != 0) || (ftruncate(fd, (off_t)RW_TEST_CHUNK) != 0)) {
+        return -1;
+    }
+    if (pread(fd, chunk, RW_TEST_CHUNK, 0) != (ssize_t)RW_TEST_CHUNK) {
+        return -1;
+    }
+    for (pos = 0; pos < (off_t)RW_TEST_CHUNK; pos++) {
+        if (chunk[pos] != ((pos < RW_SHRINK_SIZE) ? RwPatchedByte(pos) : 0)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int RwDir(const char *dir, char *chunk)
+{
+    char path[PATH_MAX];
+    int64_t coldSpeed, warmSpeed;
+    int fd, ret;
+
+    ret = snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s/vfs_rw_test", dir);
+    ICUNIT_ASSERT_NOT_EQUAL(ret, -1, ret);
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+
+    ret = RwFileFill(fd, chunk);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    coldSpeed = RwFileRead(fd, chunk, 1);
+    ICUNIT_GOTO_NOT_EQUAL(coldSpeed, -1, coldSpeed, EXIT);
+    warmSpeed = RwFileRead(fd, chunk, RW_READ_LOOPS);
+    ICUNIT_GOTO_NOT_EQUAL(warmSpeed, -1, warmSpeed, EXIT);
+    LogPrintln("read on %s: %" PRId64 " KB/ms first pass, %" PRId64 " KB/ms repeated\n",
+        dir, coldSpeed, warmSpeed);
+
+    ret = RwFileCheck(fd, chunk);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+
+    /* what reaches the file system through write-back reads the same after a reopen */
+    ret = fsync(fd);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    (void)close(fd);
+    fd = open(path, O_RDWR);
+    ICUNIT_GOTO_NOT_EQUAL(fd, -1, fd, EXIT);
+    ret = RwFileCheck(fd, chunk);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ret = RwTruncateCheck(fd, chunk);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+
+    (void)close(fd);
+    (void)unlink(path);
+    return 0;
+
+EXIT:
+    (void)close(fd);
+    (void)unlink(path);
+    return -1;
+}
+
+static int Testcase(void)
+{
+    char *chunk = (char *)malloc(RW_TEST_CHUNK);
+    unsigned int i;
+    int ret = 0;
+
+    ICUNIT_ASSERT_NOT_EQUAL(chunk, nullptr, -1);
+    for (i = 0; i < VFS_TEST_DIR_NUM; i++) {
+        if (access(g_vfsTestDirs[i], W_OK) != 0) {
+            continue;
+        }
+        ret = RwDir(g_vfsTestDirs[i], chunk);
+        if (ret != 0) {
+            break;
+        }
+    }
+    free(chunk);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    return 0;
+}
+
+void ItTestVfs004(void)
+{
+    TEST_ADD_CASE("IT_TEST_VFS_004", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vfs.h"
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+/* a buffer larger than any kernel bounce buffer, split unevenly over the iovecs */
+static const size_t PIN_TEST_SIZE = 4 << 20;
+static const int PIN_IOV_CNT = 3;
+static const size_t PIN_IOV_HEAD = 4096 + 100;
+static const size_t PIN_IOV_MID = (1 << 20) - 7;
+static const size_t PIN_APPEND_SIZE = 2 << 20;
+
+/* KB per ms, 1024 bytes per KB and 1e6 ns per ms */
+static int64_t PinSpeed(const struct timespec *start, const struct timespec *end)
+{
+    return (int64_t)(PIN_TEST_SIZE >> 10) * (int64_t)1e6 / (TimespecToNs(end) - TimespecToNs(start) + 1);
+}
+
+static void PinIovInit(struct iovec *iov, char *buf)
+{
+    iov[0].iov_base = buf;
+    iov[0].iov_len = PIN_IOV_HEAD;
+    iov[1].iov_base = buf + PIN_IOV_HEAD;
+    iov[1].iov_len = PIN_IOV_MID;
+    iov[2].iov_base = buf + PIN_IOV_HEAD + PIN_IOV_MID;
+    iov[2].iov_len = PIN_TEST_SIZE - PIN_IOV_HEAD - PIN_IOV_MID;
+}
+
+static int PinCheck(const char *buf, char seed)
+{
+    size_t i;
+
+    for (i = 0; i < PIN_TEST_SIZE; i++) {
+        if (buf[i] != (char)(seed + (i % 251))) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void PinFill(char *buf, char seed)
+{
+    size_t i;
+
+    for (i = 0; i < PIN_TEST_SIZE; i++) {
+        buf[i] = (char)(seed + (i % 251));
+    }
+}
+
+struct PinAppender {
+    int fd;
+    char *buf;
+    ssize_t ret;
+};
+
+static void *PinAppendThread(void *arg)
+{
+    struct PinAppender *appender = (struct PinAppender *)arg;
+    struct iovec iov[PIN_IOV_CNT];
+
+    iov[0].iov_base = appender->buf;
+    iov[0].iov_len = PIN_IOV_HEAD;
+    iov[1].iov_base = appender->buf + PIN_IOV_HEAD;
+    iov[1].iov_len = PIN_IOV_MID;
+    iov[2].iov_base = appender->buf + PIN_IOV_HEAD + PIN_IOV_MID;
+    iov[2].iov_len = PIN_APPEND_SIZE - PIN_IOV_HEAD - PIN_IOV_MID;
+    appender->ret = writev(appender->fd, iov, PIN_IOV_CNT);
+    return nullptr;
+}
+
+static int PinRunCheck(const char *buf, size_t len)
+{
+    size_t i;
+
+    for (i = 1; i < len; i++) {
+        if (buf[i] != buf[0]) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* two writers appending at once, each writev lands as one run and not interleaved with the other */
+static int PinAppendCheck(const char *path, char *wbuf, char *rbuf)
+{
+    struct PinAppender appender[2] = { { -1, wbuf, 0 }, { -1, rbuf, 0 } }; // 2 writers
+    pthread_t tid[2]; // 2 writers
+    int fd, ret, i, created;
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, S_IRUSR | S_IWUSR);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+    (void)memset_s(wbuf, PIN_APPEND_SIZE, 'x', PIN_APPEND_SIZE);
+    (void)memset_s(rbuf, PIN_APPEND_SIZE, 'y', PIN_APPEND_SIZE);
+    for (created = 0; created < 2; created++) { // 2 writers
+        appender[created].fd = fd;
+        ret = pthread_create(&tid[created], nullptr, PinAppendThread, &appender[created]);
+        if (ret != 0) {
+            break;
+        }
+    }
+    for (i = 0; i < created; i++) {
+        (void)pthread_join(tid[i], nullptr);
+    }
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    for (i = 0; i < 2; i++) { // 2 writers
+        ICUNIT_GOTO_EQUAL(appender[i].ret, (ssize_t)PIN_APPEND_SIZE, appender[i].ret, EXIT);
+    }
+
+    ret = pread(fd, wbuf, PIN_APPEND_SIZE * 2, 0); // 2 writers
+    ICUNIT_GOTO_EQUAL(ret, (int)(PIN_APPEND_SIZE * 2), ret, EXIT); // 2 writers
+    ICUNIT_GOTO_NOT_EQUAL(wbuf[0], wbuf[PIN_APPEND_SIZE], wbuf[0], EXIT);
+    ret = PinRunCheck(wbuf, PIN_APPEND_SIZE);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    ret = PinRunCheck(wbuf + PIN_APPEND_SIZE, PIN_APPEND_SIZE);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+
+    (void)close(fd);
+    return 0;
+
+EXIT:
+    (void)close(fd);
+    return -1;
+}
+
+static int PinDir(const char *dir, char *wbuf, char *rbuf)
+{
+    char path[PATH_MAX];
+    struct iovec iov[PIN_IOV_CNT];
+    struct timespec start, mid, end;
+    ssize_t len;
+    int fd, ret;
+
+    ret = snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s/vfs_pin_test", dir);
+    ICUNIT_ASSERT_NOT_EQUAL(ret, -1, ret);
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ICUNIT_ASSERT_NOT_EQUAL(fd, -1, fd);
+
+    PinFill(wbuf, 'a');
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    len = pwrite(fd, wbuf, PIN_TEST_SIZE, 0);
+    (void)clock_gettime(CLOCK_MONOTONIC, &mid);
+    ICUNIT_GOTO_EQUAL(len, (ssize_t)PIN_TEST_SIZE, len, EXIT);
+    len = pread(fd, rbuf, PIN_TEST_SIZE, 0);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    ICUNIT_GOTO_EQUAL(len, (ssize_t)PIN_TEST_SIZE, len, EXIT);
+    ret = PinCheck(rbuf, 'a');
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    LogPrintln("pwrite/pread on %s: %" PRId64 " / %" PRId64 " KB/ms\n",
+        dir, PinSpeed(&start, &mid), PinSpeed(&mid, &end));
+
+    /* the iovec boundaries fall inside pages, the file position moves by the whole request */
+    PinFill(wbuf, 'k');
+    PinIovInit(iov, wbuf);
+    (void)lseek(fd, 0, SEEK_SET);
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    len = writev(fd, iov, PIN_IOV_CNT);
+    (void)clock_gettime(CLOCK_MONOTONIC, &mid);
+    ICUNIT_GOTO_EQUAL(len, (ssize_t)PIN_TEST_SIZE, len, EXIT);
+    ICUNIT_GOTO_EQUAL(lseek(fd, 0, SEEK_CUR), (off_t)PIN_TEST_SIZE, -1, EXIT);
+
+    (void)memset_s(rbuf, PIN_TEST_SIZE, 0, PIN_TEST_SIZE);
+    PinIovInit(iov, rbuf);
+    (void)lseek(fd, 0, SEEK_SET);
+    len = readv(fd, iov, PIN_IOV_CNT);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    ICUNIT_GOTO_EQUAL(len, (ssize_t)PIN_TEST_SIZE, len, EXIT);
+    ret = PinCheck(rbuf, 'k');
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    LogPrintln("writev/readv on %s: %" PRId64 " / %" PRId64 " KB/ms\n",
+        dir, PinSpeed(&start, &mid), PinSpeed(&mid, &end));
+
+    /* a short read at the end of the file stops in the middle of the iovec array */
+    len = pread(fd, rbuf, PIN_TEST_SIZE, PIN_TEST_SIZE - PIN_IOV_HEAD);
+    ICUNIT_GOTO_EQUAL(len, (ssize_t)PIN_IOV_HEAD, len, EXIT);
+    (void)lseek(fd, PIN_TEST_SIZE - PIN_IOV_HEAD - 1, SEEK_SET);
+    len = readv(fd, iov, PIN_IOV_CNT);
+    ICUNIT_GOTO_EQUAL(len, (ssize_t)PIN_IOV_HEAD + 1, len, EXIT);
+
+    /* an address outside the user address space is refused, not read into */
+    len = pread(fd, (void *)0x1000, 16, 0);
+    ICUNIT_GOTO_EQUAL(len, -1, len, EXIT);
+    ICUNIT_GOTO_EQUAL(errno, EFAULT, errno, EXIT);
+
+    (void)close(fd);
+    ret = PinAppendCheck(path, wbuf, rbuf);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT1);
+
+    (void)unlink(path);
+    return 0;
+
+EXIT1:
+    (void)unlink(path);
+    return -1;
+
+EXIT:
+    (void)close(fd);
+    (void)unlink(path);
+    return -1;
+}
+
+static int Testcase(void)
+{
+    char *wbuf = (char *)malloc(PIN_TEST_SIZE);
+    char *rbuf = (char *)malloc(PIN_TEST_SIZE);
+    unsigned int i;
+    int ret = 0;
+
+    if ((wbuf == nullptr) || (rbuf == nullptr)) {
+        free(wbuf);
+        free(rbuf);
+        ICUNIT_ASSERT_NOT_EQUAL(wbuf, nullptr, -1);
+        ICUNIT_ASSERT_NOT_EQUAL(rbuf, nullptr, -1);
+    }
+    for (i = 0; i < VFS_TEST_DIR_NUM; i++) {
+        if (access(g_vfsTestDirs[i], W_OK) != 0) {
+            continue;
+        }
+        ret = PinDir(g_vfsTestDirs[i], wbuf, rbuf);
+        if (ret != 0) {
+            break;
+        }
+    }
+    free(wbuf);
+    free(rbuf);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    return 0;
+}
+
+void ItTestVfs005(void)
+{
+    TEST_ADD_CASE("IT_TEST_VFS_005", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_vfs.h"
+
+static const size_t VFS_TEST_WRITE_CHUNK = 64 << 10;
+
+const char *g_vfsTestDirs[VFS_TEST_DIR_NUM] = { "/storage", "/sdcard" };
+
+int VfsTestFileCreate(const char *path, size_t size)
+{
+    char *chunk = (char *)malloc(VFS_TEST_WRITE_CHUNK);
+    size_t pageSize = (size_t)getpagesize();
+    size_t done = 0;
+    size_t len, off, fill;
+    int fd;
+
+    if (chunk == nullptr) {
+        return -1;
+    }
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    while ((fd >= 0) && (done < size)) {
+        len = (size - done < VFS_TEST_WRITE_CHUNK) ? (size - done) : VFS_TEST_WRITE_CHUNK;
+        for (off = 0; off < len; off += fill) {
+            fill = (len - off < pageSize) ? (len - off) : pageSize;
+            (void)memset_s(chunk + off, fill, VfsTestPageByte((done + off) / pageSize), fill);
+        }
+        if (write(fd, chunk, len) != (ssize_t)len) {
+            (void)close(fd);
+            (void)unlink(path);
+            fd = -1;
+            break;
+        }
+        done += len;
+    }
+    free(chunk);
+    return fd;
+}
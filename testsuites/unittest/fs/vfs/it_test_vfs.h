@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef _IT_TEST_VFS_H
+#define _IT_TEST_VFS_H
+
+#include "osTest.h"
+#include <sys/stat.h>
+
+/* jffs2 on the nor flash and fat on the sd card, a mount point that is not writable is skipped */
+#define VFS_TEST_DIR_NUM 2
+extern const char *g_vfsTestDirs[VFS_TEST_DIR_NUM];
+
+static inline int64_t TimespecToNs(const struct timespec *tp)
+{
+    return tp->tv_sec * (int64_t)1e9 + tp->tv_nsec;
+}
+
+/* the byte every page of a file made by VfsTestFileCreate is filled with, it differs between neighbours */
+static inline char VfsTestPageByte(size_t pageIndex)
+{
+    return (char)('a' + (pageIndex % 26)); // 26 letters
+}
+
+/* create path with size bytes, returns the descriptor open for reading and writing or -1 */
+extern int VfsTestFileCreate(const char *path, size_t size);
+
+extern void ItTestVfs001(void);
+extern void ItTestVfs002(void);
+extern void ItTestVfs003(void);
+extern void ItTestVfs004(void);
+extern void ItTestVfs005(void);
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <climits>
+#include <gtest/gtest.h>
+#include "it_test_vfs.h"
+
+using namespace testing::ext;
+namespace OHOS {
+class VfsTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {}
+    static void TearDownTestCase(void) {}
+};
+
+#if defined(LOSCFG_USER_TEST_FULL)
+/* *
+ * @tc.name: it_test_vfs_001
+ * @tc.desc: performance of chmod() on a cached path from parallel threads, and a stale name after rename
+ * @tc.type: FUNC
+ */
+HWTEST_F(VfsTest, ItTestVfs001, TestSize.Level0)
+{
+    ItTestVfs001();
+}
+
+/* *
+ * @tc.name: it_test_vfs_002
+ * @tc.desc: performance of file backed page faults versus file size
+ * @tc.type: FUNC
+ */
+HWTEST_F(VfsTest, ItTestVfs002, TestSize.Level0)
+{
+    ItTestVfs002();
+}
+
+/* *
+ * @tc.name: it_test_vfs_003
+ * @tc.desc: performance of sequential and random mmap scans on jffs2 and fat
+ * @tc.type: FUNC
+ */
+HWTEST_F(VfsTest, ItTestVfs003, TestSize.Level0)
+{
+    ItTestVfs003();
+}
+
+/* *
+ * @tc.name: it_test_vfs_004
+ * @tc.desc: repeated read speed and read back of partial, appending and hole writes
+ * @tc.type: FUNC
+ */
+HWTEST_F(VfsTest, ItTestVfs004, TestSize.Level0)
+{
+    ItTestVfs004();
+}
+
+/* *
+ * @tc.name: it_test_vfs_005
+ * @tc.desc: pread/pwrite and readv/writev of a multi-megabyte user buffer, with throughput, concurrent O_APPEND writev
+ * @tc.type: FUNC
+ */
+HWTEST_F(VfsTest, ItTestVfs005, TestSize.Level0)
+{
+    ItTestVfs005();
+}
+#endif
+} // namespace OHOS
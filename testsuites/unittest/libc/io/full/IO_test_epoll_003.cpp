@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "It_test_IO.h"
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#define EPOLL_BENCH_ACTIVE 4      /* sockets with pending data in every round */
+#define EPOLL_BENCH_LOOPS 1000
+
+static const int g_benchSizes[] = { 10, 1000, 10000 };
+
+static int64_t TimespecToNs(const struct timespec *tp)
+{
+    return tp->tv_sec * (int64_t)1e9 + tp->tv_nsec;
+}
+
+static int UdpSocketOpen(struct sockaddr_in *addr)
+{
+    socklen_t len = sizeof(*addr);
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    (void)memset_s(addr, sizeof(*addr), 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_addr.s_addr = inet_addr("127.0.0.1");
+    if ((bind(fd, (struct sockaddr *)addr, sizeof(*addr)) != 0) ||
+        (getsockname(fd, (struct sockaddr *)addr, &len) != 0)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* edge triggered and oneshot items report once, and the registered data comes back unchanged */
+static int EpollModeCheck(int epFd, int sender, int fd, const struct sockaddr_in *addr)
+{
+    struct epoll_event ev = { 0 };
+    struct epoll_event out[2]; /* 2, more room than ready items */
+    char buf = 'e';
+    int ret;
+
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.u32 = 0x5a5a; /* 0x5a5a, cookie to find in the result */
+    ret = epoll_ctl(epFd, EPOLL_CTL_ADD, fd, &ev);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    ret = sendto(sender, &buf, 1, 0, (const struct sockaddr *)addr, sizeof(*addr));
+    ICUNIT_ASSERT_EQUAL(ret, 1, ret);
+    ret = epoll_wait(epFd, out, 2, 1000); /* 2, room; 1000, ms */
+    ICUNIT_ASSERT_EQUAL(ret, 1, ret);
+    ICUNIT_ASSERT_EQUAL(out[0].data.u32, 0x5a5a, out[0].data.u32);
+    ret = epoll_wait(epFd, out, 2, 0); /* 2, room; data not read, but no new edge */
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ret = epoll_ctl(epFd, EPOLL_CTL_MOD, fd, &ev);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    ret = epoll_wait(epFd, out, 2, 0); /* 2, room */
+    ICUNIT_ASSERT_EQUAL(ret, 1, ret);
+    ret = epoll_wait(epFd, out, 2, 0); /* 2, room; disarmed until the next MOD */
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+
+    ret = epoll_ctl(epFd, EPOLL_CTL_DEL, fd, NULL);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    (void)recv(fd, &buf, 1, 0);
+    return 0;
+}
+
+struct EpollCloseWaiter {
+    int epFd;
+    int ret;
+    int err;
+};
+
+static void *EpollCloseWaitThread(void *arg)
+{
+    struct EpollCloseWaiter *waiter = (struct EpollCloseWaiter *)arg;
+    struct epoll_event out;
+
+    waiter->ret = epoll_wait(waiter->epFd, &out, 1, 5000); /* 5000, ms, far longer than the close takes */
+    waiter->err = errno;
+    return NULL;
+}
+
+/* closing an instance wakes the thread blocked in it, which returns EBADF instead of sleeping on */
+static int EpollCloseCheck(int fd)
+{
+    struct EpollCloseWaiter waiter = { -1, 0, 0 };
+    struct epoll_event ev = { 0 };
+    struct timespec start, end;
+    pthread_t tid;
+    int ret;
+
+    waiter.epFd = epoll_create1(0);
+    ICUNIT_ASSERT_NOT_EQUAL(waiter.epFd, -1, waiter.epFd);
+    ev.events = EPOLLIN;
+    ret = epoll_ctl(waiter.epFd, EPOLL_CTL_ADD, fd, &ev);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+
+    ret = pthread_create(&tid, NULL, EpollCloseWaitThread, &waiter);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+    usleep(100000); /* 100000, us, let the thread block */
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = close(waiter.epFd);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    ret = pthread_join(tid, NULL);
+    ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    /* 1000000000, 1s in ns: woken by the close, not by its own timeout */
+    ICUNIT_ASSERT_WITHIN_EQUAL(TimespecToNs(&end) - TimespecToNs(&start), 0, 1000000000, -1);
+    ICUNIT_ASSERT_EQUAL(waiter.ret, -1, waiter.ret);
+    ICUNIT_ASSERT_EQUAL(waiter.err, EBADF, waiter.err);
+    return 0;
+
+EXIT:
+    (void)close(waiter.epFd);
+    return -1;
+}
+
+/* latency of epoll_wait with count registered sockets of which EPOLL_BENCH_ACTIVE have data */
+static int EpollBench(int epFd, int *fds, const struct sockaddr_in *addrs, int sender, int count)
+{
+    struct epoll_event out[EPOLL_BENCH_ACTIVE];
+    struct timespec start, end;
+    char buf = 'b';
+    int i, ret;
+
+    for (i = 0; i < EPOLL_BENCH_ACTIVE; i++) {
+        ret = sendto(sender, &buf, 1, 0, (const struct sockaddr *)&addrs[i * (count / EPOLL_BENCH_ACTIVE)],
+            sizeof(addrs[0]));
+        ICUNIT_ASSERT_EQUAL(ret, 1, ret);
+    }
+
+    /* loopback delivery goes through the stack thread, wait until every datagram landed */
+    for (i = 0; i < EPOLL_BENCH_LOOPS; i++) {
+        if (epoll_wait(epFd, out, EPOLL_BENCH_ACTIVE, 1000) == EPOLL_BENCH_ACTIVE) { /* 1000, ms */
+            break;
+        }
+        usleep(1000); /* 1000, us */
+    }
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < EPOLL_BENCH_LOOPS; i++) {
+        ret = epoll_wait(epFd, out, EPOLL_BENCH_ACTIVE, 1000); /* 1000, ms */
+        ICUNIT_ASSERT_EQUAL(ret, EPOLL_BENCH_ACTIVE, ret);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("epoll_wait with %d fds, %d active: %" PRId64 " ns\n", count, EPOLL_BENCH_ACTIVE,
+        (TimespecToNs(&end) - TimespecToNs(&start)) / EPOLL_BENCH_LOOPS);
+
+    for (i = 0; i < EPOLL_BENCH_ACTIVE; i++) {
+        (void)recv(fds[i * (count / EPOLL_BENCH_ACTIVE)], &buf, 1, 0);
+    }
+    return 0;
+}
+
+static UINT32 testcase(VOID)
+{
+    int maxFds = g_benchSizes[sizeof(g_benchSizes) / sizeof(g_benchSizes[0]) - 1];
+    struct sockaddr_in *addrs = (struct sockaddr_in *)malloc(sizeof(struct sockaddr_in) * maxFds);
+    int *fds = (int *)malloc(sizeof(int) * maxFds);
+    struct sockaddr_in senderAddr;
+    struct epoll_event ev = { 0 };
+    int opened = 0;
+    int epFd = -1;
+    int sender = -1;
+    unsigned int i;
+    int ret = -1;
+
+    ICUNIT_GOTO_NOT_EQUAL(addrs, NULL, addrs, OUT);
+    ICUNIT_GOTO_NOT_EQUAL(fds, NULL, fds, OUT);
+    sender = UdpSocketOpen(&senderAddr);
+    ICUNIT_GOTO_NOT_EQUAL(sender, -1, sender, OUT);
+    epFd = epoll_create1(0);
+    ICUNIT_GOTO_NOT_EQUAL(epFd, -1, epFd, OUT);
+
+    for (i = 0; i < sizeof(g_benchSizes) / sizeof(g_benchSizes[0]); i++) {
+        /* the socket limit of the build may stop short of the larger sizes */
+        while (opened < g_benchSizes[i]) {
+            fds[opened] = UdpSocketOpen(&addrs[opened]);
+            if (fds[opened] < 0) {
+                break;
+            }
+            ev.events = EPOLLIN;
+            ev.data.fd = fds[opened];
+            ret = epoll_ctl(epFd, EPOLL_CTL_ADD, fds[opened], &ev);
+            opened++;
+            ICUNIT_GOTO_EQUAL(ret, 0, ret, OUT);
+        }
+        if (opened < g_benchSizes[i]) {
+            printf("epoll_wait with %d fds skipped, %d sockets available\n", g_benchSizes[i], opened);
+            break;
+        }
+        ret = EpollBench(epFd, fds, addrs, sender, opened);
+        ICUNIT_GOTO_EQUAL(ret, 0, ret, OUT);
+    }
+
+    ICUNIT_GOTO_NOT_EQUAL(opened, 0, opened, OUT);
+    ret = epoll_ctl(epFd, EPOLL_CTL_DEL, fds[0], NULL);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, OUT);
+    ret = EpollModeCheck(epFd, sender, fds[0], &addrs[0]);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, OUT);
+    ret = EpollCloseCheck(fds[0]);
+    ICUNIT_GOTO_EQUAL(ret, 0, ret, OUT);
+
+OUT:
+    while (opened > 0) {
+        close(fds[--opened]);
+    }
+    if (epFd != -1) {
+        close(epFd);
+    }
+    if (sender != -1) {
+        close(sender);
+    }
+    free(fds);
+    free(addrs);
+    return (ret == 0) ? LOS_OK : LOS_NOK;
+}
+
+VOID IO_TEST_EPOLL_003(VOID)
+{
+    TEST_ADD_CASE(__FUNCTION__, testcase, TEST_LIB, TEST_LIBC, TEST_LEVEL1, TEST_FUNCTION);
+}
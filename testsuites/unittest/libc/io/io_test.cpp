@@ -160,6 +160,16 @@ HWTEST_F(IoTest, IO_TEST_EPOLL_002, TestSize.Level0)
     IO_TEST_EPOLL_002();
 }
 
+/* *
+ * @tc.name: IO_TEST_EPOLL_003
+ * @tc.desc: epoll_wait latency at 10, 1k and 10k sockets with few active, edge triggered and oneshot items, close while waiting
+ * @tc.type: FUNC
+ */
+HWTEST_F(IoTest, IO_TEST_EPOLL_003, TestSize.Level0)
+{
+    IO_TEST_EPOLL_003();
+}
+
 /* *
  * @tc.name: IT_STDLIB_POLL_002
  * @tc.desc: function for IoTest
@@ -60,6 +60,7 @@ const int MQUEUE_STANDARD_NAME_LENGTH  = 50;
 #define MQUEUE_PRIORITY_TEST 0
 #define MQUEUE_TIMEOUT_TEST 7
 #define MQUEUE_PRIORITY_NUM_TEST 3
+#define MQUEUE_PRIO_MAX_TEST 32 /* priorities supported by the kernel, MQ_PRIO_MAX of compat/posix */
 #define MQUEUE_MAX_NUM_TEST (LOSCFG_BASE_IPC_QUEUE_CONFIG - QUEUE_EXISTED_NUM)
 #define MQ_MAX_MSG_NUM 16
 #define MQ_MAX_MSG_LEN 64
@@ -274,5 +275,6 @@ VOID ItPosixQueue206(VOID);
 VOID ItPosixQueue207(VOID);
 VOID ItPosixQueue208(VOID);
 VOID ItPosixQueue209(VOID);
+VOID ItPosixQueue210(VOID);
 #endif
 #endif
@@ -45,7 +45,7 @@ static UINT32 Testcase(VOID)
 
     ts.tv_sec = 1;
     ts.tv_nsec = 0;
-    ret = mq_timedsend(mqueue, msgptr, strlen(msgptr), MQ_PRIO_MAX + 1, &ts);
+    ret = mq_timedsend(mqueue, msgptr, strlen(msgptr), MQUEUE_PRIO_MAX_TEST + 1, &ts);
     ICUNIT_GOTO_EQUAL(ret, MQUEUE_IS_ERROR, ret, EXIT1);
     ICUNIT_GOTO_EQUAL(errno, EINVAL, errno, EXIT1);
 
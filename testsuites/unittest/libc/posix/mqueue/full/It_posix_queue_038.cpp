@@ -42,7 +42,7 @@ static UINT32 Testcase(VOID)
     mqueue = mq_open(mqname, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, NULL);
     ICUNIT_GOTO_NOT_EQUAL(mqueue, (mqd_t)-1, mqueue, EXIT1);
 
-    ret = mq_send(mqueue, msgptr, strlen(msgptr), MQ_PRIO_MAX);
+    ret = mq_send(mqueue, msgptr, strlen(msgptr), MQUEUE_PRIO_MAX_TEST);
     ICUNIT_GOTO_EQUAL(ret, MQUEUE_IS_ERROR, ret, EXIT1);
     ICUNIT_GOTO_EQUAL(errno, EINVAL, errno, EXIT1);
 
@@ -33,7 +33,7 @@
 static UINT32 Testcase(VOID)
 {
     INT32 i, ret = 0;
-    INT32 mqueuePri[MQUEUE_PRIORITY_NUM_TEST] = {MQ_PRIO_MAX, MQ_PRIO_MAX + 1, MQ_PRIO_MAX + 5}; // 5, Mqueue priority.
+    INT32 mqueuePri[MQUEUE_PRIORITY_NUM_TEST] = {MQUEUE_PRIO_MAX_TEST, MQUEUE_PRIO_MAX_TEST + 1, MQUEUE_PRIO_MAX_TEST + 5}; // 5, Mqueue priority.
     CHAR mqname[MQUEUE_STANDARD_NAME_LENGTH] = "";
     const CHAR *msgptr = MQUEUE_SEND_STRING_TEST;
     mqd_t mqueue;
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "It_posix_queue.h"
+#include <inttypes.h>
+
+static const int MQ_BENCH_ROUNDS = 2000;
+static const int MQ_BENCH_DEPTH = 16;
+static const int MQ_BENCH_SIZES[] = { 16, 256, 4096 };
+
+static mqd_t g_benchMqueue;
+static int g_benchSize;
+static volatile int g_benchFailed;
+
+static int64_t TimespecToNs(const struct timespec *tp)
+{
+    return tp->tv_sec * (int64_t)1e9 + tp->tv_nsec;
+}
+
+static VOID *BenchReceiver(VOID *arg)
+{
+    CHAR *msgrcd = (CHAR *)malloc(g_benchSize);
+    int i;
+
+    (void)arg;
+    if (msgrcd == nullptr) {
+        g_benchFailed = 1;
+        return nullptr;
+    }
+    for (i = 0; i < MQ_BENCH_ROUNDS; i++) {
+        if (mq_receive(g_benchMqueue, msgrcd, g_benchSize, nullptr) != g_benchSize) {
+            g_benchFailed = 1;
+            break;
+        }
+    }
+    free(msgrcd);
+    return nullptr;
+}
+
+static UINT32 PriorityOrder(const CHAR *mqname)
+{
+    CHAR msgrcd[MQUEUE_STANDARD_NAME_LENGTH] = {0};
+    unsigned int prio[] = { 3, 0, MQUEUE_PRIO_MAX_TEST - 1, 3 };
+    unsigned int expect[] = { MQUEUE_PRIO_MAX_TEST - 1, 3, 3, 0 };
+    unsigned int recvPrio;
+    struct mq_attr attr = {0};
+    mqd_t mqueue;
+    int ret, i;
+
+    attr.mq_msgsize = MQUEUE_STANDARD_NAME_LENGTH;
+    attr.mq_maxmsg = MQUEUE_SHORT_ARRAY_LENGTH;
+    mqueue = mq_open(mqname, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, &attr);
+    ICUNIT_ASSERT_NOT_EQUAL(mqueue, (mqd_t)-1, mqueue);
+
+    for (i = 0; i < (int)(sizeof(prio) / sizeof(prio[0])); i++) {
+        msgrcd[0] = 'a' + i;
+        ret = mq_send(mqueue, msgrcd, 1, prio[i]);
+        ICUNIT_GOTO_EQUAL(ret, MQUEUE_NO_ERROR, ret, EXIT);
+    }
+
+    /* highest priority first, fifo among equal priorities */
+    for (i = 0; i < (int)(sizeof(expect) / sizeof(expect[0])); i++) {
+        ret = mq_receive(mqueue, msgrcd, MQUEUE_STANDARD_NAME_LENGTH, &recvPrio);
+        ICUNIT_GOTO_EQUAL(ret, 1, ret, EXIT);
+        ICUNIT_GOTO_EQUAL(recvPrio, expect[i], recvPrio, EXIT);
+    }
+    ICUNIT_GOTO_EQUAL(msgrcd[0], 'b', msgrcd[0], EXIT);
+
+    ret = mq_close(mqueue);
+    ICUNIT_ASSERT_EQUAL(ret, MQUEUE_NO_ERROR, ret);
+    ret = mq_unlink(mqname);
+    ICUNIT_ASSERT_EQUAL(ret, MQUEUE_NO_ERROR, ret);
+    return MQUEUE_NO_ERROR;
+EXIT:
+    mq_close(mqueue);
+    mq_unlink(mqname);
+    return MQUEUE_IS_ERROR;
+}
+
+static int64_t Throughput(const CHAR *mqname, int msgSize)
+{
+    struct timespec start, end;
+    struct mq_attr attr = {0};
+    pthread_t tid;
+    CHAR *msgptr = nullptr;
+    int ret, i;
+
+    attr.mq_msgsize = msgSize;
+    attr.mq_maxmsg = MQ_BENCH_DEPTH;
+    g_benchMqueue = mq_open(mqname, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR, &attr);
+    ICUNIT_ASSERT_NOT_EQUAL(g_benchMqueue, (mqd_t)-1, -1);
+
+    msgptr = (CHAR *)malloc(msgSize);
+    ICUNIT_GOTO_NOT_EQUAL(msgptr, nullptr, -1, EXIT);
+    (void)memset_s(msgptr, msgSize, 'm', msgSize);
+
+    g_benchSize = msgSize;
+    g_benchFailed = 0;
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = pthread_create(&tid, nullptr, BenchReceiver, nullptr);
+    ICUNIT_GOTO_EQUAL(ret, 0, -1, EXIT);
+    for (i = 0; i < MQ_BENCH_ROUNDS; i++) {
+        ret = mq_send(g_benchMqueue, msgptr, msgSize, i % MQUEUE_PRIO_MAX_TEST);
+        if (ret != MQUEUE_NO_ERROR) {
+            g_benchFailed = 1;
+            break;
+        }
+    }
+    ret = pthread_join(tid, nullptr);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    ICUNIT_GOTO_EQUAL(ret, 0, -1, EXIT);
+    ICUNIT_GOTO_EQUAL(g_benchFailed, 0, -1, EXIT);
+
+    free(msgptr);
+    mq_close(g_benchMqueue);
+    mq_unlink(mqname);
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / MQ_BENCH_ROUNDS;
+EXIT:
+    free(msgptr);
+    mq_close(g_benchMqueue);
+    mq_unlink(mqname);
+    return -1;
+}
+
+static UINT32 Testcase(VOID)
+{
+    CHAR mqname[MQUEUE_STANDARD_NAME_LENGTH] = "";
+    int64_t cost;
+    UINT32 ret;
+    int i;
+
+    snprintf(mqname, MQUEUE_STANDARD_NAME_LENGTH, "/mq210_%d", LosCurTaskIDGet());
+
+    ret = PriorityOrder(mqname);
+    ICUNIT_ASSERT_EQUAL(ret, MQUEUE_NO_ERROR, ret);
+
+    for (i = 0; i < (int)(sizeof(MQ_BENCH_SIZES) / sizeof(MQ_BENCH_SIZES[0])); i++) {
+        cost = Throughput(mqname, MQ_BENCH_SIZES[i]);
+        ICUNIT_ASSERT_NOT_EQUAL(cost, -1, cost);
+        printf("mqueue send/receive: %d bytes, %" PRId64 " ns/msg\n", MQ_BENCH_SIZES[i], cost);
+    }
+    return MQUEUE_NO_ERROR;
+}
+
+VOID ItPosixQueue210(VOID) // IT_Layer_ModuleORFeature_No
+{
+    TEST_ADD_CASE("IT_POSIX_QUEUE_210", Testcase, TEST_POSIX, TEST_QUE, TEST_LEVEL2, TEST_FUNCTION);
+}
@@ -1295,5 +1295,15 @@ HWTEST_F(PosixMqueueTest, ItPosixQueue209, TestSize.Level0)
     ItPosixQueue209();
 }
 
+/**
+ * @tc.name: IT_POSIX_QUEUE_210
+ * @tc.desc: function for mq_send/mq_receive:priority order and throughput across message sizes.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PosixMqueueTest, ItPosixQueue210, TestSize.Level0)
+{
+    ItPosixQueue210();
+}
+
 #endif
 } // namespace OHOS
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <stdio.h>
+#include <unistd.h>
+#include <time.h>
+#include <inttypes.h>
+#include <sys/syscall.h>
+#include "lt_clock_test.h"
+#include <osTest.h>
+
+static const int LOOP_COUNT = 100000;
+
+static int64_t TimespecToNs(const struct timespec *tp)
+{
+    return tp->tv_sec * (int64_t)1e9 + tp->tv_nsec;
+}
+
+static int64_t VdsoCallCost(clockid_t clk)
+{
+    struct timespec start, end, tp, last;
+    int ret;
+    int i;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    last = start;
+    for (i = 0; i < LOOP_COUNT; i++) {
+        ret = clock_gettime(clk, &tp);
+        ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+        if (clk == CLOCK_MONOTONIC) {
+            /* monotonic must never step back, also across data page updates */
+            ICUNIT_ASSERT_EQUAL((TimespecToNs(&tp) >= TimespecToNs(&last)), 1, -1);
+            last = tp;
+        }
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / LOOP_COUNT;
+}
+
+static int64_t SyscallCallCost(clockid_t clk)
+{
+    struct timespec start, end, tp;
+    int ret;
+    int i;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < LOOP_COUNT; i++) {
+        ret = syscall(SYS_clock_gettime, clk, &tp);
+        ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / LOOP_COUNT;
+}
+
+static int ClockTest(void)
+{
+    const clockid_t clks[] = { CLOCK_MONOTONIC, CLOCK_REALTIME };
+    const char *names[] = { "CLOCK_MONOTONIC", "CLOCK_REALTIME" };
+    struct timespec vdsoTp, sysTp;
+    int64_t vdsoCost, sysCost, diff;
+    int ret;
+    int i;
+
+    for (i = 0; i < (int)(sizeof(clks) / sizeof(clks[0])); i++) {
+        /* both paths read the same clock */
+        ret = syscall(SYS_clock_gettime, clks[i], &sysTp);
+        ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+        ret = clock_gettime(clks[i], &vdsoTp);
+        ICUNIT_ASSERT_EQUAL(ret, 0, ret);
+        diff = TimespecToNs(&vdsoTp) - TimespecToNs(&sysTp);
+        ICUNIT_ASSERT_WITHIN_EQUAL(diff, 0, 10000000, diff); // 10000000, 10ms apart at most.
+
+        vdsoCost = VdsoCallCost(clks[i]);
+        ICUNIT_ASSERT_NOT_EQUAL(vdsoCost, -1, vdsoCost);
+        sysCost = SyscallCallCost(clks[i]);
+        ICUNIT_ASSERT_NOT_EQUAL(sysCost, -1, sysCost);
+        LogPrintln("%s: vdso %" PRId64 " ns/call, syscall %" PRId64 " ns/call\n", names[i], vdsoCost, sysCost);
+    }
+    return 0;
+}
+
+void ClockTest011(void)
+{
+    TEST_ADD_CASE(__FUNCTION__, ClockTest, TEST_POSIX, TEST_TIMES, TEST_LEVEL0, TEST_FUNCTION);
+}
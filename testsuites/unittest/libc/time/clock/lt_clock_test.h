@@ -54,5 +54,6 @@ void ClockTest007(void);
 void ClockTest008(void);
 void ClockTest009(void);
 void ClockTest010(void);
+void ClockTest011(void);
 
 #endif /* TIME_CLOCK_LT_CLOCK_TEST_H_ */
@@ -155,5 +155,15 @@ HWTEST_F(TimeClockTest, ClockTest010, TestSize.Level0)
     ClockTest010();
 }
 
+/* *
+ * @tc.name: ClockTest011
+ * @tc.desc: performance for clock_gettime:Compare the vdso path with the syscall path for the fine clocks
+ * @tc.type: PERF
+ */
+HWTEST_F(TimeClockTest, ClockTest011, TestSize.Level0)
+{
+    ClockTest011();
+}
+
 #endif
 } // namespace OHOS
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_test_process.h"
+
+static const int RSS_STEP_NUM = 5;
+static const size_t RSS_SIZE[RSS_STEP_NUM] = { 0, 0x100000, 0x400000, 0x800000, 0x1000000 }; // 0, 1M, 4M, 8M, 16M
+static const int FORK_LOOP = 8;
+static const int PATTERN_OLD = 0x5a;
+static const int PATTERN_NEW = 0xa5;
+
+static long long TimeDiffUs(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1000000LL + (end->tv_nsec - start->tv_nsec) / 1000; // 1000000, 1000: us
+}
+
+static int ForkOnce(char *buf, size_t size, long long *costUs)
+{
+    struct timespec start = { 0 };
+    struct timespec end = { 0 };
+    int status = 1;
+    pid_t pid;
+    int ret;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    pid = fork();
+    if (pid == 0) {
+        /* the parent rewrites the buffer right after fork, the child must still see the old data */
+        usleep(1000 * 10); // 1000 * 10, wait for the parent to write.
+        if ((size != 0) && ((buf[0] != PATTERN_OLD) || (buf[size - 1] != PATTERN_OLD))) {
+            exit(1);
+        }
+        exit(0);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    ICUNIT_ASSERT_WITHIN_EQUAL(pid, 0, 100000, pid); // 100000, assert pid equal to this.
+
+    *costUs = TimeDiffUs(&start, &end);
+    if (size != 0) {
+        (void)memset_s(buf, size, PATTERN_NEW, size);
+    }
+
+    ret = waitpid(pid, &status, 0);
+    ICUNIT_ASSERT_EQUAL(ret, pid, ret);
+    ICUNIT_ASSERT_EQUAL(WEXITSTATUS(status), 0, WEXITSTATUS(status));
+
+    if (size != 0) {
+        (void)memset_s(buf, size, PATTERN_OLD, size);
+    }
+    return 0;
+}
+
+static int TestCase(void)
+{
+    long long costUs;
+    long long totalUs;
+    char *buf = NULL;
+    size_t size;
+    int ret;
+    int i, j;
+
+    for (i = 0; i < RSS_STEP_NUM; i++) {
+        size = RSS_SIZE[i];
+        if (size != 0) {
+            buf = (char *)malloc(size);
+            ICUNIT_ASSERT_NOT_EQUAL(buf, NULL, buf);
+            (void)memset_s(buf, size, PATTERN_OLD, size);
+        }
+
+        totalUs = 0;
+        for (j = 0; j < FORK_LOOP; j++) {
+            ret = ForkOnce(buf, size, &costUs);
+            ICUNIT_GOTO_EQUAL(ret, 0, ret, EXIT);
+            totalUs += costUs;
+        }
+        printf("fork latency: rss %zu KB, avg %lld us\n", size >> 10, totalUs / FORK_LOOP); // 10: KB
+
+        free(buf);
+        buf = NULL;
+    }
+    return 0;
+EXIT:
+    free(buf);
+    return 1;
+}
+
+void ItTestProcess070(void)
+{
+    TEST_ADD_CASE("IT_POSIX_PROCESS_070", TestCase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -666,5 +666,16 @@ HWTEST_F(ProcessProcessTest, ItTestProcess062, TestSize.Level0)
 {
     ItTestProcess062();
 }
+
+/* *
+ * @tc.name: it_test_process_070
+ * @tc.desc: performance for fork:Measure fork latency against the resident size of the parent,
+ * and check that the child keeps the pre-fork data after the parent writes to it.
+ * @tc.type: PERF
+ */
+HWTEST_F(ProcessProcessTest, ItTestProcess070, TestSize.Level0)
+{
+    ItTestProcess070();
+}
 #endif
 } // namespace OHOS
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2013-2019 Huawei Technologies Co., Ltd. All rights reserved.
+ * Copyright (c) 2020-2021 Huawei Device Co., Ltd. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of
+ * conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list
+ * of conditions and the following disclaimer in the documentation and/or other materials
+ * provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used
+ * to endorse or promote products derived from this software without specific prior written
+ * permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "it_mutex_test.h"
+#include <inttypes.h>
+
+static const int PING_PONG_COUNT = 10000;
+
+static pthread_mutex_t g_pingMutex;
+static pthread_cond_t g_pingCond;
+static volatile int g_pingTurn;
+static volatile int g_pongCount;
+
+static int64_t TimespecToNs(const struct timespec *tp)
+{
+    return tp->tv_sec * (int64_t)1e9 + tp->tv_nsec;
+}
+
+static void *PongThread(void *arg)
+{
+    int i;
+
+    for (i = 0; i < PING_PONG_COUNT; i++) {
+        (void)pthread_mutex_lock(&g_pingMutex);
+        while (g_pingTurn != 1) {
+            (void)pthread_cond_wait(&g_pingCond, &g_pingMutex);
+        }
+        g_pingTurn = 0;
+        g_pongCount++;
+        (void)pthread_cond_signal(&g_pingCond);
+        (void)pthread_mutex_unlock(&g_pingMutex);
+    }
+    return nullptr;
+}
+
+static int64_t PingPongCost(int protocol)
+{
+    pthread_mutexattr_t attr;
+    struct timespec start, end;
+    pthread_t tid;
+    int ret;
+    int i;
+
+    (void)pthread_mutexattr_init(&attr);
+    ret = pthread_mutexattr_setprotocol(&attr, protocol);
+    ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    ret = pthread_mutex_init(&g_pingMutex, &attr);
+    ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    (void)pthread_mutexattr_destroy(&attr);
+    ret = pthread_cond_init(&g_pingCond, nullptr);
+    ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    g_pingTurn = 0;
+    g_pongCount = 0;
+
+    ret = pthread_create(&tid, nullptr, PongThread, nullptr);
+    ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < PING_PONG_COUNT; i++) {
+        (void)pthread_mutex_lock(&g_pingMutex);
+        g_pingTurn = 1;
+        (void)pthread_cond_signal(&g_pingCond);
+        while (g_pingTurn != 0) {
+            (void)pthread_cond_wait(&g_pingCond, &g_pingMutex);
+        }
+        (void)pthread_mutex_unlock(&g_pingMutex);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ret = pthread_join(tid, nullptr);
+    ICUNIT_ASSERT_EQUAL(ret, 0, -1);
+    ICUNIT_ASSERT_EQUAL(g_pongCount, PING_PONG_COUNT, -1);
+
+    (void)pthread_cond_destroy(&g_pingCond);
+    (void)pthread_mutex_destroy(&g_pingMutex);
+    return (TimespecToNs(&end) - TimespecToNs(&start)) / PING_PONG_COUNT;
+}
+
+static int Testcase(void)
+{
+    int64_t normalCost, piCost;
+
+    normalCost = PingPongCost(PTHREAD_PRIO_NONE);
+    ICUNIT_ASSERT_NOT_EQUAL(normalCost, -1, normalCost);
+
+    /* PRIO_INHERIT mutexes are locked through FUTEX_LOCK_PI/FUTEX_UNLOCK_PI once contended */
+    piCost = PingPongCost(PTHREAD_PRIO_INHERIT);
+    ICUNIT_ASSERT_NOT_EQUAL(piCost, -1, piCost);
+
+    LogPrintln("mutex/condvar ping-pong: normal %" PRId64 " ns/round, pi %" PRId64 " ns/round\n",
+        normalCost, piCost);
+    return 0;
+}
+
+void ItTestPthreadMutex026(void)
+{
+    TEST_ADD_CASE("IT_POSIX_PTHREAD_MUTEX_026", Testcase, TEST_POSIX, TEST_MEM, TEST_LEVEL0, TEST_FUNCTION);
+}
@@ -62,5 +62,6 @@ extern void ItTestPthreadMutex022(void);
 extern void ItTestPthreadMutex023(void);
 extern void ItTestPthreadMutex024(void);
 extern void ItTestPthreadMutex025(void);
+extern void ItTestPthreadMutex026(void);
 
 #endif